@@ -368,9 +368,9 @@ QVariant GateContainerModel::data(const QModelIndex &index, int role) const
 
     if (value & m_parentMask) {
         auto *parent = reinterpret_cast<Gate *>(value & ~m_parentMask);
-        return QString::fromStdString(
+        return QString::fromStdString(std::string(
             ext::as<const mef::Event *>(parent->args().at(index.row()).event)
-                ->id());
+                ->id()));
     }
 
     auto *gate = static_cast<Gate *>(index.internalPointer());
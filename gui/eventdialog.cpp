@@ -254,7 +254,7 @@ void EventDialog::setupData(const model::Element &element, const T *origin)
     mef::FaultTree *faultTree = getFaultTree(origin);
     if (faultTree)
         containerFaultTreeName->setText(
-            QString::fromStdString(faultTree->name()));
+            QString::fromStdString(std::string(faultTree->name())));
     else
         static_cast<QListView *>(typeBox->view())
             ->setRowHidden(ext::one_bit_index(Gate), true);
@@ -311,8 +311,8 @@ void EventDialog::setupData(const model::Gate &element)
     if (element.minNumber())
         minNumberBox->setValue(*element.minNumber());
     for (const mef::Formula::Arg &arg : element.args())
-        argsList->addItem(QString::fromStdString(
-            ext::as<const mef::Event *>(arg.event)->id()));
+        argsList->addItem(QString::fromStdString(std::string(
+            ext::as<const mef::Event *>(arg.event)->id())));
     emit formulaArgsChanged(); ///< @todo Bogus signal order conflicts.
 }
 
@@ -497,7 +497,8 @@ void EventDialog::setupArgCompleter()
                       + m_model->house_events().size());
     auto addEvents = [&allEvents](const auto &eventContainer) {
         for (const auto &event : eventContainer)
-            allEvents.push_back(QString::fromStdString(event.id()));
+            allEvents.push_back(
+                QString::fromStdString(std::string(event.id())));
     };
     addEvents(m_model->gates());
     addEvents(m_model->basic_events());
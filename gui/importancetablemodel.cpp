@@ -88,7 +88,7 @@ QVariant ImportanceTableModel::data(const QModelIndex &index, int role) const
 
     switch (index.column()) {
     case 0:
-        return QString::fromStdString(record.event.id());
+        return QString::fromStdString(std::string(record.event.id()));
     case 1:
         return record.factors.occurrence;
     case 2:
@@ -300,7 +300,8 @@ bool MainWindow::addInputFiles(const std::vector<std::string> &inputFiles)
                     this, _("Initialization Error"),
                     //: Single top/root event fault tree are expected by GUI.
                     _("Fault tree '%1' must have a single top-gate.")
-                        .arg(QString::fromStdString(faultTree.name())));
+                        .arg(QString::fromStdString(
+                            std::string(faultTree.name()))));
                 return false;
             }
         }
@@ -416,7 +417,8 @@ void MainWindow::setupActions()
             nameDialog.nameLine->setText(m_guiModel->id());
         if (nameDialog.exec() == QDialog::Accepted) {
             QString name = nameDialog.nameLine->text();
-            if (name != QString::fromStdString(m_model->GetOptionalName())) {
+            if (name != QString::fromStdString(
+                            std::string(m_model->GetOptionalName()))) {
                 m_undoStack->push(new model::Model::SetName(std::move(name),
                                                             m_guiModel.get()));
             }
@@ -600,7 +602,8 @@ void MainWindow::setupStartPage()
 QString MainWindow::getModelNameForTitle()
 {
     return m_model->HasDefaultName() ? _("Unnamed Model")
-                                     : QString::fromStdString(m_model->name());
+                                     : QString::fromStdString(
+                                           std::string(m_model->name()));
 }
 
 void MainWindow::createNewModel()
@@ -780,14 +783,36 @@ void MainWindow::runAnalysis()
     WaitDialog progress(this);
     //: This is a message shown during the analysis run.
     progress.setLabelText(_("Running analysis..."));
-    auto analysis =
-        std::make_unique<core::RiskAnalysis>(m_model.get(), m_settings);
+    progress.setCancelButtonText(_("Cancel"));
+    progress.setFixedSize(progress.sizeHint());
+    progress.setAutoReset(false);
+    progress.setAutoClose(false);
+    auto channel = std::make_shared<core::Progress>();
+    connect(&progress, &QProgressDialog::canceled,
+            [&channel] { channel->Cancel(); });
+    QTimer progressTimer;
+    connect(&progressTimer, &QTimer::timeout, [&channel, &progress] {
+        double fraction = channel->fraction();
+        if (fraction == 0)
+            return;
+        progress.setRange(0, 100);
+        progress.setValue(static_cast<int>(fraction * 100));
+    });
+    progressTimer.start(100);
+    auto analysis = std::make_unique<core::RiskAnalysis>(
+        m_model.get(), core::Settings(m_settings).progress(channel));
     QFutureWatcher<void> futureWatcher;
     connect(&futureWatcher, SIGNAL(finished()), &progress, SLOT(reset()));
     futureWatcher.setFuture(
         QtConcurrent::run([&analysis] { analysis->Analyze(); }));
     progress.exec();
     futureWatcher.waitForFinished();
+    progressTimer.stop();
+    if (channel->canceled()) {
+        QMessageBox::warning(this, _("Analysis Canceled"),
+                             _("The report contains only the results "
+                               "of the completed analysis targets."));
+    }
     resetReportTree(std::move(analysis));
 }
 
@@ -1009,7 +1034,8 @@ void MainWindow::removeEvent(model::Gate *event, mef::FaultTree *faultTree)
             event, m_guiModel.get(), faultTree));
         return;
     }
-    QString faultTreeName = QString::fromStdString(faultTree->name());
+    QString faultTreeName =
+        QString::fromStdString(std::string(faultTree->name()));
     if (faultTree->gates().size() > 1) {
         QMessageBox::information(
             this,
@@ -1607,7 +1633,8 @@ void MainWindow::activateFaultTreeDiagram(mef::FaultTree *faultTree)
     GUI_ASSERT(faultTree, );
     GUI_ASSERT(faultTree->top_events().size() == 1, );
 
-	const auto title = _("Fault Tree: %1").arg(QString::fromStdString(faultTree->name()));
+	const auto title = _("Fault Tree: %1")
+		.arg(QString::fromStdString(std::string(faultTree->name())));
 	if (activateTab(title))
 		return;
 
@@ -181,7 +181,8 @@ void Model::SetName::redo()
 Model::AddFaultTree::AddFaultTree(std::unique_ptr<mef::FaultTree> faultTree,
                                   Model *model)
     : QUndoCommand(_("Add fault tree '%1'")
-                       .arg(QString::fromStdString(faultTree->name()))),
+                       .arg(QString::fromStdString(
+                           std::string(faultTree->name())))),
       m_model(model), m_address(faultTree.get()),
       m_faultTree(std::move(faultTree))
 {
@@ -202,7 +203,8 @@ void Model::AddFaultTree::undo()
 Model::RemoveFaultTree::RemoveFaultTree(mef::FaultTree *faultTree, Model *model)
     : Inverse<AddFaultTree>(faultTree, model,
                             _("Remove fault tree '%1'")
-                                .arg(QString::fromStdString(faultTree->name())))
+                                .arg(QString::fromStdString(
+                                    std::string(faultTree->name()))))
 {
 }
 
@@ -74,7 +74,10 @@ public:
     /// @returns A unique ID string for element within the element type-group.
     ///
     /// @pre The element is public.
-    QString id() const { return QString::fromStdString(m_data->name()); }
+    QString id() const
+    {
+        return QString::fromStdString(std::string(m_data->name()));
+    }
 
     /// @returns The additional description for the element.
     QString label() const { return QString::fromStdString(m_data->label()); }
@@ -516,7 +519,8 @@ public:
         AddEvent(std::unique_ptr<typename T::Origin> event, Model *model,
                  mef::FaultTree *faultTree = nullptr)
             : QUndoCommand(
-                  _("Add event '%1'").arg(QString::fromStdString(event->id()))),
+                  _("Add event '%1'")
+                      .arg(QString::fromStdString(std::string(event->id())))),
               m_model(model), m_proxy(std::make_unique<T>(event.get())),
               m_address(event.get()), m_event(std::move(event)),
               m_faultTree(faultTree)
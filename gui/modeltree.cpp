@@ -119,8 +119,8 @@ QVariant ModelTree::data(const QModelIndex &index, int role) const
         return {};
 
     if (index.parent().isValid())
-        return QString::fromStdString(
-            static_cast<mef::FaultTree *>(index.internalPointer())->name());
+        return QString::fromStdString(std::string(
+            static_cast<mef::FaultTree *>(index.internalPointer())->name()));
     switch (static_cast<Row>(index.row())) {
     case Row::FaultTrees:
         //: The parent item for collections of fault trees in the model.
@@ -39,7 +39,8 @@ ProductTableModel::ProductTableModel(const core::ProductContainer &products,
             const core::Literal &literal = *it;
             if (literal.complement)
                 members.append(QStringLiteral("\u00AC"));
-            members.append(QString::fromStdString(literal.event.id()));
+            members.append(
+                QString::fromStdString(std::string(literal.event.id())));
             if (++it != it_end)
                 members.append(QStringLiteral(" \u22C5 "));
         }
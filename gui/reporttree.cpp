@@ -87,7 +87,7 @@ QVariant ReportTree::data(const QModelIndex &index, int role) const
     {
         QString operator()(const mef::Gate *gate)
         {
-            return QString::fromStdString(gate->id());
+            return QString::fromStdString(std::string(gate->id()));
         }
 
         QString operator()(const std::pair<const mef::InitiatingEvent &,
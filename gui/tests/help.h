@@ -21,6 +21,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -42,6 +43,12 @@ inline char *toString(const std::string &value)
     return qstrdup(value.c_str());
 }
 
+template <>
+inline char *toString(const std::string_view &value)
+{
+    return qstrdup(std::string(value).c_str());
+}
+
 template <>
 inline char *toString(const std::vector<std::string> &value)
 {
@@ -30,7 +30,7 @@ Phase::Phase(std::string name, double time_fraction)
   if (time_fraction_ <= 0 || time_fraction_ > 1)
     SCRAM_THROW(DomainError("The phase fraction must be in (0, 1]."))
         << errinfo_value(std::to_string(time_fraction_))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
 }
 
 void Alignment::Validate() {
@@ -40,7 +40,7 @@ void Alignment::Validate() {
   if (!ext::is_close(1, sum, 1e-4))
     SCRAM_THROW(ValidityError("The phases of the alignment do not sum to 1."))
         << errinfo_value(std::to_string(sum))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
 }
 
 }  // namespace scram::mef
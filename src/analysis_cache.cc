@@ -0,0 +1,518 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the on-disk cache with a compact binary format.
+///
+/// The cache file consists of the header with the magic number,
+/// the format version, and the key,
+/// the ZBDD image, the optional BDD image,
+/// and the checksum of the preceding bytes.
+/// The numbers are stored in the native byte order;
+/// files with a foreign byte order fail the magic number check.
+
+#include "analysis_cache.h"
+
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "event.h"
+#include "logger.h"
+#include "xml.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram::core {
+
+namespace {
+
+const std::uint32_t kMagic = 0x53435241;  ///< "SCRA" in the native order.
+const std::int32_t kFormatVersion = 1;  ///< Changes with the format.
+const char kExtension[] = ".cache";  ///< The extension of the entry files.
+
+/// @returns The 64-bit FNV-1a hash of the bytes.
+std::uint64_t Checksum(const char* data, std::size_t size) noexcept {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+/// Incremental 128-bit digest from two unrelated 64-bit hashes.
+class Digest {
+ public:
+  /// Appends a number to the digest.
+  void Add(std::int64_t value) noexcept {
+    auto bits = static_cast<std::uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+      fnv_ ^= (bits >> (8 * i)) & 0xff;
+      fnv_ *= 0x100000001b3;
+    }
+    mix_ = Mix(mix_ ^ bits) + 0x9e3779b97f4a7c15;
+  }
+
+  /// Appends a string with its length to the digest.
+  void Add(std::string_view text) noexcept {
+    Add(static_cast<std::int64_t>(text.size()));
+    for (char symbol : text)
+      Add(symbol);
+  }
+
+  /// @returns The hexadecimal representation of the digest.
+  std::string str() const {
+    std::ostringstream out;
+    out << std::hex << std::setfill('0') << std::setw(16) << fnv_
+        << std::setw(16) << Mix(mix_);
+    return out.str();
+  }
+
+ private:
+  /// The SplitMix64 finalizer.
+  static std::uint64_t Mix(std::uint64_t z) noexcept {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  std::uint64_t fnv_ = 0xcbf29ce484222325;  ///< The FNV-1a hash.
+  std::uint64_t mix_ = 0;  ///< The multiplicative mixing hash.
+};
+
+/// Adds the gate and its sub-graph to the digest in the depth-first order.
+///
+/// @param[in] gate  The gate to add.
+/// @param[in,out] digest  The digest of the graph.
+/// @param[in,out] visited  The indices of the gates in the digest.
+void Add(const Gate& gate, Digest* digest,
+         std::unordered_set<int>* visited) {
+  if (!visited->insert(gate.index()).second)
+    return;
+  for (const auto& arg : gate.args<Gate>())
+    Add(arg.second, digest, visited);
+  digest->Add(gate.index());
+  digest->Add(gate.order());
+  digest->Add(gate.type());
+  digest->Add(gate.min_number());
+  digest->Add(gate.module());
+  digest->Add(gate.coherent());
+  digest->Add(gate.constant());
+  digest->Add(static_cast<std::int64_t>(gate.args().size()));
+  for (int arg : gate.args())
+    digest->Add(arg);
+  for (const auto& arg : gate.args<Variable>())
+    digest->Add(arg.second.order());
+}
+
+/// Serializer of the cache entries into the binary format.
+class Writer {
+ public:
+  /// Appends the binary representation of a number.
+  template <typename T>
+  void Write(T value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  /// Appends the ZBDD image with its modules.
+  void Write(const Zbdd::Image& image) {
+    Write<std::int32_t>(image.index);
+    Write<std::uint8_t>(image.coherent);
+    Write<std::int32_t>(image.root);
+    Write<std::int32_t>(image.nodes.size());
+    for (const Zbdd::Image::Node& node : image.nodes) {
+      Write<std::int32_t>(node.index);
+      Write<std::int32_t>(node.order);
+      Write<std::int32_t>(node.high);
+      Write<std::int32_t>(node.low);
+      Write<std::uint8_t>(node.module | node.coherent << 1);
+    }
+    Write<std::int32_t>(image.modules.size());
+    for (const Zbdd::Image& module : image.modules)
+      Write(module);
+  }
+
+  /// Appends the BDD image.
+  void Write(const Bdd::Image& image) {
+    Write<std::uint8_t>(image.coherent);
+    Write(image.root);
+    Write<std::int32_t>(image.vertices.size());
+    for (const Bdd::Image::Vertex& vertex : image.vertices) {
+      Write<std::int32_t>(vertex.index);
+      Write<std::int32_t>(vertex.order);
+      Write<std::int32_t>(vertex.high);
+      Write<std::int32_t>(vertex.low);
+      Write<std::uint8_t>(vertex.complement_edge | vertex.module << 1 |
+                          vertex.coherent << 2);
+    }
+    Write<std::int32_t>(image.modules.size());
+    for (const auto& [index, function] : image.modules) {
+      Write<std::int32_t>(index);
+      Write(function);
+    }
+    Write<std::int32_t>(image.index_to_order.size());
+    for (const auto& [index, order] : image.index_to_order) {
+      Write<std::int32_t>(index);
+      Write<std::int32_t>(order);
+    }
+  }
+
+  /// Appends the BDD function.
+  void Write(const Bdd::Image::Function& function) {
+    Write<std::uint8_t>(function.complement);
+    Write<std::int32_t>(function.vertex);
+  }
+
+  /// @returns The serialized data.
+  std::string& data() { return buffer_; }
+
+ private:
+  std::string buffer_;  ///< The accumulated binary data.
+};
+
+/// Deserializer of the cache entries with validation of the data.
+/// Invalid data turns the reader into the failure state
+/// instead of throwing.
+class Reader {
+ public:
+  /// @param[in] data  The serialized data.
+  /// @param[in] size  The number of bytes in the data.
+  Reader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+  /// @returns false if the data is exhausted or invalid.
+  explicit operator bool() const { return ok_; }
+
+  /// @returns true if all the data has been read.
+  bool done() const { return pos_ == size_; }
+
+  /// Marks the data as invalid unless the condition holds.
+  void Require(bool condition) { ok_ &= condition; }
+
+  /// @returns The next number or 0 on failure.
+  template <typename T>
+  T Read() {
+    T value = 0;
+    if (!ok_ || size_ - pos_ < sizeof(value)) {
+      ok_ = false;
+      return value;
+    }
+    std::memcpy(&value, data_ + pos_, sizeof(value));
+    pos_ += sizeof(value);
+    return value;
+  }
+
+  /// @param[in] element_size  The least number of bytes per element.
+  ///
+  /// @returns The next container size
+  ///          that can fit into the remaining data.
+  int ReadSize(std::size_t element_size) {
+    int size = Read<std::int32_t>();
+    Require(size >= 0 && static_cast<std::size_t>(size) * element_size <=
+                             size_ - pos_);
+    return ok_ ? size : 0;
+  }
+
+  /// Reads the ZBDD image with its modules.
+  void Read(Zbdd::Image* image) {
+    image->index = Read<std::int32_t>();
+    image->coherent = Read<std::uint8_t>();
+    image->root = Read<std::int32_t>();
+    int num_nodes = ReadSize(17);
+    image->nodes.reserve(num_nodes);
+    for (int i = 0; i < num_nodes && ok_; ++i) {
+      Zbdd::Image::Node node{};
+      node.index = Read<std::int32_t>();
+      node.order = Read<std::int32_t>();
+      node.high = Read<std::int32_t>();
+      node.low = Read<std::int32_t>();
+      std::uint8_t flags = Read<std::uint8_t>();
+      node.module = flags & 1;
+      node.coherent = flags & 2;
+      Require(node.index && node.order > 0 && node.high != node.low &&
+              node.high >= 0 && node.high < i + 2 && node.low >= 0 &&
+              node.low < i + 2);
+      image->nodes.push_back(node);
+    }
+    Require(image->root >= 0 && image->root < num_nodes + 2);
+    int num_modules = ReadSize(13);
+    image->modules.resize(num_modules);
+    std::unordered_set<int> modules;
+    for (Zbdd::Image& module : image->modules) {
+      Read(&module);
+      Require(module.index && modules.insert(module.index).second);
+      if (!ok_)
+        return;
+    }
+    for (const Zbdd::Image::Node& node : image->nodes)
+      Require(!node.module || modules.count(node.index));
+  }
+
+  /// Reads the BDD image.
+  void Read(Bdd::Image* image) {
+    image->coherent = Read<std::uint8_t>();
+    Read(&image->root);
+    int num_vertices = ReadSize(17);
+    image->vertices.reserve(num_vertices);
+    for (int i = 0; i < num_vertices && ok_; ++i) {
+      Bdd::Image::Vertex vertex{};
+      vertex.index = Read<std::int32_t>();
+      vertex.order = Read<std::int32_t>();
+      vertex.high = Read<std::int32_t>();
+      vertex.low = Read<std::int32_t>();
+      std::uint8_t flags = Read<std::uint8_t>();
+      vertex.complement_edge = flags & 1;
+      vertex.module = flags & 2;
+      vertex.coherent = flags & 4;
+      Require(vertex.index > 0 && vertex.order > 0 && vertex.high > 0 &&
+              vertex.high < i + 2 && vertex.low > 0 && vertex.low < i + 2);
+      image->vertices.push_back(vertex);
+    }
+    auto valid = [num_vertices](const Bdd::Image::Function& function) {
+      return function.vertex > 0 && function.vertex < num_vertices + 2;
+    };
+    Require(valid(image->root));
+    int num_modules = ReadSize(9);
+    std::unordered_set<int> modules;
+    for (int i = 0; i < num_modules && ok_; ++i) {
+      int index = Read<std::int32_t>();
+      Bdd::Image::Function function{};
+      Read(&function);
+      Require(valid(function) && modules.insert(index).second);
+      image->modules.emplace_back(index, function);
+    }
+    for (const Bdd::Image::Vertex& vertex : image->vertices)
+      Require(!vertex.module || modules.count(vertex.index));
+    int num_orders = ReadSize(8);
+    for (int i = 0; i < num_orders && ok_; ++i) {
+      int index = Read<std::int32_t>();
+      int order = Read<std::int32_t>();
+      image->index_to_order.emplace_back(index, order);
+    }
+  }
+
+  /// Reads the BDD function.
+  void Read(Bdd::Image::Function* function) {
+    function->complement = Read<std::uint8_t>();
+    function->vertex = Read<std::int32_t>();
+  }
+
+ private:
+  const char* data_;  ///< The serialized data.
+  std::size_t size_;  ///< The number of bytes in the data.
+  std::size_t pos_ = 0;  ///< The current read position.
+  bool ok_ = true;  ///< The state of the data.
+};
+
+/// @returns The serialized cache entry.
+std::string Encode(const std::string& key, const AnalysisCache::Entry& entry) {
+  Writer out;
+  out.Write(kMagic);
+  out.Write(kFormatVersion);
+  out.Write<std::int32_t>(key.size());
+  out.data() += key;
+  out.Write(entry.products);
+  out.Write<std::uint8_t>(entry.bdd.has_value());
+  if (entry.bdd)
+    out.Write(*entry.bdd);
+  out.Write(Checksum(out.data().data(), out.data().size()));
+  return std::move(out.data());
+}
+
+/// @returns The deserialized cache entry if the data is valid.
+std::optional<AnalysisCache::Entry> Decode(const std::string& data,
+                                           const std::string& key) {
+  std::uint64_t checksum = 0;
+  if (data.size() < sizeof(checksum))
+    return {};
+  std::size_t size = data.size() - sizeof(checksum);
+  std::memcpy(&checksum, data.data() + size, sizeof(checksum));
+  if (checksum != Checksum(data.data(), size))
+    return {};
+
+  Reader in(data.data(), size);
+  in.Require(in.Read<std::uint32_t>() == kMagic);
+  in.Require(in.Read<std::int32_t>() == kFormatVersion);
+  int key_size = in.ReadSize(1);
+  in.Require(key_size == key.size());
+  for (char symbol : key)
+    in.Require(in.Read<char>() == symbol);
+  AnalysisCache::Entry entry;
+  if (in)
+    in.Read(&entry.products);
+  if (in && in.Read<std::uint8_t>()) {
+    entry.bdd.emplace();
+    in.Read(&*entry.bdd);
+  }
+  if (!in || !in.done())
+    return {};
+  return entry;
+}
+
+}  // namespace
+
+AnalysisCache::AnalysisCache(const Settings& settings)
+    : directory_(settings.cache_dir()),
+      limit_(static_cast<std::uintmax_t>(settings.cache_limit()) << 20) {
+  assert(!directory_.empty() && "No cache directory.");
+  boost::system::error_code error;
+  fs::create_directories(directory_, error);
+  if (error)
+    LOG(WARNING) << "Cannot create the cache directory " << directory_ << ": "
+                 << error.message();
+}
+
+std::string AnalysisCache::Key(const Pdag& graph,
+                               const Settings& settings) {
+  Digest digest;
+  digest.Add(kFormatVersion);
+  digest.Add(static_cast<int>(settings.algorithm()));
+  digest.Add(settings.prime_implicants());
+  digest.Add(settings.limit_order());
+  digest.Add(settings.ccf_analysis());
+  digest.Add(graph.complement());
+  digest.Add(graph.coherent());
+  digest.Add(graph.normal());
+  digest.Add(static_cast<std::int64_t>(graph.basic_events().size()));
+  for (const mef::BasicEvent* event : graph.basic_events())
+    digest.Add(event->id());
+  for (const Pdag::Substitution& substitution : graph.substitutions()) {
+    for (const std::vector<int>* events :
+         {&substitution.hypothesis, &substitution.source}) {
+      digest.Add(static_cast<std::int64_t>(events->size()));
+      for (int index : *events)
+        digest.Add(index);
+    }
+    digest.Add(substitution.target);
+  }
+  std::unordered_set<int> visited;
+  Add(graph.root(), &digest, &visited);
+  return digest.str();
+}
+
+std::optional<AnalysisCache::Entry>
+AnalysisCache::Load(const std::string& key) noexcept {
+  try {
+    fs::path path = GetPath(key);
+    boost::system::error_code error;
+    std::uintmax_t size = fs::file_size(path, error);
+    if (error)
+      return {};
+    std::string data(size, '\0');
+    {
+      std::ifstream file(path.string(), std::ios::binary);
+      if (!file.read(data.data(), size))
+        return {};
+    }
+    std::optional<Entry> entry = Decode(data, key);
+    if (!entry) {
+      LOG(WARNING) << "Discarding the invalid cache entry " << path;
+      fs::remove(path, error);
+      return {};
+    }
+    fs::last_write_time(path, std::time(nullptr), error);  // Recently used.
+    LOG(DEBUG3) << "Loaded the cache entry " << path;
+    return entry;
+  } catch (const std::exception& err) {  // The cache misses on any failure.
+    LOG(WARNING) << "Cannot load the cache entry from " << directory_ << ": "
+                 << err.what();
+    return {};
+  }
+}
+
+void AnalysisCache::Store(const std::string& key, const Entry& entry) noexcept {
+  try {
+    std::string data = Encode(key, entry);
+    boost::system::error_code error;
+    // The entry is written into a unique file first
+    // so that concurrent readers never see partial entries.
+    fs::path temp = directory_ / fs::unique_path("%%%%-%%%%-%%%%.tmp", error);
+    if (!error) {
+      std::ofstream file(temp.string(), std::ios::binary);
+      if (!file.write(data.data(), data.size()) || !file.flush())
+        error = boost::system::errc::make_error_code(
+            boost::system::errc::io_error);
+    }
+    if (!error)
+      fs::rename(temp, GetPath(key), error);
+    if (error) {
+      LOG(WARNING) << "Cannot store the cache entry in " << directory_ << ": "
+                   << error.message();
+      fs::remove(temp, error);
+      return;
+    }
+    LOG(DEBUG3) << "Stored the cache entry " << GetPath(key);
+    Evict();
+  } catch (const std::exception& err) {
+    LOG(WARNING) << "Cannot store the cache entry in " << directory_ << ": "
+                 << err.what();
+  }
+}
+
+void AnalysisCache::Evict() {
+  struct File {
+    std::time_t time;  ///< The last use time.
+    std::uintmax_t size;  ///< The size in bytes.
+    fs::path path;  ///< The path to the entry file.
+  };
+  std::vector<File> files;
+  std::uintmax_t total_size = 0;
+  boost::system::error_code error;
+  for (fs::directory_iterator it(directory_, error), it_end;
+       !error && it != it_end; it.increment(error)) {
+    const fs::path& path = it->path();
+    // The records of valid input files share the directory and the limit.
+    if (path.extension() != kExtension &&
+        path.extension() != xml::ValidationCache::kExtension) {
+      continue;
+    }
+    boost::system::error_code file_error;
+    std::uintmax_t size = fs::file_size(path, file_error);
+    std::time_t time = fs::last_write_time(path, file_error);
+    if (file_error)
+      continue;  // Removed by another process.
+    total_size += size;
+    files.push_back({time, size, path});
+  }
+  if (total_size <= limit_)
+    return;
+  std::sort(files.begin(), files.end(), [](const File& lhs, const File& rhs) {
+    return lhs.time < rhs.time;
+  });
+  for (const File& file : files) {
+    if (total_size <= limit_)
+      break;
+    if (fs::remove(file.path, error)) {
+      LOG(DEBUG3) << "Evicted the cache entry " << file.path;
+      total_size -= file.size;
+    }
+  }
+}
+
+fs::path AnalysisCache::GetPath(const std::string& key) const {
+  return directory_ / (key + kExtension);
+}
+
+}  // namespace scram::core
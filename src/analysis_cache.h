@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// On-disk cache of qualitative analysis results between runs.
+
+#pragma once
+
+#include <cstdint>
+
+#include <optional>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include "bdd.h"
+#include "pdag.h"
+#include "settings.h"
+#include "zbdd.h"
+
+namespace scram::core {
+
+/// Content-addressed storage of the analysis products and BDD
+/// in a directory shared by analysis runs.
+/// The entries are keyed by the structure of the preprocessed PDAG
+/// and the settings affecting the qualitative analysis results,
+/// so the analysis of unchanged model logic skips to quantification.
+///
+/// The cache is only an optimization;
+/// failures to read or write the entries are logged and ignored.
+class AnalysisCache {
+ public:
+  /// The cached results of the qualitative analysis.
+  struct Entry {
+    Zbdd::Image products;  ///< The resultant products.
+    std::optional<Bdd::Image> bdd;  ///< The BDD of the BDD algorithm.
+  };
+
+  /// @param[in] settings  The settings with the cache directory and limit.
+  ///
+  /// @pre The cache directory is provided in the settings.
+  explicit AnalysisCache(const Settings& settings);
+
+  /// Computes the key of the analysis results.
+  /// Any change in the graph structure, variable ordering,
+  /// basic event identities, substitutions,
+  /// or the qualitative analysis settings changes the key.
+  ///
+  /// @param[in] graph  The preprocessed PDAG of the analysis.
+  /// @param[in] settings  The analysis settings.
+  ///
+  /// @returns The hexadecimal digest of the graph and settings.
+  ///
+  /// @throws std::bad_alloc  The digest cannot be built.
+  static std::string Key(const Pdag& graph, const Settings& settings);
+
+  /// Loads the cached entry
+  /// and marks it as the most recently used.
+  ///
+  /// @param[in] key  The key of the analysis results.
+  ///
+  /// @returns The entry if it is in the cache and valid.
+  ///          None on any failure to read the entry.
+  std::optional<Entry> Load(const std::string& key) noexcept;
+
+  /// Stores the entry
+  /// and evicts the least recently used entries beyond the size limit.
+  ///
+  /// @param[in] key  The key of the analysis results.
+  /// @param[in] entry  The analysis results to store.
+  void Store(const std::string& key, const Entry& entry) noexcept;
+
+ private:
+  /// Removes the least recently used entries
+  /// and records of valid input files
+  /// until the total size is within the limit.
+  void Evict();
+
+  /// @returns The path to the cache file of the entry.
+  boost::filesystem::path GetPath(const std::string& key) const;
+
+  boost::filesystem::path directory_;  ///< The cache directory.
+  std::uintmax_t limit_;  ///< The limit on the total size in bytes.
+};
+
+}  // namespace scram::core
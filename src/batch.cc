@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the batch analysis of models.
+
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <boost/core/typeinfo.hpp>
+#include <boost/exception/errinfo_at_line.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/filesystem.hpp>
+
+#include "error.h"
+#include "ext/parallel.h"
+#include "initializer.h"
+#include "logger.h"
+#include "project.h"
+#include "reporter.h"
+#include "risk_analysis.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram {
+
+namespace {
+
+/// The rough ratio of the analysis memory to the input file size.
+const std::uintmax_t kMemoryPerInputByte = 64;
+
+/// @returns The estimated memory footprint of the model analysis in bytes.
+std::uintmax_t EstimateMemory(const Batch::Job& job) noexcept {
+  std::uintmax_t input_size = 0;
+  for (const std::string& input_file : job.input_files) {
+    boost::system::error_code ec;
+    std::uintmax_t file_size = fs::file_size(input_file, ec);
+    if (!ec)
+      input_size += file_size;
+  }
+  return input_size * kMemoryPerInputByte;
+}
+
+}  // namespace
+
+std::vector<Batch::Entry> Batch::ReadManifest(const std::string& manifest) {
+  std::ifstream in(manifest);
+  if (!in.good()) {
+    SCRAM_THROW(IOError("The batch manifest file is not accessible."))
+        << boost::errinfo_file_name(manifest);
+  }
+  fs::path base_path = fs::absolute(manifest).parent_path();
+  auto resolve = [&base_path](const std::string& path) {
+    return fs::absolute(path, base_path).generic_string();
+  };
+
+  std::vector<Entry> entries;
+  std::string line;
+  for (int line_number = 1; std::getline(in, line); ++line_number) {
+    std::istringstream tokens(line);
+    std::string token;
+    if (!(tokens >> token) || token.front() == '#')
+      continue;
+    Entry entry;
+    entry.output = resolve(token);
+    while (tokens >> token) {
+      if (token != "--project") {
+        entry.input_files.push_back(resolve(token));
+        continue;
+      }
+      if (!entry.project.empty() || !(tokens >> token)) {
+        SCRAM_THROW(SettingsError("Expected a single project file."))
+            << boost::errinfo_file_name(manifest)
+            << boost::errinfo_at_line(line_number);
+      }
+      entry.project = resolve(token);
+    }
+    if (entry.input_files.empty() && entry.project.empty()) {
+      SCRAM_THROW(SettingsError("No input or configuration file is given."))
+          << boost::errinfo_file_name(manifest)
+          << boost::errinfo_at_line(line_number);
+    }
+    entries.push_back(std::move(entry));
+  }
+  if (in.bad()) {
+    SCRAM_THROW(IOError("Failed to read the batch manifest file."))
+        << boost::errinfo_file_name(manifest);
+  }
+  return entries;
+}
+
+Batch::Batch(std::vector<Job> jobs, int num_threads, int memory_limit,
+             bool allow_extern, bool indent)
+    : jobs_(std::move(jobs)),
+      num_threads_(num_threads),
+      allow_extern_(allow_extern),
+      indent_(indent) {
+  if (num_threads < 1) {
+    SCRAM_THROW(
+        SettingsError("The number of batch threads cannot be less than 1."));
+  }
+  if (memory_limit < 1)
+    SCRAM_THROW(SettingsError("The memory limit cannot be less than 1 MB."));
+  memory_limit_ = static_cast<std::uintmax_t>(memory_limit) << 20;
+}
+
+int Batch::Run() noexcept {
+  // The spare threads go to the concurrent jobs within the models.
+  int num_models = std::max<int>(jobs_.size(), 1);
+  int num_jobs = std::max(1, num_threads_ / num_models);
+  std::atomic<int> num_failures(0);
+  ext::parallel_for(jobs_.size(), num_threads_, [&](int i) {
+    const Job& job = jobs_[i];
+    std::uintmax_t cost = 0;
+    bool admitted = false;
+    try {
+      LOG(INFO) << "Analyzing the batch model for " << job.output;
+      Job model = Configure(job);
+      cost = EstimateMemory(model);
+      Acquire(cost);
+      admitted = true;
+      Analyze(model, std::min(num_jobs, model.settings.num_jobs()));
+    } catch (const Error& err) {
+      LOG(ERROR) << "Failed the batch model for " << job.output << ": "
+                 << boost::core::demangled_name(typeid(err)) << ": "
+                 << err.what();
+      ++num_failures;
+    } catch (const std::exception& err) {
+      LOG(ERROR) << "Failed the batch model for " << job.output << ": "
+                 << err.what();
+      ++num_failures;
+    }
+    if (admitted)
+      Release(cost);
+  });
+  return num_failures;
+}
+
+void Batch::Acquire(std::uintmax_t cost) noexcept {
+  std::unique_lock<std::mutex> lock(memory_mutex_);
+  memory_released_.wait(lock, [this, cost] {
+    return memory_in_use_ == 0 || memory_in_use_ + cost <= memory_limit_;
+  });
+  memory_in_use_ += cost;
+}
+
+void Batch::Release(std::uintmax_t cost) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    memory_in_use_ -= cost;
+  }
+  memory_released_.notify_all();
+}
+
+Batch::Job Batch::Configure(const Job& job) {
+  if (job.project.empty())
+    return job;
+  Project config(job.project);
+  Job model{config.input_files(), config.settings(), job.output};
+  if (job.configure)
+    job.configure(&model.settings);
+  model.input_files.insert(model.input_files.end(), job.input_files.begin(),
+                           job.input_files.end());
+  return model;
+}
+
+void Batch::Analyze(const Job& job, int num_jobs) {
+  core::Settings settings = job.settings;
+  settings.num_jobs(num_jobs);
+  std::unique_ptr<mef::Model> model =
+      mef::Initializer(job.input_files, settings, allow_extern_).model();
+  core::RiskAnalysis analysis(model.get(), settings);
+  Reporter reporter;
+  analysis.Analyze(reporter.Prerender(analysis, indent_));
+  reporter.Report(analysis, job.output, indent_);
+}
+
+}  // namespace scram
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Analysis of many models in one process.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "settings.h"
+
+namespace scram {
+
+/// Analyzes independent models concurrently
+/// with a common thread and memory budget.
+/// Every model gets its own report file,
+/// and failures of some models do not stop the analysis of others.
+///
+/// The models share the process-wide facilities,
+/// e.g., the compiled XML schemas are loaded only once.
+class Batch : private boost::noncopyable {
+ public:
+  /// A line of the batch manifest.
+  struct Entry {
+    std::string output;  ///< The report file.
+    std::string project;  ///< The optional project file.
+    std::vector<std::string> input_files;  ///< The MEF input files.
+  };
+
+  /// A model analysis in the batch.
+  struct Job {
+    std::vector<std::string> input_files;  ///< The MEF input files.
+    core::Settings settings;  ///< The analysis settings.
+    std::string output;  ///< The report file.
+    /// The optional project file loaded by the job.
+    /// The project settings replace the job settings,
+    /// and the project input files precede the job input files.
+    std::string project = {};
+    /// The overrides of the project settings, e.g., command-line options.
+    std::function<void(core::Settings*)> configure = {};
+  };
+
+  /// Reads the batch manifest.
+  /// Each non-empty line not starting with '#' describes one model:
+  ///
+  ///     report.xml model.xml extra-model.xml
+  ///     other-report.xml --project configuration.xml
+  ///
+  /// The first path is the report file;
+  /// the rest are MEF input files or a project file after "--project".
+  /// The paths are separated by whitespace
+  /// and resolved against the manifest directory.
+  ///
+  /// @param[in] manifest  The path to the manifest file.
+  ///
+  /// @returns The models in the manifest order.
+  ///
+  /// @throws IOError  The manifest file is not accessible.
+  /// @throws SettingsError  A line of the manifest is malformed.
+  static std::vector<Entry> ReadManifest(const std::string& manifest);
+
+  /// @param[in] jobs  The models to analyze.
+  /// @param[in] num_threads  The total number of threads for all the models.
+  /// @param[in] memory_limit  The memory budget in megabytes
+  ///                          for the models analyzed concurrently.
+  /// @param[in] allow_extern  Allow external libraries in the models.
+  /// @param[in] indent  Indent the reports.
+  ///
+  /// @throws SettingsError  The thread number or budget is not positive.
+  Batch(std::vector<Job> jobs, int num_threads, int memory_limit,
+        bool allow_extern = false, bool indent = true);
+
+  /// Analyzes all the models and writes their reports.
+  /// The threads take the next model as soon as they are free.
+  /// If there are fewer models than threads,
+  /// the spare threads are given to the analyses of the models.
+  ///
+  /// @returns The number of failed models.
+  ///          The errors are logged with the model report file.
+  int Run() noexcept;
+
+ private:
+  /// Waits for the memory budget to admit a model.
+  /// A model is always admitted if no other model is in progress.
+  ///
+  /// @param[in] cost  The estimated memory of the model in bytes.
+  void Acquire(std::uintmax_t cost) noexcept;
+
+  /// Returns the memory of a finished model into the budget.
+  ///
+  /// @param[in] cost  The estimated memory of the model in bytes.
+  void Release(std::uintmax_t cost) noexcept;
+
+  /// Loads the project file of the job if any.
+  ///
+  /// @param[in] job  The model analysis.
+  ///
+  /// @returns The job with the project settings and input files.
+  ///
+  /// @throws Error  The project file is invalid.
+  static Job Configure(const Job& job);
+
+  /// Analyzes a single model and writes its report.
+  ///
+  /// @param[in] job  The configured model analysis.
+  /// @param[in] num_jobs  The number of concurrent jobs for the analysis.
+  ///
+  /// @throws Error  The model is invalid or the analysis has failed.
+  void Analyze(const Job& job, int num_jobs);
+
+  std::vector<Job> jobs_;  ///< The models to analyze.
+  int num_threads_;  ///< The total number of threads.
+  std::uintmax_t memory_limit_;  ///< The memory budget in bytes.
+  bool allow_extern_;  ///< Permission for external libraries.
+  bool indent_;  ///< Indentation of the reports.
+  std::uintmax_t memory_in_use_ = 0;  ///< The memory of the running models.
+  std::mutex memory_mutex_;  ///< The guard of the memory in use.
+  std::condition_variable memory_released_;  ///< The budget notification.
+};
+
+}  // namespace scram
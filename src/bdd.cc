@@ -20,6 +20,8 @@
 
 #include "bdd.h"
 
+#include <unordered_set>
+
 #include <boost/multiprecision/miller_rabin.hpp>
 #include <boost/range/algorithm.hpp>
 
@@ -79,8 +81,107 @@ Bdd::Bdd(const Pdag* graph, const Settings& settings)
   }
 }
 
+Bdd::Bdd(const Pdag* graph, const Settings& settings,
+         const std::vector<GatePtr>& targets)
+    : kSettings_(settings),
+      coherent_(graph->coherent()),
+      kOne_(new Terminal<Ite>(true)),
+      function_id_(2) {
+  TIMER(DEBUG3, "Converting shared PDAG into BDD");
+  root_ = {true, kOne_};
+  std::unordered_map<int, Function> gates;
+  for (const GatePtr& target : targets)
+    targets_.push_back(ConvertGate(*target, &gates));
+  for (const Function& target : targets_)
+    TestStructure(target.vertex);
+  for (const Function& target : targets_)
+    ClearMarks(target.vertex, false);
+  LOG(DEBUG4) << "# of BDD targets: " << targets_.size();
+  LOG(DEBUG4) << "# of BDD vertices created: " << function_id_ - 1;
+  LOG(DEBUG4) << "# of entries in unique table: " << unique_table_.size();
+  if (coherent_) {
+    Freeze();
+  } else {  // The consensus is calculated for the targets.
+    ClearTables();
+  }
+}
+
+Bdd::Bdd(Bdd* host, int target)
+    : kSettings_(host->kSettings_),
+      root_(host->targets_[target]),
+      coherent_(host->coherent_),
+      index_to_order_(host->index_to_order_),
+      kOne_(host->kOne_),
+      function_id_(host->function_id_),
+      host_(host) {
+  // The vertex marks may be left over by the analyses of other targets.
+  std::unordered_set<int> visited;
+  auto clear_marks = [&visited](auto& self, const VertexPtr& vertex) -> void {
+    if (vertex->terminal() || !visited.insert(vertex->id()).second)
+      return;
+    Ite& ite = Ite::Ref(vertex);
+    ite.mark(false);
+    self(self, ite.high());
+    self(self, ite.low());
+  };
+  clear_marks(clear_marks, root_.vertex);
+}
+
+Bdd::Bdd(const Image& image, const Settings& settings)
+    : kSettings_(settings),
+      coherent_(image.coherent),
+      kOne_(new Terminal<Ite>(true)),
+      function_id_(2) {
+  std::vector<VertexPtr> vertices = {nullptr, kOne_};
+  vertices.reserve(image.vertices.size() + 2);
+  for (const Image::Vertex& vertex : image.vertices) {
+    assert(vertex.high < vertices.size() && vertex.low < vertices.size());
+    ItePtr ite =
+        FindOrAddVertex(vertex.index, vertices[vertex.high],
+                        vertices[vertex.low], vertex.complement_edge,
+                        vertex.order);
+    ite->module(vertex.module);
+    ite->coherent(vertex.coherent);
+    vertices.push_back(ite);
+  }
+  root_ = {image.root.complement, vertices[image.root.vertex]};
+  for (const auto& [index, module] : image.modules)
+    modules_.emplace(index, Function{module.complement, vertices[module.vertex]});
+  index_to_order_.insert(image.index_to_order.begin(),
+                         image.index_to_order.end());
+  Freeze();
+}
+
 Bdd::~Bdd() noexcept = default;
 
+Bdd::Image Bdd::Export() const noexcept {
+  assert(!host_ && "Exporting a target of the shared BDD.");
+  Image image{coherent_, {}, {}, {}, {}};
+  std::unordered_map<int, int> references;  // Vertex ids to image references.
+  auto reference = [&image, &references](auto& self,
+                                         const VertexPtr& vertex) -> int {
+    if (vertex->terminal())
+      return 1;
+    if (auto it = references.find(vertex->id()); it != references.end())
+      return it->second;
+    const Ite& ite = Ite::Ref(vertex);
+    int high = self(self, ite.high());
+    int low = self(self, ite.low());
+    image.vertices.push_back({ite.index(), ite.order(), high, low,
+                              ite.complement_edge(), ite.module(),
+                              ite.coherent()});
+    int position = image.vertices.size() + 1;
+    references.emplace(vertex->id(), position);
+    return position;
+  };
+  image.root = {root_.complement, reference(reference, root_.vertex)};
+  for (const auto& [index, module] : modules_)
+    image.modules.push_back(
+        {index, {module.complement, reference(reference, module.vertex)}});
+  image.index_to_order.assign(index_to_order_.begin(), index_to_order_.end());
+  return image;
+}
+
 void Bdd::Analyze(const Pdag* graph) noexcept {
   zbdd_ = std::make_unique<Zbdd>(this, kSettings_);
   zbdd_->Analyze(graph);
@@ -172,6 +273,8 @@ Bdd::Function Bdd::ConvertGraph(
   });
   auto it = args.cbegin();
   for (result = *it++; it != args.cend(); ++it) {
+    if (kSettings_.canceled())
+      break;  // The incomplete result is discarded by the risk analysis.
     result = Apply(gate.type(), result.vertex, it->vertex, result.complement,
                    it->complement);
   }
@@ -306,8 +409,95 @@ Bdd::Function Bdd::Apply(Connective type, const VertexPtr& arg_one,
   return Apply<kOr>(arg_one, arg_two, complement_one, complement_two);
 }
 
+Bdd::Function Bdd::ConvertGate(
+    const Gate& gate, std::unordered_map<int, Function>* gates) noexcept {
+  if (auto it = ext::find(*gates, gate.index()))
+    return it->second;
+  Function result;
+  if (gate.constant()) {
+    result = {*gate.args().begin() < 0, kOne_};
+    gates->emplace(gate.index(), result);
+    return result;
+  }
+  std::vector<Function> args;
+  for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>()) {
+    Function res = ConvertGate(arg.second, gates);
+    args.push_back({(arg.first < 0) != res.complement, res.vertex});
+  }
+  for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
+    int order = index_to_order_.size() + 1;
+    order = index_to_order_.emplace(arg.second.index(), order).first->second;
+    args.push_back({arg.first < 0, FindOrAddVertex(arg.second.index(), kOne_,
+                                                   kOne_, true, order)});
+  }
+  switch (gate.type()) {
+    case kNull:
+      result = args.front();
+      break;
+    case kNot:
+      result = {!args.front().complement, args.front().vertex};
+      break;
+    case kXor: {
+      const Function& one = args.front();
+      const Function& two = args.back();
+      Function only_one = Apply<kAnd>(one.vertex, two.vertex, one.complement,
+                                      !two.complement);
+      Function only_two = Apply<kAnd>(one.vertex, two.vertex, !one.complement,
+                                      two.complement);
+      result = Apply<kOr>(only_one.vertex, only_two.vertex,
+                          only_one.complement, only_two.complement);
+      break;
+    }
+    case kAtleast:
+      result = ApplyAtleast(gate.min_number(), args);
+      break;
+    default: {
+      Connective type = gate.type();
+      if (type == kNand || type == kNor)
+        type = type == kNand ? kAnd : kOr;
+      boost::sort(args, [](const Function& lhs, const Function& rhs) {
+        if (lhs.vertex->terminal())
+          return true;
+        if (rhs.vertex->terminal())
+          return false;
+        return Ite::Ref(lhs.vertex).order() > Ite::Ref(rhs.vertex).order();
+      });
+      auto it = args.cbegin();
+      for (result = *it++; it != args.cend(); ++it) {
+        result = Apply(type, result.vertex, it->vertex, result.complement,
+                       it->complement);
+      }
+      if (type != gate.type())
+        result.complement = !result.complement;
+    }
+  }
+  ClearTables();
+  gates->emplace(gate.index(), result);
+  return result;
+}
+
+Bdd::Function Bdd::ApplyAtleast(int min_number,
+                                const std::vector<Function>& args) noexcept {
+  // The functions of at least K true arguments in the processed suffix.
+  std::vector<Function> combinations(min_number + 1, {true, kOne_});
+  combinations.front() = {false, kOne_};
+  for (auto it = args.rbegin(); it != args.rend(); ++it) {
+    for (int k = min_number; k > 0; --k) {
+      Function with_arg =
+          Apply<kAnd>(it->vertex, combinations[k - 1].vertex, it->complement,
+                      combinations[k - 1].complement);
+      combinations[k] =
+          Apply<kOr>(with_arg.vertex, combinations[k].vertex,
+                     with_arg.complement, combinations[k].complement);
+    }
+  }
+  return combinations.back();
+}
+
 Bdd::Function Bdd::CalculateConsensus(const ItePtr& ite,
                                       bool complement) noexcept {
+  if (host_)  // The shared computation tables.
+    return host_->CalculateConsensus(ite, complement);
   ClearTables();
   return Apply<kAnd>(ite->high(), ite->low(), complement,
                      ite->complement_edge() ^ complement);
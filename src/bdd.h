@@ -710,6 +710,31 @@ class Bdd : private boost::noncopyable {
     }
   };
 
+  /// Flat representation of the BDD graph for storage outside of the analysis.
+  struct Image {
+    /// The if-then-else vertex with references to the terminal One (1)
+    /// or to preceding vertices (the position in the vertex list + 2).
+    struct Vertex {
+      int index;  ///< The positive index of the variable or module.
+      int order;  ///< The positive order of the variable.
+      int high;  ///< The reference to the high vertex.
+      int low;  ///< The reference to the low vertex.
+      bool complement_edge;  ///< The interpretation of the low vertex.
+      bool module;  ///< The indication of a module proxy.
+      bool coherent;  ///< The coherence of the module.
+    };
+    /// The function with the reference to its root vertex.
+    struct Function {
+      bool complement;  ///< The interpretation of the function.
+      int vertex;  ///< The reference to the root vertex.
+    };
+    bool coherent;  ///< The coherence of the source PDAG.
+    Function root;  ///< The root function of the BDD.
+    std::vector<Vertex> vertices;  ///< The vertices with the children first.
+    std::vector<std::pair<int, Function>> modules;  ///< Module indices.
+    std::vector<std::pair<int, int>> index_to_order;  ///< Variable orders.
+  };
+
   /// Provides access to consensus calculation private facilities.
   class Consensus {
     friend class Zbdd;  // Access for calculation of prime implicants.
@@ -737,12 +762,53 @@ class Bdd : private boost::noncopyable {
   /// @note BDD construction may take considerable time.
   Bdd(const Pdag* graph, const Settings& settings);
 
+  /// Constructs a shared BDD with multiple roots
+  /// for the analysis targets of a PDAG.
+  /// The BDD vertices are shared by the common sub-graphs of the targets.
+  ///
+  /// @param[in] graph  The PDAG shared by the targets.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] targets  The gates of the analysis targets in the PDAG.
+  ///
+  /// @pre The graph is not preprocessed;
+  ///      any connective and constant arguments are accepted.
+  ///
+  /// @post The root of this BDD is constant False;
+  ///       the target functions are provided by targets().
+  Bdd(const Pdag* graph, const Settings& settings,
+      const std::vector<GatePtr>& targets);
+
+  /// Constructs a BDD for one of the targets of a shared BDD.
+  /// All the computations are delegated to the host BDD.
+  ///
+  /// @param[in] host  The shared BDD with multiple roots.
+  /// @param[in] target  The position of the target in the host.
+  ///
+  /// @pre The host BDD outlives this BDD.
+  /// @pre The analyses with other targets of the host are done
+  ///      because the BDD vertices and their marks are shared.
+  Bdd(Bdd* host, int target);
+
+  /// Restores the BDD graph exported by another BDD.
+  /// The restored BDD is frozen
+  /// and meant only for quantitative analyses.
+  ///
+  /// @param[in] image  The valid image of an analyzed BDD.
+  /// @param[in] settings  The analysis settings of the exported BDD.
+  ///
+  /// @note The products of the analysis are not restored;
+  ///       the analysis of the restored BDD is not expected.
+  Bdd(const Image& image, const Settings& settings);
+
   /// To handle incomplete ZBDD type with unique pointers.
   ~Bdd() noexcept;
 
   /// @returns The root function of the ROBDD.
   const Function& root() const { return root_; }
 
+  /// @returns The root functions of the targets of the shared BDD.
+  const std::vector<Function>& targets() const { return targets_; }
+
   /// @returns Mapping of PDAG modules and BDD graph vertices.
   const std::unordered_map<int, Function>& modules() const { return modules_; }
 
@@ -778,6 +844,11 @@ class Bdd : private boost::noncopyable {
     return *zbdd_;
   }
 
+  /// @returns The flat image of the root and module graphs.
+  ///
+  /// @pre The BDD is not a target of a shared BDD.
+  Image Export() const noexcept;
+
  private:
   using IteWeakPtr = WeakIntrusivePtr<Ite>;  ///< Pointer in containers.
   using ComputeTable = CacheTable<Function>;  ///< Computation results.
@@ -842,6 +913,25 @@ class Bdd : private boost::noncopyable {
       const Gate& gate,
       std::unordered_map<int, std::pair<Function, int>>* gates) noexcept;
 
+  /// Converts a gate of a PDAG without preprocessing.
+  /// The variables are ordered upon the first encounter.
+  ///
+  /// @param[in] gate  The root or current parent gate of the graph.
+  /// @param[in,out] gates  Processed gates.
+  ///
+  /// @returns The BDD function representing the gate.
+  Function ConvertGate(const Gate& gate,
+                       std::unordered_map<int, Function>* gates) noexcept;
+
+  /// Applies the at-least connective to BDD functions.
+  ///
+  /// @param[in] min_number  The minimum number of true arguments.
+  /// @param[in] args  The argument functions.
+  ///
+  /// @returns The BDD function of the combination.
+  Function ApplyAtleast(int min_number,
+                        const std::vector<Function>& args) noexcept;
+
   /// Computes minimum and maximum ids for keys in computation tables.
   ///
   /// @param[in] arg_one  First argument function graph.
@@ -985,6 +1075,8 @@ class Bdd : private boost::noncopyable {
   const TerminalPtr kOne_;  ///< Terminal True.
   int function_id_;  ///< Identification assignment for new function graphs.
   std::unique_ptr<Zbdd> zbdd_;  ///< ZBDD as a result of analysis.
+  std::vector<Function> targets_;  ///< The roots of the shared BDD.
+  Bdd* host_ = nullptr;  ///< The shared BDD with the computation tables.
 };
 
 }  // namespace scram::core
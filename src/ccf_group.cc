@@ -24,9 +24,6 @@
 
 #include <utility>
 
-#include <boost/algorithm/string/join.hpp>
-#include <boost/range/adaptor/transformed.hpp>
-
 #include "error.h"
 #include "expression/constant.h"
 #include "expression/numerical.h"
@@ -42,26 +39,26 @@ CcfEvent::CcfEvent(std::vector<Gate*> members, const CcfGroup* ccf_group)
       members_(std::move(members)) {}
 
 std::string CcfEvent::MakeName(const std::vector<Gate*>& members) {
-  return "[" +
-         boost::join(members | boost::adaptors::transformed(
-                                   [](const Gate* gate) -> decltype(auto) {
-                                     return gate->name();
-                                   }),
-                     " ") +
-         "]";
+  std::string name = "[";
+  for (const Gate* gate : members) {
+    if (name.size() > 1)
+      name += ' ';
+    name += gate->name();
+  }
+  return name += ']';
 }
 
 void CcfGroup::AddMember(BasicEvent* basic_event) {
   if (distribution_ || factors_.empty() == false) {
     SCRAM_THROW(LogicError("No more members accepted. The distribution for " +
-                           Element::name() +
+                           std::string(Element::name()) +
                            " CCF group has already been defined."));
   }
   if (ext::any_of(members_, [&basic_event](BasicEvent* member) {
         return member->name() == basic_event->name();
       })) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(basic_event->name(), "CCF group event");
+        << errinfo_element(std::string(basic_event->name()), "CCF group event");
   }
   members_.push_back(basic_event);
 }
@@ -71,7 +68,7 @@ void CcfGroup::AddDistribution(Expression* distr) {
     SCRAM_THROW(LogicError("CCF distribution is already defined."));
   if (members_.size() < 2) {
     SCRAM_THROW(ValidityError("CCF group must have at least 2 members."))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
   distribution_ = distr;
   // Define probabilities of all basic events.
@@ -92,20 +89,20 @@ void CcfGroup::AddFactor(Expression* factor, std::optional<int> level) {
                               std::to_string(*level) +
                               ") is less than the minimum level (" +
                               std::to_string(min_level) + ")."))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
   if (members_.size() < *level) {
     SCRAM_THROW(ValidityError("The CCF factor level " + std::to_string(*level) +
                               " is more than the number of members (" +
                               std::to_string(members_.size()) + ")"))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
 
   int index = *level - min_level;
   if (index < factors_.size() && factors_[index].second != nullptr) {
     SCRAM_THROW(ValidityError("Redefinition of CCF factor for level " +
                               std::to_string(*level)))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
   if (index >= factors_.size())
     factors_.resize(index + 1);
@@ -131,7 +128,7 @@ void CcfGroup::Validate() const {
     this->DoValidate();
 
   } catch (Error& err) {
-    err << errinfo_element(Element::name(), kTypeString);
+    err << errinfo_element(std::string(Element::name()), kTypeString);
     throw;
   }
 }
@@ -20,120 +20,136 @@
 
 #include "cycle.h"
 
+#include <unordered_set>
+
 namespace scram::mef::cycle {
 
 template <>
-bool ContinueConnector(Branch* connector, std::vector<NamedBranch*>* cycle) {
+void CollectNodes(Branch* connector, std::vector<NamedBranch*>* nodes) {
   struct {
-    bool operator()(NamedBranch* branch) { return DetectCycle(branch, cycle_); }
+    void operator()(NamedBranch* branch) { nodes_->push_back(branch); }
 
-    bool operator()(Fork* fork) {
-      for (Branch& branch : fork->paths()) {
-        if (ContinueConnector(&branch, cycle_))
-          return true;
-      }
-      return false;
+    void operator()(Fork* fork) {
+      for (Branch& branch : fork->paths())
+        branches_.push_back(&branch);
     }
 
-    bool operator()(Sequence*) { return false; }
+    void operator()(Sequence*) {}
 
-    decltype(cycle) cycle_;
-  } continue_connector{cycle};
+    decltype(nodes) nodes_;
+    std::vector<Branch*> branches_;
+  } collector{nodes, {connector}};
 
-  return std::visit(continue_connector, connector->target());
+  while (!collector.branches_.empty()) {
+    Branch* branch = collector.branches_.back();
+    collector.branches_.pop_back();
+    std::visit(collector, branch->target());
+  }
 }
 
 template <>
-bool ContinueConnector(const Instruction* connector,
-                       std::vector<Rule*>* cycle) {
-  struct Visitor : public InstructionVisitor {
-    struct ArgSelector : public InstructionVisitor {
-      explicit ArgSelector(Visitor* visitor) : visitor_(visitor) {}
-
-      void Visit(const SetHouseEvent*) override {}
-      void Visit(const CollectExpression*) override {}
-      void Visit(const CollectFormula*) override {}
-      void Visit(const Link*) override {}
-      void Visit(const IfThenElse* ite) override { visitor_->Visit(ite); }
-      void Visit(const Block* block) override { visitor_->Visit(block); }
-      void Visit(const Rule* rule) override {
-        // Non-const rules are only needed to mark the nodes.
-        if (DetectCycle(const_cast<Rule*>(rule), visitor_->cycle_))
-          throw true;
-      }
-
-      Visitor* visitor_;
-    };
-
-    explicit Visitor(std::vector<Rule*>* t_cycle)
-        : cycle_(t_cycle), selector_(this) {}
+void CollectNodes(const Instruction* connector, std::vector<Rule*>* nodes) {
+  struct Collector : public InstructionVisitor {
+    explicit Collector(std::vector<Rule*>* t_nodes) : nodes_(t_nodes) {}
 
     void Visit(const SetHouseEvent*) override {}
     void Visit(const CollectExpression*) override {}
     void Visit(const CollectFormula*) override {}
     void Visit(const Link*) override {}
     void Visit(const IfThenElse* ite) override {
-      ite->then_instruction()->Accept(&selector_);
+      instructions_.push_back(ite->then_instruction());
       if (ite->else_instruction())
-        ite->else_instruction()->Accept(&selector_);
+        instructions_.push_back(ite->else_instruction());
     }
     void Visit(const Block* block) override {
-      for (const Instruction* instruction : block->instructions())
-        instruction->Accept(&selector_);
+      instructions_.insert(instructions_.end(), block->instructions().begin(),
+                           block->instructions().end());
     }
     void Visit(const Rule* rule) override {
-      for (const Instruction* instruction : rule->instructions())
-        instruction->Accept(&selector_);
+      // The connector rule is expanded; other rules are the nodes.
+      if (rule == root_) {
+        instructions_.insert(instructions_.end(), rule->instructions().begin(),
+                             rule->instructions().end());
+      } else {
+        // Non-const rules are only needed to mark the nodes.
+        nodes_->push_back(const_cast<Rule*>(rule));
+      }
     }
-    std::vector<Rule*>* cycle_;
-    ArgSelector selector_;
-  } visitor(cycle);
-
-  try {
-    connector->Accept(&visitor);
-  } catch (bool& ret_val) {
-    assert(ret_val && !cycle->empty());
-    return true;
+
+    std::vector<Rule*>* nodes_;
+    const Instruction* root_ = nullptr;
+    std::vector<const Instruction*> instructions_;
+  } collector(nodes);
+
+  collector.root_ = connector;
+  connector->Accept(&collector);
+  collector.root_ = nullptr;  // Self-references are cycles.
+  while (!collector.instructions_.empty()) {
+    const Instruction* instruction = collector.instructions_.back();
+    collector.instructions_.pop_back();
+    instruction->Accept(&collector);
   }
-  return false;
 }
 
 template <>
-bool ContinueConnector(const EventTree* connector, std::vector<Link*>* cycle) {
-  struct {
-    void operator()(const Branch* branch) {
-      std::visit(*this, branch->target());
+void CollectNodes(const EventTree* connector, std::vector<Link*>* nodes) {
+  // Links are expected only in the sequence instructions.
+  struct Collector : public InstructionVisitor {
+    explicit Collector(std::vector<Link*>* t_nodes) : nodes_(t_nodes) {}
+
+    void Visit(const SetHouseEvent*) override {}
+    void Visit(const CollectExpression*) override {}
+    void Visit(const CollectFormula*) override {}
+    void Visit(const IfThenElse* ite) override {
+      instructions_.push_back(ite->then_instruction());
+      if (ite->else_instruction())
+        instructions_.push_back(ite->else_instruction());
     }
-    void operator()(Fork* fork) {
-      for (Branch& branch : fork->paths())
-        (*this)(&branch);
+    void Visit(const Block* block) override {
+      instructions_.insert(instructions_.end(), block->instructions().begin(),
+                           block->instructions().end());
     }
-    void operator()(Sequence* sequence) {
-      struct Visitor : public NullVisitor {
-        explicit Visitor(decltype(cycle) t_cycle) : visitor_cycle_(t_cycle) {}
-
-        void Visit(const Link* link) override {
-          if (DetectCycle(const_cast<Link*>(link), visitor_cycle_))
-            throw true;
-        }
-
-        decltype(cycle) visitor_cycle_;
-      } visitor(cycle_);
-
-      for (const Instruction* instruction : sequence->instructions())
-        instruction->Accept(&visitor);
+    void Visit(const Rule* rule) override {
+      instructions_.insert(instructions_.end(), rule->instructions().begin(),
+                           rule->instructions().end());
+    }
+    void Visit(const Link* link) override {
+      nodes_->push_back(const_cast<Link*>(link));
     }
 
-    decltype(cycle) cycle_;
-  } continue_connector{cycle};
+    void operator()(Sequence* sequence) {
+      if (!visited_.insert(sequence).second)
+        return;
+      instructions_.assign(sequence->instructions().begin(),
+                           sequence->instructions().end());
+      while (!instructions_.empty()) {
+        const Instruction* instruction = instructions_.back();
+        instructions_.pop_back();
+        instruction->Accept(this);
+      }
+    }
+    void operator()(NamedBranch* branch) {
+      if (visited_.insert(branch).second)
+        branches_.push_back(branch);
+    }
+    void operator()(Fork* fork) {
+      for (const Branch& branch : fork->paths())
+        branches_.push_back(&branch);
+    }
 
-  try {
-    continue_connector(&connector->initial_state());
-  } catch (bool& ret_val) {
-    assert(ret_val && !cycle->empty());
-    return true;
+    std::vector<Link*>* nodes_;
+    std::vector<const Instruction*> instructions_;
+    std::vector<const Branch*> branches_;
+    // Named branches and sequences shared by paths are visited once.
+    std::unordered_set<const void*> visited_;
+  } collector(nodes);
+
+  collector.branches_.push_back(&connector->initial_state());
+  while (!collector.branches_.empty()) {
+    const Branch* branch = collector.branches_.back();
+    collector.branches_.pop_back();
+    std::visit(collector, branch->target());
   }
-  return false;
 }
 
 }  // namespace scram::mef::cycle
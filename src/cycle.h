@@ -20,11 +20,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <string>
 #include <vector>
 
-#include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -94,8 +95,9 @@ inline auto GetConnectors(Expression* connector) {
 }
 /// @}
 
-/// Helper function to check for cyclic references through connectors.
-/// Connectors may get market upon traversal.
+/// Collects the nodes on the other end of a connector.
+/// The connectors are traversed without recursion
+/// to accommodate deeply nested models.
 ///
 /// Connectors and nodes of the connector are retrieved via unqualified calls:
 /// GetConnectors(connector) and GetNodes(connector).
@@ -103,15 +105,36 @@ inline auto GetConnectors(Expression* connector) {
 /// @tparam T  The type managing the connectors (nodes, edges).
 /// @tparam N  The node type.
 ///
-/// @param[in,out] connector  Connector to nodes.
-/// @param[out] cycle  The cycle path if detected.
-///
-/// @returns True if a cycle is detected.
+/// @param[in] connector  Connector to nodes.
+/// @param[out] nodes  The destination container for the connected nodes.
 template <class T, class N>
-bool ContinueConnector(T* connector, std::vector<N*>* cycle);
+void CollectNodes(T* connector, std::vector<N*>* nodes) {
+  std::vector<T*> connectors = {connector};
+  while (!connectors.empty()) {
+    T* current = connectors.back();
+    connectors.pop_back();
+    for (N* node : GetNodes(current))
+      nodes->push_back(node);
+    for (auto* link : GetConnectors(current))
+      connectors.push_back(link);
+  }
+}
 
-/// Traverses nodes with connectors to find a cycle.
-/// Interrupts the detection at first cycle.
+/// Collection specialization for event tree named branches.
+template <>
+void CollectNodes(Branch* connector, std::vector<NamedBranch*>* nodes);
+
+/// Collection specialization for visitor-based traversal of instructions.
+template <>
+void CollectNodes(const Instruction* connector, std::vector<Rule*>* nodes);
+
+/// Collection specialization for visitor-based traversal of event-trees.
+template <>
+void CollectNodes(const EventTree* connector, std::vector<Link*>* nodes);
+
+/// Traverses nodes with connectors depth-first to find cycles.
+/// The traversal keeps its own stack instead of recursion,
+/// and every node and connection is visited only once (O(V + E)).
 /// Nodes get marked.
 ///
 /// The connector of the node is retrieved via unqualified call to
@@ -120,66 +143,103 @@ bool ContinueConnector(T* connector, std::vector<N*>* cycle);
 /// @tparam T  The type of nodes in the graph.
 ///
 /// @param[in,out] node  The node to start with.
-/// @param[out] cycle  If a cycle is detected,
-///                    it is given in reverse,
-///                    ending with the cycle node.
+/// @param[out] cycles  The detected cycles
+///                     (one per back connection in the traversal).
+///                     Each cycle is given in reverse,
+///                     starting and ending with the cycle node.
+/// @param[in] first_only  Interrupt the detection at first cycle.
 ///
 /// @returns True if a cycle is found.
 ///
 /// @post All traversed nodes are marked with non-clear marks.
 template <class T>
-bool DetectCycle(T* node, std::vector<T*>* cycle) {
-  if (!node->mark()) {
-    node->mark(NodeMark::kTemporary);
-    if (ContinueConnector(GetConnector(node), cycle)) {
-      if (cycle->size() == 1 || cycle->back() != cycle->front())
-        cycle->push_back(node);
-      return true;
+bool DetectCycles(T* node, std::vector<std::vector<T*>>* cycles,
+                  bool first_only = false) {
+  struct Frame {
+    T* node;  // The node on the traversal path.
+    std::size_t begin;  // The first successor of the node.
+    std::size_t next;  // The next successor to visit.
+  };
+  std::vector<Frame> path;
+  std::vector<T*> successors;  // The successors of the nodes on the path.
+  bool found = false;
+
+  // Returns true to interrupt the detection.
+  auto visit = [&](T* arg) {
+    if (!arg->mark()) {
+      arg->mark(NodeMark::kTemporary);
+      std::size_t begin = successors.size();
+      CollectNodes(GetConnector(arg), &successors);
+      path.push_back({arg, begin, begin});
+      return false;
     }
-    node->mark(NodeMark::kPermanent);
-  } else if (node->mark() == NodeMark::kTemporary) {
-    assert(cycle->empty() && "The report container must be provided empty.");
-    cycle->push_back(node);
-    return true;
-  }
-  assert(node->mark() == NodeMark::kPermanent);
-  return false;
-}
+    if (arg->mark() == NodeMark::kTemporary) {
+      assert(!path.empty() && "Unfinished detection from the same node.");
+      auto it = std::find_if(path.rbegin(), path.rend(),
+                             [arg](const Frame& frame) {
+                               return frame.node == arg;
+                             });
+      assert(it != path.rend() && "The node is not on the path.");
+      std::vector<T*> cycle = {arg};
+      std::transform(path.rbegin(), it, std::back_inserter(cycle),
+                     [](const Frame& frame) { return frame.node; });
+      cycle.push_back(arg);
+      cycles->push_back(std::move(cycle));
+      found = true;
+      return first_only;
+    }
+    assert(arg->mark() == NodeMark::kPermanent);
+    return false;
+  };
 
-template <class T, class N>
-bool ContinueConnector(T* connector, std::vector<N*>* cycle) {
-  for (N* node : GetNodes(connector)) {
-    if (DetectCycle(node, cycle))
-      return true;
-  }
-  for (auto* link : GetConnectors(connector)) {
-    if (ContinueConnector(link, cycle))
+  if (visit(node))
+    return true;
+  while (!path.empty()) {
+    Frame& frame = path.back();
+    if (frame.next == successors.size()) {
+      frame.node->mark(NodeMark::kPermanent);
+      successors.resize(frame.begin);
+      path.pop_back();
+    } else if (visit(successors[frame.next++])) {
       return true;
+    }
   }
-  return false;
+  return found;
 }
 
-/// Cycle detection specialization for event tree named branches.
-template <>
-bool ContinueConnector(Branch* connector, std::vector<NamedBranch*>* cycle);
-
-/// Cycle detection specialization for visitor-based traversal of instructions.
-template <>
-bool ContinueConnector(const Instruction* connector, std::vector<Rule*>* cycle);
-
-/// Cycle detection specialization for visitor-based traversal of event-trees.
-template <>
-bool ContinueConnector(const EventTree* connector, std::vector<Link*>* cycle);
+/// Traverses nodes with connectors to find a cycle.
+/// Interrupts the detection at first cycle.
+/// Nodes get marked.
+///
+/// @tparam T  The type of nodes in the graph.
+///
+/// @param[in,out] node  The node to start with.
+/// @param[out] cycle  If a cycle is detected,
+///                    it is given in reverse,
+///                    ending with the cycle node.
+///
+/// @returns True if a cycle is found.
+///
+/// @post All traversed nodes are marked with non-clear marks.
+template <class T>
+bool DetectCycle(T* node, std::vector<T*>* cycle) {
+  assert(cycle->empty() && "The report container must be provided empty.");
+  std::vector<std::vector<T*>> cycles;
+  if (!DetectCycles(node, &cycles, /*first_only=*/true))
+    return false;
+  *cycle = std::move(cycles.front());
+  return true;
+}
 
 /// Retrieves a unique name for a node.
 template <class T>
-const std::string& GetUniqueName(const T* node) {
+std::string_view GetUniqueName(const T* node) {
   return Id::unique_name(*node);
 }
 
 /// Specialization for event-tree link name retrieval.
 template <>
-inline const std::string& GetUniqueName(const Link* node) {
+inline std::string_view GetUniqueName(const Link* node) {
   return node->event_tree().name();
 }
 
@@ -195,14 +255,17 @@ template <class T>
 std::string PrintCycle(const std::vector<T*>& cycle) {
   assert(cycle.size() > 1);
   assert(cycle.front() == cycle.back() && "No cycle is provided.");
-  return boost::join(
-      boost::adaptors::reverse(cycle) |
-          boost::adaptors::transformed(
-              [](T* node) -> decltype(auto) { return GetUniqueName(node); }),
-      "->");
+  std::string path;
+  for (T* node : boost::adaptors::reverse(cycle)) {
+    if (!path.empty())
+      path += "->";
+    path += GetUniqueName(node);
+  }
+  return path;
 }
 
 /// Checks for cycles in a model constructs.
+/// All the cycles are reported at once.
 ///
 /// @tparam T  The type of the node.
 /// @tparam SinglePassRange  The range type with nodes.
@@ -210,16 +273,26 @@ std::string PrintCycle(const std::vector<T*>& cycle) {
 /// @param[in] container  The range with nodes to be tested.
 /// @param[in] type  The type of nodes for error messages.
 ///
-/// @throws CycleError  A cycle is detected in the graph of nodes.
+/// @throws CycleError  Cycles are detected in the graph of nodes.
 template <class T, class SinglePassRange>
 void CheckCycle(const SinglePassRange& container, const char* type) {
-  std::vector<T*> cycle;
+  std::vector<std::vector<T*>> cycles;
+  const T* origin = nullptr;  // The node leading to the first cycle.
   for (T& node : container) {
-    if (DetectCycle(&node, &cycle)) {
-      SCRAM_THROW(CycleError()) << errinfo_element(GetUniqueName(&node), type)
-                                << errinfo_cycle(PrintCycle(cycle));
-    }
+    if (DetectCycles(&node, &cycles) && !origin)
+      origin = &node;
+  }
+  if (!origin)
+    return;
+  std::string paths;
+  for (const std::vector<T*>& cycle : cycles) {
+    if (!paths.empty())
+      paths += ", ";
+    paths += PrintCycle(cycle);
   }
+  SCRAM_THROW(CycleError())
+      << errinfo_element(std::string(GetUniqueName(origin)), type)
+      << errinfo_cycle(std::move(paths));
 }
 
 }  // namespace scram::mef::cycle
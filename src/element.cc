@@ -22,20 +22,21 @@
 
 namespace scram::mef {
 
-Element::Element(std::string name) { Element::name(std::move(name)); }
+Element::Element(std::string_view name) { Element::name(name); }
 
-void Element::name(std::string name) {
+void Element::name(std::string_view name) {
   if (name.empty())
     SCRAM_THROW(LogicError("The element name cannot be empty"));
-  if (name.find('.') != std::string::npos)
+  if (name.find('.') != std::string_view::npos)
     SCRAM_THROW(ValidityError("The element name is malformed."));
-  name_ = std::move(name);
+  name_ = Symbol(name);
 }
 
 void Element::AddAttribute(Attribute attr) {
   if (attributes_.insert(std::move(attr)).second == false) {
     SCRAM_THROW(ValidityError("Duplicate attribute"))
-        << errinfo_element(name_, "element") << errinfo_attribute(attr.name());
+        << errinfo_element(std::string(name()), "element")
+        << errinfo_attribute(std::string(attr.name()));
   }
 }
 
@@ -64,24 +65,22 @@ Element::RemoveAttribute(std::string_view name) noexcept {
   return attr;
 }
 
-Role::Role(RoleSpecifier role, std::string base_path)
-    : kBasePath_(std::move(base_path)), kRole_(role) {
-  if (!kBasePath_.empty() &&
-      (kBasePath_.front() == '.' || kBasePath_.back() == '.')) {
+Role::Role(RoleSpecifier role, std::string_view base_path)
+    : kBasePath_(base_path), kRole_(role) {
+  if (!base_path.empty() &&
+      (base_path.front() == '.' || base_path.back() == '.')) {
     SCRAM_THROW(ValidityError("Element reference base path is malformed."));
   }
   if (kRole_ == RoleSpecifier::kPrivate && kBasePath_.empty())
     SCRAM_THROW(ValidityError("Elements cannot be private at model scope."));
 }
 
-Id::Id(std::string name, std::string base_path, RoleSpecifier role)
-    : Element(std::move(name)),
-      Role(role, std::move(base_path)),
-      full_path_(GetFullPath(this)) {}
+Id::Id(std::string_view name, std::string_view base_path, RoleSpecifier role)
+    : Element(name), Role(role, base_path), full_path_(GetFullPath(this)) {}
 
-void Id::id(std::string name) {
-  Element::name(std::move(name));
-  full_path_ = GetFullPath(this);
+void Id::id(std::string_view name) {
+  Element::name(name);
+  full_path_ = Symbol(GetFullPath(this));
 }
 
 }  // namespace scram::mef
@@ -40,6 +40,7 @@
 #include "error.h"
 #include "ext/linear_set.h"
 #include "ext/multi_index.h"
+#include "symbol.h"
 
 namespace scram::mef {
 
@@ -76,6 +77,8 @@ class ContainerElement {
 ///       The strings are not sanitized or normalized to be meaningful.
 ///       If not careful, it is possible to end-up with values
 ///       that XML schema validators won't accept (e.g., special chars).
+/// @note The attribute strings are interned
+///       since the same attributes tend to repeat over many elements.
 class Attribute {
  public:
   /// @param[in] name  The name for the attribute.
@@ -83,48 +86,49 @@ class Attribute {
   /// @param[in] type  The optional type of the attribute value.
   ///
   /// @throws LogicError  if any required values are empty.
-  Attribute(std::string name, std::string value, std::string type = "") {
-    Attribute::name(std::move(name));
-    Attribute::value(std::move(value));
-    Attribute::type(std::move(type));
+  Attribute(std::string_view name, std::string_view value,
+            std::string_view type = "") {
+    Attribute::name(name);
+    Attribute::value(value);
+    Attribute::type(type);
   }
 
   /// @returns The name of the attribute.
-  const std::string& name() const { return name_; }
+  std::string_view name() const { return name_.view(); }
 
   /// @param[in] name  The name for the attribute.
   ///
   /// @throws LogicError  The name is empty.
-  void name(std::string name) {
+  void name(std::string_view name) {
     if (name.empty())
       SCRAM_THROW(LogicError("Attribute name cannot be empty."));
-    name_ = std::move(name);
+    name_ = Symbol(name);
   }
 
   /// @returns The value of the attribute.
-  const std::string& value() const { return value_; }
+  std::string_view value() const { return value_.view(); }
 
   /// @param[in] value  The value for the attribute.
   ///
   /// @throws LogicError  The value is empty.
-  void value(std::string value) {
+  void value(std::string_view value) {
     if (value.empty())
       SCRAM_THROW(LogicError("Attribute value cannot be empty."));
-    value_ = std::move(value);
+    value_ = Symbol(value);
   }
 
   /// @returns The type of the attribute value.
   ///          Empty string if the type is not set.
-  const std::string& type() const { return type_; }
+  std::string_view type() const { return type_.view(); }
 
   /// @param[in] type  The value type.
   ///                  Empty string to remove the type.
-  void type(std::string type) { type_ = std::move(type); }
+  void type(std::string_view type) { type_ = Symbol(type); }
 
  private:
-  std::string name_;  ///< The name that identifies this attribute.
-  std::string value_;  ///< Value of this attribute.
-  std::string type_;  ///< Optional type of the attribute.
+  Symbol name_;  ///< The name that identifies this attribute.
+  Symbol value_;  ///< Value of this attribute.
+  Symbol type_;  ///< Optional type of the attribute.
 };
 
 /// The MEF Element
@@ -158,13 +162,13 @@ class Element : public ContainerElement, private boost::noncopyable {
   ///
   /// @throws LogicError  The name is required and empty.
   /// @throws ValidityError  The name is malformed.
-  explicit Element(std::string name);
+  explicit Element(std::string_view name);
 
   /// @returns The original name.
-  const std::string& name() const { return name_; }
+  std::string_view name() const { return name_.view(); }
 
-  /// @returns The string view to the name for table keys.
-  std::string_view name_view() const { return name_; }
+  /// @returns The interned name for table keys.
+  const Symbol& name_symbol() const { return name_; }
 
   /// @returns The empty or preset label.
   /// @returns Empty string if the label has not been set.
@@ -231,10 +235,10 @@ class Element : public ContainerElement, private boost::noncopyable {
   ///
   /// @throws LogicError  The name is required and empty.
   /// @throws ValidityError  The name is malformed.
-  void name(std::string name);
+  void name(std::string_view name);
 
  private:
-  std::string name_;  ///< The original name of the element.
+  Symbol name_;  ///< The original name of the element.
   std::string label_;  ///< The label text for the element.
 
   /// Element attributes ordered by insertion time.
@@ -251,9 +255,9 @@ class Element : public ContainerElement, private boost::noncopyable {
 template <typename T>
 using ElementTable = boost::multi_index_container<
     T, boost::multi_index::indexed_by<boost::multi_index::hashed_unique<
-           boost::multi_index::const_mem_fun<Element, std::string_view,
-                                             &Element::name_view>,
-           std::hash<std::string_view>>>>;
+           boost::multi_index::const_mem_fun<Element, const Symbol&,
+                                             &Element::name_symbol>,
+           SymbolHash, SymbolEqual>>>;
 
 /// Role, access attributes for elements.
 enum class RoleSpecifier : std::uint8_t { kPublic, kPrivate };
@@ -274,19 +278,19 @@ class Role {
   /// @throws ValidityError  The base path string is malformed.
   /// @throws ValidityError  Private element at model/global scope.
   explicit Role(RoleSpecifier role = RoleSpecifier::kPublic,
-                std::string base_path = "");
+                std::string_view base_path = "");
 
   /// @returns The assigned role of the element.
   RoleSpecifier role() const { return kRole_; }
 
   /// @returns The base path containing ancestor container names.
-  const std::string& base_path() const { return kBasePath_; }
+  std::string_view base_path() const { return kBasePath_.view(); }
 
  protected:
   ~Role() = default;
 
  private:
-  const std::string kBasePath_;  ///< A series of ancestor containers.
+  const Symbol kBasePath_;  ///< A series of ancestor containers.
   const RoleSpecifier kRole_;  ///< The role of the element.
 };
 
@@ -299,7 +303,10 @@ class Role {
 /// @returns A string representation of the full path.
 template <typename T>
 std::string GetFullPath(const T* element) {
-  return element->base_path() + "." + element->name();
+  std::string full_path(element->base_path());
+  full_path += '.';
+  full_path += element->name();
+  return full_path;
 }
 
 /// Mixin class for assigning unique identifiers to elements.
@@ -311,20 +318,20 @@ class Id : public Element, public Role {
   /// Mangles the element name into a unique id.
   /// Private elements get their full path as their ids,
   /// while public elements retain their name as ids.
-  explicit Id(std::string name, std::string base_path = "",
+  explicit Id(std::string_view name, std::string_view base_path = "",
               RoleSpecifier role = RoleSpecifier::kPublic);
 
   /// @returns The unique id that is set upon the construction of this element.
-  const std::string& id() const {
-    return Role::role() == RoleSpecifier::kPublic ? Element::name()
+  std::string_view id() const { return id_symbol().view(); }
+
+  /// @returns The interned id to be used as a table key.
+  const Symbol& id_symbol() const {
+    return Role::role() == RoleSpecifier::kPublic ? Element::name_symbol()
                                                   : full_path_;
   }
 
-  /// @returns The string view to the id to be used as a table key.
-  std::string_view id_view() const { return id(); }
-
-  /// @returns The string view to the unique full path for a table key.
-  std::string_view full_path() const { return full_path_; }
+  /// @returns The interned unique full path for a table key.
+  const Symbol& full_path() const { return full_path_; }
 
   /// Resets the element ID.
   ///
@@ -334,14 +341,14 @@ class Id : public Element, public Role {
   ///
   /// @throws LogicError  The name is empty.
   /// @throws ValidityError  The name is malformed.
-  void id(std::string name);
+  void id(std::string_view name);
 
   /// Produces unique name for the model element within the same type.
   /// @{
-  static const std::string& unique_name(const Element& element) {
+  static std::string_view unique_name(const Element& element) {
     return element.name();
   }
-  static const std::string& unique_name(const Id& element) {
+  static std::string_view unique_name(const Id& element) {
     return element.id();
   }
   /// @}
@@ -350,7 +357,7 @@ class Id : public Element, public Role {
   ~Id() = default;
 
  private:
-  std::string full_path_;  ///< Unique for all elements per certain type.
+  Symbol full_path_;  ///< Unique for all elements per certain type.
 };
 
 /// Table of elements with unique ids.
@@ -363,8 +370,8 @@ template <typename T>
 using IdTable = boost::multi_index_container<
     T,
     boost::multi_index::indexed_by<boost::multi_index::hashed_unique<
-        boost::multi_index::const_mem_fun<Id, std::string_view, &Id::id_view>,
-        std::hash<std::string_view>>>>;
+        boost::multi_index::const_mem_fun<Id, const Symbol&, &Id::id_symbol>,
+        SymbolHash, SymbolEqual>>>;
 
 /// Wraps the element container tables into ranges of plain references
 /// to hide the memory smart or raw pointers.
@@ -376,11 +383,8 @@ using IdTable = boost::multi_index_container<
 /// @tparam T  Const or non-const associative container type.
 template <class T>
 class TableRange {
-  /// Types inferred from the container.
-  /// @{
+  /// The element type inferred from the container.
   using deref_type = std::decay_t<decltype(*typename T::value_type(nullptr))>;
-  using key_type = typename T::key_type;
-  /// @}
 
  public:
   /// Value typedefs of the range.
@@ -420,11 +424,19 @@ class TableRange {
   explicit TableRange(T& table) : table_(table) {}
 
   /// The proxy members for the common functionality of the associative table T.
+  /// The lookup keys may be of any type compatible with the table keys,
+  /// e.g., the strings for the interned symbols.
   /// @{
   bool empty() const { return table_.empty(); }
   std::size_t size() const { return table_.size(); }
-  std::size_t count(const key_type& key) const { return table_.count(key); }
-  iterator find(const key_type& key) const { return table_.find(key); }
+  template <typename Key>
+  std::size_t count(const Key& key) const {
+    return table_.count(key);
+  }
+  template <typename Key>
+  iterator find(const Key& key) const {
+    return table_.find(key);
+  }
   iterator begin() const { return table_.begin(); }
   iterator end() const { return table_.end(); }
   iterator cbegin() const { return table_.begin(); }
@@ -469,17 +481,18 @@ class Container {
   ///
   /// @throws UndefinedElement  The element is not found.
   /// @{
-  const T& Get(const key_type& id) const {
+  const T& Get(std::string_view id) const {
     auto it = table_.find(id);
     if (it != table_.end())
       return **it;
 
     SCRAM_THROW(UndefinedElement())
         << errinfo_element(std::string(id), T::kTypeString)
-        << errinfo_container(Id::unique_name(static_cast<const Self&>(*this)),
-                             Self::kTypeString);
+        << errinfo_container(
+               std::string(Id::unique_name(static_cast<const Self&>(*this))),
+               Self::kTypeString);
   }
-  T& Get(const key_type& id) {
+  T& Get(std::string_view id) {
     return const_cast<T&>(std::as_const(*this).Get(id));
   }
   /// @}
@@ -494,9 +507,11 @@ class Container {
     T& stable_ref = *element;  // The pointer will be moved later.
     if (table_.insert(std::move(element)).second == false) {
       SCRAM_THROW(DuplicateElementError())
-          << errinfo_element(Id::unique_name(stable_ref), T::kTypeString)
-          << errinfo_container(Id::unique_name(static_cast<Self&>(*this)),
-                               Self::kTypeString);
+          << errinfo_element(std::string(Id::unique_name(stable_ref)),
+                             T::kTypeString)
+          << errinfo_container(
+                 std::string(Id::unique_name(static_cast<Self&>(*this))),
+                 Self::kTypeString);
     }
     stable_ref.container(static_cast<const Self*>(this));
   }
@@ -510,11 +525,11 @@ class Container {
   /// @throws UndefinedElement  The element cannot be found in the container.
   /// @throws LogicError  The element in the container is not the same object.
   Pointer Remove(T* element) {
-    const std::string& key = [element]() -> decltype(auto) {
+    const Symbol& key = [element]() -> const Symbol& {
       if constexpr (ById) {
-        return element->id();
+        return element->id_symbol();
       } else {
-        return element->name();
+        return element->name_symbol();
       }
     }();
 
@@ -527,9 +542,11 @@ class Container {
         SCRAM_THROW(LogicError("Duplicate element with different address."));
 
     } catch (Error& err) {
-      err << errinfo_element(Id::unique_name(*element), T::kTypeString)
-          << errinfo_container(Id::unique_name(static_cast<const Self&>(*this)),
-                               Self::kTypeString);
+      err << errinfo_element(std::string(Id::unique_name(*element)),
+                             T::kTypeString)
+          << errinfo_container(
+                 std::string(Id::unique_name(static_cast<const Self&>(*this))),
+                 Self::kTypeString);
       throw;
     }
     element->container(nullptr);
@@ -613,12 +630,12 @@ class Composite : public Ts... {
   /// @{
   template <class T,
             class ContainerType = typename detail::container_of<T, Ts...>::type>
-  const T& Get(const typename ContainerType::key_type& id) const {
+  const T& Get(std::string_view id) const {
     return ContainerType::Get(id);
   }
   template <class T,
             class ContainerType = typename detail::container_of<T, Ts...>::type>
-  T& Get(const typename ContainerType::key_type& id) {
+  T& Get(std::string_view id) {
     return ContainerType::Get(id);
   }
   /// @}
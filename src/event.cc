@@ -32,6 +32,8 @@ namespace scram::mef {
 
 Event::~Event() = default;
 
+thread_local HouseEvent::Overlay* HouseEvent::current_ = nullptr;
+
 HouseEvent HouseEvent::kTrue = []() {
   HouseEvent house_event("__true__");
   house_event.state(true);
@@ -44,7 +46,7 @@ void BasicEvent::Validate() const {
   try {
     EnsureProbability(expression_);
   } catch (DomainError& err) {
-    err << errinfo_element(Event::name(), kTypeString);
+    err << errinfo_element(std::string(Event::name()), kTypeString);
     throw;
   }
 }
@@ -55,7 +57,7 @@ void Formula::ArgSet::Add(ArgEvent event, bool complement) {
         return ext::as<Event*>(arg.event)->id() == base->id();
       })) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(base->id(), "event");
+        << errinfo_element(std::string(base->id()), "event");
   }
   args_.push_back({complement, event});
   if (!base->usage())
@@ -114,7 +116,7 @@ void Formula::Swap(ArgEvent current, ArgEvent other) {
                ext::as<Event*>(arg.event)->id() == base->id();
       })) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(base->id(), "event");
+        << errinfo_element(std::string(base->id()), "event");
   }
 
   ValidateNesting({it->complement, other});
@@ -30,6 +30,8 @@
 #include <variant>
 #include <vector>
 
+#include <boost/noncopyable.hpp>
+
 #include "element.h"
 #include "expression.h"
 
@@ -55,6 +57,30 @@ class HouseEvent : public Event {
   static HouseEvent kTrue;  ///< Literal True event.
   static HouseEvent kFalse;  ///< Literal False event.
 
+  /// Overrides the states of house events for the calling thread only.
+  /// Analyses of alignment phases can run concurrently
+  /// without changing the model observed by other threads.
+  ///
+  /// @note Overlays must be destroyed in the reverse order of construction.
+  class Overlay : private boost::noncopyable {
+   public:
+    /// @param[in] states  The house events and their states in effect
+    ///                    in the calling thread.
+    explicit Overlay(std::vector<std::pair<const HouseEvent*, bool>> states)
+        : states_(std::move(states)), previous_(current_) {
+      current_ = this;
+    }
+
+    ~Overlay() noexcept { current_ = previous_; }
+
+   private:
+    friend class HouseEvent;
+
+    /// The overridden house events with their states.
+    std::vector<std::pair<const HouseEvent*, bool>> states_;
+    Overlay* previous_;  ///< The enclosing overlay of the thread.
+  };
+
   using Event::Event;
 
   HouseEvent(HouseEvent&&);  ///< For the (N)RVO only (undefined!).
@@ -64,10 +90,22 @@ class HouseEvent : public Event {
   /// @param[in] constant  False or True for the state of this house event.
   void state(bool constant) { state_ = constant; }
 
-  /// @returns The true or false state of this house event.
-  bool state() const { return state_; }
+  /// @returns The true or false state of this house event
+  ///          in effect in the calling thread.
+  bool state() const {
+    for (const Overlay* overlay = current_; overlay;
+         overlay = overlay->previous_) {
+      for (const std::pair<const HouseEvent*, bool>& entry : overlay->states_) {
+        if (entry.first == this)
+          return entry.second;
+      }
+    }
+    return state_;
+  }
 
  private:
+  static thread_local Overlay* current_;  ///< The innermost overlay.
+
   /// Represents the state of the house event.
   /// Implies On or Off for True or False values of the probability.
   bool state_ = false;
@@ -44,7 +44,8 @@ Fork::Fork(const FunctionalEvent& functional_event, std::vector<Path> paths)
     if (it_find != paths_.end())
       SCRAM_THROW(ValidityError("Duplicate state path in a fork"))
           << errinfo_value(it->state())
-          << errinfo_element(functional_event_.name(), "functional event");
+          << errinfo_element(std::string(functional_event_.name()),
+                             "functional event");
   }
 }
 
@@ -19,6 +19,9 @@
 
 #include "event_tree_analysis.h"
 
+#include <algorithm>
+#include <map>
+
 #include "expression/numerical.h"
 #include "ext/find_iterator.h"
 #include "instruction.h"
@@ -34,56 +37,123 @@ EventTreeAnalysis::EventTreeAnalysis(
 
 namespace {  // The model cloning functions.
 
-/// Clones the formula by applying the set-instructions.
-///
-/// @param[in] formula  The formula to be deep-cloned.
-/// @param[in] set_instructions  The set instructions to change arguments.
-/// @param[in] clones  The storage container for newly created clones.
+/// Clones formulas by applying the set-instructions.
 ///
-/// @returns The deep-copy of the argument formula with new (changed) arguments.
-std::unique_ptr<mef::Formula>
-Clone(const mef::Formula& formula,
-      const std::unordered_map<std::string, bool>& set_instructions,
-      std::vector<std::unique_ptr<mef::Event>>* clones) noexcept {
-  struct {
-    mef::Formula::ArgEvent operator()(mef::BasicEvent* arg) { return arg; }
-    mef::Formula::ArgEvent operator()(mef::HouseEvent* arg) {
-      if (auto it = ext::find(set_house, arg->id())) {
-        if (it->second == arg->state())
-          return arg;
-        auto clone = std::make_unique<mef::HouseEvent>(
-            arg->name(), "__clone__." + arg->id(),
-            mef::RoleSpecifier::kPrivate);
-        clone->state(it->second);
-        auto* ptr = clone.get();
-        event_register->emplace_back(std::move(clone));
-        return ptr;
-      }
-      return arg;
+/// Only the gates with affected house events in their sub-graphs get cloned,
+/// and the clones are shared by all the paths and sequences
+/// with the same effective house event states.
+class Cloner {
+ public:
+  /// @param[in] clones  The storage container for newly created clones.
+  explicit Cloner(std::vector<std::unique_ptr<mef::Event>>* clones)
+      : clones_(*clones) {}
+
+  /// @param[in] formula  The formula to be cloned.
+  /// @param[in] set_instructions  The set instructions to change arguments.
+  ///
+  /// @returns The copy of the argument formula with new (changed) arguments.
+  std::unique_ptr<mef::Formula>
+  Clone(const mef::Formula& formula,
+        const std::unordered_map<std::string, bool>& set_instructions) noexcept {
+    mef::Formula::ArgSet arg_set;
+    for (const mef::Formula::Arg& arg : formula.args()) {
+      arg_set.Add(std::visit(
+                      [this, &set_instructions](auto* event) {
+                        return CloneArg(event, set_instructions);
+                      },
+                      arg.event),
+                  arg.complement);
     }
-    mef::Formula::ArgEvent operator()(mef::Gate* arg) {
-      if (set_house.empty())
-        return arg;
-      auto clone = std::make_unique<mef::Gate>(
-          arg->name(), "__clone__." + arg->id(), mef::RoleSpecifier::kPrivate);
-      clone->formula(Clone(arg->formula(), set_house, event_register));
-      auto* ptr = clone.get();
-      event_register->emplace_back(std::move(clone));
-      return ptr;
+    return std::make_unique<mef::Formula>(
+        formula.connective(), std::move(arg_set), formula.min_number(),
+        formula.max_number());
+  }
+
+ private:
+  /// House events sorted by their addresses.
+  using HouseEventSet = std::vector<const mef::HouseEvent*>;
+
+  /// @returns The argument as-is since basic events are not affected.
+  mef::Formula::ArgEvent
+  CloneArg(mef::BasicEvent* event,
+           const std::unordered_map<std::string, bool>& /*set_instructions*/) {
+    return event;
+  }
+
+  /// @returns The house event with the state of the set-instructions.
+  mef::Formula::ArgEvent
+  CloneArg(mef::HouseEvent* event,
+           const std::unordered_map<std::string, bool>& set_instructions) {
+    auto it = ext::find(set_instructions, std::string(event->id()));
+    if (!it || it->second == event->state())
+      return event;
+    mef::HouseEvent*& clone = house_clones_[event];
+    if (!clone) {
+      auto house_event = std::make_unique<mef::HouseEvent>(
+          event->name(), "__clone__." + std::string(event->id()),
+          mef::RoleSpecifier::kPrivate);
+      house_event->state(it->second);
+      clone = house_event.get();
+      clones_.emplace_back(std::move(house_event));
     }
+    return clone;
+  }
 
-    const std::unordered_map<std::string, bool>& set_house;
-    std::vector<std::unique_ptr<mef::Event>>* event_register;
-  } cloner{set_instructions, clones};
+  /// @returns The gate or its shared clone
+  ///          if any house event in its sub-graph changes the state.
+  mef::Formula::ArgEvent
+  CloneArg(mef::Gate* gate,
+           const std::unordered_map<std::string, bool>& set_instructions) {
+    if (set_instructions.empty())
+      return gate;
+    std::pair<const mef::Gate*, HouseEventSet> key{gate, {}};
+    for (const mef::HouseEvent* house_event : house_events(*gate)) {
+      auto it = ext::find(set_instructions, std::string(house_event->id()));
+      if (it && it->second != house_event->state())
+        key.second.push_back(house_event);
+    }
+    if (key.second.empty())
+      return gate;
+    if (auto it = ext::find(gate_clones_, key))
+      return it->second;
+    auto clone = std::make_unique<mef::Gate>(gate->name(),
+                                             "__clone__." +
+                                                 std::string(gate->id()),
+                                             mef::RoleSpecifier::kPrivate);
+    clone->formula(Clone(gate->formula(), set_instructions));
+    auto* ptr = clone.get();
+    clones_.emplace_back(std::move(clone));
+    gate_clones_.emplace(std::move(key), ptr);
+    return ptr;
+  }
 
-  mef::Formula::ArgSet arg_set;
-  for (const mef::Formula::Arg& arg : formula.args())
-    arg_set.Add(std::visit(cloner, arg.event), arg.complement);
+  /// @returns The house events in the sub-graph of the gate.
+  const HouseEventSet& house_events(const mef::Gate& gate) noexcept {
+    if (auto it = ext::find(house_events_, &gate))
+      return it->second;
+    HouseEventSet result;
+    for (const mef::Formula::Arg& arg : gate.formula().args()) {
+      if (auto* house_event = std::get_if<mef::HouseEvent*>(&arg.event)) {
+        result.push_back(*house_event);
+      } else if (auto* arg_gate = std::get_if<mef::Gate*>(&arg.event)) {
+        const HouseEventSet& sub_result = house_events(**arg_gate);
+        result.insert(result.end(), sub_result.begin(), sub_result.end());
+      }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return house_events_.emplace(&gate, std::move(result)).first->second;
+  }
 
-  return std::make_unique<mef::Formula>(
-      formula.connective(), std::move(arg_set), formula.min_number(),
-      formula.max_number());
-}
+  std::vector<std::unique_ptr<mef::Event>>& clones_;  ///< The clone storage.
+  /// The memoized house events of the original gates.
+  std::unordered_map<const mef::Gate*, HouseEventSet> house_events_;
+  /// The clones of house events with the flipped state.
+  std::unordered_map<const mef::HouseEvent*, mef::HouseEvent*> house_clones_;
+  /// The clones of gates with the changed house events in their sub-graphs.
+  std::map<std::pair<const mef::Gate*, HouseEventSet>, mef::Gate*>
+      gate_clones_;
+};
 
 }  // namespace
 
@@ -98,8 +168,8 @@ void EventTreeAnalysis::Analyze() noexcept {
   int formula_id = 0;  // Enumeration of collected formulas turned into gates.
   // Creates an internal gate representing the formula.
   auto make_gate = [&formula_id, this](mef::FormulaPtr formula) {
-    std::string gate_name = "___" + initiating_event_.name() + "__formula_" +
-                            std::to_string(formula_id++) + "__";
+    std::string gate_name = "___" + std::string(initiating_event_.name()) +
+                            "__formula_" + std::to_string(formula_id++) + "__";
     auto gate = std::make_unique<mef::Gate>(gate_name);
     gate->formula(std::move(formula));
     auto* address = gate.get();
@@ -110,7 +180,8 @@ void EventTreeAnalysis::Analyze() noexcept {
   SequenceCollector collector{initiating_event_, *context_};
   CollectSequences(initiating_event_.event_tree()->initial_state(), &collector);
   for (auto& sequence : collector.sequences) {
-    auto gate = std::make_unique<mef::Gate>("__" + sequence.first->name());
+    auto gate =
+        std::make_unique<mef::Gate>("__" + std::string(sequence.first->name()));
     std::vector<mef::FormulaPtr> gate_formulas;
     std::vector<mef::Expression*> arg_expressions;
     for (PathCollector& path_collector : sequence.second) {
@@ -144,8 +215,8 @@ void EventTreeAnalysis::Analyze() noexcept {
       gate->formula(
           std::make_unique<mef::Formula>(mef::kOr, std::move(arg_set)));
     } else if (!arg_expressions.empty()) {
-      auto event =
-          std::make_unique<mef::BasicEvent>("__" + sequence.first->name());
+      auto event = std::make_unique<mef::BasicEvent>(
+          "__" + std::string(sequence.first->name()));
       if (arg_expressions.size() == 1) {
         event->expression(arg_expressions.front());
       } else if (arg_expressions.size() > 1) {
@@ -186,12 +257,10 @@ void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
       }
 
       void Visit(const mef::CollectFormula* collect_formula) override {
-        // clang-format off
         collector_.path_collector_.formulas.push_back(
-            core::Clone(collect_formula->formula(),
-                        collector_.path_collector_.set_instructions,
-                        collector_.clones_));
-        // clang-format on
+            collector_.cloner_->Clone(
+                collect_formula->formula(),
+                collector_.path_collector_.set_instructions));
       }
 
       void Visit(const mef::CollectExpression* collect_expression) override {
@@ -215,7 +284,7 @@ void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
     }
 
     void operator()(const mef::Fork* fork) const {
-      const std::string& name = fork->functional_event().name();
+      std::string name(fork->functional_event().name());
       assert(result_->context.functional_events.count(name) == false);
       std::string& state = result_->context.functional_events[name];
       assert(state.empty());
@@ -237,12 +306,13 @@ void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
     }
 
     SequenceCollector* result_;
-    std::vector<std::unique_ptr<mef::Event>>* clones_;
+    Cloner* cloner_;
     PathCollector path_collector_;
   };
   context_->functional_events.clear();
   context_->initiating_event = initiating_event_.name();
-  Collector{result, &events_}(&initial_state);  // NOLINT(whitespace/braces)
+  Cloner cloner(&events_);
+  Collector{result, &cloner}(&initial_state);  // NOLINT(whitespace/braces)
 }
 
 }  // namespace scram::core
@@ -31,7 +31,17 @@ namespace scram::mef {
 Expression::Expression(std::vector<Expression*> args)
     : args_(std::move(args)), sampled_value_(0), sampled_(false) {}
 
+thread_local Expression::SampleContext* Expression::SampleContext::current_ =
+    nullptr;
+
 double Expression::Sample() noexcept {
+  if (SampleContext* context = SampleContext::current_) {
+    if (auto it = context->samples_.find(this); it != context->samples_.end())
+      return it->second;
+    double value = this->DoSample();
+    context->samples_.emplace(this, value);
+    return value;
+  }
   if (!sampled_) {
     sampled_ = true;
     sampled_value_ = this->DoSample();
@@ -40,9 +50,14 @@ double Expression::Sample() noexcept {
 }
 
 void Expression::Reset() noexcept {
-  if (!sampled_)
+  if (SampleContext* context = SampleContext::current_) {
+    if (!context->samples_.erase(this))
+      return;
+  } else if (!sampled_) {
     return;
-  sampled_ = false;
+  } else {
+    sampled_ = false;
+  }
   for (Expression* arg : args_)
     arg->Reset();
 }
@@ -61,6 +76,19 @@ void EnsureMultivariateArgs(std::vector<Expression*> args) {
 
 }  // namespace detail
 
+bool DependsOn(Expression* expression, const Expression& target,
+               std::unordered_map<const Expression*, bool>* memo) noexcept {
+  if (expression == &target)
+    return true;
+  if (auto it = memo->find(expression); it != memo->end())
+    return it->second;
+  bool result = ext::any_of(expression->args(), [&target, memo](Expression* arg) {
+    return DependsOn(arg, target, memo);
+  });
+  memo->emplace(expression, result);
+  return result;
+}
+
 namespace {  // Interval to string.
 
 /// Converts an interval into a string.
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <algorithm>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -65,6 +66,27 @@ inline bool IsPositive(const Interval& interval) {
 /// after validation phases.
 class Expression : private boost::noncopyable {
  public:
+  /// The storage of expression samples private to a sampling thread.
+  /// While the context is alive,
+  /// the samples of the thread are kept in the context
+  /// instead of the expressions,
+  /// so concurrent simulations may sample the shared expressions.
+  class SampleContext : private boost::noncopyable {
+   public:
+    /// Activates the context on the current thread.
+    SampleContext() noexcept : previous_(current_) { current_ = this; }
+
+    /// Restores the previous context of the thread.
+    ~SampleContext() noexcept { current_ = previous_; }
+
+   private:
+    friend class Expression;  // Stores the samples.
+
+    static thread_local SampleContext* current_;  ///< The active context.
+    SampleContext* previous_;  ///< The context to restore.
+    std::unordered_map<const Expression*, double> samples_;  ///< The samples.
+  };
+
   /// Constructor for use by derived classes
   /// to register their arguments.
   ///
@@ -105,7 +127,26 @@ class Expression : private boost::noncopyable {
   ///          may yield silent failure.
   virtual bool IsDeviate() noexcept;
 
+  /// Evaluates the expression over a grid of time values in one call.
+  /// Closed-form expressions of time override this function
+  /// to avoid re-evaluation of the whole argument graph per time point.
+  ///
+  /// @param[in] time  The argument expression to be treated as the time.
+  /// @param[in] grid  The time values.
+  /// @param[out] values  The expression values at the grid points.
+  ///
+  /// @returns false if the expression doesn't provide grid evaluation
+  ///          or the time is not its direct argument.
+  ///
+  /// @pre The other arguments do not depend on the time.
+  virtual bool ValuesOverTime(const Expression& /*time*/,
+                              const std::vector<double>& /*grid*/,
+                              std::vector<double>* /*values*/) noexcept {
+    return false;
+  }
+
   /// @returns A sampled value of this expression.
+  ///          The sample is kept in the active context of the thread if any.
   double Sample() noexcept;
 
   /// This routine resets the sampling to get new values.
@@ -278,6 +319,18 @@ class NaryExpression<T, -1> : public ExpressionFormula<NaryExpression<T, -1>> {
   }
 };
 
+/// Determines if an expression depends on another expression
+/// directly or through its arguments.
+///
+/// @param[in] expression  The expression to be checked.
+/// @param[in] target  The expression of interest, e.g., the mission time.
+/// @param[in,out] memo  The results for already visited expressions.
+///                      The memo must only be shared for the same target.
+///
+/// @returns true if the value of the expression changes with the target.
+bool DependsOn(Expression* expression, const Expression& target,
+               std::unordered_map<const Expression*, bool>* memo) noexcept;
+
 /// Ensures that expression can be used for probability ([0, 1]).
 ///
 /// @param[in] expression  The expression to be validated.
@@ -70,6 +70,18 @@ double Exponential::Compute(double lambda, double time) noexcept {
   return p_exp(lambda, time);
 }
 
+bool Exponential::ValuesOverTime(const Expression& time,
+                                 const std::vector<double>& grid,
+                                 std::vector<double>* values) noexcept {
+  if (&time_ != &time)
+    return false;
+  double lambda = lambda_.value();
+  values->resize(grid.size());
+  for (int i = 0; i < grid.size(); ++i)
+    (*values)[i] = p_exp(lambda, grid[i]);
+  return true;
+}
+
 Glm::Glm(Expression* gamma, Expression* lambda, Expression* mu, Expression* t)
     : ExpressionFormula({gamma, lambda, mu, t}),
       gamma_(*gamma),
@@ -90,6 +102,21 @@ double Glm::Compute(double gamma, double lambda, double mu,
   return (lambda - (lambda - gamma * r) * std::exp(-r * time)) / r;
 }
 
+bool Glm::ValuesOverTime(const Expression& time,
+                         const std::vector<double>& grid,
+                         std::vector<double>* values) noexcept {
+  if (&time_ != &time)
+    return false;
+  double gamma = gamma_.value();
+  double lambda = lambda_.value();
+  double r = lambda + mu_.value();
+  double scale = lambda - gamma * r;
+  values->resize(grid.size());
+  for (int i = 0; i < grid.size(); ++i)
+    (*values)[i] = (lambda - scale * std::exp(-r * grid[i])) / r;
+  return true;
+}
+
 Weibull::Weibull(Expression* alpha, Expression* beta, Expression* t0,
                  Expression* time)
     : ExpressionFormula({alpha, beta, t0, time}),
@@ -110,6 +137,20 @@ double Weibull::Compute(double alpha, double beta, double t0,
   return time <= t0 ? 0 : 1 - std::exp(-std::pow((time - t0) / alpha, beta));
 }
 
+bool Weibull::ValuesOverTime(const Expression& time,
+                             const std::vector<double>& grid,
+                             std::vector<double>* values) noexcept {
+  if (&time_ != &time)
+    return false;
+  double alpha = alpha_.value();
+  double beta = beta_.value();
+  double t0 = t0_.value();
+  values->resize(grid.size());
+  for (int i = 0; i < grid.size(); ++i)
+    (*values)[i] = Compute(alpha, beta, t0, grid[i]);
+  return true;
+}
+
 PeriodicTest::PeriodicTest(Expression* lambda, Expression* tau,
                            Expression* theta, Expression* time)
     : Expression({lambda, tau, theta, time}),
@@ -131,6 +172,15 @@ PeriodicTest::PeriodicTest(Expression* lambda, Expression* lambda_test,
           lambda, lambda_test, mu, tau, theta, gamma, test_duration,
           available_at_test, sigma, omega, time)) {}
 
+bool PeriodicTest::ValuesOverTime(const Expression& time,
+                                  const std::vector<double>& grid,
+                                  std::vector<double>* values) noexcept {
+  if (&flavor_->time() != &time)
+    return false;
+  flavor_->ValuesOverTime(grid, values);
+  return true;
+}
+
 void PeriodicTest::InstantRepair::Validate() const {
   EnsurePositive(&lambda_, "rate of failure");
   EnsurePositive(&tau_, "time between tests");
@@ -178,6 +228,16 @@ double PeriodicTest::InstantRepair::Sample() noexcept {
                  time_.Sample());
 }
 
+void PeriodicTest::InstantRepair::ValuesOverTime(
+    const std::vector<double>& grid, std::vector<double>* values) noexcept {
+  double lambda = lambda_.value();
+  double tau = tau_.value();
+  double theta = theta_.value();
+  values->resize(grid.size());
+  for (int i = 0; i < grid.size(); ++i)
+    (*values)[i] = Compute(lambda, tau, theta, grid[i]);
+}
+
 double PeriodicTest::InstantTest::Compute(double lambda, double mu, double tau,
                                           double theta, double time) noexcept {
   if (time <= theta)  // No test has been performed.
@@ -216,6 +276,17 @@ double PeriodicTest::InstantTest::Sample() noexcept {
                  time_.Sample());
 }
 
+void PeriodicTest::InstantTest::ValuesOverTime(
+    const std::vector<double>& grid, std::vector<double>* values) noexcept {
+  double lambda = lambda_.value();
+  double mu = mu_.value();
+  double tau = tau_.value();
+  double theta = theta_.value();
+  values->resize(grid.size());
+  for (int i = 0; i < grid.size(); ++i)
+    (*values)[i] = Compute(lambda, mu, tau, theta, grid[i]);
+}
+
 double PeriodicTest::Complete::Compute(double lambda, double lambda_test,
                                        double mu, double tau, double theta,
                                        double gamma, double test_duration,
@@ -303,4 +374,24 @@ double PeriodicTest::Complete::Sample() noexcept {
                  sigma_.Sample(), omega_.Sample(), time_.Sample());
 }
 
+void PeriodicTest::Complete::ValuesOverTime(
+    const std::vector<double>& grid, std::vector<double>* values) noexcept {
+  double lambda = lambda_.value();
+  double lambda_test = lambda_test_.value();
+  double mu = mu_.value();
+  double tau = tau_.value();
+  double theta = theta_.value();
+  double gamma = gamma_.value();
+  double test_duration = test_duration_.value();
+  bool available_at_test = available_at_test_.value();
+  double sigma = sigma_.value();
+  double omega = omega_.value();
+  values->resize(grid.size());
+  for (int i = 0; i < grid.size(); ++i) {
+    (*values)[i] =
+        Compute(lambda, lambda_test, mu, tau, theta, gamma, test_duration,
+                available_at_test, sigma, omega, grid[i]);
+  }
+}
+
 }  // namespace scram::mef
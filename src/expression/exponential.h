@@ -22,6 +22,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "src/expression.h"
 
@@ -50,6 +51,9 @@ class Exponential : public ExpressionFormula<Exponential> {
   double Compute(double lambda, double time) noexcept;
   /// @}
 
+  bool ValuesOverTime(const Expression& time, const std::vector<double>& grid,
+                      std::vector<double>* values) noexcept override;
+
  private:
   Expression& lambda_;  ///< Failure rate in hours.
   Expression& time_;  ///< Mission time in hours.
@@ -79,6 +83,9 @@ class Glm : public ExpressionFormula<Glm> {
   double Compute(double gamma, double lambda, double mu, double time) noexcept;
   /// @}
 
+  bool ValuesOverTime(const Expression& time, const std::vector<double>& grid,
+                      std::vector<double>* values) noexcept override;
+
  private:
   Expression& gamma_;  ///< Probability of failure on demand.
   Expression& lambda_;  ///< Failure rate in hours.
@@ -110,6 +117,9 @@ class Weibull : public ExpressionFormula<Weibull> {
   double Compute(double alpha, double beta, double t0, double time) noexcept;
   /// @}
 
+  bool ValuesOverTime(const Expression& time, const std::vector<double>& grid,
+                      std::vector<double>* values) noexcept override;
+
  private:
   Expression& alpha_;  ///< Scale parameter.
   Expression& beta_;  ///< Shape parameter.
@@ -156,6 +166,9 @@ class PeriodicTest : public Expression {
   double value() noexcept override { return flavor_->value(); }
   Interval interval() noexcept override { return Interval::closed(0, 1); }
 
+  bool ValuesOverTime(const Expression& time, const std::vector<double>& grid,
+                      std::vector<double>* values) noexcept override;
+
  private:
   double DoSample() noexcept override { return flavor_->Sample(); }
 
@@ -168,6 +181,15 @@ class PeriodicTest : public Expression {
     virtual double value() noexcept = 0;
     /// @copydoc Expression::Sample
     virtual double Sample() noexcept = 0;
+    /// @returns The time argument expression.
+    virtual const Expression& time() const = 0;
+    /// Computes the expression values over the time grid
+    /// with the mean values of the other arguments.
+    ///
+    /// @param[in] grid  The time values.
+    /// @param[out] values  The expression values at the grid points.
+    virtual void ValuesOverTime(const std::vector<double>& grid,
+                                std::vector<double>* values) noexcept = 0;
   };
 
   /// The tests and repairs are instantaneous and always successful.
@@ -181,6 +203,9 @@ class PeriodicTest : public Expression {
     void Validate() const override;
     double value() noexcept override;
     double Sample() noexcept override;
+    const Expression& time() const override { return time_; }
+    void ValuesOverTime(const std::vector<double>& grid,
+                        std::vector<double>* values) noexcept override;
 
    protected:
     Expression& lambda_;  ///< The failure rate when functioning.
@@ -206,6 +231,8 @@ class PeriodicTest : public Expression {
     void Validate() const override;
     double value() noexcept override;
     double Sample() noexcept override;
+    void ValuesOverTime(const std::vector<double>& grid,
+                        std::vector<double>* values) noexcept override;
 
    protected:
     Expression& mu_;  ///< The repair rate.
@@ -235,6 +262,8 @@ class PeriodicTest : public Expression {
     void Validate() const override;
     double value() noexcept override;
     double Sample() noexcept override;
+    void ValuesOverTime(const std::vector<double>& grid,
+                        std::vector<double>* values) noexcept override;
 
    private:
     /// Computes the expression value.
@@ -41,7 +41,7 @@ ExternLibrary::ExternLibrary(std::string name, std::string lib_path,
       lib_path.back() == '\\') {
     SCRAM_THROW(ValidityError("Invalid library path format"))
         << errinfo_value(lib_path)
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
   // clang-format on
 
@@ -60,7 +60,7 @@ ExternLibrary::ExternLibrary(std::string name, std::string lib_path,
   } catch (const boost::system::system_error& err) {
     SCRAM_THROW(DLError(err.what()))
         << boost::errinfo_nested_exception(boost::current_exception())
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
 }
 
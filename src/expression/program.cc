@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2014-2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the expression compiler and the program evaluator.
+
+#include "program.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "boolean.h"
+#include "conditional.h"
+#include "exponential.h"
+#include "numerical.h"
+#include "random_deviate.h"
+#include "src/ext/algorithm.h"
+#include "src/parameter.h"
+#include "test_event.h"
+
+namespace scram::mef {
+
+namespace {
+
+/// @returns true if the expression is of the given type.
+template <class T>
+bool Is(Expression* expression) {
+  return dynamic_cast<T*>(expression) != nullptr;
+}
+
+/// Finds the math function of the unary function expression.
+///
+/// @tparam Fs  The candidate functions.
+///
+/// @param[in] expression  The expression to be matched.
+///
+/// @returns The wrapped function or nullptr.
+template <double (*... Fs)(double)>
+auto FindFunction(Expression* expression) {
+  double (*function)(double) = nullptr;
+  ((function = !function && Is<FunctorExpression<Fs>>(expression) ? Fs
+                                                                  : function),
+   ...);
+  return function;
+}
+
+/// Computes the integer modulo of the operands
+/// without trapping on the operands rejected by the Mod validation.
+/// The conditionals are evaluated eagerly by the program,
+/// so the operands of the arms not taken are arbitrary.
+///
+/// @returns NaN for the operands without the integer modulo.
+double Modulo(double dividend, double divisor) noexcept {
+  // The open bounds of the truncation to int.
+  const double kLow = std::numeric_limits<int>::min() - 1.0;
+  const double kHigh = std::numeric_limits<int>::max() + 1.0;
+  if (!(dividend > kLow && dividend < kHigh && divisor > kLow &&
+        divisor < kHigh)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  int denominator = divisor;
+  if (denominator == 0)
+    return std::numeric_limits<double>::quiet_NaN();
+  if (denominator == -1)  // The overflow of the minimum int.
+    return 0;
+  return static_cast<int>(dividend) % denominator;
+}
+
+}  // namespace
+
+ExpressionProgram::ExpressionProgram(const std::vector<Expression*>& roots,
+                                     Mode mode, const Expression* time)
+    : mode_(mode), time_(time) {
+  for (Expression* root : roots)
+    roots_.push_back(Compile(root));
+  compiled_.clear();
+  dynamic_.clear();
+  reset_set_.clear();
+  signatures_.clear();
+  constants_.clear();
+}
+
+void ExpressionProgram::Run() noexcept {
+  for (Expression* expression : resets_)
+    expression->Reset();
+
+  double* r = registers_.data();
+  for (const Instruction& op : code_) {
+    const int* arg = operands_.data() + op.first;
+    double& out = r[op.result];
+    switch (op.opcode) {
+      case Opcode::kValue:
+        out = op.source->value();
+        break;
+      case Opcode::kSample:
+        out = op.source->Sample();
+        break;
+      case Opcode::kNeg:
+        out = -r[arg[0]];
+        break;
+      case Opcode::kUnary:
+        out = op.unary(r[arg[0]]);
+        break;
+      case Opcode::kBinary:
+        out = r[arg[0]];
+        for (int i = 1; i < op.size; ++i)
+          out = op.binary(out, r[arg[i]]);
+        break;
+      case Opcode::kMod:
+        out = Modulo(r[arg[0]], r[arg[1]]);
+        break;
+      case Opcode::kAdd:
+        out = r[arg[0]];
+        for (int i = 1; i < op.size; ++i)
+          out += r[arg[i]];
+        break;
+      case Opcode::kSub:
+        out = r[arg[0]];
+        for (int i = 1; i < op.size; ++i)
+          out -= r[arg[i]];
+        break;
+      case Opcode::kMul:
+        out = r[arg[0]];
+        for (int i = 1; i < op.size; ++i)
+          out *= r[arg[i]];
+        break;
+      case Opcode::kDiv:
+        out = r[arg[0]];
+        for (int i = 1; i < op.size; ++i)
+          out /= r[arg[i]];
+        break;
+      case Opcode::kMean:
+        out = 0;
+        for (int i = 0; i < op.size; ++i)
+          out += r[arg[i]];
+        out /= op.size;
+        break;
+      case Opcode::kNot:
+        out = !r[arg[0]];
+        break;
+      case Opcode::kAnd:
+        out = std::all_of(arg, arg + op.size, [r](int i) { return r[i]; });
+        break;
+      case Opcode::kOr:
+        out = std::any_of(arg, arg + op.size, [r](int i) { return r[i]; });
+        break;
+      case Opcode::kEq:
+        out = r[arg[0]] == r[arg[1]];
+        break;
+      case Opcode::kDf:
+        out = r[arg[0]] != r[arg[1]];
+        break;
+      case Opcode::kLt:
+        out = r[arg[0]] < r[arg[1]];
+        break;
+      case Opcode::kGt:
+        out = r[arg[0]] > r[arg[1]];
+        break;
+      case Opcode::kLeq:
+        out = r[arg[0]] <= r[arg[1]];
+        break;
+      case Opcode::kGeq:
+        out = r[arg[0]] >= r[arg[1]];
+        break;
+      case Opcode::kIte:
+        out = r[arg[0]] ? r[arg[1]] : r[arg[2]];
+        break;
+      case Opcode::kSwitch:
+        out = r[arg[0]];
+        for (int i = 1; i < op.size; i += 2) {
+          if (r[arg[i]]) {
+            out = r[arg[i + 1]];
+            break;
+          }
+        }
+        break;
+      case Opcode::kExponential:
+        out = static_cast<Exponential*>(op.source)->Compute(r[arg[0]],
+                                                            r[arg[1]]);
+        break;
+      case Opcode::kGlm:
+        out = static_cast<Glm*>(op.source)->Compute(r[arg[0]], r[arg[1]],
+                                                    r[arg[2]], r[arg[3]]);
+        break;
+      case Opcode::kWeibull:
+        out = static_cast<Weibull*>(op.source)->Compute(r[arg[0]], r[arg[1]],
+                                                        r[arg[2]], r[arg[3]]);
+        break;
+    }
+  }
+}
+
+int ExpressionProgram::Compile(Expression* expression) noexcept {
+  if (auto it = compiled_.find(expression); it != compiled_.end())
+    return it->second;
+
+  int reg = 0;
+  if (!IsDynamic(expression)) {
+    reg = AddConstant(expression->value());
+  } else if (Is<Parameter>(expression) && expression != time_) {
+    reg = Compile(expression->args().front());
+  } else {
+    Instruction instruction{};
+    instruction.source = expression;
+    Lower(expression, &instruction);
+    std::vector<int> args;
+    bool opaque = instruction.opcode == Opcode::kValue ||
+                  instruction.opcode == Opcode::kSample;
+    if (!opaque) {
+      for (Expression* arg : expression->args())
+        args.push_back(Compile(arg));
+    }
+    Signature signature{instruction.opcode, instruction.unary,
+                        instruction.binary, args};
+    if (auto it = signatures_.find(signature);
+        !opaque && it != signatures_.end()) {
+      reg = it->second;
+    } else {
+      reg = registers_.size();
+      registers_.push_back(0);
+      instruction.result = reg;
+      instruction.first = operands_.size();
+      instruction.size = args.size();
+      operands_.insert(operands_.end(), args.begin(), args.end());
+      code_.push_back(instruction);
+      if (instruction.opcode == Opcode::kSample)
+        CollectResets(expression);
+      if (!opaque)
+        signatures_.emplace(std::move(signature), reg);
+    }
+  }
+  compiled_.emplace(expression, reg);
+  return reg;
+}
+
+void ExpressionProgram::CollectResets(Expression* expression) noexcept {
+  if (!IsDynamic(expression) || !reset_set_.insert(expression).second)
+    return;
+  resets_.push_back(expression);
+  for (Expression* arg : expression->args())
+    CollectResets(arg);
+}
+
+bool ExpressionProgram::IsDynamic(Expression* expression) noexcept {
+  if (expression == time_ || Is<TestEvent>(expression))
+    return true;
+  if (mode_ == Mode::kSample &&
+      (Is<RandomDeviate>(expression) ||
+       (expression->args().empty() && expression->IsDeviate()))) {
+    return true;
+  }
+  if (auto it = dynamic_.find(expression); it != dynamic_.end())
+    return it->second;
+  bool result = ext::any_of(expression->args(), [this](Expression* arg) {
+    return IsDynamic(arg);
+  });
+  dynamic_.emplace(expression, result);
+  return result;
+}
+
+void ExpressionProgram::Lower(Expression* expression,
+                              Instruction* instruction) noexcept {
+  Opcode& opcode = instruction->opcode;
+  if (mode_ == Mode::kSample && (Is<Ite>(expression) || Is<Switch>(expression))
+      && expression->IsDeviate()) {
+    // Only the taken arms of conditionals get sampled.
+    opcode = Opcode::kSample;
+  } else if (Is<Neg>(expression)) {
+    opcode = Opcode::kNeg;
+  } else if (auto function =
+                 FindFunction<&std::abs, &std::acos, &std::asin, &std::atan,
+                              &std::cos, &std::sin, &std::tan, &std::cosh,
+                              &std::sinh, &std::tanh, &std::exp, &std::log,
+                              &std::log10, &std::sqrt, &std::ceil,
+                              &std::floor>(expression)) {
+    opcode = Opcode::kUnary;
+    instruction->unary = function;
+  } else if (Is<Pow>(expression)) {
+    opcode = Opcode::kBinary;
+    instruction->binary = &std::pow;
+  } else if (Is<Min>(expression)) {
+    opcode = Opcode::kBinary;
+    instruction->binary = &std::fmin;
+  } else if (Is<Max>(expression)) {
+    opcode = Opcode::kBinary;
+    instruction->binary = &std::fmax;
+  } else if (Is<Mod>(expression)) {
+    opcode = Opcode::kMod;
+  } else if (Is<Add>(expression)) {
+    opcode = Opcode::kAdd;
+  } else if (Is<Sub>(expression)) {
+    opcode = Opcode::kSub;
+  } else if (Is<Mul>(expression)) {
+    opcode = Opcode::kMul;
+  } else if (Is<Div>(expression)) {
+    opcode = Opcode::kDiv;
+  } else if (Is<Mean>(expression)) {
+    opcode = Opcode::kMean;
+  } else if (Is<Not>(expression)) {
+    opcode = Opcode::kNot;
+  } else if (Is<And>(expression)) {
+    opcode = Opcode::kAnd;
+  } else if (Is<Or>(expression)) {
+    opcode = Opcode::kOr;
+  } else if (Is<Eq>(expression)) {
+    opcode = Opcode::kEq;
+  } else if (Is<Df>(expression)) {
+    opcode = Opcode::kDf;
+  } else if (Is<Lt>(expression)) {
+    opcode = Opcode::kLt;
+  } else if (Is<Gt>(expression)) {
+    opcode = Opcode::kGt;
+  } else if (Is<Leq>(expression)) {
+    opcode = Opcode::kLeq;
+  } else if (Is<Geq>(expression)) {
+    opcode = Opcode::kGeq;
+  } else if (Is<Ite>(expression)) {
+    opcode = Opcode::kIte;
+  } else if (Is<Switch>(expression)) {
+    opcode = Opcode::kSwitch;
+  } else if (Is<Exponential>(expression)) {
+    opcode = Opcode::kExponential;
+  } else if (Is<Glm>(expression)) {
+    opcode = Opcode::kGlm;
+  } else if (Is<Weibull>(expression)) {
+    opcode = Opcode::kWeibull;
+  } else {
+    opcode = mode_ == Mode::kSample ? Opcode::kSample : Opcode::kValue;
+  }
+}
+
+int ExpressionProgram::AddConstant(double value) noexcept {
+  if (!std::isnan(value)) {
+    if (auto it = constants_.find(value); it != constants_.end())
+      return it->second;
+  }
+  int reg = registers_.size();
+  registers_.push_back(value);
+  if (!std::isnan(value))
+    constants_.emplace(value, reg);
+  return reg;
+}
+
+}  // namespace scram::mef
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2014-2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Compilation of expression graphs into flat register programs.
+
+#pragma once
+
+#include <cstdint>
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "src/expression.h"
+
+namespace scram::mef {
+
+/// A linear register program compiled from expression graphs
+/// for repeated evaluation of the same expressions,
+/// e.g., basic event probabilities over time steps or Monte Carlo trials.
+///
+/// The compiler folds the sub-graphs that cannot change between runs
+/// into constants
+/// and shares the registers of structurally equal sub-expressions.
+/// The expressions it doesn't know how to lower
+/// are called through the Expression interface.
+///
+/// @note The expressions must not be changed after the compilation
+///       except for the value of the varying expression.
+class ExpressionProgram {
+ public:
+  /// Evaluation modes of the program.
+  enum class Mode : std::uint8_t {
+    kValue = 0,  ///< The mean values of the expressions.
+    kSample  ///< The sampled values of the expressions.
+  };
+
+  /// Compiles expressions into a program.
+  ///
+  /// @param[in] roots  The expressions to be evaluated together.
+  /// @param[in] mode  The evaluation mode of the program.
+  /// @param[in] time  The expression that may change value between runs,
+  ///                  i.e., the mission time or a swept parameter,
+  ///                  or nullptr if it stays constant.
+  ExpressionProgram(const std::vector<Expression*>& roots, Mode mode,
+                    const Expression* time = nullptr);
+
+  /// @returns The number of instructions executed per run.
+  int size() const { return code_.size(); }
+
+  /// Evaluates all the root expressions.
+  /// In the sample mode,
+  /// the random deviates are reset and sampled anew.
+  void Run() noexcept;
+
+  /// @param[in] index  The position of the root expression upon compilation.
+  ///
+  /// @returns The value of the root expression from the last run.
+  double result(int index) const { return registers_[roots_[index]]; }
+
+ private:
+  /// Operations of the program instructions.
+  enum class Opcode : std::uint8_t {
+    kValue,  ///< Calls the expression for its value.
+    kSample,  ///< Calls the expression for its sampled value.
+    kNeg,
+    kUnary,  ///< Applies a unary math function.
+    kBinary,  ///< Folds the operands with a binary math function.
+    kMod,
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kMean,
+    kNot,
+    kAnd,
+    kOr,
+    kEq,
+    kDf,
+    kLt,
+    kGt,
+    kLeq,
+    kGeq,
+    kIte,  ///< Condition, then-arm, and else-arm operands.
+    kSwitch,  ///< The default value followed by condition-value pairs.
+    kExponential,
+    kGlm,
+    kWeibull
+  };
+
+  /// A single instruction writing into its own result register.
+  struct Instruction {
+    Opcode opcode;  ///< The operation.
+    int result;  ///< The destination register.
+    int first;  ///< The position of the first operand register.
+    int size;  ///< The number of operands.
+    Expression* source;  ///< The originating expression.
+    double (*unary)(double);  ///< The math function for kUnary.
+    double (*binary)(double, double);  ///< The math function for kBinary.
+  };
+
+  /// The structural identity of instructions for register sharing.
+  using Signature = std::tuple<Opcode, double (*)(double),
+                               double (*)(double, double), std::vector<int>>;
+
+  /// Compiles an expression graph.
+  ///
+  /// @param[in] expression  The root of the graph.
+  ///
+  /// @returns The register with the expression value.
+  int Compile(Expression* expression) noexcept;
+
+  /// Registers the sampled expression and its varying arguments for reset.
+  /// Every expression is reset individually
+  /// because the samples may be left over from other users of the graph.
+  ///
+  /// @param[in] expression  The expression called for samples.
+  void CollectResets(Expression* expression) noexcept;
+
+  /// Determines if the expression value may change between runs.
+  ///
+  /// @param[in] expression  The expression to be checked.
+  ///
+  /// @returns true if the expression must be evaluated in every run.
+  bool IsDynamic(Expression* expression) noexcept;
+
+  /// Finds the operation for the expression type.
+  ///
+  /// @param[in] expression  The expression to be lowered.
+  /// @param[out] instruction  The instruction to set the operation.
+  void Lower(Expression* expression, Instruction* instruction) noexcept;
+
+  /// @param[in] value  The constant value.
+  ///
+  /// @returns The register holding the constant.
+  int AddConstant(double value) noexcept;
+
+  Mode mode_;  ///< The evaluation mode.
+  const Expression* time_;  ///< The varying time expression.
+  std::vector<Instruction> code_;  ///< The instructions in evaluation order.
+  std::vector<int> operands_;  ///< The operand registers of instructions.
+  std::vector<double> registers_;  ///< The constants and results.
+  std::vector<int> roots_;  ///< The result registers of the root expressions.
+  std::vector<Expression*> resets_;  ///< The sampled expressions to reset.
+  /// Compilation state.
+  /// @{
+  std::unordered_map<const Expression*, int> compiled_;
+  std::unordered_map<const Expression*, bool> dynamic_;
+  std::unordered_set<const Expression*> reset_set_;
+  std::map<Signature, int> signatures_;
+  std::map<double, int> constants_;
+  /// @}
+};
+
+}  // namespace scram::mef
@@ -36,7 +36,7 @@
 
 namespace scram::mef {
 
-std::mt19937 RandomDeviate::rng_;
+thread_local std::mt19937 RandomDeviate::rng_;
 
 UniformDeviate::UniformDeviate(Expression* min, Expression* max)
     : RandomDeviate({min, max}), min_(*min), max_(*max) {}
@@ -34,9 +34,9 @@ namespace scram::mef {
 /// Abstract base class for all deviate expressions.
 /// These expressions provide quantification for uncertainty and sensitivity.
 ///
-/// @note Only single RNG is embedded for convenience.
-///       All the distributions share this RNG.
-///       This is not suitable for parallelized simulations!!!
+/// @note Only single RNG per thread is embedded for convenience.
+///       All the distributions share this RNG within a thread.
+///       Concurrent simulations must seed the RNG of their own threads.
 ///
 /// @todo Parametrize with RNG (requires mef::Expression interface change).
 class RandomDeviate : public Expression {
@@ -45,7 +45,8 @@ class RandomDeviate : public Expression {
 
   bool IsDeviate() noexcept override { return true; }
 
-  /// Sets the seed of the underlying random number generator.
+  /// Sets the seed of the underlying random number generator
+  /// of the calling thread.
   ///
   /// @param[in] seed  The seed for RNGs.
   ///
@@ -57,7 +58,7 @@ class RandomDeviate : public Expression {
   std::mt19937& rng() { return rng_; }
 
  private:
-  static std::mt19937 rng_;  ///< The random number generator.
+  static thread_local std::mt19937 rng_;  ///< The random number generator.
 };
 
 /// Uniform distribution.
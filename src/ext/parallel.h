@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Task-parallel execution facilities.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ext {
+
+/// Runs independent tasks concurrently.
+/// The calling thread participates in the execution of the tasks.
+/// The tasks are dispatched in the order of their indices.
+///
+/// @tparam F  The task type callable with the task index.
+///
+/// @param[in] num_tasks  The number of tasks with indices [0, num_tasks).
+/// @param[in] num_threads  The maximum number of threads to run the tasks.
+/// @param[in] task  The task to run for each index.
+///
+/// @pre The task does not throw.
+///
+/// @post All the tasks are complete.
+template <typename F>
+void parallel_for(int num_tasks, int num_threads, F&& task) {
+  std::atomic<int> next_task(0);
+  auto worker = [&next_task, &task, num_tasks] {
+    for (int i = next_task++; i < num_tasks; i = next_task++)
+      task(i);
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < std::min(num_threads, num_tasks); ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+}
+
+}  // namespace ext
@@ -24,14 +24,14 @@
 
 namespace scram::mef {
 
-Component::Component(std::string name, std::string base_path,
+Component::Component(std::string_view name, std::string_view base_path,
                      RoleSpecifier role)
-    : Element(std::move(name)), Role(role, std::move(base_path)) {}
+    : Element(name), Role(role, base_path) {}
 
 void Component::Add(CcfGroup* ccf_group) {
   if (ccf_groups().count(ccf_group->name())) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(ccf_group->name(), "CCF group");
+        << errinfo_element(std::string(ccf_group->name()), "CCF group");
   }
   for (BasicEvent* member : ccf_group->members())
     CheckDuplicateEvent(*member);
@@ -49,12 +49,12 @@ void Component::GatherGates(std::unordered_set<Gate*>* gates) {
 }
 
 void Component::CheckDuplicateEvent(const Event& event) {
-  const std::string& name = event.name();
+  const Symbol& name = event.name_symbol();
   if (gates().count(name) || basic_events().count(name) ||
       house_events().count(name)) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(name, "event")
-        << errinfo_container(Element::name(), kTypeString);
+        << errinfo_element(std::string(name.view()), "event")
+        << errinfo_container(std::string(Element::name()), kTypeString);
   }
 }
 
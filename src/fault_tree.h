@@ -60,7 +60,7 @@ class Component
   ///
   /// @throws LogicError  The name is empty.
   /// @throws ValidityError  The name or reference paths are malformed.
-  explicit Component(std::string name, std::string base_path = "",
+  explicit Component(std::string_view name, std::string_view base_path = "",
                      RoleSpecifier role = RoleSpecifier::kPublic);
 
   virtual ~Component() = default;
@@ -21,6 +21,7 @@
 #include "fault_tree_analysis.h"
 
 #include <iostream>
+#include <new>
 #include <utility>
 
 #include <boost/container/flat_set.hpp>
@@ -112,23 +113,54 @@ double Product::p() const {
   return p;
 }
 
+SharedBdd::SharedBdd(const std::vector<const mef::Gate*>& targets,
+                     const Settings& settings, const mef::Model* model)
+    : graph_(std::make_shared<Pdag>(targets, settings.ccf_analysis(), model)) {
+  CLOCK(bdd_time);
+  LOG(DEBUG2) << "Creating the shared BDD for " << targets.size()
+              << " targets...";
+  bdd_ = std::make_unique<Bdd>(graph_.get(), settings, graph_->targets());
+  for (int i = 0; i < targets.size(); ++i)
+    targets_.emplace(targets[i], i);
+  LOG(DEBUG2) << "The shared BDD is created in " << DUR(bdd_time);
+}
+
+std::unique_ptr<Bdd> SharedBdd::Extract(const mef::Gate& target) noexcept {
+  assert(targets_.count(&target) && "The target is not in the shared BDD.");
+  return std::make_unique<Bdd>(bdd_.get(), targets_.find(&target)->second);
+}
+
 FaultTreeAnalysis::FaultTreeAnalysis(const mef::Gate& root,
                                      const Settings& settings,
                                      const mef::Model* model)
     : Analysis(settings), top_event_(root), model_(model) {}
 
+FaultTreeAnalysis::FaultTreeAnalysis(const mef::Gate& root,
+                                     const Settings& settings,
+                                     std::shared_ptr<SharedBdd> shared_bdd)
+    : Analysis(settings),
+      top_event_(root),
+      model_(nullptr),
+      shared_bdd_(std::move(shared_bdd)) {}
+
 void FaultTreeAnalysis::Analyze() noexcept {
   CLOCK(analysis_time);
-  graph_ = std::make_unique<Pdag>(top_event_,
-                                  Analysis::settings().ccf_analysis(), model_);
-  this->Preprocess(graph_.get());
+  if (shared_bdd_) {
+    graph_ = shared_bdd_->graph();
+  } else {
+    graph_ = std::make_shared<Pdag>(
+        top_event_, Analysis::settings().ccf_analysis(), model_);
+    this->Preprocess(graph_.get());
+  }
 #ifndef NDEBUG
   if (Analysis::settings().preprocessor)
     return;  // Preprocessor only option.
 #endif
   CLOCK(algo_time);
   LOG(DEBUG2) << "Launching the algorithm...";
-  const Zbdd& products = this->GenerateProducts(graph_.get());
+  const Zbdd& products = Analysis::settings().cache_dir().empty() || shared_bdd_
+                             ? this->GenerateProducts(graph_.get())
+                             : GenerateCachedProducts(graph_.get());
   LOG(DEBUG2) << "The algorithm finished in " << DUR(algo_time);
   LOG(DEBUG2) << "# of products: " << products.size();
 
@@ -138,6 +170,28 @@ void FaultTreeAnalysis::Analyze() noexcept {
   LOG(DEBUG2) << "Stored the result for reporting in " << DUR(store_time);
 }
 
+const Zbdd& FaultTreeAnalysis::GenerateCachedProducts(
+    const Pdag* graph) noexcept {
+  AnalysisCache cache(Analysis::settings());
+  std::string key;
+  try {
+    key = AnalysisCache::Key(*graph, Analysis::settings());
+  } catch (const std::bad_alloc&) {  // The cache is only an optimization.
+    LOG(WARNING) << "Cannot compute the key of the analysis cache.";
+    return this->GenerateProducts(graph);
+  }
+  if (std::optional<AnalysisCache::Entry> entry = cache.Load(key)) {
+    if (const Zbdd* products = this->RestoreProducts(*entry)) {
+      LOG(DEBUG2) << "Restored the products from the cache.";
+      return *products;
+    }
+  }
+  const Zbdd& products = this->GenerateProducts(graph);
+  if (!Analysis::settings().canceled())  // Incomplete results are not cached.
+    cache.Store(key, this->ExportProducts());
+  return products;
+}
+
 void FaultTreeAnalysis::Store(const Zbdd& products,
                               const Pdag& graph) noexcept {
   // Special cases of sets.
@@ -23,13 +23,17 @@
 #include <cstdlib>
 
 #include <memory>
+#include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <boost/noncopyable.hpp>
 
 #include "analysis.h"
+#include "analysis_cache.h"
 #include "pdag.h"
 #include "preprocessor.h"
 #include "settings.h"
@@ -171,6 +175,34 @@ class ProductContainer {
 /// @param[in] products  Valid, unique collection of analysis results.
 void Print(const ProductContainer& products);
 
+/// The PDAG and BDD shared by several analysis targets.
+/// The PDAG is not preprocessed to keep the target gates intact,
+/// and the BDD has a root function for every target.
+/// The analyses of the targets reuse the common sub-graphs,
+/// so the cost grows with the union of the target logic.
+class SharedBdd : private boost::noncopyable {
+ public:
+  /// @param[in] targets  The top events of the analysis targets.
+  /// @param[in] settings  Analysis settings for all calculations.
+  /// @param[in] model  The Model containing substitutions if any.
+  SharedBdd(const std::vector<const mef::Gate*>& targets,
+            const Settings& settings, const mef::Model* model = nullptr);
+
+  /// @returns The PDAG shared by all the targets.
+  const std::shared_ptr<Pdag>& graph() const { return graph_; }
+
+  /// @param[in] target  The top event of one of the targets.
+  ///
+  /// @returns The BDD with the root function of the target.
+  std::unique_ptr<Bdd> Extract(const mef::Gate& target) noexcept;
+
+ private:
+  std::shared_ptr<Pdag> graph_;  ///< The graph of all targets.
+  std::unique_ptr<Bdd> bdd_;  ///< The host BDD with the target functions.
+  /// The top events and their positions in the host BDD.
+  std::unordered_map<const mef::Gate*, int> targets_;
+};
+
 /// Fault tree analysis functionality.
 /// The analysis must be done on
 /// a validated and fully initialized fault trees.
@@ -210,6 +242,18 @@ class FaultTreeAnalysis : public Analysis {
   FaultTreeAnalysis(const mef::Gate& root, const Settings& settings,
                     const mef::Model* model = nullptr);
 
+  /// Sets up the analysis of the fault tree
+  /// as one of the targets of a shared BDD.
+  /// The shared PDAG is analyzed without preprocessing.
+  ///
+  /// @param[in] root  The top event among the targets of the shared BDD.
+  /// @param[in] settings  Analysis settings for all calculations.
+  /// @param[in] shared_bdd  The shared PDAG and BDD.
+  ///
+  /// @pre The analysis algorithm is BDD.
+  FaultTreeAnalysis(const mef::Gate& root, const Settings& settings,
+                    std::shared_ptr<SharedBdd> shared_bdd);
+
   virtual ~FaultTreeAnalysis() = default;
 
   /// @returns The top gate that is passed to the analysis.
@@ -242,6 +286,9 @@ class FaultTreeAnalysis : public Analysis {
   /// @returns Pointer to the PDAG representing the fault tree.
   const Pdag* graph() const { return graph_.get(); }
 
+  /// @returns The shared PDAG and BDD if the analysis target is shared.
+  SharedBdd* shared_bdd() const { return shared_bdd_.get(); }
+
  private:
   /// Preprocesses a PDAG for future analysis with a specific algorithm.
   ///
@@ -261,6 +308,31 @@ class FaultTreeAnalysis : public Analysis {
   /// @post The result ZBDD lives as long as the host analysis.
   virtual const Zbdd& GenerateProducts(const Pdag* graph) noexcept = 0;
 
+  /// Restores the products of the analysis from the cache.
+  ///
+  /// @param[in] entry  The cached results for the analysis graph.
+  ///
+  /// @returns The restored products.
+  ///          nullptr if the entry is not suitable for the algorithm.
+  ///
+  /// @post The result ZBDD lives as long as the host analysis.
+  virtual const Zbdd* RestoreProducts(
+      const AnalysisCache::Entry& entry) noexcept = 0;
+
+  /// @returns The results of the analysis for the cache.
+  ///
+  /// @pre The products are generated.
+  virtual AnalysisCache::Entry ExportProducts() const noexcept = 0;
+
+  /// Generates the products with the analysis cache.
+  ///
+  /// @param[in] graph  The analysis PDAG.
+  ///
+  /// @returns The set of products restored from or stored into the cache.
+  ///
+  /// @pre The cache directory is provided in the settings.
+  const Zbdd& GenerateCachedProducts(const Pdag* graph) noexcept;
+
   /// Stores resultant sets of products for future reporting.
   ///
   /// @param[in] products  Sets with indices of events from calculations.
@@ -269,7 +341,8 @@ class FaultTreeAnalysis : public Analysis {
 
   const mef::Gate& top_event_;  ///< The root of the graph under analysis.
   const mef::Model* model_;  ///< The optional Model with substitutions.
-  std::unique_ptr<Pdag> graph_;  ///< PDAG of the fault tree.
+  std::shared_ptr<Pdag> graph_;  ///< PDAG of the fault tree.
+  std::shared_ptr<SharedBdd> shared_bdd_;  ///< The optional shared graph.
   std::unique_ptr<const ProductContainer> products_;  ///< Container of results.
 };
 
@@ -284,23 +357,58 @@ class FaultTreeAnalyzer : public FaultTreeAnalysis {
   using FaultTreeAnalysis::graph;  // Provide access to other analyses.
 
   /// @returns The analysis algorithm for use by other analyses.
+  ///          The algorithm is nullptr for non-BDD analyses
+  ///          with the products restored from the cache.
   /// @{
   const Algorithm* algorithm() const { return algorithm_.get(); }
   Algorithm* algorithm() { return algorithm_.get(); }
   /// @}
 
+  /// @returns The products generated by the algorithm
+  ///          or restored from the cache.
+  ///
+  /// @pre The analysis is done.
+  const Zbdd& zbdd() const {
+    return cached_products_ ? *cached_products_ : algorithm_->products();
+  }
+
  private:
   void Preprocess(Pdag* graph) noexcept override {
     CustomPreprocessor<Algorithm>{graph}();
   }
 
   const Zbdd& GenerateProducts(const Pdag* graph) noexcept override {
-    algorithm_ = std::make_unique<Algorithm>(graph, Analysis::settings());
+    if constexpr (std::is_same_v<Algorithm, Bdd>) {
+      if (SharedBdd* shared = FaultTreeAnalysis::shared_bdd())
+        algorithm_ = shared->Extract(FaultTreeAnalysis::top_event());
+    }
+    if (!algorithm_)
+      algorithm_ = std::make_unique<Algorithm>(graph, Analysis::settings());
     algorithm_->Analyze(graph);
     return algorithm_->products();
   }
 
+  const Zbdd* RestoreProducts(
+      const AnalysisCache::Entry& entry) noexcept override {
+    if constexpr (std::is_same_v<Algorithm, Bdd>) {
+      if (!entry.bdd)
+        return nullptr;
+      algorithm_ = std::make_unique<Bdd>(*entry.bdd, Analysis::settings());
+    }
+    cached_products_ =
+        std::make_unique<Zbdd>(entry.products, Analysis::settings());
+    return cached_products_.get();
+  }
+
+  AnalysisCache::Entry ExportProducts() const noexcept override {
+    AnalysisCache::Entry entry{algorithm_->products().Export(), {}};
+    if constexpr (std::is_same_v<Algorithm, Bdd>)
+      entry.bdd = algorithm_->Export();
+    return entry;
+  }
+
   std::unique_ptr<Algorithm> algorithm_;  ///< Analysis algorithm.
+  std::unique_ptr<Zbdd> cached_products_;  ///< The products from the cache.
 };
 
 }  // namespace scram::core
@@ -40,27 +40,34 @@ void ImportanceAnalysis::Analyze() noexcept {
       this->basic_events();
 
   std::vector<int> occurrences = this->occurrences();
+  std::vector<double> mifs = this->CalculateMifs();
   for (int i = 0; i < basic_events.size(); ++i) {
     if (occurrences[i] == 0)
       continue;
     const mef::BasicEvent& event = *basic_events[i];
-    double p_var = event.p();
-    ImportanceFactors imp{};
+    ImportanceFactors imp = CalculateFactors(p_total, event.p(), mifs[i]);
     imp.occurrence = occurrences[i];
-    imp.mif = this->CalculateMif(i);
-    if (p_total != 0) {
-      imp.cif = p_var * imp.mif / p_total;
-      imp.raw = 1 + (1 - p_var) * imp.mif / p_total;
-      imp.dif = p_var * imp.raw;
-      if (p_total != p_var * imp.mif)
-        imp.rrw = p_total / (p_total - p_var * imp.mif);
-    }
     importance_.push_back({event, imp});
   }
   LOG(DEBUG3) << "Calculated importance factors in " << DUR(imp_time);
   Analysis::AddAnalysisTime(DUR(imp_time));
 }
 
+ImportanceFactors ImportanceAnalysis::CalculateFactors(double p_total,
+                                                       double p_var,
+                                                       double mif) noexcept {
+  ImportanceFactors imp{};
+  imp.mif = mif;
+  if (p_total != 0) {
+    imp.cif = p_var * imp.mif / p_total;
+    imp.raw = 1 + (1 - p_var) * imp.mif / p_total;
+    imp.dif = p_var * imp.raw;
+    if (p_total != p_var * imp.mif)
+      imp.rrw = p_total / (p_total - p_var * imp.mif);
+  }
+  return imp;
+}
+
 std::vector<int> ImportanceAnalyzerBase::occurrences() noexcept {
   Pdag::IndexMap<int> result(prob_analyzer_->graph()->basic_events().size());
   for (const std::vector<int>& product : prob_analyzer_->products()) {
@@ -70,54 +77,95 @@ std::vector<int> ImportanceAnalyzerBase::occurrences() noexcept {
   return result;
 }
 
-double ImportanceAnalyzer<Bdd>::CalculateMif(int index) noexcept {
-  index += Pdag::kVariableStartIndex;
-  const Bdd::VertexPtr& root = bdd_graph_->root().vertex;
-  if (root->terminal())
-    return 0;
-  bool original_mark = Ite::Ref(root).mark();
-
-  int order = bdd_graph_->index_to_order().find(index)->second;
-  double mif = CalculateMif(root, order, !original_mark);
-  bdd_graph_->ClearMarks(original_mark);
-  return mif;
+std::vector<double> ImportanceAnalyzerBase::CalculateMifs() noexcept {
+  std::vector<double> mifs;
+  CalculateMarginalImportance(prob_analyzer_->p_vars(), &mifs);
+  return mifs;
 }
 
-double ImportanceAnalyzer<Bdd>::CalculateMif(const Bdd::VertexPtr& vertex,
-                                             int order, bool mark) noexcept {
-  if (vertex->terminal())
-    return 0;
-  Ite& ite = Ite::Ref(vertex);
-  if (ite.mark() == mark)
-    return ite.factor();
-  ite.mark(mark);
-  if (ite.order() > order) {
-    if (!ite.module()) {
-      ite.factor(0);
-    } else {  /// @todo Detect if the variable is in the module.
-      // The assumption is
-      // that the order of a module is always larger
-      // than the order of its variables.
-      double high = RetrieveProbability(ite.high());
-      double low = RetrieveProbability(ite.low());
-      if (ite.complement_edge())
-        low = 1 - low;
-      const Bdd::Function& res =
-          bdd_graph_->modules().find(ite.index())->second;
-      double mif = CalculateMif(res.vertex, order, mark);
-      if (res.complement)
-        mif = -mif;
-      ite.factor((high - low) * mif);
+void ImportanceAnalyzerBase::CalculateMarginalImportances(
+    const std::vector<double>& p_vars, int num_points, double* p_total,
+    std::vector<double>* mifs) noexcept {
+  Pdag::IndexMap<double> point(prob_analyzer_->p_vars().size());
+  std::vector<double> point_mifs;
+  mifs->resize(p_vars.size());
+  for (int j = 0; j < num_points; ++j) {
+    for (int i = 0; i < point.size(); ++i)
+      point[i + Pdag::kVariableStartIndex] = p_vars[i * num_points + j];
+    p_total[j] = this->CalculateMarginalImportance(point, &point_mifs);
+    for (int i = 0; i < point.size(); ++i)
+      (*mifs)[i * num_points + j] = point_mifs[i];
+  }
+}
+
+template <>
+double ImportanceAnalyzer<RareEventCalculator>::CalculateMarginalImportance(
+    const Pdag::IndexMap<double>& p_vars, std::vector<double>* mifs) noexcept {
+  auto p_literal = [&p_vars](int literal) {
+    return literal < 0 ? 1 - p_vars[-literal] : p_vars[literal];
+  };
+  // The sum of products is linear in any single variable:
+  // sum = slope * p_var + const.
+  Pdag::IndexMap<double> slopes(p_vars.size());
+  double sum = 0;
+  std::vector<double> suffix;  // Products of literals after the position.
+  for (const std::vector<int>& product : prob_analyzer()->products()) {
+    int num_literals = product.size();
+    suffix.assign(num_literals + 1, 1);
+    for (int i = num_literals - 1; i >= 0; --i)
+      suffix[i] = suffix[i + 1] * p_literal(product[i]);
+    double prefix = 1;  // Products of literals before the position.
+    for (int i = 0; i < num_literals; ++i) {
+      double rest = prefix * suffix[i + 1];
+      slopes[std::abs(product[i])] += product[i] < 0 ? -rest : rest;
+      prefix *= p_literal(product[i]);
     }
-  } else if (ite.order() == order) {
-    assert(!ite.module() && "A variable can't be a module.");
+    sum += suffix.front();
+  }
+  // The conditional sums are adjusted just like the total probability.
+  auto adjust = [](double value) { return value > 1 ? 1 : value; };
+  mifs->assign(p_vars.size(), 0);
+  for (int i = 0; i < mifs->size(); ++i) {
+    int index = i + Pdag::kVariableStartIndex;
+    double p_var = p_vars[index];
+    (*mifs)[i] = adjust(sum + (1 - p_var) * slopes[index]) -
+                 adjust(sum - p_var * slopes[index]);
+  }
+  return adjust(sum);
+}
+
+double ImportanceAnalyzer<Bdd>::CalculateMarginalImportance(
+    const Pdag::IndexMap<double>& p_vars, std::vector<double>* mifs) noexcept {
+  // The forward pass saves the probabilities of vertices.
+  double p_total = static_cast<ProbabilityAnalyzer<Bdd>*>(prob_analyzer())
+                       ->CalculateTotalProbability(p_vars);
+  mifs->assign(p_vars.size(), 0);
+  const Bdd::Function& root = bdd_graph_->root();
+  if (root.vertex->terminal())
+    return p_total;
+  if (vertices_.empty()) {
+    bool original_mark = Ite::Ref(root.vertex).mark();
+    CollectVertices(root.vertex, !original_mark);
+    bdd_graph_->ClearMarks(original_mark);
+  }
+  // Probability factor fields accumulate the partial derivatives
+  // of the total probability w.r.t. the vertex probabilities.
+  for (Ite* ite : vertices_)
+    ite->factor(0);
+  Ite::Ref(root.vertex).factor(root.complement ? -1 : 1);
+  auto propagate = [](const Bdd::VertexPtr& vertex, double derivative) {
+    if (!vertex->terminal()) {
+      Ite& ite = Ite::Ref(vertex);
+      ite.factor(ite.factor() + derivative);
+    }
+  };
+  for (auto it = vertices_.rbegin(); it != vertices_.rend(); ++it) {
+    Ite& ite = **it;  // All the parents are already processed.
     double high = RetrieveProbability(ite.high());
     double low = RetrieveProbability(ite.low());
     if (ite.complement_edge())
       low = 1 - low;
-    ite.factor(high - low);
-  } else {
-    assert(ite.order() < order);
+    double d_var = ite.factor() * (high - low);
     double p_var = 0;
     if (ite.module()) {
       const Bdd::Function& res =
@@ -125,16 +173,39 @@ double ImportanceAnalyzer<Bdd>::CalculateMif(const Bdd::VertexPtr& vertex,
       p_var = RetrieveProbability(res.vertex);
       if (res.complement)
         p_var = 1 - p_var;
+      propagate(res.vertex, res.complement ? -d_var : d_var);
     } else {
-      p_var = prob_analyzer()->p_vars()[ite.index()];
+      p_var = p_vars[ite.index()];
+      (*mifs)[ite.index() - Pdag::kVariableStartIndex] += d_var;
     }
-    double high = CalculateMif(ite.high(), order, mark);
-    double low = CalculateMif(ite.low(), order, mark);
-    if (ite.complement_edge())
-      low = -low;
-    ite.factor(p_var * high + (1 - p_var) * low);
+    propagate(ite.high(), ite.factor() * p_var);
+    double d_low = ite.factor() * (1 - p_var);
+    propagate(ite.low(), ite.complement_edge() ? -d_low : d_low);
   }
-  return ite.factor();
+  return p_total;
+}
+
+void ImportanceAnalyzer<Bdd>::CalculateMarginalImportances(
+    const std::vector<double>& p_vars, int num_points, double* p_total,
+    std::vector<double>* mifs) noexcept {
+  static_cast<ProbabilityAnalyzer<Bdd>*>(prob_analyzer())
+      ->CalculateDerivatives(p_vars, num_points, p_total, mifs);
+}
+
+void ImportanceAnalyzer<Bdd>::CollectVertices(const Bdd::VertexPtr& vertex,
+                                              bool mark) noexcept {
+  if (vertex->terminal())
+    return;
+  Ite& ite = Ite::Ref(vertex);
+  if (ite.mark() == mark)
+    return;
+  ite.mark(mark);
+  if (ite.module())
+    CollectVertices(bdd_graph_->modules().find(ite.index())->second.vertex,
+                    mark);
+  CollectVertices(ite.high(), mark);
+  CollectVertices(ite.low(), mark);
+  vertices_.push_back(&ite);
 }
 
 double ImportanceAnalyzer<Bdd>::RetrieveProbability(
@@ -76,6 +76,16 @@ class ImportanceAnalysis : public Analysis {
     return importance_;
   }
 
+  /// Derives importance factors from the marginal importance of a variable.
+  ///
+  /// @param[in] p_total  The total probability.
+  /// @param[in] p_var  The probability of the variable.
+  /// @param[in] mif  The Birnbaum marginal importance factor of the variable.
+  ///
+  /// @returns Importance factors without the occurrence information.
+  static ImportanceFactors CalculateFactors(double p_total, double p_var,
+                                            double mif) noexcept;
+
  private:
   /// @returns Total probability from the probability analysis.
   virtual double p_total() noexcept = 0;
@@ -85,12 +95,10 @@ class ImportanceAnalysis : public Analysis {
   /// @returns Occurrences of basic events in products.
   virtual std::vector<int> occurrences() noexcept = 0;
 
-  /// Calculates Marginal Importance Factor.
-  ///
-  /// @param[in] index  The position index of an event in events vector.
+  /// Calculates Marginal Importance Factors of all basic event candidates.
   ///
-  /// @returns Calculated value for MIF.
-  virtual double CalculateMif(int index) noexcept = 0;
+  /// @returns MIF values in the order of the basic events vector.
+  virtual std::vector<double> CalculateMifs() noexcept = 0;
 
   /// Container of important events and their importance factors.
   std::vector<ImportanceRecord> importance_;
@@ -108,18 +116,49 @@ class ImportanceAnalyzerBase : public ImportanceAnalysis {
   explicit ImportanceAnalyzerBase(ProbabilityAnalyzerBase* prob_analyzer)
       : ImportanceAnalysis(prob_analyzer), prob_analyzer_(prob_analyzer) {}
 
+  /// Calculates the total probability
+  /// together with Marginal Importance Factors of all variables
+  /// without re-running the calculations per variable.
+  ///
+  /// @param[in] p_vars  Probabilities of the variables mapped by their indices.
+  /// @param[out] mifs  MIF values in the order of the graph basic events.
+  ///
+  /// @returns The total probability calculated with the given values.
+  virtual double CalculateMarginalImportance(
+      const Pdag::IndexMap<double>& p_vars,
+      std::vector<double>* mifs) noexcept = 0;
+
+  /// Calculates the total probabilities
+  /// together with Marginal Importance Factors of all variables
+  /// for a batch of variable probability sets at once.
+  ///
+  /// @param[in] p_vars  The probabilities of the graph variables
+  ///                    laid out in the order of the variable indices
+  ///                    with ``num_points`` consecutive values per variable.
+  /// @param[in] num_points  The number of probability sets in the batch.
+  /// @param[out] p_total  The destination for the total probabilities
+  ///                      of the ``num_points`` sets.
+  /// @param[out] mifs  MIF values laid out as the variable probabilities.
+  ///
+  /// @note The default implementation calculates the factors one by one.
+  virtual void CalculateMarginalImportances(const std::vector<double>& p_vars,
+                                            int num_points, double* p_total,
+                                            std::vector<double>* mifs) noexcept;
+
  protected:
   virtual ~ImportanceAnalyzerBase() = default;
 
   /// @returns A pointer to the helper probability analyzer.
   ProbabilityAnalyzerBase* prob_analyzer() { return prob_analyzer_; }
 
+  std::vector<int> occurrences() noexcept override;
+
  private:
   double p_total() noexcept override { return prob_analyzer_->p_total(); }
   const std::vector<const mef::BasicEvent*>& basic_events() noexcept override {
     return prob_analyzer_->graph()->basic_events();
   }
-  std::vector<int> occurrences() noexcept override;
+  std::vector<double> CalculateMifs() noexcept final;
 
   /// Calculator of the total probability.
   ProbabilityAnalyzerBase* prob_analyzer_;
@@ -137,14 +176,37 @@ class ImportanceAnalyzer : public ImportanceAnalyzerBase {
       : ImportanceAnalyzerBase(prob_analyzer),
         p_vars_(prob_analyzer->p_vars()) {}
 
+  double CalculateMarginalImportance(const Pdag::IndexMap<double>& p_vars,
+                                     std::vector<double>* mifs) noexcept final;
+
  private:
-  double CalculateMif(int index) noexcept override;
+  /// Calculates Marginal Importance Factor of a variable
+  /// with the current probabilities of variables.
+  ///
+  /// @param[in] index  The index of the variable.
+  ///
+  /// @returns Calculated value for MIF.
+  double CalculateMif(int index) noexcept;
+
   Pdag::IndexMap<double> p_vars_;  ///< A copy of variable probabilities.
 };
 
+template <class Calculator>
+double ImportanceAnalyzer<Calculator>::CalculateMarginalImportance(
+    const Pdag::IndexMap<double>& p_vars, std::vector<double>* mifs) noexcept {
+  p_vars_ = p_vars;
+  std::vector<int> occurrences = ImportanceAnalyzerBase::occurrences();
+  mifs->assign(occurrences.size(), 0);
+  for (int i = 0; i < occurrences.size(); ++i) {
+    if (occurrences[i])  // The variables out of products are not important.
+      (*mifs)[i] = CalculateMif(i + Pdag::kVariableStartIndex);
+  }
+  return static_cast<ProbabilityAnalyzer<Calculator>*>(prob_analyzer())
+      ->CalculateTotalProbability(p_vars_);
+}
+
 template <class Calculator>
 double ImportanceAnalyzer<Calculator>::CalculateMif(int index) noexcept {
-  index += Pdag::kVariableStartIndex;
   auto p_conditional = [index, this](bool state) {
     p_vars_[index] = state;
     return static_cast<ProbabilityAnalyzer<Calculator>*>(prob_analyzer())
@@ -156,6 +218,12 @@ double ImportanceAnalyzer<Calculator>::CalculateMif(int index) noexcept {
   return mif;
 }
 
+/// The Rare-Event approximation is linear in each variable,
+/// so all the MIFs are gathered in a single pass over the products.
+template <>
+double ImportanceAnalyzer<RareEventCalculator>::CalculateMarginalImportance(
+    const Pdag::IndexMap<double>& p_vars, std::vector<double>* mifs) noexcept;
+
 /// Specialization of importance analyzer with Binary Decision Diagrams.
 template <>
 class ImportanceAnalyzer<Bdd> : public ImportanceAnalyzerBase {
@@ -169,22 +237,31 @@ class ImportanceAnalyzer<Bdd> : public ImportanceAnalyzerBase {
       : ImportanceAnalyzerBase(prob_analyzer),
         bdd_graph_(prob_analyzer->bdd_graph()) {}
 
- private:
-  double CalculateMif(int index) noexcept override;
+  /// @copydoc ImportanceAnalyzerBase::CalculateMarginalImportance
+  ///
+  /// The MIFs are the partial derivatives of the total probability,
+  /// which are propagated from the root to all the vertices
+  /// in a single reverse sweep over the BDD.
+  double CalculateMarginalImportance(const Pdag::IndexMap<double>& p_vars,
+                                     std::vector<double>* mifs) noexcept final;
 
-  /// Calculates Marginal Importance Factor of a variable.
+  /// @copydoc ImportanceAnalyzerBase::CalculateMarginalImportances
+  ///
+  /// The MIFs are the partial derivatives
+  /// from the batched evaluation of the probability analyzer.
+  void CalculateMarginalImportances(const std::vector<double>& p_vars,
+                                    int num_points, double* p_total,
+                                    std::vector<double>* mifs) noexcept final;
+
+ private:
+  /// Collects vertices of the BDD and its modules
+  /// in the order of dependencies (children before parents).
   ///
   /// @param[in] vertex  The root vertex of a function graph.
-  /// @param[in] order  The identifying order of the variable.
   /// @param[in] mark  A flag to mark traversed vertices.
   ///
-  /// @returns Importance factor value.
-  ///
-  /// @note Probability factor fields are used to save results.
-  /// @note The graph needs cleaning its marks after this function
-  ///       because the graph gets continuously-but-partially marked.
-  double CalculateMif(const Bdd::VertexPtr& vertex, int order,
-                      bool mark) noexcept;
+  /// @note The graph needs cleaning its marks after this function.
+  void CollectVertices(const Bdd::VertexPtr& vertex, bool mark) noexcept;
 
   /// Retrieves memorized probability values for BDD function graphs.
   ///
@@ -194,6 +271,9 @@ class ImportanceAnalyzer<Bdd> : public ImportanceAnalyzerBase {
   double RetrieveProbability(const Bdd::VertexPtr& vertex) noexcept;
 
   Bdd* bdd_graph_;  ///< Binary decision diagram for the analyzer.
+  /// Vertices of the BDD in the order of dependencies.
+  /// The order is collected once and reused for every sweep.
+  std::vector<Ite*> vertices_;
 };
 
 }  // namespace scram::core
@@ -21,6 +21,8 @@
 #include "initializer.h"
 
 #include <functional>  // std::mem_fn
+#include <future>
+#include <optional>
 #include <sstream>
 #include <type_traits>
 
@@ -43,6 +45,8 @@
 #include "expression/test_event.h"
 #include "ext/algorithm.h"
 #include "ext/find_iterator.h"
+#include "ext/parallel.h"
+#include "ext/scope_guard.h"
 #include "logger.h"
 
 namespace scram::mef {
@@ -70,26 +74,23 @@ RoleSpecifier GetRole(const std::string_view& s, RoleSpecifier parent_role) {
   return s.empty() ? parent_role : GetRole(s);
 }
 
-/// Attaches attributes and a label to the elements of the analysis.
+/// Attaches attributes or a label to the elements of the analysis.
 /// These attributes are not XML attributes
 /// but the Open-PSA format defined arbitrary attributes
 /// and a label that can be attached to many analysis elements.
 ///
-/// @param[in] xml_element  XML element.
+/// @param[in] xml_child  XML 'label' or 'attributes' element.
 /// @param[out] element  The object that needs attributes and label.
 ///
 /// @throws ValidityError  Invalid attribute setting.
-void AttachLabelAndAttributes(const xml::Element& xml_element,
-                              Element* element) {
-  if (std::optional<xml::Element> label = xml_element.child("label")) {
+void AttachLabelOrAttributes(const xml::Element& xml_child, Element* element) {
+  if (xml_child.name() == "label") {
     assert(element->label().empty() && "Resetting element label.");
-    element->label(std::string(label->text()));
-  }
-
-  std::optional<xml::Element> attributes = xml_element.child("attributes");
-  if (!attributes)
+    element->label(std::string(xml_child.text()));
     return;
-  for (const xml::Element& attribute : attributes->children()) {
+  }
+  assert(xml_child.name() == "attributes");
+  for (const xml::Element& attribute : xml_child.children()) {
     assert(attribute.name() == "attribute");
     try {
       element->AddAttribute({std::string(attribute.attribute("name")),
@@ -102,6 +103,20 @@ void AttachLabelAndAttributes(const xml::Element& xml_element,
   }
 }
 
+/// Attaches attributes and a label to the elements of the analysis.
+///
+/// @param[in] xml_element  XML element.
+/// @param[out] element  The object that needs attributes and label.
+///
+/// @throws ValidityError  Invalid attribute setting.
+void AttachLabelAndAttributes(const xml::Element& xml_element,
+                              Element* element) {
+  for (const char* name : {"label", "attributes"}) {
+    if (std::optional<xml::Element> xml_child = xml_element.child(name))
+      AttachLabelOrAttributes(*xml_child, element);
+  }
+}
+
 /// Constructs Element of type T from an XML element.
 template <class T>
 std::enable_if_t<std::is_base_of_v<Element, T>, std::unique_ptr<T>>
@@ -115,7 +130,7 @@ ConstructElement(const xml::Element& xml_element) {
 /// Constructs Element of type T with a role from an XML element.
 template <class T>
 std::enable_if_t<std::is_base_of_v<Role, T>, std::unique_ptr<T>>
-ConstructElement(const xml::Element& xml_element, const std::string& base_path,
+ConstructElement(const xml::Element& xml_element, std::string_view base_path,
                  RoleSpecifier base_role) {
   auto element =
       std::make_unique<T>(std::string(xml_element.attribute("name")), base_path,
@@ -153,6 +168,20 @@ ConstructElement<Phase>(const xml::Element& xml_element) {
   return element;
 }
 
+/// Looks up the full path of a reference in the local scope.
+/// The paths that have never been interned cannot belong to any element.
+///
+/// @param[in] base_path  The non-empty base path of the local scope.
+/// @param[in] reference  The reference to an element in the scope.
+///
+/// @returns The key of the interned full path or the empty key.
+Symbol::Key FindFullPath(std::string_view base_path, std::string_view reference) {
+  std::string full_path(base_path);
+  full_path += '.';
+  full_path += reference;
+  return Symbol::Find(full_path);
+}
+
 }  // namespace
 
 Initializer::Initializer(const std::vector<std::string>& xml_files,
@@ -195,24 +224,73 @@ void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
   LOG(DEBUG1) << "Processing input files";
   CheckFileExistence(xml_files);
   CheckDuplicateFiles(xml_files);
-  for (const auto& xml_file : xml_files) {
-    CLOCK(parse_time);
-    LOG(DEBUG3) << "Parsing " << xml_file << " ...";
-    xml::Document document(xml_file, &validator);
-    if (extra_validator_)
-      extra_validator_->validate(document);
-    documents_.emplace_back(std::move(document));
-    LOG(DEBUG3) << "Parsed " << xml_file << " in " << DUR(parse_time);
-  }
-  CLOCK(def_time);
-  for (const xml::Document& document : documents_) {
+  // The files are validated concurrently ahead of their reading in order.
+  // The compiled model images are valid by construction unless corrupted,
+  // and the unchanged files recorded valid in the cache skip the validation.
+  std::optional<xml::ValidationCache> cache;
+  if (!settings_.cache_dir().empty())
+    cache.emplace(settings_.cache_dir());
+  std::vector<std::unique_ptr<xml::Validation>> validations;
+  for (const auto& xml_file : xml_files)
+    validations.push_back(
+        xml::Image::Detect(xml_file)
+            ? nullptr
+            : std::make_unique<xml::Validation>(xml_file, &validator,
+                                                cache ? &*cache : nullptr));
+  std::future<void> validation_pool =
+      std::async(std::launch::async, [&validations, this] {
+        ext::parallel_for(validations.size(), settings_.num_jobs(),
+                          [&validations](int i) {
+                            if (validations[i])
+                              validations[i]->run();
+                          });
+      });
+  SCOPE_EXIT([&validations] {
+    for (const std::unique_ptr<xml::Validation>& validation : validations) {
+      if (validation)
+        validation->cancel();
+    }
+  });
+  // The fault tree containers may hold most of the model.
+  const std::vector<std::string> containers = {
+      "define-fault-tree", "define-component", "model-data"};
+  auto process = [this](xml::Reader* reader, const std::string& file_path) {
     try {
-      ProcessInputFile(document);
+      ProcessInputFile(reader);
     } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(document.root().filename());
+      err << boost::errinfo_file_name(file_path);
       throw;
     }
+  };
+  for (std::size_t i = 0; i < xml_files.size(); ++i) {
+    const std::string& xml_file = xml_files[i];
+    CLOCK(parse_time);
+    LOG(DEBUG3) << "Reading " << xml_file << " ...";
+    if (!validations[i]) {
+      xml::Image image(xml_file);
+      if (!image.intact())
+        LOG(WARNING) << "The checksum of " << xml_file
+                     << " does not match; validating the image documents.";
+      for (int j = 0; j < image.num_documents(); ++j) {
+        if (!image.intact() || extra_validator_) {
+          xml::Document document = image.document(j);
+          if (!image.intact())
+            validator.validate(document);
+          if (extra_validator_)
+            extra_validator_->validate(document);
+        }
+        xml::Reader reader(image, j, containers);
+        process(&reader, reader.root().filename());
+      }
+    } else {
+      if (extra_validator_)
+        extra_validator_->validate(xml::Document(xml_file));
+      xml::Reader reader(xml_file, containers, validations[i].get());
+      process(&reader, xml_file);
+    }
+    LOG(DEBUG3) << "Read " << xml_file << " in " << DUR(parse_time);
   }
+  CLOCK(def_time);
   ProcessTbdElements();
   LOG(DEBUG2) << "Element definition time " << DUR(def_time);
   LOG(DEBUG1) << "Input files are processed in " << DUR(input_time);
@@ -232,6 +310,12 @@ void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
   LOG(DEBUG1) << "Setup time " << DUR(setup_time);
 }
 
+template <class T>
+void Initializer::Defer(T* element, const xml::Element& xml_node) {
+  tbd_.emplace_back(element);
+  definitions_.Append(xml_node);
+}
+
 template <class T>
 void Initializer::Register(std::unique_ptr<T> element,
                            const xml::Element& xml_element) {
@@ -247,33 +331,33 @@ void Initializer::Register(std::unique_ptr<T> element,
 /// @{
 template <>
 Gate* Initializer::Register(const xml::Element& gate_node,
-                            const std::string& base_path,
+                            std::string_view base_path,
                             RoleSpecifier container_role) {
   std::unique_ptr<Gate> ptr =
       ConstructElement<Gate>(gate_node, base_path, container_role);
   auto* gate = ptr.get();
   Register(std::move(ptr), gate_node);
   path_gates_.insert(gate);
-  tbd_.emplace_back(gate, gate_node);
+  Defer(gate, gate_node);
   return gate;
 }
 
 template <>
 BasicEvent* Initializer::Register(const xml::Element& event_node,
-                                  const std::string& base_path,
+                                  std::string_view base_path,
                                   RoleSpecifier container_role) {
   std::unique_ptr<BasicEvent> ptr =
       ConstructElement<BasicEvent>(event_node, base_path, container_role);
   auto* basic_event = ptr.get();
   Register(std::move(ptr), event_node);
   path_basic_events_.insert(basic_event);
-  tbd_.emplace_back(basic_event, event_node);
+  Defer(basic_event, event_node);
   return basic_event;
 }
 
 template <>
 HouseEvent* Initializer::Register(const xml::Element& event_node,
-                                  const std::string& base_path,
+                                  std::string_view base_path,
                                   RoleSpecifier container_role) {
   std::unique_ptr<HouseEvent> ptr =
       ConstructElement<HouseEvent>(event_node, base_path, container_role);
@@ -290,14 +374,14 @@ HouseEvent* Initializer::Register(const xml::Element& event_node,
 
 template <>
 Parameter* Initializer::Register(const xml::Element& param_node,
-                                 const std::string& base_path,
+                                 std::string_view base_path,
                                  RoleSpecifier container_role) {
   std::unique_ptr<Parameter> ptr =
       ConstructElement<Parameter>(param_node, base_path, container_role);
   auto* parameter = ptr.get();
   Register(std::move(ptr), param_node);
   path_parameters_.insert(parameter);
-  tbd_.emplace_back(parameter, param_node);
+  Defer(parameter, param_node);
 
   // Attach units.
   std::string_view unit = param_node.attribute("unit");
@@ -311,7 +395,7 @@ Parameter* Initializer::Register(const xml::Element& param_node,
 
 template <>
 CcfGroup* Initializer::Register(const xml::Element& ccf_node,
-                                const std::string& base_path,
+                                std::string_view base_path,
                                 RoleSpecifier container_role) {
   auto ptr = [&]() -> std::unique_ptr<CcfGroup> {
     std::string_view model = ccf_node.attribute("model");
@@ -332,50 +416,62 @@ CcfGroup* Initializer::Register(const xml::Element& ccf_node,
 
   ProcessCcfMembers(*ccf_node.child("members"), ccf_group);
 
-  tbd_.emplace_back(ccf_group, ccf_node);
+  Defer(ccf_group, ccf_node);
   return ccf_group;
 }
 
 template <>
 Sequence* Initializer::Register(const xml::Element& xml_node,
-                                const std::string& /*base_path*/,
+                                std::string_view /*base_path*/,
                                 RoleSpecifier /*container_role*/) {
   std::unique_ptr<Sequence> ptr = ConstructElement<Sequence>(xml_node);
   auto* sequence = ptr.get();
   Register(std::move(ptr), xml_node);
-  tbd_.emplace_back(sequence, xml_node);
+  Defer(sequence, xml_node);
   return sequence;
 }
 /// @}
 
-void Initializer::ProcessInputFile(const xml::Document& document) {
-  xml::Element root = document.root();
+void Initializer::ProcessInputFile(xml::Reader* reader) {
+  xml::Element root = reader->root();
   assert(root.name() == "opsa-mef");
+  // Only the deferred definitions outlive the stream.
+  documents_.emplace_back(root);
+  definitions_.Start(root);
 
-  if (!model_) {  // Create only one model for multiple files.
-    model_ = ConstructElement<Model>(root);
+  bool new_model = !model_;
+  if (new_model) {  // Create only one model for multiple files.
+    model_ = std::make_unique<Model>(std::string(root.attribute("name")));
     model_->mission_time().value(settings_.mission_time());
   }
 
-  for (const xml::Element& node : root.children()) {
-    if (node.name() == "define-initiating-event") {
+  while (std::optional<xml::Element> next = reader->next()) {
+    const xml::Element& node = *next;
+    if (node.name() == "label" || node.name() == "attributes") {
+      if (new_model)
+        AttachLabelOrAttributes(node, model_.get());
+
+    } else if (node.name() == "define-extern-function") {
+      documents_.back().append(node);
+
+    } else if (node.name() == "define-initiating-event") {
       std::unique_ptr<InitiatingEvent> initiating_event =
           ConstructElement<InitiatingEvent>(node);
       auto* ref_ptr = initiating_event.get();
       Register(std::move(initiating_event), node);
-      tbd_.emplace_back(ref_ptr, node);
+      Defer(ref_ptr, node);
 
     } else if (node.name() == "define-rule") {
       std::unique_ptr<Rule> rule = ConstructElement<Rule>(node);
       auto* ref_ptr = rule.get();
       Register(std::move(rule), node);
-      tbd_.emplace_back(ref_ptr, node);
+      Defer(ref_ptr, node);
 
     } else if (node.name() == "define-event-tree") {
       DefineEventTree(node);
 
     } else if (node.name() == "define-fault-tree") {
-      DefineFaultTree(node);
+      DefineFaultTree(node, reader);
 
     } else if (node.name() == "define-CCF-group") {
       Register<CcfGroup>(node, "", RoleSpecifier::kPublic);
@@ -384,17 +480,17 @@ void Initializer::ProcessInputFile(const xml::Document& document) {
       std::unique_ptr<Alignment> alignment = ConstructElement<Alignment>(node);
       auto* address = alignment.get();
       Register(std::move(alignment), node);
-      tbd_.emplace_back(address, node);
+      Defer(address, node);
 
     } else if (node.name() == "define-substitution") {
       std::unique_ptr<Substitution> substitution =
           ConstructElement<Substitution>(node);
       auto* address = substitution.get();
       Register(std::move(substitution), node);
-      tbd_.emplace_back(address, node);
+      Defer(address, node);
 
     } else if (node.name() == "model-data") {
-      ProcessModelData(node);
+      ProcessModelData(reader);
 
     } else if (node.name() == "define-extern-library") {
       if (!allow_extern_) {
@@ -429,7 +525,7 @@ void Initializer::Define(const xml::Element& event_node,
         GetExpression(*expressions.begin(), basic_event->base_path()));
   } else if (settings_.probability_analysis()) {
     SCRAM_THROW(ValidityError("The basic event does not have an expression."))
-        << errinfo_element(basic_event->id(), "basic event")
+        << errinfo_element(std::string(basic_event->id()), "basic event")
         << boost::errinfo_at_line(event_node.line());
   }
 }
@@ -603,18 +699,26 @@ void Initializer::ProcessTbdElements() {
     }
   }
 
-  for (const auto& [tbd_element, xml_element] : tbd_) {
-    try {
-      std::visit(
-          [this, &xml_element](auto* tbd_construct) {
-            this->Define(xml_element, tbd_construct);
-          },
-          tbd_element);
-    } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(xml_element.filename());
-      throw;
+  // The definitions are rebuilt one at a time in the order of the elements.
+  xml::Image definitions = definitions_.Finish();
+  auto tbd_element = tbd_.begin();
+  for (int i = 0; i < definitions.num_documents(); ++i) {
+    xml::Reader reader(definitions, i);
+    while (std::optional<xml::Element> xml_element = reader.next()) {
+      assert(tbd_element != tbd_.end() && "Missing late defined elements.");
+      try {
+        std::visit(
+            [this, &xml_element](auto* tbd_construct) {
+              this->Define(*xml_element, tbd_construct);
+            },
+            *tbd_element++);
+      } catch (ValidityError& err) {
+        err << boost::errinfo_file_name(xml_element->filename());
+        throw;
+      }
     }
   }
+  assert(tbd_element == tbd_.end() && "Missing XML definitions.");
 }
 
 void Initializer::DefineEventTree(const xml::Element& et_node) {
@@ -642,30 +746,37 @@ void Initializer::DefineEventTree(const xml::Element& et_node) {
   EventTree* tbd_element = event_tree.get();
   Register(std::move(event_tree), et_node);
   // Save only after registration.
-  tbd_.emplace_back(tbd_element, et_node);
+  Defer(tbd_element, et_node);
 }
 
-void Initializer::DefineFaultTree(const xml::Element& ft_node) {
-  std::unique_ptr<FaultTree> fault_tree = ConstructElement<FaultTree>(ft_node);
-  RegisterFaultTreeData(ft_node, fault_tree->name(), fault_tree.get());
+void Initializer::DefineFaultTree(const xml::Element& ft_node,
+                                  xml::Reader* reader) {
+  // The label and attributes come later with the streamed data.
+  auto fault_tree =
+      std::make_unique<FaultTree>(std::string(ft_node.attribute("name")));
+  RegisterFaultTreeData(reader, fault_tree->name(), fault_tree.get());
   Register(std::move(fault_tree), ft_node);
 }
 
 std::unique_ptr<Component> Initializer::DefineComponent(
-    const xml::Element& component_node, const std::string& base_path,
-    RoleSpecifier container_role) {
-  std::unique_ptr<Component> component =
-      ConstructElement<Component>(component_node, base_path, container_role);
-  RegisterFaultTreeData(component_node, base_path + "." + component->name(),
-                        component.get());
+    const xml::Element& component_node, std::string_view base_path,
+    RoleSpecifier container_role, xml::Reader* reader) {
+  auto component = std::make_unique<Component>(
+      std::string(component_node.attribute("name")), base_path,
+      GetRole(component_node.attribute("role"), container_role));
+  RegisterFaultTreeData(reader, GetFullPath(component.get()), component.get());
   return component;
 }
 
-void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
-                                        const std::string& base_path,
+void Initializer::RegisterFaultTreeData(xml::Reader* reader,
+                                        std::string_view base_path,
                                         Component* component) {
-  for (const xml::Element& node : ft_node.children()) {
-    if (node.name() == "define-basic-event") {
+  while (std::optional<xml::Element> next = reader->next()) {
+    const xml::Element& node = *next;
+    if (node.name() == "label" || node.name() == "attributes") {
+      AttachLabelOrAttributes(node, component);
+
+    } else if (node.name() == "define-basic-event") {
       component->Add(Register<BasicEvent>(node, base_path, component->role()));
 
     } else if (node.name() == "define-parameter") {
@@ -682,7 +793,7 @@ void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
 
     } else if (node.name() == "define-component") {
       std::unique_ptr<Component> sub =
-          DefineComponent(node, base_path, component->role());
+          DefineComponent(node, base_path, component->role(), reader);
       try {
         component->Add(std::move(sub));
       } catch (ValidityError& err) {
@@ -693,8 +804,9 @@ void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
   }
 }
 
-void Initializer::ProcessModelData(const xml::Element& model_data) {
-  for (const xml::Element& node : model_data.children()) {
+void Initializer::ProcessModelData(xml::Reader* reader) {
+  while (std::optional<xml::Element> next = reader->next()) {
+    const xml::Element& node = *next;
     if (node.name() == "define-basic-event") {
       Register<BasicEvent>(node, "", RoleSpecifier::kPublic);
     } else if (node.name() == "define-parameter") {
@@ -706,7 +818,7 @@ void Initializer::ProcessModelData(const xml::Element& model_data) {
 }
 
 std::unique_ptr<Formula> Initializer::GetFormula(
-    const xml::Element& formula_node, const std::string& base_path) {
+    const xml::Element& formula_node, std::string_view base_path) {
   Connective formula_type = [&formula_node]() {
     if (formula_node.has_attribute("name") || formula_node.name() == "constant")
       return kNull;
@@ -804,7 +916,7 @@ void Initializer::DefineBranchTarget(const xml::Element& target_node,
         event_tree->Add(std::move(fork));
         functional_event.usage(true);
       } catch (ValidityError& err) {
-        err << errinfo_container(event_tree->name(), "event tree");
+        err << errinfo_container(std::string(event_tree->name()), "event tree");
         throw;
       }
     } else if (target_node.name() == "sequence") {
@@ -933,7 +1045,7 @@ struct Initializer::Extractor {
   ///
   /// @pre The XML args container size equals N.
   std::unique_ptr<T> operator()(const xml::Element::Range& args,
-                                const std::string& base_path,
+                                std::string_view base_path,
                                 Initializer* init) {
     static_assert(N > 0, "The number of arguments can't be fewer than 1.");
     return (*this)(args.begin(), args.end(), base_path, init);
@@ -956,7 +1068,7 @@ struct Initializer::Extractor {
   template <class... Ts>
   std::unique_ptr<T> operator()(xml::Element::Range::iterator it,
                                 xml::Element::Range::iterator it_end,
-                                const std::string& base_path, Initializer* init,
+                                std::string_view base_path, Initializer* init,
                                 Ts&&... expressions) {
     static_assert(N >= 0);
 
@@ -985,7 +1097,7 @@ struct Initializer::Extractor<T, -1> {
   ///
   /// @returns The constructed expression.
   std::unique_ptr<T> operator()(const xml::Element::Range& args,
-                                const std::string& base_path,
+                                std::string_view base_path,
                                 Initializer* init) {
     std::vector<Expression*> expr_args;
     for (const xml::Element& node : args) {
@@ -1024,7 +1136,7 @@ constexpr std::enable_if_t<std::is_base_of_v<Expression, T>, int> num_args() {
 template <class T>
 std::unique_ptr<Expression>
 Initializer::Extract(const xml::Element::Range& args,
-                     const std::string& base_path, Initializer* init) {
+                     std::string_view base_path, Initializer* init) {
   return Extractor<T, num_args<T>()>()(args, base_path, init);
 }
 
@@ -1032,7 +1144,7 @@ Initializer::Extract(const xml::Element::Range& args,
 template <>
 std::unique_ptr<Expression>
 Initializer::Extract<Histogram>(const xml::Element::Range& args,
-                                const std::string& base_path,
+                                std::string_view base_path,
                                 Initializer* init) {
   auto it = args.begin();
   std::vector<Expression*> boundaries = {init->GetExpression(*it, base_path)};
@@ -1052,7 +1164,7 @@ Initializer::Extract<Histogram>(const xml::Element::Range& args,
 template <>
 std::unique_ptr<Expression>
 Initializer::Extract<LognormalDeviate>(const xml::Element::Range& args,
-                                       const std::string& base_path,
+                                       std::string_view base_path,
                                        Initializer* init) {
   if (args.size() == 3)
     return Extractor<LognormalDeviate, 3>()(args, base_path, init);
@@ -1063,7 +1175,7 @@ Initializer::Extract<LognormalDeviate>(const xml::Element::Range& args,
 template <>
 std::unique_ptr<Expression>
 Initializer::Extract<PeriodicTest>(const xml::Element::Range& args,
-                                   const std::string& base_path,
+                                   std::string_view base_path,
                                    Initializer* init) {
   switch (args.size()) {
     case 4:
@@ -1082,7 +1194,7 @@ Initializer::Extract<PeriodicTest>(const xml::Element::Range& args,
 template <>
 std::unique_ptr<Expression>
 Initializer::Extract<Switch>(const xml::Element::Range& args,
-                             const std::string& base_path, Initializer* init) {
+                             std::string_view base_path, Initializer* init) {
   assert(!args.empty());
   Expression* default_value = nullptr;
   std::vector<Switch::Case> cases;
@@ -1152,7 +1264,7 @@ const Initializer::ExtractorMap Initializer::kExpressionExtractors_ = {
     {"switch", &Extract<Switch>}};
 
 Expression* Initializer::GetExpression(const xml::Element& expr_element,
-                                       const std::string& base_path) {
+                                       std::string_view base_path) {
   std::string_view expr_type = expr_element.name();
   auto register_expression = [this](std::unique_ptr<Expression> expression) {
     auto* ret_ptr = expression.get();
@@ -1217,7 +1329,10 @@ Expression* Initializer::GetExpression(const xml::Element& expr_element,
     Expression* expression = register_expression(kExpressionExtractors_.at(
         expr_type)(expr_element.children(), base_path, this));
     // Register for late validation after ensuring no cycles.
-    expressions_.emplace_back(expression, expr_element);
+    auto file = filenames_.find(std::string_view(expr_element.filename()));
+    if (file == filenames_.end())
+      file = filenames_.emplace(expr_element.filename()).first;
+    expressions_.emplace_back(expression, &*file, expr_element.line());
     return expression;
   } catch (ValidityError& err) {
     err << boost::errinfo_at_line(expr_element.line());
@@ -1227,7 +1342,7 @@ Expression* Initializer::GetExpression(const xml::Element& expr_element,
 
 Expression* Initializer::GetParameter(const std::string_view& expr_type,
                                       const xml::Element& expr_element,
-                                      const std::string& base_path) {
+                                      std::string_view base_path) {
   auto check_units = [&expr_element](const auto& parameter) {
     std::string_view unit = expr_element.attribute("unit");
     const char* param_unit = scram::mef::kUnitsToString[parameter.unit()];
@@ -1289,48 +1404,50 @@ void Initializer::DefineCcfFactor(const xml::Element& factor_node,
 }
 
 Parameter* Initializer::GetParameter(std::string_view entity_reference,
-                                     const std::string& base_path) {
+                                     std::string_view base_path) {
   return GetEntity(entity_reference, base_path, model_->table<Parameter>(),
                    TableRange(path_parameters_));
 }
 
 HouseEvent* Initializer::GetHouseEvent(std::string_view entity_reference,
-                                       const std::string& base_path) {
+                                       std::string_view base_path) {
   return GetEntity(entity_reference, base_path, model_->table<HouseEvent>(),
                    TableRange(path_house_events_));
 }
 
 BasicEvent* Initializer::GetBasicEvent(std::string_view entity_reference,
-                                       const std::string& base_path) {
+                                       std::string_view base_path) {
   return GetEntity(entity_reference, base_path, model_->table<BasicEvent>(),
                    TableRange(path_basic_events_));
 }
 
 Gate* Initializer::GetGate(std::string_view entity_reference,
-                           const std::string& base_path) {
+                           std::string_view base_path) {
   return GetEntity(entity_reference, base_path, model_->table<Gate>(),
                    TableRange(path_gates_));
 }
 
 template <class P, class T>
 T* Initializer::GetEntity(std::string_view entity_reference,
-                          const std::string& base_path,
+                          std::string_view base_path,
                           const TableRange<IdTable<P>>& container,
                           const TableRange<PathTable<T>>& path_container) {
   assert(!entity_reference.empty());
   if (!base_path.empty()) {  // Check the local scope.
-    std::string full_path = base_path + ".";
-    full_path.append(entity_reference.data(), entity_reference.size());
-    if (auto it = ext::find(path_container, full_path))
+    if (auto it = ext::find(path_container,
+                            FindFullPath(base_path, entity_reference)))
       return &*it;
   }
 
-  auto at = [&entity_reference, &base_path](const auto& reference_container) {
-    if (auto it = ext::find(reference_container, entity_reference))
+  Symbol::Key reference = Symbol::Find(entity_reference);
+  auto at = [&reference, &entity_reference,
+             &base_path](const auto& reference_container) {
+    if (auto it = ext::find(reference_container, reference))
       return &*it;
     SCRAM_THROW(UndefinedElement())
         << errinfo_reference(std::string(entity_reference))
-        << errinfo_base_path(base_path) << errinfo_element_type(T::kTypeString);
+        << errinfo_base_path(std::string(base_path))
+        << errinfo_element_type(T::kTypeString);
   };
 
   if (entity_reference.find('.') == std::string_view::npos)  // Public entity.
@@ -1351,28 +1468,29 @@ T* Initializer::GetEntity(std::string_view entity_reference,
   } while (false)
 
 Formula::ArgEvent Initializer::GetEvent(std::string_view entity_reference,
-                                        const std::string& base_path) {
+                                        std::string_view base_path) {
   // Do not implement this in terms of
   // GetGate, GetBasicEvent, or GetHouseEvent.
   // The semantics for local lookup with the base type is different.
   assert(!entity_reference.empty());
   if (!base_path.empty()) {  // Check the local scope.
-    std::string full_path = base_path + ".";
-    full_path.append(entity_reference.data(), entity_reference.size());
+    Symbol::Key full_path = FindFullPath(base_path, entity_reference);
     GET_EVENT(TableRange(path_gates_), TableRange(path_basic_events_),
               TableRange(path_house_events_), full_path);
   }
 
+  Symbol::Key reference = Symbol::Find(entity_reference);
   if (entity_reference.find('.') == std::string_view::npos) {  // Public entity.
     GET_EVENT(model_->table<Gate>(), model_->table<BasicEvent>(),
-              model_->table<HouseEvent>(), entity_reference);
+              model_->table<HouseEvent>(), reference);
   } else {  // Direct access.
     GET_EVENT(TableRange(path_gates_), TableRange(path_basic_events_),
-              TableRange(path_house_events_), entity_reference);
+              TableRange(path_house_events_), reference);
   }
   SCRAM_THROW(UndefinedElement())
       << errinfo_reference(std::string(entity_reference))
-      << errinfo_base_path(base_path) << errinfo_element_type("event");
+      << errinfo_base_path(std::string(base_path))
+      << errinfo_element_type("event");
 }
 
 #undef GET_EVENT
@@ -1552,7 +1670,7 @@ void Initializer::ValidateInitialization() {
     try {
       cycle::CheckCycle<NamedBranch>(event_tree.table<NamedBranch>(), "branch");
     } catch (CycleError& err) {
-      err << errinfo_container(event_tree.name(), "event tree");
+      err << errinfo_container(std::string(event_tree.name()), "event tree");
       throw;
     }
   }
@@ -1567,7 +1685,7 @@ void Initializer::ValidateInitialization() {
       CheckFunctionalEventOrder(event_tree.initial_state());
       EnsureLinksOnlyInSequences(event_tree.initial_state());
     } catch (ValidityError& err) {
-      err << errinfo_container(event_tree.name(), "event tree");
+      err << errinfo_container(std::string(event_tree.name()), "event tree");
       throw;
     }
   }
@@ -1583,7 +1701,7 @@ void Initializer::ValidateInitialization() {
       }
       EnsureHomogeneousEventTree(event_tree.initial_state());
     } catch (ValidityError& err) {
-      err << errinfo_container(event_tree.name(), "event tree");
+      err << errinfo_container(std::string(event_tree.name()), "event tree");
       throw;
     }
   }
@@ -1605,15 +1723,16 @@ void Initializer::CheckFunctionalEventOrder(const Branch& branch) {
       if (functional_event.order() == fork->functional_event().order()) {
         assert(&functional_event == &fork->functional_event());
         SCRAM_THROW(ValidityError("Functional event " +
-                                  functional_event.name() +
+                                  std::string(functional_event.name()) +
                                   " is duplicated in event tree fork paths."));
       }
 
       if (functional_event.order() > fork->functional_event().order())
         SCRAM_THROW(ValidityError(
-            "Functional event " + functional_event.name() +
+            "Functional event " + std::string(functional_event.name()) +
             " must appear after functional event " +
-            fork->functional_event().name() + " in event tree fork paths."));
+            std::string(fork->functional_event().name()) +
+            " in event tree fork paths."));
     }
 
     const FunctionalEvent& functional_event;
@@ -1637,7 +1756,8 @@ void Initializer::CheckFunctionalEventOrder(const Branch& branch) {
 void Initializer::EnsureLinksOnlyInSequences(const Branch& branch) {
   struct Validator : public NullVisitor {
     void Visit(const Link* link) override {
-      SCRAM_THROW(ValidityError("Link " + link->event_tree().name() +
+      SCRAM_THROW(ValidityError("Link " +
+                                std::string(link->event_tree().name()) +
                                 " can only be used in end-state sequences."));
     }
   };
@@ -1729,7 +1849,7 @@ void Initializer::EnsureNoSubstitutionConflicts() {
         SCRAM_THROW(
             ValidityError("Non-declarative substitution target event should "
                           "not appear in any substitution source."))
-            << errinfo_element(origin.name(), "substitution");
+            << errinfo_element(std::string(origin.name()), "substitution");
       if (&origin == &substitution)
         continue;
       auto in_hypothesis = [&substitution](const BasicEvent* source) {
@@ -1742,12 +1862,12 @@ void Initializer::EnsureNoSubstitutionConflicts() {
         SCRAM_THROW(
             ValidityError("Non-declarative substitution target event should "
                           "not appear in another substitution hypothesis."))
-            << errinfo_element(origin.name(), "substitution");
+            << errinfo_element(std::string(origin.name()), "substitution");
       if (ext::any_of(origin.source(), in_hypothesis))
         SCRAM_THROW(
             ValidityError("Non-declarative substitution source event should "
                           "not appear in another substitution hypothesis."))
-            << errinfo_element(origin.name(), "substitution");
+            << errinfo_element(std::string(origin.name()), "substitution");
     }
   }
 }
@@ -1777,7 +1897,7 @@ void Initializer::EnsureNoCcfSubstitutions() {
   for (const Substitution& substitution : substitutions) {
     if (is_ccf(substitution))
       SCRAM_THROW(ValidityError("Non-declarative substitution '" +
-                                substitution.name() +
+                                std::string(substitution.name()) +
                                 "' events cannot be in a CCF group."));
   }
 }
@@ -1800,12 +1920,11 @@ void Initializer::ValidateExpressions() {
   cycle::CheckCycle<Parameter>(model_->table<Parameter>(), "parameter");
 
   // Validate expressions.
-  for (const std::pair<Expression*, xml::Element>& expression : expressions_) {
+  for (const auto& [expression, file, line] : expressions_) {
     try {
-      expression.first->Validate();
+      expression->Validate();
     } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(expression.second.filename())
-          << boost::errinfo_at_line(expression.second.line());
+      err << boost::errinfo_file_name(*file) << boost::errinfo_at_line(line);
       throw;
     }
   }
@@ -1819,6 +1938,36 @@ void Initializer::ValidateExpressions() {
     if (event.HasExpression())
       event.Validate();
   }
+
+  if (settings_.sensitivity_analysis())
+    ValidateSensitivity();
+}
+
+void Initializer::ValidateSensitivity() {
+  Parameter* parameter = GetParameter(settings_.sensitivity_parameter(), "");
+  std::unordered_map<const Expression*, bool> memo;
+  std::vector<const BasicEvent*> dependents;
+  for (const BasicEvent& event : model_->basic_events()) {
+    if (event.HasExpression() &&
+        DependsOn(&event.expression(), *parameter, &memo)) {
+      dependents.push_back(&event);
+    }
+  }
+  // The probabilities must stay valid over the whole sweep;
+  // the overlay narrows the parameter domain to each swept value.
+  Parameter::Overlay overlay(parameter, parameter->value());
+  for (double value : settings_.sensitivity_values()) {
+    overlay.value(value);
+    for (const BasicEvent* event : dependents) {
+      try {
+        event->Validate();
+      } catch (DomainError& err) {
+        err << errinfo_container(std::string(parameter->id()),
+                                 Parameter::kTypeString);
+        throw;
+      }
+    }
+  }
 }
 
 void Initializer::SetupForAnalysis() {
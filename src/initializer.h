@@ -22,8 +22,10 @@
 
 #include <functional>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -63,7 +65,8 @@ class Initializer : private boost::noncopyable {
   /// Initializes the analysis model from the given input files.
   /// Puts all events into their appropriate containers in the model.
   ///
-  /// @param[in] xml_files  The MEF XML input files.
+  /// @param[in] xml_files  The MEF XML input files
+  ///                       or the binary model images compiled from them.
   /// @param[in] settings  Analysis settings.
   /// @param[in] allow_extern  Allow external libraries in the input.
   /// @param[in] extra_validator  Additional XML validator to be run
@@ -88,22 +91,21 @@ class Initializer : private boost::noncopyable {
  private:
   /// Convenience alias for expression extractor function types.
   using ExtractorFunction = std::unique_ptr<Expression> (*)(
-      const xml::Element::Range&, const std::string&, Initializer*);
+      const xml::Element::Range&, std::string_view, Initializer*);
   /// Map of expression names and their extractor functions.
   using ExtractorMap = std::unordered_map<std::string_view, ExtractorFunction>;
   /// Container for late defined constructs.
   template <class... Ts>
-  using TbdContainer =
-      std::vector<std::pair<std::variant<Ts*...>, xml::Element>>;
+  using TbdContainer = std::vector<std::variant<Ts*...>>;
   /// Container with full paths to elements.
   ///
   /// @tparam T  The element type.
   template <typename T>
   using PathTable = boost::multi_index_container<
       T*, boost::multi_index::indexed_by<boost::multi_index::hashed_unique<
-              boost::multi_index::const_mem_fun<Id, std::string_view,
+              boost::multi_index::const_mem_fun<Id, const Symbol&,
                                                 &Id::full_path>,
-              std::hash<std::string_view>>>>;
+              SymbolHash, SymbolEqual>>>;
 
   /// @tparam T  Type of an expression.
   /// @tparam N  The number of arguments for the expression.
@@ -127,7 +129,7 @@ class Initializer : private boost::noncopyable {
   /// @returns The new extracted expression.
   template <class T>
   static std::unique_ptr<Expression> Extract(const xml::Element::Range& args,
-                                             const std::string& base_path,
+                                             std::string_view base_path,
                                              Initializer* init);
 
   /// Checks if all input files exist on the system.
@@ -148,6 +150,10 @@ class Initializer : private boost::noncopyable {
 
   /// @copybrief Initializer::Initializer
   ///
+  /// The files are validated against the schema concurrently
+  /// with up to the number of jobs in the settings,
+  /// but the files are read and processed one by one in the given order.
+  ///
   /// @param[in] xml_files  The formatted XML input files.
   ///
   /// @throws xml::Error  The xml files are erroneous or malformed.
@@ -164,13 +170,29 @@ class Initializer : private boost::noncopyable {
   /// but it may leave them to be defined later
   /// because of possible undefined dependencies of those elements.
   ///
-  /// @param[in] document  The XML DOM document from a model input file.
+  /// The elements are registered as soon as they are read from the stream.
+  /// Only the XML of the elements left to be defined later is kept.
+  ///
+  /// @param[in,out] reader  The stream of the model input file document.
   ///
   /// @pre The document has not been passed before.
   ///
   /// @throws ValidityError  The input model contains errors.
   /// @throws IllegalOperation  Loading external libraries is disallowed.
-  void ProcessInputFile(const xml::Document& document);
+  /// @throws xml::Error  The XML stream is erroneous or malformed.
+  void ProcessInputFile(xml::Reader* reader);
+
+  /// Saves an element to be defined
+  /// after registering all the elements in the input files.
+  /// Only a compact copy of the XML definition outlives the stream.
+  ///
+  /// @tparam T  The type of the element to be defined later.
+  ///
+  /// @param[in] element  The registered element.
+  /// @param[in] xml_node  The XML element with the definition
+  ///                      in the stream of the current input file.
+  template <class T>
+  void Defer(T* element, const xml::Element& xml_node);
 
   /// Processes definitions of elements
   /// that are left to be determined later.
@@ -202,7 +224,7 @@ class Initializer : private boost::noncopyable {
   ///
   /// @throws ValidityError  Issues with the new element or registration.
   template <class T>
-  T* Register(const xml::Element& xml_node, const std::string& base_path,
+  T* Register(const xml::Element& xml_node, std::string_view base_path,
               RoleSpecifier base_role);
 
   /// Adds additional data to element definition
@@ -227,18 +249,22 @@ class Initializer : private boost::noncopyable {
 
   /// Defines a fault tree for the analysis.
   ///
-  /// @param[in] ft_node  XML element defining the fault tree.
+  /// @param[in] ft_node  The start of the XML element
+  ///                     defining the fault tree.
+  /// @param[in,out] reader  The stream of the fault tree data.
   ///
   /// @throws ValidityError  There are issues with registering and defining
   ///                        the fault tree and its data
   ///                        like gates and events.
-  void DefineFaultTree(const xml::Element& ft_node);
+  void DefineFaultTree(const xml::Element& ft_node, xml::Reader* reader);
 
   /// Defines a component container.
   ///
-  /// @param[in] component_node  XML element defining the component.
+  /// @param[in] component_node  The start of the XML element
+  ///                            defining the component.
   /// @param[in] base_path  Series of ancestor containers in the path with dots.
   /// @param[in] container_role  The parent container's role.
+  /// @param[in,out] reader  The stream of the component data.
   ///
   /// @returns Component that is ready for registration.
   ///
@@ -246,27 +272,28 @@ class Initializer : private boost::noncopyable {
   ///                        the component and its data
   ///                        like gates and events.
   std::unique_ptr<Component> DefineComponent(const xml::Element& component_node,
-                                             const std::string& base_path,
-                                             RoleSpecifier container_role);
+                                             std::string_view base_path,
+                                             RoleSpecifier container_role,
+                                             xml::Reader* reader);
 
   /// Registers fault tree and component data
   /// like gates, events, parameters.
   ///
-  /// @param[in] ft_node  XML element defining the fault tree or component.
+  /// @param[in,out] reader  The stream of the fault tree or component data.
   /// @param[in] base_path  Series of ancestor containers in the path with dots.
   /// @param[in,out] component  The component or fault tree container
   ///                          that is the owner of the data.
   ///
   /// @throws ValidityError  There are issues with registering and defining
   ///                        the component's data like gates and events.
-  void RegisterFaultTreeData(const xml::Element& ft_node,
-                             const std::string& base_path,
+  void RegisterFaultTreeData(xml::Reader* reader,
+                             std::string_view base_path,
                              Component* component);
 
   /// Processes model data with definitions of events and analysis.
   ///
-  /// @param[in] model_data  XML node with model data description.
-  void ProcessModelData(const xml::Element& model_data);
+  /// @param[in,out] reader  The stream of the model data description.
+  void ProcessModelData(xml::Reader* reader);
 
   /// Creates a Boolean formula from the XML elements
   /// describing the formula with events and other nested formulas.
@@ -278,7 +305,7 @@ class Initializer : private boost::noncopyable {
   ///
   /// @throws ValidityError  The defined formula is not valid.
   std::unique_ptr<Formula> GetFormula(const xml::Element& formula_node,
-                                      const std::string& base_path);
+                                      std::string_view base_path);
 
   /// Processes event tree branch instructions and target from XML data.
   ///
@@ -319,7 +346,7 @@ class Initializer : private boost::noncopyable {
   ///
   /// @throws ValidityError  There are problems with getting the expression.
   Expression* GetExpression(const xml::Element& expr_element,
-                            const std::string& base_path);
+                            std::string_view base_path);
 
   /// Processes Parameter Expression definitions in input file.
   ///
@@ -333,7 +360,7 @@ class Initializer : private boost::noncopyable {
   /// @throws ValidityError  The parameter variable is not reachable.
   Expression* GetParameter(const std::string_view& expr_type,
                            const xml::Element& expr_element,
-                           const std::string& base_path);
+                           std::string_view base_path);
 
   /// Processes common cause failure group members as defined basic events.
   ///
@@ -366,15 +393,15 @@ class Initializer : private boost::noncopyable {
   /// @throws UndefinedElement  The entity cannot be found.
   /// @{
   Parameter* GetParameter(std::string_view entity_reference,
-                          const std::string& base_path);
+                          std::string_view base_path);
   HouseEvent* GetHouseEvent(std::string_view entity_reference,
-                            const std::string& base_path);
+                            std::string_view base_path);
   BasicEvent* GetBasicEvent(std::string_view entity_reference,
-                            const std::string& base_path);
+                            std::string_view base_path);
   Gate* GetGate(std::string_view entity_reference,
-                const std::string& base_path);
+                std::string_view base_path);
   Formula::ArgEvent GetEvent(std::string_view entity_reference,
-                             const std::string& base_path);
+                             std::string_view base_path);
   /// @}
 
   /// Generic helper function to find an entity from a reference.
@@ -393,7 +420,7 @@ class Initializer : private boost::noncopyable {
   ///
   /// @throws UndefinedElement  The entity cannot be found.
   template <class P, class T = typename P::element_type>
-  T* GetEntity(std::string_view entity_reference, const std::string& base_path,
+  T* GetEntity(std::string_view entity_reference, std::string_view base_path,
                const TableRange<IdTable<P>>& container,
                const TableRange<PathTable<T>>& path_container);
 
@@ -465,6 +492,13 @@ class Initializer : private boost::noncopyable {
   /// @throws ValidityError  There are problems detected with expressions.
   void ValidateExpressions();
 
+  /// Validates the parameter sweep of sensitivity analysis.
+  ///
+  /// @throws UndefinedElement  The swept parameter is not in the model.
+  /// @throws DomainError  The basic event probabilities are invalid
+  ///                      for some values of the parameter.
+  void ValidateSensitivity();
+
   /// Applies the input information to set up for future analysis.
   /// This step is crucial to get
   /// correct fault tree structures
@@ -495,9 +529,14 @@ class Initializer : private boost::noncopyable {
   bool allow_extern_;  ///< Allow processing MEF 'extern-library'.
   xml::Validator* extra_validator_;  ///< The optional extra XML validation.
 
-  /// Saved XML documents to keep elements alive.
+  /// The copies of the extern function declarations
+  /// per input file stream.
   std::vector<xml::Document> documents_;
 
+  /// The copies of the XML definitions of the late defined elements
+  /// in the same order as the elements.
+  xml::Image::Builder definitions_;
+
   /// Collection of elements that are defined late
   /// because of unordered registration and definition of their dependencies.
   ///
@@ -515,8 +554,11 @@ class Initializer : private boost::noncopyable {
                InitiatingEvent, Rule, Alignment, Substitution>
       tbd_;
 
-  /// Container of defined expressions for later validation due to cycles.
-  std::vector<std::pair<Expression*, xml::Element>> expressions_;
+  /// Container of defined expressions for later validation due to cycles
+  /// with the file names and line numbers of their XML definitions.
+  std::vector<std::tuple<Expression*, const std::string*, int>> expressions_;
+  /// The names of the input files of the XML definitions.
+  std::set<std::string, std::less<>> filenames_;
   /// Container for event tree links to check for cycles.
   std::vector<Link*> links_;
 
@@ -65,6 +65,8 @@ Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) noexcept {
       Pdag::kVariableStartIndex + graph_->basic_events().size() - 1;
   auto container = std::make_unique<zbdd::CutSetContainer>(
       kSettings_, gate.index(), kMaxVariableIndex);
+  if (kSettings_.canceled())
+    return container;  // The empty result is discarded by the risk analysis.
   container->Merge(container->ConvertGate(gate));
   while (int next_gate_index = container->GetNextGate()) {
     LOG(DEBUG5) << "Expanding gate G" << next_gate_index;
@@ -31,23 +31,24 @@ Model::Model(std::string name)
       mission_time_(std::make_unique<MissionTime>()) {}
 
 void Model::CheckDuplicateEvent(const Event& event) {
-  const std::string& id = event.id();
+  const Symbol& id = event.id_symbol();
   if (gates().count(id) || basic_events().count(id) || house_events().count(id))
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(id, "event")
-        << errinfo_container(Element::name(), kTypeString);
+        << errinfo_element(std::string(id.view()), "event")
+        << errinfo_container(std::string(Element::name()), kTypeString);
 }
 
 Formula::ArgEvent Model::GetEvent(std::string_view id) {
-  if (auto it = ext::find(table<BasicEvent>(), id))
+  Symbol::Key key = Symbol::Find(id);  // The tables are probed by the identity.
+  if (auto it = ext::find(table<BasicEvent>(), key))
     return &*it;
-  if (auto it = ext::find(table<Gate>(), id))
+  if (auto it = ext::find(table<Gate>(), key))
     return &*it;
-  if (auto it = ext::find(table<HouseEvent>(), id))
+  if (auto it = ext::find(table<HouseEvent>(), key))
     return &*it;
   SCRAM_THROW(UndefinedElement())
       << errinfo_element(std::string(id), "event")
-      << errinfo_container(Element::name(), kTypeString);
+      << errinfo_container(std::string(Element::name()), kTypeString);
 }
 
 }  // namespace scram::mef
@@ -41,8 +41,11 @@
 namespace scram::mef {
 
 /// This class represents a risk analysis model.
+/// The unused identifiers are released from the symbol pool
+/// after the destruction of the last model.
 class Model
-    : public Element,
+    : private SymbolPoolUser,
+      public Element,
       public MultiContainer<Model, InitiatingEvent, EventTree, Sequence, Rule,
                             Alignment, Substitution, FaultTree, BasicEvent,
                             Gate, HouseEvent, Parameter, CcfGroup,
@@ -68,9 +71,8 @@ class Model
   bool HasDefaultName() const { return Element::name() == kDefaultName; }
 
   /// @returns The model name or an empty string for the optional name.
-  const std::string& GetOptionalName() const {
-    static const std::string empty_name("");
-    return HasDefaultName() ? empty_name : Element::name();
+  std::string_view GetOptionalName() const {
+    return HasDefaultName() ? std::string_view() : Element::name();
   }
 
   /// Sets the optional name of the model.
@@ -24,6 +24,9 @@
 
 namespace scram::mef {
 
+thread_local MissionTime::Overlay* MissionTime::current_ = nullptr;
+thread_local Parameter::Overlay* Parameter::current_ = nullptr;
+
 MissionTime::MissionTime(double time, Units unit) : unit_(unit) { value(time); }
 
 void MissionTime::value(double time) {
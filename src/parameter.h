@@ -20,8 +20,11 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 
+#include <boost/noncopyable.hpp>
+
 #include "element.h"
 #include "expression.h"
 
@@ -51,6 +54,39 @@ const char* const kUnitsToString[] = {"unitless", "bool",    "int",   "float",
 /// The special parameter for system mission time.
 class MissionTime : public Expression {
  public:
+  /// Overrides the mission time value for the calling thread only.
+  /// Concurrent analyses can step through time
+  /// without changing the mission time observed by other threads.
+  ///
+  /// @note Overlays must be destroyed in the reverse order of construction.
+  class Overlay : private boost::noncopyable {
+   public:
+    /// @param[in] mission_time  The mission time to override.
+    explicit Overlay(const MissionTime* mission_time)
+        : mission_time_(mission_time),
+          value_(mission_time->value_),
+          previous_(current_) {
+      current_ = this;
+    }
+
+    ~Overlay() noexcept { current_ = previous_; }
+
+    /// Changes the mission time value in the calling thread.
+    ///
+    /// @param[in] time  The non-negative mission time in hours.
+    void value(double time) noexcept {
+      assert(time >= 0 && "Negative mission time.");
+      value_ = time;
+    }
+
+   private:
+    friend class MissionTime;
+
+    const MissionTime* mission_time_;  ///< The overridden mission time.
+    double value_;  ///< The value in effect in the calling thread.
+    Overlay* previous_;  ///< The enclosing overlay of the thread.
+  };
+
   /// @param[in] time  The mission time.
   /// @param[in] unit  The unit of the given ``time`` argument.
   ///
@@ -67,12 +103,20 @@ class MissionTime : public Expression {
   /// @throws LogicError  The time value is negative.
   void value(double time);
 
-  double value() noexcept override { return value_; }
-  Interval interval() noexcept override { return Interval::closed(0, value_); }
+  double value() noexcept override {
+    for (Overlay* overlay = current_; overlay; overlay = overlay->previous_) {
+      if (overlay->mission_time_ == this)
+        return overlay->value_;
+    }
+    return value_;
+  }
+  Interval interval() noexcept override { return Interval::closed(0, value()); }
   bool IsDeviate() noexcept override { return false; }
 
  private:
-  double DoSample() noexcept override { return value_; }
+  double DoSample() noexcept override { return value(); }
+
+  static thread_local Overlay* current_;  ///< The innermost overlay.
 
   Units unit_;  ///< Units of this parameter.
   double value_;  ///< The universal value to represent int, bool, double.
@@ -86,6 +130,35 @@ class Parameter : public Expression, public Id, public NodeMark, public Usage {
   /// Type string for errors.
   static constexpr const char* kTypeString = "parameter";
 
+  /// Overrides the parameter value for the calling thread only.
+  /// Parameter sweeps can evaluate the dependent expressions
+  /// without changing the model observed by other threads.
+  ///
+  /// @note Overlays must be destroyed in the reverse order of construction.
+  class Overlay : private boost::noncopyable {
+   public:
+    /// @param[in] parameter  The parameter to override.
+    /// @param[in] value  The initial value in effect in the calling thread.
+    Overlay(const Parameter* parameter, double value)
+        : parameter_(parameter), value_(value), previous_(current_) {
+      current_ = this;
+    }
+
+    ~Overlay() noexcept { current_ = previous_; }
+
+    /// Changes the parameter value in the calling thread.
+    ///
+    /// @param[in] value  The new value of the parameter.
+    void value(double value) noexcept { value_ = value; }
+
+   private:
+    friend class Parameter;
+
+    const Parameter* parameter_;  ///< The overridden parameter.
+    double value_;  ///< The value in effect in the calling thread.
+    Overlay* previous_;  ///< The enclosing overlay of the thread.
+  };
+
   using Id::Id;
 
   /// Sets the expression of this parameter.
@@ -103,11 +176,38 @@ class Parameter : public Expression, public Id, public NodeMark, public Usage {
   /// @param[in] unit  A valid unit.
   void unit(Units unit) { unit_ = unit; }
 
-  double value() noexcept override { return expression_->value(); }
-  Interval interval() noexcept override { return expression_->interval(); }
+  double value() noexcept override {
+    if (const Overlay* overlay = FindOverlay())
+      return overlay->value_;
+    return expression_->value();
+  }
+  /// @returns The overridden value as a point interval in the calling thread,
+  ///          or the domain of the parameter expression.
+  Interval interval() noexcept override {
+    if (const Overlay* overlay = FindOverlay())
+      return Interval::closed(overlay->value_, overlay->value_);
+    return expression_->interval();
+  }
 
  private:
-  double DoSample() noexcept override { return expression_->Sample(); }
+  double DoSample() noexcept override {
+    if (const Overlay* overlay = FindOverlay())
+      return overlay->value_;
+    return expression_->Sample();
+  }
+
+  /// @returns The innermost overlay of this parameter in the calling thread.
+  ///          nullptr if the parameter is not overridden.
+  const Overlay* FindOverlay() const noexcept {
+    for (const Overlay* overlay = current_; overlay;
+         overlay = overlay->previous_) {
+      if (overlay->parameter_ == this)
+        return overlay;
+    }
+    return nullptr;
+  }
+
+  static thread_local Overlay* current_;  ///< The innermost overlay.
 
   Units unit_ = kUnitless;  ///< Units of this parameter.
   Expression* expression_ = nullptr;  ///< Expression for this parameter.
@@ -483,6 +483,54 @@ Pdag::Pdag(const mef::Gate& root, bool ccf, const mef::Model* model) noexcept
   }
 }
 
+Pdag::Pdag(const std::vector<const mef::Gate*>& targets, bool ccf,
+           const mef::Model* model) noexcept
+    : Pdag() {
+  TIMER(DEBUG2, "Shared PDAG Construction");
+  ProcessedNodes nodes;
+  for (const mef::Gate* target : targets) {
+    if (nodes.gates.emplace(target, nullptr).second)
+      GatherVariables(target->formula(), ccf, &nodes);
+  }
+  if (model) {
+    for (const mef::Substitution& substitution : model->substitutions())
+      GatherVariables(substitution, ccf, &nodes);
+  }
+
+  GatePtr application;  // Declarative substitutions for every target.
+  if (model) {
+    application = std::make_shared<Gate>(kAnd, this);
+    for (const mef::Substitution& substitution : model->substitutions()) {
+      if (substitution.declarative()) {
+        application->AddArg(ConstructSubstitution(substitution, ccf, &nodes));
+      } else {
+        CollectSubstitution(substitution, &nodes);
+      }
+    }
+    if (application->args().empty()) {
+      application = nullptr;
+    } else {
+      coherent_ = false;
+    }
+  }
+
+  root_ = std::make_shared<Gate>(kOr, this);
+  for (const mef::Gate* target : targets) {
+    GatePtr& gate = nodes.gates.find(target)->second;
+    if (!gate)
+      gate = ConstructGate(target->formula(), ccf, &nodes);
+    GatePtr target_gate = gate;
+    if (application) {
+      target_gate = std::make_shared<Gate>(kAnd, this);
+      target_gate->AddArg(application);
+      target_gate->AddArg(gate);
+    }
+    if (!root_->args().count(target_gate->index()))
+      root_->AddArg(target_gate);
+    targets_.push_back(std::move(target_gate));
+  }
+}
+
 void Pdag::Print() {
   Clear<kVisit>();
   std::cerr << "\n" << this << std::endl;
@@ -861,6 +861,22 @@ class Pdag : private boost::noncopyable {
   explicit Pdag(const mef::Gate& root, bool ccf = false,
                 const mef::Model* model = nullptr) noexcept;
 
+  /// Constructs a PDAG shared by several analysis targets.
+  /// The root of the graph is an artificial OR gate of the targets.
+  ///
+  /// @param[in] targets  The top gates of the analysis targets.
+  /// @param[in] ccf  Incorporation of CCF gates and events for CCF groups.
+  /// @param[in] model  The Model containing substitutions if any.
+  ///
+  /// @post The gates of the targets are intact
+  ///       as long as the graph is not preprocessed.
+  Pdag(const std::vector<const mef::Gate*>& targets, bool ccf,
+       const mef::Model* model = nullptr) noexcept;
+
+  /// @returns The gates of the analysis targets in the order of construction
+  ///          if the graph is shared by several targets.
+  const std::vector<GatePtr>& targets() const { return targets_; }
+
   /// @returns Non-declarative substitutions to be applied by analysis.
   const std::vector<Substitution>& substitutions() const {
     return substitutions_;
@@ -1130,6 +1146,7 @@ class Pdag : private boost::noncopyable {
   bool normal_;  ///< Indication for the graph containing only OR and AND gates.
   bool register_null_gates_;  ///< Automatically register pass-through gates.
   GatePtr root_;  ///< The root gate of this graph.
+  std::vector<GatePtr> targets_;  ///< The gates of shared analysis targets.
   ConstantPtr constant_;  ///< The single constant TRUE for the whole graph.
   /// Mapping for basic events and their Variable indices.
   IndexMap<const mef::BasicEvent*> basic_events_;
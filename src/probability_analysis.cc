@@ -21,9 +21,17 @@
 
 #include "probability_analysis.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
 #include <boost/range/algorithm/find_if.hpp>
 
 #include "event.h"
+#include "expression/program.h"
+#include "ext/algorithm.h"
 #include "logger.h"
 #include "parameter.h"
 #include "settings.h"
@@ -33,7 +41,10 @@ namespace scram::core {
 
 ProbabilityAnalysis::ProbabilityAnalysis(const FaultTreeAnalysis* fta,
                                          mef::MissionTime* mission_time)
-    : Analysis(fta->settings()), p_total_(0), mission_time_(mission_time) {}
+    : Analysis(fta->settings()), p_total_(0), mission_time_(mission_time) {
+  // The fault tree analysis may be shared by phases with other mission times.
+  Analysis::settings().mission_time(mission_time->value());
+}
 
 void ProbabilityAnalysis::Analyze() noexcept {
   CLOCK(p_time);
@@ -176,6 +187,35 @@ double RareEventCalculator::Calculate(
   return sum > 1 ? 1 : sum;
 }
 
+double RareEventCalculator::Update(
+    const Zbdd& cut_sets, const Pdag::IndexMap<double>& p_vars,
+    const std::vector<std::pair<int, double>>& changes) noexcept {
+  if (cut_sets_.empty()) {  // The first call caches the contributions.
+    sum_ = 0;
+    for (const std::vector<int>& cut_set : cut_sets) {
+      for (int member : cut_set)  // The changes come by variable indices.
+        variable_cut_sets_[std::abs(member)].push_back(cut_sets_.size());
+      cut_sets_.push_back(cut_set);
+      contributions_.push_back(
+          CutSetProbabilityCalculator::Calculate(cut_set, p_vars));
+      sum_ += contributions_.back();
+    }
+  } else {
+    for (const std::pair<int, double>& change : changes) {
+      auto it = variable_cut_sets_.find(change.first);
+      if (it == variable_cut_sets_.end())
+        continue;
+      for (int position : it->second) {
+        double contribution =
+            CutSetProbabilityCalculator::Calculate(cut_sets_[position], p_vars);
+        sum_ += contribution - contributions_[position];
+        contributions_[position] = contribution;
+      }
+    }
+  }
+  return sum_ > 1 ? 1 : sum_;
+}
+
 double McubCalculator::Calculate(
     const Zbdd& cut_sets, const Pdag::IndexMap<double>& p_vars) noexcept {
   double m = 1;
@@ -191,6 +231,13 @@ void ProbabilityAnalyzerBase::ExtractVariableProbabilities() {
     p_vars_.push_back(event->p());
 }
 
+namespace {
+
+/// The number of time points evaluated together in probability curves.
+const int kTimeBatchSize = 256;
+
+}  // namespace
+
 std::vector<std::pair<double, double>>
 ProbabilityAnalyzerBase::CalculateProbabilityOverTime() noexcept {
   std::vector<std::pair<double, double>> p_time;
@@ -202,20 +249,110 @@ ProbabilityAnalyzerBase::CalculateProbabilityOverTime() noexcept {
          ProbabilityAnalysis::mission_time().value());
   double total_time = ProbabilityAnalysis::mission_time().value();
 
-  auto update = [this, &p_time](double time) {
-    mission_time().value(time);
-    auto it_p = p_vars_.begin();
-    for (const mef::BasicEvent* event : graph_->basic_events())
-      *it_p++ = event->p();
-    p_time.emplace_back(this->CalculateTotalProbability(p_vars_), time);
-  };
-
+  std::vector<double> grid;
   for (double time = 0; time < total_time; time += time_step)
-    update(time);
-  update(total_time);  // Handle cases when total_time is not divisible by step.
+    grid.push_back(time);
+  grid.push_back(total_time);  // Handle cases when not divisible by step.
+
+  // Only the events depending on the mission time change over the grid.
+  // Closed-form expressions are tabulated over the whole grid at once;
+  // the rest is re-evaluated at every time step.
+  const mef::MissionTime& time_expression =
+      ProbabilityAnalysis::mission_time();
+  std::unordered_map<const mef::Expression*, bool> memo;
+  std::vector<std::pair<int, std::vector<double>>> tabulated_events;
+  std::vector<std::pair<int, const mef::BasicEvent*>> dynamic_events;
+  int index = Pdag::kVariableStartIndex;
+  for (const mef::BasicEvent* event : graph_->basic_events()) {
+    mef::Expression* expression = &event->expression();
+    if (mef::DependsOn(expression, time_expression, &memo)) {
+      while (auto* parameter = dynamic_cast<mef::Parameter*>(expression))
+        expression = parameter->args().front();
+      std::vector<double> values;
+      if (ext::none_of(expression->args(),
+                       [&time_expression, &memo](mef::Expression* arg) {
+                         return arg != &time_expression &&
+                                mef::DependsOn(arg, time_expression, &memo);
+                       }) &&
+          expression->ValuesOverTime(time_expression, grid, &values)) {
+        tabulated_events.emplace_back(index, std::move(values));
+      } else {
+        dynamic_events.emplace_back(index, event);
+      }
+    }
+    ++index;
+  }
+  LOG(DEBUG4) << "Time-dependent events: " << tabulated_events.size()
+              << " tabulated, " << dynamic_events.size() << " dynamic";
+
+  std::vector<mef::Expression*> dynamic_expressions;
+  for (const auto& [var_index, event] : dynamic_events)
+    dynamic_expressions.push_back(&event->expression());
+  mef::ExpressionProgram program(dynamic_expressions,
+                                 mef::ExpressionProgram::Mode::kValue,
+                                 &time_expression);
+  LOG(DEBUG4) << "Compiled dynamic events into " << program.size()
+              << " instructions";
+
+  // The time steps are local to this analysis.
+  mef::MissionTime::Overlay time_overlay(&time_expression);
+  // The grid is evaluated in batches to bound the memory footprint.
+  int num_vars = p_vars_.size();
+  std::vector<double> batch;
+  std::vector<double> p_total(grid.size());
+  for (int start = 0; start < grid.size(); start += kTimeBatchSize) {
+    int num_points = std::min<int>(kTimeBatchSize, grid.size() - start);
+    batch.resize(num_vars * num_points);
+    for (int i = 0; i < num_vars; ++i) {
+      std::fill_n(batch.begin() + i * num_points, num_points,
+                  p_vars_[i + Pdag::kVariableStartIndex]);
+    }
+    for (const auto& [var_index, values] : tabulated_events) {
+      std::copy_n(values.begin() + start, num_points,
+                  batch.begin() +
+                      (var_index - Pdag::kVariableStartIndex) * num_points);
+    }
+    if (!dynamic_events.empty()) {
+      for (int j = 0; j < num_points; ++j) {
+        time_overlay.value(grid[start + j]);
+        program.Run();
+        for (int k = 0; k < dynamic_events.size(); ++k) {
+          int position = dynamic_events[k].first - Pdag::kVariableStartIndex;
+          batch[position * num_points + j] = program.result(k);
+        }
+      }
+    }
+    this->CalculateTotalProbabilities(batch, num_points, &p_total[start]);
+  }
+  for (int i = 0; i < grid.size(); ++i)
+    p_time.emplace_back(p_total[i], grid[i]);
   return p_time;
 }
 
+double ProbabilityAnalyzerBase::Update(
+    const std::vector<std::pair<int, double>>& changes) noexcept {
+  for (const std::pair<int, double>& change : changes) {
+    assert(change.first >= Pdag::kVariableStartIndex &&
+           change.first < Pdag::kVariableStartIndex + p_vars_.size() &&
+           "The index is not a graph variable.");
+    p_vars_[change.first] = change.second;
+  }
+  double p_total = this->CalculateUpdate(changes);
+  ProbabilityAnalysis::p_total(p_total);
+  return p_total;
+}
+
+void ProbabilityAnalyzerBase::CalculateTotalProbabilities(
+    const std::vector<double>& p_vars, int num_points,
+    double* p_total) noexcept {
+  Pdag::IndexMap<double> point(p_vars_.size());
+  for (int j = 0; j < num_points; ++j) {
+    for (int i = 0; i < point.size(); ++i)
+      point[i + Pdag::kVariableStartIndex] = p_vars[i * num_points + j];
+    p_total[j] = this->CalculateTotalProbability(point);
+  }
+}
+
 ProbabilityAnalyzer<Bdd>::ProbabilityAnalyzer(FaultTreeAnalyzer<Bdd>* fta,
                                               mef::MissionTime* mission_time)
     : ProbabilityAnalyzerBase(fta, mission_time), owner_(false) {
@@ -243,6 +380,193 @@ double ProbabilityAnalyzer<Bdd>::CalculateTotalProbability(
   return prob;
 }
 
+void ProbabilityAnalyzer<Bdd>::CalculateTotalProbabilities(
+    const std::vector<double>& p_vars, int num_points,
+    double* p_total) noexcept {
+  CLOCK(calc_time);
+  LOG(DEBUG4) << "Calculating " << num_points << " probabilities with BDD...";
+  std::vector<double> results;
+  EvaluateBatch(p_vars, num_points, &results);
+  const Bdd::Function& root = bdd_graph_->root();
+  const double* p_root = results.data() + batch_root_ * num_points;
+  for (int j = 0; j < num_points; ++j)
+    p_total[j] = root.complement ? 1 - p_root[j] : p_root[j];
+  LOG(DEBUG4) << "Calculated probabilities in " << DUR(calc_time);
+}
+
+void ProbabilityAnalyzer<Bdd>::CalculateDerivatives(
+    const std::vector<double>& p_vars, int num_points, double* p_total,
+    std::vector<double>* derivatives) noexcept {
+  CLOCK(calc_time);
+  LOG(DEBUG4) << "Calculating " << num_points
+              << " probability derivatives with BDD...";
+  std::vector<double> results;
+  EvaluateBatch(p_vars, num_points, &results);
+  const Bdd::Function& root = bdd_graph_->root();
+  const double* p_root = results.data() + batch_root_ * num_points;
+  for (int j = 0; j < num_points; ++j)
+    p_total[j] = root.complement ? 1 - p_root[j] : p_root[j];
+
+  // The derivatives over the slot results are accumulated
+  // from parents to children in the reverse topological order.
+  derivatives->assign(p_vars.size(), 0);
+  std::vector<double> factors(results.size());
+  std::fill_n(factors.begin() + batch_root_ * num_points, num_points,
+              root.complement ? -1 : 1);
+  for (int slot = batch_program_.size(); slot > 0; --slot) {
+    const BatchVertex& step = batch_program_[slot - 1];
+    const double* factor = factors.data() + slot * num_points;
+    const double* var = step.module ? results.data() + step.variable * num_points
+                                    : p_vars.data() + step.variable * num_points;
+    const double* high = results.data() + step.high * num_points;
+    const double* low = results.data() + step.low * num_points;
+    double* d_var = step.module ? factors.data() + step.variable * num_points
+                                : derivatives->data() +
+                                      step.variable * num_points;
+    double* d_high = factors.data() + step.high * num_points;
+    double* d_low = factors.data() + step.low * num_points;
+    double var_shift = step.module_complement ? 1 : 0;
+    double var_sign = step.module_complement ? -1 : 1;
+    double low_shift = step.complement_edge ? 1 : 0;
+    double low_sign = step.complement_edge ? -1 : 1;
+    for (int j = 0; j < num_points; ++j) {
+      double p_var = var_shift + var_sign * var[j];
+      double p_low = low_shift + low_sign * low[j];
+      d_var[j] += var_sign * factor[j] * (high[j] - p_low);
+      d_high[j] += factor[j] * p_var;
+      d_low[j] += low_sign * factor[j] * (1 - p_var);
+    }
+  }
+  LOG(DEBUG4) << "Calculated probability derivatives in " << DUR(calc_time);
+}
+
+void ProbabilityAnalyzer<Bdd>::EvaluateBatch(
+    const std::vector<double>& p_vars, int num_points,
+    std::vector<double>* results) noexcept {
+  if (batch_root_ < 0) {
+    std::unordered_map<int, int> slots;
+    batch_root_ = CompileVertex(bdd_graph_->root().vertex, &slots);
+  }
+  // All the vertex results are laid out in one buffer
+  // so that every step is a loop over contiguous rows.
+  results->assign((batch_program_.size() + 1) * num_points, 0);
+  std::fill_n(results->begin(), num_points, 1);  // The terminal vertex.
+  double* out = results->data() + num_points;
+  for (const BatchVertex& step : batch_program_) {
+    const double* var = step.module
+                            ? results->data() + step.variable * num_points
+                            : p_vars.data() + step.variable * num_points;
+    const double* high = results->data() + step.high * num_points;
+    const double* low = results->data() + step.low * num_points;
+    // Complements are folded into the coefficients to keep the loop flat.
+    double var_shift = step.module_complement ? 1 : 0;
+    double var_sign = step.module_complement ? -1 : 1;
+    double low_shift = step.complement_edge ? 1 : 0;
+    double low_sign = step.complement_edge ? -1 : 1;
+    for (int j = 0; j < num_points; ++j) {
+      double p_var = var_shift + var_sign * var[j];
+      out[j] = p_var * high[j] + (1 - p_var) * (low_shift + low_sign * low[j]);
+    }
+    out += num_points;
+  }
+}
+
+double ProbabilityAnalyzer<Bdd>::CalculateUpdate(
+    const std::vector<std::pair<int, double>>& changes) noexcept {
+  CLOCK(calc_time);
+  const Bdd::Function& root = bdd_graph_->root();
+  if (batch_root_ < 0) {
+    std::unordered_map<int, int> slots;
+    batch_root_ = CompileVertex(root.vertex, &slots);
+  }
+  const Pdag::IndexMap<double>& p_vars = ProbabilityAnalyzerBase::p_vars();
+  auto evaluate = [this, &p_vars](int slot) {
+    const BatchVertex& step = batch_program_[slot - 1];
+    double p_var = step.module ? slot_p_[step.variable]
+                               : p_vars[step.variable +
+                                        Pdag::kVariableStartIndex];
+    if (step.module_complement)
+      p_var = 1 - p_var;
+    double low = slot_p_[step.low];
+    if (step.complement_edge)
+      low = 1 - low;
+    slot_p_[slot] = p_var * slot_p_[step.high] + (1 - p_var) * low;
+  };
+
+  if (slot_p_.empty()) {  // The first update evaluates all the vertices.
+    slot_p_.resize(batch_program_.size() + 1);
+    slot_p_.front() = 1;  // The terminal vertex.
+    slot_parents_.resize(batch_program_.size() + 1);
+    variable_slots_.resize(p_vars.size());
+    for (int slot = 1; slot <= batch_program_.size(); ++slot) {
+      const BatchVertex& step = batch_program_[slot - 1];
+      if (step.module) {
+        slot_parents_[step.variable].push_back(slot);
+      } else {
+        variable_slots_[step.variable].push_back(slot);
+      }
+      slot_parents_[step.high].push_back(slot);
+      if (step.low != step.high)
+        slot_parents_[step.low].push_back(slot);
+      evaluate(slot);
+    }
+  } else {
+    // The slots are in the topological order,
+    // so the smallest dirty slot has all its arguments up-to-date.
+    std::vector<bool> dirty(slot_p_.size());
+    std::priority_queue<int, std::vector<int>, std::greater<>> queue;
+    auto mark_dirty = [&dirty, &queue](int slot) {
+      if (!dirty[slot]) {
+        dirty[slot] = true;
+        queue.push(slot);
+      }
+    };
+    for (const std::pair<int, double>& change : changes) {
+      for (int slot :
+           variable_slots_[change.first - Pdag::kVariableStartIndex])
+        mark_dirty(slot);
+    }
+    while (!queue.empty()) {
+      int slot = queue.top();
+      queue.pop();
+      evaluate(slot);
+      for (int parent : slot_parents_[slot])
+        mark_dirty(parent);
+    }
+    LOG(DEBUG4) << "Updated " << std::count(dirty.begin(), dirty.end(), true)
+                << " of "
+                << batch_program_.size() << " BDD vertices in "
+                << DUR(calc_time);
+  }
+  return root.complement ? 1 - slot_p_[batch_root_] : slot_p_[batch_root_];
+}
+
+int ProbabilityAnalyzer<Bdd>::CompileVertex(
+    const Bdd::VertexPtr& vertex,
+    std::unordered_map<int, int>* slots) noexcept {
+  if (vertex->terminal())
+    return 0;
+  if (auto it = slots->find(vertex->id()); it != slots->end())
+    return it->second;
+  Ite& ite = Ite::Ref(vertex);
+  BatchVertex step{};
+  if (ite.module()) {
+    const Bdd::Function& res = bdd_graph_->modules().find(ite.index())->second;
+    step.variable = CompileVertex(res.vertex, slots);
+    step.module = true;
+    step.module_complement = res.complement;
+  } else {
+    step.variable = ite.index() - Pdag::kVariableStartIndex;
+  }
+  step.high = CompileVertex(ite.high(), slots);
+  step.low = CompileVertex(ite.low(), slots);
+  step.complement_edge = ite.complement_edge();
+  batch_program_.push_back(step);
+  int slot = batch_program_.size();
+  slots->emplace(vertex->id(), slot);
+  return slot;
+}
+
 void ProbabilityAnalyzer<Bdd>::CreateBdd(
     const FaultTreeAnalysis& fta) noexcept {
   CLOCK(total_time);
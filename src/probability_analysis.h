@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -60,7 +61,8 @@ class ProbabilityAnalysis : public Analysis {
   /// with the results of qualitative analysis.
   ///
   /// @param[in] fta  Fault tree analysis with results.
-  /// @param[in] mission_time  The mission time expression of the model.
+  /// @param[in] mission_time  The mission time expression of the model
+  ///                          with the value in effect for the analysis.
   ///
   /// @pre The underlying fault tree must not have changed in any way
   ///      since the fault tree analysis finished.
@@ -101,6 +103,11 @@ class ProbabilityAnalysis : public Analysis {
   /// @returns The mission time expression of the model.
   mef::MissionTime& mission_time() { return *mission_time_; }
 
+  /// Resets the total probability after recalculations.
+  ///
+  /// @param[in] value  The new total probability.
+  void p_total(double value) { p_total_ = value; }
+
  private:
   /// Calculates the total probability.
   ///
@@ -162,6 +169,27 @@ class RareEventCalculator : private CutSetProbabilityCalculator {
   ///       with large probability values.
   double Calculate(const Zbdd& cut_sets,
                    const Pdag::IndexMap<double>& p_vars) noexcept;
+
+  /// Recalculates the probability after changes in some variables
+  /// by updating only the contributions of the cut sets
+  /// containing the changed variables.
+  /// The contributions are cached upon the first call.
+  ///
+  /// @param[in] cut_sets  The same cut sets as in all the previous calls.
+  /// @param[in] p_vars  Probabilities of events with the changes applied.
+  /// @param[in] changes  The indices of the changed variables.
+  ///
+  /// @returns The total probability with the rare-event approximation.
+  double Update(const Zbdd& cut_sets, const Pdag::IndexMap<double>& p_vars,
+                const std::vector<std::pair<int, double>>& changes) noexcept;
+
+ private:
+  std::vector<std::vector<int>> cut_sets_;  ///< The cached cut sets.
+  std::vector<double> contributions_;  ///< The cut set probabilities.
+  /// The positions of the cut sets containing the variables
+  /// in either polarity.
+  std::unordered_map<int, std::vector<int>> variable_cut_sets_;
+  double sum_ = 0;  ///< The sum of the contributions.
 };
 
 /// Quantitative calculator of probability values
@@ -177,6 +205,17 @@ class McubCalculator : private CutSetProbabilityCalculator {
   /// @returns The total probability with the MCUB approximation.
   double Calculate(const Zbdd& cut_sets,
                    const Pdag::IndexMap<double>& p_vars) noexcept;
+
+  /// Recalculates the probability after changes in some variables.
+  /// The MCUB product is recalculated in whole
+  /// because the factors of certain cut sets may be zero.
+  ///
+  /// @returns The total probability with the MCUB approximation.
+  double Update(
+      const Zbdd& cut_sets, const Pdag::IndexMap<double>& p_vars,
+      const std::vector<std::pair<int, double>>& /*changes*/) noexcept {
+    return Calculate(cut_sets, p_vars);
+  }
 };
 
 /// Base class for Probability analyzers.
@@ -192,7 +231,7 @@ class ProbabilityAnalyzerBase : public ProbabilityAnalysis {
                           mef::MissionTime* mission_time)
       : ProbabilityAnalysis(fta, mission_time),
         graph_(fta->graph()),
-        products_(fta->algorithm()->products()) {
+        products_(fta->zbdd()) {
     ExtractVariableProbabilities();
   }
 
@@ -205,6 +244,37 @@ class ProbabilityAnalyzerBase : public ProbabilityAnalysis {
   /// @returns A mapping for probability values with indices.
   const Pdag::IndexMap<double>& p_vars() const { return p_vars_; }
 
+  /// Recalculates the total probability
+  /// after changes in the probabilities of some variables.
+  /// Only the parts of the calculation
+  /// depending on the changed variables are redone.
+  ///
+  /// @param[in] changes  The variable indices and their new probabilities.
+  ///
+  /// @returns The new total probability.
+  ///
+  /// @pre The analysis is done.
+  ///
+  /// @post The variable probabilities and the total probability
+  ///       reflect the changes.
+  ///       The probabilities over time and the SIL are not updated.
+  double Update(const std::vector<std::pair<int, double>>& changes) noexcept;
+
+  /// Calculates the total probabilities
+  /// for a batch of variable probability sets at once.
+  ///
+  /// @param[in] p_vars  The probabilities of the graph variables
+  ///                    laid out in the order of the variable indices
+  ///                    with ``num_points`` consecutive values per variable.
+  /// @param[in] num_points  The number of probability sets in the batch.
+  /// @param[out] p_total  The destination for the total probabilities
+  ///                      of the ``num_points`` sets.
+  ///
+  /// @note The default implementation calculates the probabilities one by one.
+  virtual void CalculateTotalProbabilities(const std::vector<double>& p_vars,
+                                           int num_points,
+                                           double* p_total) noexcept;
+
  protected:
   ~ProbabilityAnalyzerBase() override = default;
 
@@ -221,6 +291,20 @@ class ProbabilityAnalyzerBase : public ProbabilityAnalysis {
   virtual double
   CalculateTotalProbability(const Pdag::IndexMap<double>& p_vars) noexcept = 0;
 
+  /// Recalculates the total probability
+  /// with the changes applied to the variable probabilities.
+  ///
+  /// @param[in] changes  The changed variables.
+  ///
+  /// @returns The total probability with the current variable probabilities.
+  ///
+  /// @note The default implementation recalculates the whole probability.
+  virtual double
+  CalculateUpdate(const std::vector<std::pair<int, double>>& changes) noexcept {
+    (void)changes;
+    return this->CalculateTotalProbability(p_vars_);
+  }
+
   double CalculateTotalProbability() noexcept final {
     return this->CalculateTotalProbability(p_vars_);
   }
@@ -258,6 +342,12 @@ class ProbabilityAnalyzer : public ProbabilityAnalyzerBase {
   }
 
  private:
+  double CalculateUpdate(
+      const std::vector<std::pair<int, double>>& changes) noexcept final {
+    return calc_.Update(ProbabilityAnalyzerBase::products(),
+                        ProbabilityAnalyzerBase::p_vars(), changes);
+  }
+
   Calculator calc_;  ///< Provider of the calculation logic.
 };
 
@@ -302,7 +392,66 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   double CalculateTotalProbability(
       const Pdag::IndexMap<double>& p_vars) noexcept final;
 
+  /// Calculates the total probabilities
+  /// together with their partial derivatives over the variable probabilities
+  /// for a batch of variable probability sets at once.
+  /// The derivatives are propagated from the root
+  /// in a single reverse pass over the batched evaluation steps.
+  ///
+  /// @param[in] p_vars  The probabilities of the graph variables
+  ///                    laid out as for CalculateTotalProbabilities.
+  /// @param[in] num_points  The number of probability sets in the batch.
+  /// @param[out] p_total  The destination for the total probabilities
+  ///                      of the ``num_points`` sets.
+  /// @param[out] derivatives  The partial derivatives
+  ///                          laid out as the variable probabilities.
+  void CalculateDerivatives(const std::vector<double>& p_vars, int num_points,
+                            double* p_total,
+                            std::vector<double>* derivatives) noexcept;
+
  private:
+  /// Evaluation step of the batched probability calculation
+  /// for a single BDD vertex.
+  /// The results of the steps are stored in slots
+  /// with the slot 0 reserved for the terminal vertex.
+  struct BatchVertex {
+    int variable;  ///< The variable position or the module result slot.
+    int high;  ///< The slot of the high branch result.
+    int low;  ///< The slot of the low branch result.
+    bool module;  ///< The variable is a module.
+    bool module_complement;  ///< The module result is complemented.
+    bool complement_edge;  ///< The low branch is complemented.
+  };
+
+  void CalculateTotalProbabilities(const std::vector<double>& p_vars,
+                                   int num_points,
+                                   double* p_total) noexcept final;
+
+  /// Evaluates the batched steps for all the vertices.
+  ///
+  /// @param[in] p_vars  The batch of variable probabilities.
+  /// @param[in] num_points  The number of probability sets in the batch.
+  /// @param[out] results  The ``num_points`` results of every slot.
+  void EvaluateBatch(const std::vector<double>& p_vars, int num_points,
+                     std::vector<double>* results) noexcept;
+
+  /// Updates the cached vertex probabilities
+  /// only for the vertices depending on the changed variables.
+  /// The dependent vertices are found through the parent links
+  /// of the batch evaluation steps
+  /// and recalculated in the topological order.
+  double CalculateUpdate(
+      const std::vector<std::pair<int, double>>& changes) noexcept final;
+
+  /// Translates the function graph into the batched evaluation steps.
+  ///
+  /// @param[in] vertex  The root vertex of a function graph.
+  /// @param[in,out] slots  The result slots of the translated vertices.
+  ///
+  /// @returns The result slot of the vertex.
+  int CompileVertex(const Bdd::VertexPtr& vertex,
+                    std::unordered_map<int, int>* slots) noexcept;
+
   /// Creates a new BDD for use by the analyzer.
   ///
   /// @param[in] fta  The fault tree analysis providing the root gate.
@@ -326,6 +475,15 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
                               const Pdag::IndexMap<double>& p_vars) noexcept;
 
   Bdd* bdd_graph_;  ///< The main BDD graph for analysis.
+  std::vector<BatchVertex> batch_program_;  ///< In topological order.
+  int batch_root_ = -1;  ///< The result slot of the root vertex.
+  /// The incremental update state of the batch evaluation steps.
+  /// @{
+  std::vector<double> slot_p_;  ///< The cached probabilities of the slots.
+  std::vector<std::vector<int>> slot_parents_;  ///< The dependent slots.
+  /// The slots of vertices with the variables at their positions.
+  std::vector<std::vector<int>> variable_slots_;
+  /// @}
   bool current_mark_;  ///< To keep track of BDD current mark.
   bool owner_;  ///< Indication that pointers are handles.
 };
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Cooperative cancellation and progress of running analyses.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+namespace scram::core {
+
+/// The channel between a running analysis and its observers.
+/// The observers request cancellation and poll the progress
+/// from any thread while the analysis is running.
+///
+/// The analysis checks the cancellation request at cheap points,
+/// e.g., between BDD/ZBDD operations, modules, targets, and trials.
+/// Once canceled, the algorithms cut their work short,
+/// and the incomplete results are discarded by the risk analysis.
+class Progress : private boost::noncopyable {
+ public:
+  /// Requests the analysis to stop as soon as possible.
+  ///
+  /// @note This function is safe to call from signal handlers.
+  void Cancel() noexcept { canceled_.store(true, std::memory_order_relaxed); }
+
+  /// @returns true if the cancellation is requested.
+  bool canceled() const noexcept {
+    return canceled_.load(std::memory_order_relaxed);
+  }
+
+  /// Starts a new stage of the analysis.
+  ///
+  /// @param[in] stage  The description of the stage.
+  /// @param[in] num_steps  The number of steps to complete the stage.
+  void Start(std::string stage, int num_steps) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stage_ = std::move(stage);
+    num_done_ = 0;
+    num_steps_ = num_steps;
+  }
+
+  /// Marks a step of the current stage complete.
+  void Advance() noexcept { ++num_done_; }
+
+  /// @returns The description of the current stage.
+  std::string stage() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stage_;
+  }
+
+  /// @returns The fraction of the completed steps of the current stage.
+  double fraction() const noexcept {
+    int num_steps = num_steps_;
+    return num_steps ? std::min(1.0, static_cast<double>(num_done_) / num_steps)
+                     : 0;
+  }
+
+ private:
+  std::atomic<bool> canceled_ = false;  ///< The cancellation request.
+  std::atomic<int> num_done_ = 0;  ///< The completed steps of the stage.
+  std::atomic<int> num_steps_ = 0;  ///< The total steps of the stage.
+  mutable std::mutex mutex_;  ///< The guard of the stage description.
+  std::string stage_;  ///< The description of the current stage.
+};
+
+}  // namespace scram::core
@@ -21,6 +21,7 @@
 #include "project.h"
 
 #include <cassert>
+#include <cmath>
 
 #include <array>
 #include <memory>
@@ -128,11 +129,20 @@ void Project::GatherOptions(const xml::Element& root) {
       } else if (name == "prime-implicants") {
         settings_.prime_implicants(true);
 
+      } else if (name == "shared-bdd") {
+        settings_.shared_bdd(true);
+
+      } else if (name == "control-variates") {
+        settings_.control_variates(true);
+
       } else if (name == "approximation") {
         settings_.approximation(option_group.attribute("name"));
 
       } else if (name == "limits") {
         SetLimits(option_group);
+
+      } else if (name == "sensitivity") {
+        SetSensitivity(option_group);
       }
     } catch (SettingsError& err) {
       err << boost::errinfo_at_line(option_group.line());
@@ -161,6 +171,8 @@ void Project::SetAnalysis(const xml::Element& analysis) {
            [this](bool flag) { settings_.importance_analysis(flag); });
   set_flag("uncertainty",
            [this](bool flag) { settings_.uncertainty_analysis(flag); });
+  set_flag("importance-uncertainty",
+           [this](bool flag) { settings_.importance_uncertainty(flag); });
   set_flag("ccf", [this](bool flag) { settings_.ccf_analysis(flag); });
   set_flag("sil",
            [this](bool flag) { settings_.safety_integrity_levels(flag); });
@@ -196,4 +208,31 @@ void Project::SetLimits(const xml::Element& limits) {
   }
 }
 
+void Project::SetSensitivity(const xml::Element& sensitivity) {
+  std::vector<double> values;
+  if (std::optional<xml::Element> range = sensitivity.child("range")) {
+    double start = *range->attribute<double>("start");
+    double end = *range->attribute<double>("end");
+    int points = *range->attribute<int>("points");
+    bool log_scale = range->attribute("scale") == "log";
+    if (log_scale && (start <= 0 || end <= 0))
+      SCRAM_THROW(SettingsError("The logarithmic range must be positive."))
+          << errinfo_value(std::to_string(start) + " " + std::to_string(end));
+    if (log_scale) {
+      start = std::log(start);
+      end = std::log(end);
+    }
+    for (int i = 0; i < points; ++i) {
+      double value = points == 1 ? start
+                                 : start + (end - start) * i / (points - 1);
+      values.push_back(log_scale ? std::exp(value) : value);
+    }
+  } else {
+    for (xml::Element value : sensitivity.children("value"))
+      values.push_back(value.text<double>());
+  }
+  std::string parameter(sensitivity.attribute("parameter"));
+  settings_.sensitivity_analysis(std::move(parameter), std::move(values));
+}
+
 }  // namespace scram
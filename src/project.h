@@ -79,6 +79,11 @@ class Project {
   /// @param[in] limits  An XML element containing various limits.
   void SetLimits(const xml::Element& limits);
 
+  /// Extracts the parameter sweep for sensitivity analysis.
+  ///
+  /// @param[in] sensitivity  The XML element with the parameter values.
+  void SetSensitivity(const xml::Element& sensitivity);
+
   /// Container for input files for analysis.
   /// These input files contain fault trees, events, etc.
   std::vector<std::string> input_files_;
@@ -20,22 +20,36 @@
 
 #include "reporter.h"
 
+#include <cassert>
+#include <cmath>
+#include <cstdio>
 #include <ctime>
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <boost/algorithm/string/join.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/exception/errinfo_errno.hpp>
 #include <boost/exception/errinfo_file_name.hpp>
 #include <boost/exception/errinfo_file_open_mode.hpp>
-#include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
 #include "ccf_group.h"
 #include "element.h"
 #include "error.h"
+#include "ext/parallel.h"
 #include "logger.h"
 #include "parameter.h"
 #include "version.h"
@@ -66,57 +80,638 @@ void PutId(const core::RiskAnalysis::Result::Id& id,
   }
 }
 
-}  // namespace
+/// @returns The version of the software.
+const char* GetVersion() {
+  return *SCRAM_GIT_REVISION != '\0' ? SCRAM_GIT_REVISION : SCRAM_VERSION;
+}
 
-void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
-                      bool indent) {
-  xml::Stream xml_stream(out, indent);
-  xml::StreamElement report = xml_stream.root("report");
-  ReportInformation(risk_an, &report);
+/// @returns The current UTC time in the ISO extended format.
+///          An empty string if the time cannot be formatted.
+std::string GetCurrentTime() {
+  std::time_t current_time = std::time(nullptr);
+  char iso_extended[20] = {};
+  auto ret = std::strftime(iso_extended, sizeof(iso_extended),
+                           "%Y-%m-%dT%H:%M:%S", std::gmtime(&current_time));
+  assert(ret && "Time formatting failure. Who is running this in year 10000?");
+  return ret ? iso_extended : "";  // The wall-clock year can be beyond 10k.
+}
 
-  if (risk_an.results().empty() && risk_an.event_tree_results().empty())
-    return;
-  TIMER(DEBUG1, "Reporting analysis results");
-  xml::StreamElement results = report.AddChild("results");
-  if (risk_an.settings().probability_analysis()) {
-    for (const core::RiskAnalysis::EtaResult& result :
-         risk_an.event_tree_results()) {
-      ReportResults(result, &results);
+/// @returns The shortest round-trip text of the number.
+std::string ToString(double value) {
+  char text[32];
+  auto [last, ec] = std::to_chars(text, text + sizeof(text), value);
+  assert(ec == std::errc());
+  return std::string(text, last);
+}
+
+/// The key-value pairs describing the analysis in compact reports.
+using Header = std::vector<std::pair<std::string, std::string>>;
+
+/// The key-value pairs identifying the analysis target in compact reports.
+using Identifiers = std::vector<std::pair<const char*, std::string_view>>;
+
+/// @returns The identifiers of the analysis target as in the XML reports.
+Identifiers GetIdentifiers(const core::RiskAnalysis::Result::Id& id) {
+  Identifiers identifiers;
+  if (const auto* gate = std::get_if<const mef::Gate*>(&id.target)) {
+    identifiers.emplace_back("name", (*gate)->id());
+  } else {
+    const auto& sequence = std::get<1>(id.target);
+    identifiers.emplace_back("initiating-event", sequence.first.name());
+    identifiers.emplace_back("name", sequence.second.name());
+  }
+  if (id.context) {
+    identifiers.emplace_back("alignment", id.context->alignment.name());
+    identifiers.emplace_back("phase", id.context->phase.name());
+  }
+  return identifiers;
+}
+
+/// The basic events in the products of a target
+/// indexed in the order of their identifiers.
+class EventDictionary {
+ public:
+  /// @param[in] products  The products of the target.
+  explicit EventDictionary(const core::ProductContainer& products)
+      : events_(products.product_events().begin(),
+                products.product_events().end()) {
+    std::sort(events_.begin(), events_.end(),
+              [](const mef::BasicEvent* lhs, const mef::BasicEvent* rhs) {
+                return lhs->id() < rhs->id();
+              });
+    for (int i = 0; i < events_.size(); ++i)
+      indices_.emplace(events_[i], i);
+  }
+
+  /// @returns The events in the dictionary order.
+  const std::vector<const mef::BasicEvent*>& events() const { return events_; }
+
+  /// @returns The dictionary index of the event in the products.
+  int index(const mef::BasicEvent& event) const {
+    return indices_.find(&event)->second;
+  }
+
+ private:
+  std::vector<const mef::BasicEvent*> events_;  ///< The sorted events.
+  std::unordered_map<const mef::BasicEvent*, int> indices_;  ///< The lookup.
+};
+
+/// @returns The string quoted as a CSV field.
+std::string QuoteCsv(std::string_view text) {
+  std::string field = "\"";
+  for (char symbol : text) {
+    if (symbol == '"')
+      field += '"';  // The quotes are doubled.
+    field += symbol;
+  }
+  return field += '"';
+}
+
+/// @returns The text escaped to fit into a single comment line.
+std::string EscapeLine(std::string_view text) {
+  std::string line;
+  for (char symbol : text) {
+    switch (symbol) {
+      case '\\':
+        line += "\\\\";
+        break;
+      case '\n':
+        line += "\\n";
+        break;
+      case '\r':
+        line += "\\r";
+        break;
+      default:
+        line += symbol;
     }
   }
+  return line;
+}
 
-  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
-    if (result.fault_tree_analysis)
-      ReportResults(result.id, *result.fault_tree_analysis,
-                    result.probability_analysis.get(), &results);
+/// @returns The string quoted as a JSON string.
+std::string QuoteJson(std::string_view text) {
+  std::string value = "\"";
+  for (char symbol : text) {
+    switch (symbol) {
+      case '"':
+        value += "\\\"";
+        break;
+      case '\\':
+        value += "\\\\";
+        break;
+      case '\n':
+        value += "\\n";
+        break;
+      case '\t':
+        value += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(symbol) < 0x20) {
+          char escape[7];
+          std::snprintf(escape, sizeof(escape), "\\u%04x", symbol);
+          value += escape;
+        } else {
+          value += symbol;
+        }
+    }
+  }
+  return value += '"';
+}
 
-    if (result.probability_analysis)
-      ReportResults(result.id, *result.probability_analysis, &results);
+/// Writes the number as a JSON value.
+/// JSON has no infinities or NaNs, which are written as null.
+void WriteJson(double value, xml::detail::FileStream* out) {
+  if (std::isfinite(value)) {
+    *out << value;
+  } else {
+    *out << "null";
+  }
+}
 
-    if (result.importance_analysis)
-      ReportResults(result.id, *result.importance_analysis, &results);
+/// Writes the products as CSV rows with the header in comment lines.
+void WriteCsv(const Header& header,
+              const std::vector<const core::RiskAnalysis::Result*>& results,
+              xml::detail::FileStream* out) {
+  for (const auto& [key, value] : header)
+    *out << "# " << EscapeLine(key) << ": " << EscapeLine(value) << '\n';
+  *out << "name,initiating-event,alignment,phase,order,probability,literals\n";
+  for (const core::RiskAnalysis::Result* result : results) {
+    Identifiers identifiers = GetIdentifiers(result->id);
+    std::string target;  // The constant leading fields of the rows.
+    for (const char* key : {"name", "initiating-event", "alignment", "phase"}) {
+      auto it = std::find_if(identifiers.begin(), identifiers.end(),
+                             [key](const auto& id) {
+                               return std::string_view(id.first) == key;
+                             });
+      if (it != identifiers.end())
+        target += QuoteCsv(it->second);
+      target += ',';
+    }
+    const core::ProductContainer& products =
+        result->fault_tree_analysis->products();
+    std::vector<std::string> literals[2];  // The regular and complement.
+    EventDictionary dictionary(products);
+    for (const mef::BasicEvent* event : dictionary.events()) {
+      std::string quoted = QuoteCsv(event->id());  // Parts of a quoted field.
+      literals[0].push_back(quoted.substr(1, quoted.size() - 2));
+      literals[1].push_back("~" + literals[0].back());
+    }
+    bool probability = result->probability_analysis != nullptr;
+    for (const core::Product& product : products) {
+      *out << target << product.order() << ',';
+      if (probability)
+        *out << product.p();
+      *out << ",\"";
+      bool first = true;
+      for (const core::Literal& literal : product) {
+        if (!first)
+          *out << ';';
+        first = false;
+        *out << literals[literal.complement][dictionary.index(literal.event)];
+      }
+      *out << "\"\n";
+    }
+  }
+}
 
-    if (result.uncertainty_analysis)
-      ReportResults(result.id, *result.uncertainty_analysis, &results);
+/// Writes the header, targets, and products as JSON objects per line.
+void WriteJsonLines(
+    const Header& header,
+    const std::vector<const core::RiskAnalysis::Result*>& results,
+    xml::detail::FileStream* out) {
+  *out << "{\"information\":{";
+  for (const auto& [key, value] : header) {
+    if (&key != &header.front().first)
+      *out << ',';
+    *out << QuoteJson(key) << ':' << QuoteJson(value);
+  }
+  *out << "}}\n";
+  for (const core::RiskAnalysis::Result* result : results) {
+    std::string target;  // The identifiers of the target in the objects.
+    for (const auto& [key, value] : GetIdentifiers(result->id))
+      target += QuoteJson(key) + ":" + QuoteJson(value) + ",";
+    const core::FaultTreeAnalysis& fta = *result->fault_tree_analysis;
+    const core::ProbabilityAnalysis* prob_analysis =
+        result->probability_analysis.get();
+    *out << "{\"sum-of-products\":{" << target
+         << "\"basic-events\":" << fta.products().product_events().size()
+         << ",\"products\":" << fta.products().size();
+    if (prob_analysis) {
+      *out << ",\"probability\":";
+      WriteJson(prob_analysis->p_total(), out);
+    }
+    *out << "}}\n";
+
+    std::vector<std::string> literals[2];  // The regular and complement.
+    EventDictionary dictionary(fta.products());
+    for (const mef::BasicEvent* event : dictionary.events()) {
+      literals[0].push_back(QuoteJson(event->id()));
+      literals[1].push_back(QuoteJson("~" + std::string(event->id())));
+    }
+    for (const core::Product& product : fta.products()) {
+      *out << "{\"product\":{" << target << "\"order\":" << product.order();
+      if (prob_analysis) {
+        *out << ",\"probability\":";
+        WriteJson(product.p(), out);
+      }
+      *out << ",\"literals\":[";
+      bool first = true;
+      for (const core::Literal& literal : product) {
+        if (!first)
+          *out << ',';
+        first = false;
+        *out << literals[literal.complement][dictionary.index(literal.event)];
+      }
+      *out << "]}}\n";
+    }
   }
 }
 
+/// Writer of the binary columnar report.
+class BinaryWriter {
+ public:
+  /// @param[out] out  The report destination.
+  explicit BinaryWriter(xml::detail::FileStream* out) : out_(*out) {}
+
+  /// Writes the number as the unsigned LEB128 varint.
+  void Varint(std::uint64_t value) {
+    char data[10];
+    int size = 0;
+    for (; value >= 0x80; value >>= 7)
+      data[size++] = static_cast<char>(value | 0x80);
+    data[size++] = static_cast<char>(value);
+    out_ << std::string_view(data, size);
+  }
+
+  /// Writes the string with its size.
+  void String(std::string_view value) {
+    Varint(value.size());
+    out_ << value;
+  }
+
+  /// Writes the binary representation of the number.
+  template <typename T>
+  void Raw(T value) {
+    out_ << std::string_view(reinterpret_cast<const char*>(&value),
+                             sizeof(value));
+  }
+
+ private:
+  xml::detail::FileStream& out_;  ///< The report destination.
+};
+
+const std::uint32_t kBinaryMagic = 0x504d4353;  ///< "SCMP" in little-endian.
+const std::int32_t kBinaryVersion = 1;  ///< Changes with the format.
+
+/// Writes the binary columnar report with the event dictionaries.
+void WriteBinary(const Header& header,
+                 const std::vector<const core::RiskAnalysis::Result*>& results,
+                 xml::detail::FileStream* out) {
+  BinaryWriter writer(out);
+  writer.Raw(kBinaryMagic);
+  writer.Raw(kBinaryVersion);
+  writer.Varint(header.size());
+  for (const auto& [key, value] : header) {
+    writer.String(key);
+    writer.String(value);
+  }
+  writer.Varint(results.size());
+  for (const core::RiskAnalysis::Result* result : results) {
+    Identifiers identifiers = GetIdentifiers(result->id);
+    writer.Varint(identifiers.size());
+    for (const auto& [key, value] : identifiers) {
+      writer.String(key);
+      writer.String(value);
+    }
+    const core::ProductContainer& products =
+        result->fault_tree_analysis->products();
+    EventDictionary dictionary(products);
+    writer.Varint(dictionary.events().size());
+    for (const mef::BasicEvent* event : dictionary.events())
+      writer.String(event->id());
+    writer.Varint(products.size());
+    for (const core::Product& product : products) {
+      writer.Varint(product.size());
+      for (const core::Literal& literal : product)
+        writer.Varint(2 * dictionary.index(literal.event) + literal.complement);
+    }
+    bool probability = result->probability_analysis != nullptr;
+    writer.Raw<std::uint8_t>(probability);
+    if (probability) {
+      for (const core::Product& product : products)
+        writer.Raw(product.p());
+    }
+  }
+}
+
+}  // namespace
+
+struct Reporter::Prerendered {
+  const core::RiskAnalysis& risk_an;  ///< The analysis with the results.
+  const bool indent;  ///< The indentation of the fragments.
+  std::mutex mutex;  ///< The guard of the fragments from the analysis jobs.
+  /// The rendered results by their positions in the analysis results.
+  std::unordered_map<int, std::unique_ptr<xml::Fragment>> fragments;
+};
+
+core::RiskAnalysis::Observer Reporter::Prerender(
+    const core::RiskAnalysis& risk_an, bool indent) {
+  prerendered_.reset();
+  if (format_ != ReportFormat::kXml || risk_an.settings().num_jobs() < 2)
+    return nullptr;
+  prerendered_.reset(new Prerendered{risk_an, indent});
+  return [this, prerendered = prerendered_](int index) noexcept {
+    try {
+      // The results are the children of <report><results>.
+      auto fragment = std::make_unique<xml::Fragment>(1, prerendered->indent);
+      ReportResults(prerendered->risk_an.results()[index], &fragment->root());
+      std::lock_guard<std::mutex> lock(prerendered->mutex);
+      prerendered->fragments[index] = std::move(fragment);
+    } catch (...) {
+      // The failed results are rendered again into the report.
+    }
+  };
+}
+
+void Reporter::CheckSettings(const core::Settings& settings) const {
+  if (format_ == ReportFormat::kXml)
+    return;
+  const char* results = nullptr;
+  if (settings.importance_analysis()) {
+    results = "importance analysis";
+  } else if (settings.uncertainty_analysis()) {
+    results = "uncertainty analysis";
+  } else if (settings.sensitivity_analysis()) {
+    results = "sensitivity analysis";
+  } else if (settings.safety_integrity_levels()) {
+    results = "safety integrity levels";
+  } else if (settings.probability_analysis() && settings.time_step()) {
+    results = "probability curve";
+  }
+  if (results) {
+    SCRAM_THROW(SettingsError(
+        std::string("The ") + kReportFormatToString[static_cast<int>(format_)] +
+        " report format has no place for the " + results +
+        " results; use the XML report format."));
+  }
+}
+
+void Reporter::CheckResults(const core::RiskAnalysis& risk_an) const {
+  CheckSettings(risk_an.settings());
+  if (format_ != ReportFormat::kXml &&
+      risk_an.settings().probability_analysis() &&
+      !risk_an.event_tree_results().empty()) {
+    SCRAM_THROW(SettingsError(
+        std::string("The ") + kReportFormatToString[static_cast<int>(format_)] +
+        " report format has no place for the event tree analysis results;"
+        " use the XML report format."));
+  }
+}
+
+void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
+                      bool indent) {
+  CheckResults(risk_an);
+  Write(risk_an, out, indent);
+}
+
 void Reporter::Report(const core::RiskAnalysis& risk_an,
                       const std::string& file, bool indent) {
-  std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
-      std::fopen(file.c_str(), "w"), &std::fclose);
+  CheckResults(risk_an);  // No file is written for the unfit results.
+  if (boost::ends_with(file, ".zst")) {
+    ReportZstd(risk_an, file, indent);
+    return;
+  }
+  if (!boost::ends_with(file, ".gz")) {
+    const char* mode = format_ == ReportFormat::kBinary ? "wb" : "w";
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(file.c_str(), mode), &std::fclose);
+    try {
+      if (!fp) {
+        SCRAM_THROW(IOError("Cannot open the output file for report."))
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_file_open_mode(mode);
+      }
+      Report(risk_an, fp.get(), indent);
+    } catch (IOError& err) {
+      err << boost::errinfo_file_name(file);
+      throw;
+    }
+    return;
+  }
+  std::unique_ptr<gzFile_s, decltype(&gzclose)> gz(gzopen(file.c_str(), "wb"),
+                                                   &gzclose);
+  try {
+    if (!gz) {
+      SCRAM_THROW(IOError("Cannot open the output file for report."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("wb");
+    }
+    Write(risk_an, gz.get(), indent);
+    if (gzclose(gz.release()) != Z_OK) {  // The remaining data is compressed.
+      SCRAM_THROW(IOError("Cannot write the compressed report."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("wb");
+    }
+  } catch (IOError& err) {
+    err << boost::errinfo_file_name(file);
+    throw;
+  }
+}
+
+void Reporter::ReportZstd(const core::RiskAnalysis& risk_an,
+                          const std::string& file, bool indent) {
   try {
+#ifdef SCRAM_WITH_ZSTD
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(file.c_str(), "wb"), &std::fclose);
     if (!fp) {
       SCRAM_THROW(IOError("Cannot open the output file for report."))
-          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("w");
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("wb");
+    }
+    xml::ZstdFile zstd_file(fp.get());
+    Write(risk_an, &zstd_file, indent);
+    if (int err = zstd_file.close()) {  // The remaining data is compressed.
+      SCRAM_THROW(IOError("Cannot write the compressed report."))
+          << boost::errinfo_errno(err) << boost::errinfo_file_open_mode("wb");
     }
-    Report(risk_an, fp.get(), indent);
+#else
+    (void)risk_an;
+    (void)indent;
+    SCRAM_THROW(IOError("The zstd compression is not supported in this build."))
+        << boost::errinfo_file_open_mode("wb");
+#endif
   } catch (IOError& err) {
     err << boost::errinfo_file_name(file);
     throw;
   }
 }
 
+template <typename T>
+void Reporter::Write(const core::RiskAnalysis& risk_an, T out, bool indent) {
+  if (format_ == ReportFormat::kXml) {
+    xml::Stream xml_stream(out, indent);
+    Report(risk_an, &xml_stream, indent);
+    return;
+  }
+  xml::detail::FileStream stream(out);
+  ReportProducts(risk_an, &stream);
+  if (int err = stream.error())
+    SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
+}
+
+void Reporter::Report(const core::RiskAnalysis& risk_an,
+                      xml::Stream* xml_stream, bool indent) {
+  xml::StreamElement report = xml_stream->root("report");
+  ReportInformation(risk_an, &report);
+
+  if (risk_an.results().empty() && risk_an.event_tree_results().empty())
+    return;
+  TIMER(DEBUG1, "Reporting analysis results");
+  xml::StreamElement results = report.AddChild("results");
+  int num_eta_results = risk_an.settings().probability_analysis()
+                            ? risk_an.event_tree_results().size()
+                            : 0;
+  int num_results = num_eta_results + risk_an.results().size();
+  auto report_result = [this, &risk_an, num_eta_results](
+                           int index, xml::StreamElement* parent) {
+    if (index < num_eta_results) {
+      ReportResults(risk_an.event_tree_results()[index], parent);
+    } else {
+      ReportResults(risk_an.results()[index - num_eta_results], parent);
+    }
+  };
+  std::shared_ptr<Prerendered> prerendered;
+  if (prerendered_ && &prerendered_->risk_an == &risk_an &&
+      prerendered_->indent == indent)
+    prerendered = prerendered_;
+  // The results rendered ahead are taken once.
+  auto take_fragment = [&prerendered, num_eta_results](int index) {
+    std::unique_ptr<xml::Fragment> fragment;
+    if (!prerendered || index < num_eta_results)
+      return fragment;
+    std::lock_guard<std::mutex> lock(prerendered->mutex);
+    auto it = prerendered->fragments.find(index - num_eta_results);
+    if (it != prerendered->fragments.end()) {
+      fragment = std::move(it->second);
+      prerendered->fragments.erase(it);
+    }
+    return fragment;
+  };
+  int num_jobs = std::min(risk_an.settings().num_jobs(), num_results);
+  if (num_jobs > 1) {
+    auto render = [&take_fragment, &report_result, &results](int index) {
+      std::unique_ptr<xml::Fragment> fragment = take_fragment(index);
+      if (!fragment) {
+        fragment = std::make_unique<xml::Fragment>(results);
+        report_result(index, &fragment->root());
+      }
+      return fragment;
+    };
+    ReportConcurrently(num_results, num_jobs, render, &results);
+  } else {
+    for (int i = 0; i < num_results; ++i) {
+      if (std::unique_ptr<xml::Fragment> fragment = take_fragment(i)) {
+        results.AddFragment(*fragment);
+      } else {
+        report_result(i, &results);
+      }
+    }
+  }
+}
+
+template <typename F>
+void Reporter::ReportConcurrently(int num_results, int num_jobs, F&& render,
+                                  xml::StreamElement* results) {
+  // The rendering runs ahead of the writing by a bounded number of fragments
+  // to keep the memory of the finished fragments in check.
+  // The fragments are dispatched in the index order,
+  // so the fragment awaited by the writer is never blocked.
+  const int kMaxAhead = 2 * num_jobs;
+  std::vector<std::unique_ptr<xml::Fragment>> fragments(num_results);
+  std::vector<std::exception_ptr> errors(num_results);
+  std::vector<char> rendered(num_results, false);
+  int num_written = 0;
+  std::atomic<bool> failed = false;
+  std::mutex mutex;
+  std::condition_variable progress;
+
+  std::thread renderer([&] {
+    ext::parallel_for(num_results, num_jobs, [&](int index) noexcept {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        progress.wait(lock, [&] { return index < num_written + kMaxAhead; });
+      }
+      std::unique_ptr<xml::Fragment> fragment;
+      std::exception_ptr error;
+      if (!failed) {
+        try {
+          fragment = render(index);
+        } catch (...) {
+          fragment.reset();
+          error = std::current_exception();
+          failed = true;
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        fragments[index] = std::move(fragment);
+        errors[index] = error;
+        rendered[index] = true;
+      }
+      progress.notify_all();
+    });
+  });
+
+  std::exception_ptr error;
+  for (int i = 0; i < num_results && !error; ++i) {
+    std::unique_ptr<xml::Fragment> fragment;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      progress.wait(lock, [&] { return rendered[i]; });
+      fragment = std::move(fragments[i]);
+      error = errors[i];
+    }
+    if (!error) {
+      try {
+        results->AddFragment(*fragment);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    if (error)
+      failed = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      num_written = error ? num_results : i + 1;
+    }
+    progress.notify_all();
+  }
+  renderer.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void Reporter::ReportResults(const core::RiskAnalysis::Result& result,
+                             xml::StreamElement* results) {
+  if (result.fault_tree_analysis)
+    ReportResults(result.id, *result.fault_tree_analysis,
+                  result.probability_analysis.get(), results);
+
+  if (result.probability_analysis)
+    ReportResults(result.id, *result.probability_analysis, results);
+
+  if (result.importance_analysis)
+    ReportResults(result.id, *result.importance_analysis, results);
+
+  if (result.uncertainty_analysis) {
+    ReportResults(result.id, *result.uncertainty_analysis, results);
+    if (!result.uncertainty_analysis->importance().empty())
+      ReportResults(result.id, result.uncertainty_analysis->importance(),
+                    results);
+  }
+
+  if (result.sensitivity_analysis)
+    ReportResults(result.id, *result.sensitivity_analysis, results);
+}
+
 /// Describes the fault tree analysis and techniques.
 template <>
 void Reporter::ReportCalculatedQuantity<core::FaultTreeAnalysis>(
@@ -210,6 +805,16 @@ void Reporter::ReportCalculatedQuantity<core::UncertaintyAnalysis>(
   }
 }
 
+/// Describes the sensitivity analysis over the parameter values.
+template <>
+void Reporter::ReportCalculatedQuantity<core::SensitivityAnalysis>(
+    const core::Settings& /*settings*/, xml::StreamElement* information) {
+  information->AddChild("calculated-quantity")
+      .SetAttribute("name", "Sensitivity Analysis")
+      .SetAttribute("definition",
+                    "Quantitative analysis over the values of a parameter.");
+}
+
 /// Describes all performed analyses deduced from settings.
 template <>
 void Reporter::ReportCalculatedQuantity<core::RiskAnalysis>(
@@ -230,6 +835,9 @@ void Reporter::ReportCalculatedQuantity<core::RiskAnalysis>(
   if (settings.uncertainty_analysis()) {
     ReportCalculatedQuantity<core::UncertaintyAnalysis>(settings, information);
   }
+  if (settings.sensitivity_analysis()) {
+    ReportCalculatedQuantity<core::SensitivityAnalysis>(settings, information);
+  }
 }
 
 void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
@@ -239,6 +847,8 @@ void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
   ReportPerformance(risk_an, &information);
   ReportCalculatedQuantity(risk_an.settings(), &information);
   ReportModelFeatures(risk_an.model(), &information);
+  if (!risk_an.warnings().empty())
+    information.AddChild("warning").AddText(risk_an.warnings());
   ReportUnusedElements(risk_an.model().basic_events(),
                        "Unused basic events: ", &information);
   ReportUnusedElements(risk_an.model().house_events(),
@@ -257,7 +867,8 @@ void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
                        "Unused sequences: ", &information);
   ReportUnusedElements(risk_an.model().rules(), "Unused rules: ", &information);
   for (const mef::EventTree& event_tree : risk_an.model().event_trees()) {
-    std::string header = "In event tree " + event_tree.name() + ", ";
+    std::string header =
+        "In event tree " + std::string(event_tree.name()) + ", ";
     ReportUnusedElements(event_tree.branches(),
                          header + "unused branches: ", &information);
     ReportUnusedElements(event_tree.functional_events(),
@@ -268,17 +879,12 @@ void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
 void Reporter::ReportSoftwareInformation(xml::StreamElement* information) {
   information->AddChild("software")
       .SetAttribute("name", "SCRAM")
-      .SetAttribute("version", *SCRAM_GIT_REVISION != '\0' ? SCRAM_GIT_REVISION
-                                                           : SCRAM_VERSION)
+      .SetAttribute("version", GetVersion())
       .SetAttribute("contacts", "https://github.com/Murmele/scram");
 
-  std::time_t current_time = std::time(nullptr);
-  char iso_extended[20] = {};
-  auto ret = std::strftime(iso_extended, sizeof(iso_extended),
-                           "%Y-%m-%dT%H:%M:%S", std::gmtime(&current_time));
-  assert(ret && "Time formatting failure. Who is running this in year 10000?");
-  if (ret)  // The user can set the wall-clock year beyond 10k.
-    information->AddChild("time").AddText(iso_extended);
+  std::string time = GetCurrentTime();
+  if (!time.empty())
+    information->AddChild("time").AddText(time);
 }
 
 void Reporter::ReportModelFeatures(const mef::Model& model,
@@ -333,6 +939,10 @@ void Reporter::ReportPerformance(const core::RiskAnalysis& risk_an,
     if (result.uncertainty_analysis)
       calc_time.AddChild("uncertainty")
           .AddText(result.uncertainty_analysis->analysis_time());
+
+    if (result.sensitivity_analysis)
+      calc_time.AddChild("sensitivity")
+          .AddText(result.sensitivity_analysis->analysis_time());
   }
 }
 
@@ -340,13 +950,14 @@ template <class T>
 void Reporter::ReportUnusedElements(const T& container,
                                     const std::string& header,
                                     xml::StreamElement* information) {
-  std::string out = boost::join(
-      container | boost::adaptors::filtered([](const auto& arg) {
-        return !arg.usage();
-      }) | boost::adaptors::transformed([](const auto& arg) -> decltype(auto) {
-        return mef::Id::unique_name(arg);
-      }),
-      " ");
+  std::string out;
+  for (const auto& arg : container) {
+    if (arg.usage())
+      continue;
+    if (!out.empty())
+      out += ' ';
+    out += mef::Id::unique_name(arg);
+  }
   if (!out.empty())
     information->AddChild("warning").AddText(header + out);
 }
@@ -407,6 +1018,12 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
     for (const core::Product& product_set : fta.products())
       sum += product_set.p();
   }
+  // The names are escaped only once for all their occurrences in products.
+  std::unordered_map<const mef::BasicEvent*, xml::EscapedText> names;
+  for (const mef::BasicEvent* event : fta.products().product_events()) {
+    if (!dynamic_cast<const mef::CcfEvent*>(event))
+      names.emplace(event, event->id());
+  }
   for (const core::Product& product_set : fta.products()) {
     xml::StreamElement product = sum_of_products.AddChild("product");
     product.SetAttribute("order", product_set.order());
@@ -417,7 +1034,7 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
         product.SetAttribute("contribution", prob / sum);
     }
     for (const core::Literal& literal : product_set) {
-      ReportLiteral(literal, &product);
+      ReportLiteral(literal, names, &product);
     }
   }
 }
@@ -513,6 +1130,11 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
   measure.AddChild("error-factor")
       .SetAttribute("percentage", "95")
       .SetAttribute("value", uncert_analysis.error_factor());
+  if (uncert_analysis.variance_reduction()) {
+    measure.AddChild("control-variate")
+        .SetAttribute("variance-reduction",
+                      *uncert_analysis.variance_reduction());
+  }
   {
     xml::StreamElement quantiles = measure.AddChild("quantiles");
     int num_quantiles = uncert_analysis.quantiles().size();
@@ -547,14 +1169,87 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
   }
 }
 
-void Reporter::ReportLiteral(const core::Literal& literal,
-                             xml::StreamElement* parent) {
-  auto add_data = [](xml::StreamElement* /*element*/) {};
+void Reporter::ReportResults(
+    const core::RiskAnalysis::Result::Id& id,
+    const std::vector<core::ImportanceDistribution>& importance,
+    xml::StreamElement* results) {
+  xml::StreamElement element = results->AddChild("importance-uncertainty");
+  scram::PutId(id, &element);
+  element.SetAttribute("basic-events", importance.size())
+      .SetAttribute("percentage", "90");
+
+  for (const core::ImportanceDistribution& entry : importance) {
+    auto add_data = [&entry](xml::StreamElement* parent) {
+      auto add_factor = [parent](const char* name,
+                                 const core::FactorStatistics& factor) {
+        parent->AddChild("factor")
+            .SetAttribute("name", name)
+            .SetAttribute("mean", factor.mean)
+            .SetAttribute("lower-bound", factor.lower)
+            .SetAttribute("median", factor.median)
+            .SetAttribute("upper-bound", factor.upper);
+      };
+      add_factor("MIF", entry.mif);
+      add_factor("CIF", entry.cif);
+      add_factor("DIF", entry.dif);
+      add_factor("RAW", entry.raw);
+      add_factor("RRW", entry.rrw);
+    };
+    ReportBasicEvent(entry.event, &element, add_data);
+  }
+}
+
+void Reporter::ReportResults(
+    const core::RiskAnalysis::Result::Id& id,
+    const core::SensitivityAnalysis& sensitivity_analysis,
+    xml::StreamElement* results) {
+  xml::StreamElement sensitivity = results->AddChild("sensitivity");
+  scram::PutId(id, &sensitivity);
+  if (!sensitivity_analysis.warnings().empty()) {
+    sensitivity.SetAttribute("warning", sensitivity_analysis.warnings());
+  }
+  sensitivity.SetAttribute("parameter", sensitivity_analysis.parameter().id())
+      .SetAttribute("points", sensitivity_analysis.points().size());
+
+  for (const core::SensitivityPoint& point : sensitivity_analysis.points()) {
+    xml::StreamElement element = sensitivity.AddChild("point");
+    element.SetAttribute("value", point.value)
+        .SetAttribute("probability", point.p_total);
+    for (int i = 0; i < point.importance.size(); ++i) {
+      const core::ImportanceFactors& factors = point.importance[i];
+      double p_event = point.p_events[i];
+      auto add_data = [&factors, p_event](xml::StreamElement* event) {
+        event->SetAttribute("occurrence", factors.occurrence)
+            .SetAttribute("probability", p_event)
+            .SetAttribute("MIF", factors.mif)
+            .SetAttribute("CIF", factors.cif)
+            .SetAttribute("DIF", factors.dif)
+            .SetAttribute("RAW", factors.raw)
+            .SetAttribute("RRW", factors.rrw);
+      };
+      ReportBasicEvent(*sensitivity_analysis.events()[i], &element, add_data);
+    }
+  }
+}
+
+void Reporter::ReportLiteral(
+    const core::Literal& literal,
+    const std::unordered_map<const mef::BasicEvent*, xml::EscapedText>& names,
+    xml::StreamElement* parent) {
+  auto report = [this, &literal, &names](xml::StreamElement* element) {
+    auto it = names.find(&literal.event);
+    if (it != names.end()) {
+      element->AddChild("basic-event").SetAttribute("name", it->second);
+    } else {
+      ReportBasicEvent(literal.event, element,
+                       [](xml::StreamElement* /*element*/) {});
+    }
+  };
   if (literal.complement) {
     xml::StreamElement not_parent = parent->AddChild("not");
-    ReportBasicEvent(literal.event, &not_parent, add_data);
+    report(&not_parent);
   } else {
-    ReportBasicEvent(literal.event, parent, add_data);
+    report(parent);
   }
 }
 
@@ -579,4 +1274,67 @@ void Reporter::ReportBasicEvent(const mef::BasicEvent& basic_event,
   }
 }
 
+void Reporter::ReportProducts(const core::RiskAnalysis& risk_an,
+                              xml::detail::FileStream* out) {
+  TIMER(DEBUG1, "Reporting analysis products");
+  const core::Settings& settings = risk_an.settings();
+  Header header = {{"software", "SCRAM"}, {"version", GetVersion()}};
+  if (std::string time = GetCurrentTime(); !time.empty())
+    header.emplace_back("time", time);
+  if (!risk_an.model().HasDefaultName())
+    header.emplace_back("model", risk_an.model().name());
+  header.emplace_back("calculated-quantity", settings.prime_implicants()
+                                                 ? "Prime Implicants"
+                                                 : "Minimal Cut Sets");
+  header.emplace_back(
+      "algorithm",
+      core::kAlgorithmToString[static_cast<int>(settings.algorithm())]);
+  header.emplace_back("limit-order", std::to_string(settings.limit_order()));
+  if (settings.probability_analysis()) {
+    header.emplace_back("approximation",
+                        core::kApproximationToString[static_cast<int>(
+                            settings.approximation())]);
+    header.emplace_back("mission-time", ToString(settings.mission_time()));
+  }
+  if (!risk_an.warnings().empty())
+    header.emplace_back("warning", risk_an.warnings());
+
+  std::vector<const core::RiskAnalysis::Result*> results;
+  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
+    if (!result.fault_tree_analysis)
+      continue;
+    results.push_back(&result);
+    std::string target;  // The unique key of the target performance.
+    for (const auto& identifier : GetIdentifiers(result.id))
+      target += (target.empty() ? "" : "/") + std::string(identifier.second);
+    header.emplace_back("products-time:" + target,
+                        ToString(result.fault_tree_analysis->analysis_time()));
+    std::string warning = result.fault_tree_analysis->warnings();
+    if (result.probability_analysis) {
+      header.emplace_back(
+          "probability-time:" + target,
+          ToString(result.probability_analysis->analysis_time()));
+      if (!result.probability_analysis->warnings().empty())
+        warning += (warning.empty() ? "" : "; ") +
+                   result.probability_analysis->warnings();
+    }
+    if (!warning.empty())
+      header.emplace_back("warning:" + target, std::move(warning));
+  }
+
+  switch (format_) {
+    case ReportFormat::kBinary:
+      WriteBinary(header, results, out);
+      break;
+    case ReportFormat::kCsv:
+      WriteCsv(header, results, out);
+      break;
+    case ReportFormat::kJsonLines:
+      WriteJsonLines(header, results, out);
+      break;
+    case ReportFormat::kXml:
+      assert(false && "The XML report is not compact.");
+  }
+}
+
 }  // namespace scram
@@ -20,9 +20,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstdio>
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "event.h"
 #include "fault_tree_analysis.h"
@@ -30,17 +34,83 @@
 #include "model.h"
 #include "probability_analysis.h"
 #include "risk_analysis.h"
+#include "sensitivity_analysis.h"
 #include "settings.h"
 #include "uncertainty_analysis.h"
 #include "xml_stream.h"
 
 namespace scram {
 
+/// The formats of the analysis reports.
+///
+/// The XML report is the complete document with all the analysis results.
+/// The other formats are compact reports of the products and probabilities
+/// for bulk loading of large results;
+/// the analysis information, warnings, and performance are mapped
+/// into a small header of key-value pairs.
+/// The analyses with other results require the XML report.
+///
+/// The CSV report puts the header into "# key: value" comment lines,
+/// where the backslashes, newlines, and carriage returns are escaped
+/// as "\\", "\n", and "\r",
+/// followed by a row per product with the target identifiers,
+/// the product order, the probability,
+/// and the ';'-separated literals, where '~' marks the complement.
+///
+/// The JSON-lines report has the header object on the first line,
+/// followed by a "sum-of-products" object per target
+/// and then a "product" object per product of the target.
+/// The non-finite probabilities are null.
+///
+/// The binary report is a columnar image in the native byte order
+/// with unsigned LEB128 varints ("u") and strings prefixed by the size:
+///
+///     "SCMP" magic, i32 version, u header size, (string key, string value)*
+///     u targets, per target:
+///       u identifiers, (string key, string value)*
+///       u basic events, string* event dictionary
+///       u products, per product: u literals, u (2 * event + complement)*
+///       u8 probability column flag, f64* product probabilities
+enum class ReportFormat : std::uint8_t { kXml = 0, kBinary, kCsv, kJsonLines };
+
+/// String representations of the report formats.
+const char* const kReportFormatToString[] = {"xml", "binary", "csv", "jsonl"};
+
 /// Facilities to report analysis results.
 class Reporter {
  public:
+  /// @param[in] format  The format of the reports.
+  explicit Reporter(ReportFormat format = ReportFormat::kXml)
+      : format_(format) {}
+
+  /// Checks that the reports in the format can hold
+  /// all the results requested by the analysis settings.
+  /// Only the XML reports have the analysis results besides the products,
+  /// and the results are never dropped silently.
+  ///
+  /// @param[in] settings  The analysis settings.
+  ///
+  /// @throws SettingsError  The format has no place for some results.
+  void CheckSettings(const core::Settings& settings) const;
+
+  /// Renders the XML results of the analysis as they are finished,
+  /// so that the rendering overlaps the analysis of the other targets.
+  /// The rendered results are put into the next XML report of the analysis
+  /// with the same indentation.
+  ///
+  /// @param[in] risk_an  Risk analysis to be run.
+  /// @param[in] indent  The flag to indent output for readability.
+  ///
+  /// @returns The observer of the finished results for the analysis,
+  ///          or nullptr if the report is written without jobs
+  ///          or in the compact format.
+  ///
+  /// @pre The reporter outlives the analysis with the observer.
+  core::RiskAnalysis::Observer Prerender(const core::RiskAnalysis& risk_an,
+                                         bool indent);
+
   /// Reports the results of risk analysis on a model.
-  /// The XML report is formed as a single document.
+  /// The report is formed as a single document in the reporter format.
   ///
   /// @param[in] risk_an  Risk analysis with results.
   /// @param[out] out  The report destination stream.
@@ -49,23 +119,89 @@ class Reporter {
   /// @pre The output destination is used only by this reporter.
   ///      There is going to be no appending to the stream after the report.
   ///
+  /// @throws SettingsError  The format has no place for some results.
   /// @throws IOError  The write operation has failed.
   void Report(const core::RiskAnalysis& risk_an, std::FILE* out,
               bool indent = true);
 
   /// A convenience function to generate the report into a file.
   /// This function overwrites the file.
+  /// The report is compressed on the fly
+  /// if the file name has the gzip ".gz" or zstd ".zst" extension.
   ///
   /// @param[in] risk_an  Risk analysis with results.
   /// @param[out] file  The output destination.
   /// @param[in] indent  The flag to indent output for readability.
   ///
+  /// @throws SettingsError  The format has no place for some results.
   /// @throws IOError  The output file is not accessible,
   ///                  or the write operation has failed.
   void Report(const core::RiskAnalysis& risk_an, const std::string& file,
               bool indent = true);
 
  private:
+  /// The results rendered ahead of the report.
+  struct Prerendered;
+
+  /// Checks that the reports in the format can hold all the results.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  ///
+  /// @throws SettingsError  The format has no place for some results.
+  void CheckResults(const core::RiskAnalysis& risk_an) const;
+
+  /// Writes the zstd-compressed report into a file.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[out] file  The output destination.
+  /// @param[in] indent  The flag to indent XML output for readability.
+  ///
+  /// @throws IOError  The output file is not accessible,
+  ///                  the write operation has failed,
+  ///                  or the build has no zstd support.
+  void ReportZstd(const core::RiskAnalysis& risk_an, const std::string& file,
+                  bool indent);
+
+  /// Writes the report in the requested format.
+  ///
+  /// @tparam T  The stdio FILE, gzip, or zstd file pointer type.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[out] out  The report destination.
+  /// @param[in] indent  The flag to indent XML output for readability.
+  ///
+  /// @throws IOError  The write operation has failed.
+  template <typename T>
+  void Write(const core::RiskAnalysis& risk_an, T out, bool indent);
+
+  /// Reports the results of risk analysis into the XML document.
+  /// The results rendered ahead during the analysis are put as they are.
+  /// With multiple jobs in the analysis settings,
+  /// the fragments of the other results are rendered concurrently
+  /// and put into the document in the order of the results
+  /// as soon as they are complete.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[in,out] xml_stream  The empty report document.
+  /// @param[in] indent  The indentation of the document.
+  void Report(const core::RiskAnalysis& risk_an, xml::Stream* xml_stream,
+              bool indent);
+
+  /// Renders the fragments of the results concurrently
+  /// and puts them in order into the parent element.
+  ///
+  /// @tparam F  The callable type to render a result into a fragment.
+  ///
+  /// @param[in] num_results  The number of the results.
+  /// @param[in] num_jobs  The number of threads to render the fragments.
+  /// @param[in] render  The renderer of the results by index.
+  /// @param[in,out] results  XML element for all results.
+  ///
+  /// @throws Error  The rendering of a result has failed.
+  template <typename F>
+  void ReportConcurrently(int num_results, int num_jobs, F&& render,
+                          xml::StreamElement* results);
+
   /// This function populates information
   /// about the software, settings, time, methods, model, etc.
   ///
@@ -128,6 +264,14 @@ class Reporter {
   void ReportResults(const core::RiskAnalysis::EtaResult& eta_result,
                      xml::StreamElement* results);
 
+  /// Reports all the analyses of a target
+  /// to a specified output destination.
+  ///
+  /// @param[in] result  The analysis results of the target.
+  /// @param[in,out] results  XML element to for all results.
+  void ReportResults(const core::RiskAnalysis::Result& result,
+                     xml::StreamElement* results);
+
   /// Reports the results of fault tree analysis
   /// to a specified output destination.
   ///
@@ -168,11 +312,35 @@ class Reporter {
                      const core::UncertaintyAnalysis& uncert_analysis,
                      xml::StreamElement* results);
 
+  /// Reports the distributions of importance factors
+  /// sampled in uncertainty analysis.
+  ///
+  /// @param[in] id  The analysis id.
+  /// @param[in] importance  The distributions of importance factors of events.
+  /// @param[in,out] results  XML element to for all results.
+  void ReportResults(
+      const core::RiskAnalysis::Result::Id& id,
+      const std::vector<core::ImportanceDistribution>& importance,
+      xml::StreamElement* results);
+
+  /// Reports the results of sensitivity analysis.
+  ///
+  /// @param[in] id  The analysis id.
+  /// @param[in] sensitivity_analysis  Sensitivity analysis with results.
+  /// @param[in,out] results  XML element to for all results.
+  void ReportResults(const core::RiskAnalysis::Result::Id& id,
+                     const core::SensitivityAnalysis& sensitivity_analysis,
+                     xml::StreamElement* results);
+
   /// Reports literal in products.
   ///
   /// @param[in] literal  A literal to be reported.
+  /// @param[in] names  The escaped names of the plain basic events.
   /// @param[in,out] parent  A parent element node to have this literal.
-  void ReportLiteral(const core::Literal& literal, xml::StreamElement* parent);
+  void ReportLiteral(
+      const core::Literal& literal,
+      const std::unordered_map<const mef::BasicEvent*, xml::EscapedText>& names,
+      xml::StreamElement* parent);
 
   /// Detects if a given basic event is a CCF event,
   /// and reports it with specific formatting.
@@ -190,6 +358,16 @@ class Reporter {
   template <class T>
   void ReportBasicEvent(const mef::BasicEvent& basic_event,
                         xml::StreamElement* parent, const T& add_data);
+
+  /// Reports the products and probabilities in the compact format.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[out] out  The report destination.
+  void ReportProducts(const core::RiskAnalysis& risk_an,
+                      xml::detail::FileStream* out);
+
+  ReportFormat format_;  ///< The format of the reports.
+  std::shared_ptr<Prerendered> prerendered_;  ///< The results rendered ahead.
 };
 
 }  // namespace scram
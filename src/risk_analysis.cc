@@ -20,9 +20,19 @@
 
 #include "risk_analysis.h"
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <boost/noncopyable.hpp>
+#include <boost/range/algorithm.hpp>
+
 #include "bdd.h"
 #include "expression/random_deviate.h"
-#include "ext/scope_guard.h"
+#include "ext/find_iterator.h"
+#include "ext/parallel.h"
 #include "fault_tree.h"
 #include "logger.h"
 #include "mocus.h"
@@ -30,127 +40,317 @@
 
 namespace scram::core {
 
+namespace {
+
+/// @returns The house event states set by the phase of the context.
+std::vector<std::pair<const mef::HouseEvent*, bool>> GetHouseEventStates(
+    const std::optional<RiskAnalysis::Context>& context,
+    const mef::Model& model) noexcept {
+  std::vector<std::pair<const mef::HouseEvent*, bool>> states;
+  if (!context)
+    return states;
+  for (const mef::SetHouseEvent* instruction : context->phase.instructions()) {
+    auto it = model.table<mef::HouseEvent>().find(instruction->name());
+    assert(it != model.table<mef::HouseEvent>().end() &&
+           "Invalid instruction.");
+    auto state = std::find_if(states.begin(), states.end(),
+                              [&it](const auto& entry) {
+                                return entry.first == &*it;
+                              });
+    if (state != states.end()) {
+      state->second = instruction->state();
+    } else {
+      states.emplace_back(&*it, instruction->state());
+    }
+  }
+  return states;
+}
+
+/// Applies the alignment phase of the analysis context in the calling thread
+/// without changing the model observed by other threads.
+///
+/// @pre No mission time overlay is in effect in the calling thread.
+class ContextOverlay : private boost::noncopyable {
+ public:
+  /// @param[in] context  The optional context with the alignment phase.
+  /// @param[in] model  The model under analysis.
+  ContextOverlay(const std::optional<RiskAnalysis::Context>& context,
+                 mef::Model* model) noexcept
+      : house_events_(GetHouseEventStates(context, *model)),
+        mission_time_(&model->mission_time()) {
+    if (context) {
+      mission_time_.value(context->phase.time_fraction() *
+                          model->mission_time().value());
+    }
+  }
+
+ private:
+  mef::HouseEvent::Overlay house_events_;  ///< The phase house event states.
+  mef::MissionTime::Overlay mission_time_;  ///< The phase mission time.
+};
+
+/// Gathers the house events in the sub-graph of the gate.
+///
+/// @param[in] gate  The root gate of the sub-graph.
+/// @param[in,out] visited  The gates already gathered.
+/// @param[in,out] house_events  The unique house events in the sub-graph.
+void GatherHouseEvents(const mef::Gate& gate,
+                       std::unordered_set<const mef::Gate*>* visited,
+                       std::vector<const mef::HouseEvent*>* house_events) {
+  if (!visited->insert(&gate).second)
+    return;
+  for (const mef::Formula::Arg& arg : gate.formula().args()) {
+    if (auto* house_event = std::get_if<mef::HouseEvent*>(&arg.event)) {
+      if (boost::find(*house_events, *house_event) == house_events->end())
+        house_events->push_back(*house_event);
+    } else if (auto* arg_gate = std::get_if<mef::Gate*>(&arg.event)) {
+      GatherHouseEvents(**arg_gate, visited, house_events);
+    }
+  }
+}
+
+/// @returns The name of the analysis target for logging.
+std::string GetName(const RiskAnalysis::Result::Id& id) {
+  if (const auto* gate = std::get_if<const mef::Gate*>(&id.target))
+    return "gate: " + std::string((*gate)->id());
+  return "sequence: " +
+         std::string(std::get<std::pair<const mef::InitiatingEvent&,
+                                        const mef::Sequence&>>(id.target)
+                         .second.name());
+}
+
+}  // namespace
+
+struct RiskAnalysis::Task {
+  /// The target gates with the result positions.
+  /// The results of a gate share its qualitative analysis.
+  std::vector<std::pair<const mef::Gate*, std::vector<int>>> targets;
+  bool shared_bdd;  ///< The targets of one context share one BDD.
+};
+
 RiskAnalysis::RiskAnalysis(mef::Model* model, const Settings& settings)
     : Analysis(settings), model_(model) {}
 
-void RiskAnalysis::Analyze() noexcept {
+void RiskAnalysis::Analyze(const Observer& observer) noexcept {
   assert(results_.empty() && "Rerunning the analysis.");
-  // Set the seed for the pseudo-random number generator if given explicitly.
-  // Otherwise it defaults to the implementation dependent value.
-  if (Analysis::settings().seed() >= 0)
-    mef::RandomDeviate::seed(Analysis::settings().seed());
-
+  std::vector<std::optional<Context>> contexts;
   if (model_->alignments().empty()) {
-    RunAnalysis();
+    contexts.emplace_back();
   } else {
     for (const mef::Alignment& alignment : model_->alignments()) {
       for (const mef::Phase& phase : alignment.phases())
-        RunAnalysis(Context{alignment, phase});
+        contexts.push_back(Context{alignment, phase});
     }
   }
-}
-
-void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
-  std::vector<std::pair<mef::HouseEvent*, bool>> house_events;
-  /// Restores the model after application of the context.
-  ext::scope_guard restorator(
-      [&house_events, this, init_time = model_->mission_time().value()] {
-        model_->mission_time().value(init_time);
-        Analysis::settings().mission_time(init_time);
 
-        for (const std::pair<mef::HouseEvent*, bool>& entry : house_events)
-          entry.first->state(entry.second);
-      });
+  std::vector<Task> tasks;
+  std::vector<std::pair<int, EventTreeAnalysis::Result*>> sequences;
+  // The house events of the fault tree targets
+  // to find the phases with the same target logic.
+  std::unordered_map<const mef::Gate*, std::vector<const mef::HouseEvent*>>
+      target_house_events;
+  std::map<std::pair<const mef::Gate*, std::vector<bool>>, int> target_tasks;
+  for (const std::optional<Context>& context : contexts) {
+    if (Analysis::settings().canceled())
+      break;
+    // The event tree walks manipulate the model context,
+    // so only the analyses of their resulting sequences run concurrently.
+    ContextOverlay overlay(context, model_);
+    std::vector<std::pair<const mef::Gate*, int>> targets;
+    for (const mef::InitiatingEvent& initiating_event :
+         model_->initiating_events()) {
+      if (initiating_event.event_tree()) {
+        LOG(INFO) << "Running event tree analysis: "
+                  << initiating_event.name();
+        auto eta = std::make_unique<EventTreeAnalysis>(
+            initiating_event, Analysis::settings(), model_->context());
+        eta->Analyze();
+        for (EventTreeAnalysis::Result& result : eta->sequences()) {
+          sequences.emplace_back(results_.size(), &result);
+          targets.emplace_back(result.gate.get(), results_.size());
+          results_.push_back(
+              {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
+                    initiating_event, result.sequence},
+                context}});
+        }
+        event_tree_results_.push_back(
+            {initiating_event, context, std::move(eta)});
+        LOG(INFO) << "Finished event tree analysis: "
+                  << initiating_event.name();
+      }
+    }
+    int num_sequences = targets.size();
+    for (const mef::FaultTree& ft : model_->fault_trees()) {
+      for (const mef::Gate* target : ft.top_events()) {
+        targets.emplace_back(target, results_.size());
+        results_.push_back({{target, context}});
+      }
+    }
 
-  if (context) {
-    double mission_time =
-        context->phase.time_fraction() * model_->mission_time().value();
-    model_->mission_time().value(mission_time);
-    Analysis::settings().mission_time(mission_time);
-
-    for (const mef::SetHouseEvent* instruction :
-         context->phase.instructions()) {
-      auto it = model_->table<mef::HouseEvent>().find(instruction->name());
-      assert(it != model_->table<mef::HouseEvent>().end() &&
-             "Invalid instruction.");
-      mef::HouseEvent& house_event = *it;
-      if (house_event.state() != instruction->state()) {
-        house_events.emplace_back(&house_event, house_event.state());
-        house_event.state(instruction->state());
+    if (Analysis::settings().shared_bdd()) {
+      if (targets.empty())
+        continue;
+      Task task{{}, true};
+      for (const auto& [gate, index] : targets)
+        task.targets.push_back({gate, {index}});
+      tasks.push_back(std::move(task));
+      continue;
+    }
+    for (int i = 0; i < num_sequences; ++i)
+      tasks.push_back({{{targets[i].first, {targets[i].second}}}, false});
+    // The phases with the same house event states in the fault tree
+    // share its qualitative analysis.
+    for (int i = num_sequences; i < targets.size(); ++i) {
+      const auto& [gate, index] = targets[i];
+      auto it = target_house_events.find(gate);
+      if (it == target_house_events.end()) {
+        std::unordered_set<const mef::Gate*> visited;
+        it = target_house_events.try_emplace(gate).first;
+        GatherHouseEvents(*gate, &visited, &it->second);
+      }
+      std::vector<bool> states;
+      for (const mef::HouseEvent* house_event : it->second)
+        states.push_back(house_event->state());
+      auto [task, inserted] = target_tasks.emplace(
+          std::make_pair(gate, std::move(states)), tasks.size());
+      if (inserted) {
+        tasks.push_back({{{gate, {index}}}, false});
+      } else {
+        tasks[task->second].targets.front().second.push_back(index);
       }
     }
   }
 
-  for (const mef::InitiatingEvent& initiating_event :
-       model_->initiating_events()) {
-    if (initiating_event.event_tree()) {
-      LOG(INFO) << "Running event tree analysis: " << initiating_event.name();
-      auto eta = std::make_unique<EventTreeAnalysis>(
-          initiating_event, Analysis::settings(), model_->context());
-      eta->Analyze();
-      for (EventTreeAnalysis::Result& result : eta->sequences()) {
-        const mef::Sequence& sequence = result.sequence;
-        LOG(INFO) << "Running analysis for sequence: " << sequence.name();
-        results_.push_back(
-            {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
-                  initiating_event, sequence},
-              context}});
-        RunAnalysis(*result.gate, &results_.back());
-        if (result.is_expression_only) {
-          results_.back().fault_tree_analysis = nullptr;
-          results_.back().importance_analysis = nullptr;
+  std::vector<bool> is_sequence(results_.size(), false);
+  for (const auto& sequence : sequences)
+    is_sequence[sequence.first] = true;
+  if (Progress* progress = Analysis::settings().progress().get())
+    progress->Start("Analyzing targets", results_.size());
+  ext::parallel_for(
+      tasks.size(), Analysis::settings().num_jobs(),
+      [this, &tasks, &is_sequence, &observer](int i) {
+        if (Analysis::settings().canceled())
+          return;
+        RunTask(tasks[i]);
+        // The cancellation may have cut the analyses short.
+        if (Analysis::settings().canceled()) {
+          Discard(tasks[i]);
+          return;
         }
-        if (Analysis::settings().probability_analysis())
-          result.p_sequence = results_.back().probability_analysis->p_total();
-        LOG(INFO) << "Finished analysis for sequence: " << sequence.name();
-      }
-      event_tree_results_.push_back(
-          {initiating_event, context, std::move(eta)});
-      LOG(INFO) << "Finished event tree analysis: " << initiating_event.name();
+        if (!observer)
+          return;
+        for (const auto& target : tasks[i].targets) {
+          for (int index : target.second) {
+            if (!is_sequence[index])
+              observer(index);
+          }
+        }
+      });
+  if (Analysis::settings().canceled())
+    Analysis::AddWarning("The analysis is canceled.");
+
+  for (const auto& [index, sequence] : sequences) {
+    Result& result = results_[index];
+    if (sequence->is_expression_only) {
+      result.fault_tree_analysis = nullptr;
+      result.importance_analysis = nullptr;
     }
+    if (result.probability_analysis)
+      sequence->p_sequence = result.probability_analysis->p_total();
   }
+}
 
-  for (const mef::FaultTree& ft : model_->fault_trees()) {
-    for (const mef::Gate* target : ft.top_events()) {
-      LOG(INFO) << "Running analysis for gate: " << target->id();
-      results_.push_back({{target, context}});
-      RunAnalysis(*target, &results_.back());
-      LOG(INFO) << "Finished analysis for gate: " << target->id();
+void RiskAnalysis::Discard(const Task& task) noexcept {
+  for (const auto& target : task.targets) {
+    for (int index : target.second) {
+      Result& result = results_[index];
+      result.fault_tree_analysis.reset();
+      result.probability_analysis.reset();
+      result.importance_analysis.reset();
+      result.uncertainty_analysis.reset();
+      result.sensitivity_analysis.reset();
     }
   }
 }
 
+void RiskAnalysis::RunTask(const Task& task) noexcept {
+  if (!task.shared_bdd) {
+    for (const auto& [gate, results] : task.targets)
+      RunAnalysis(*gate, results, nullptr);
+    return;
+  }
+  // The vertices of the shared BDD are analyzed by one target at a time.
+  mef::HouseEvent::Overlay house_events(GetHouseEventStates(
+      results_[task.targets.front().second.front()].id.context, *model_));
+  std::vector<const mef::Gate*> gates;
+  for (const auto& target : task.targets)
+    gates.push_back(target.first);
+  auto shared_bdd =
+      std::make_shared<SharedBdd>(gates, Analysis::settings(), model_);
+  for (const auto& [gate, results] : task.targets)
+    RunAnalysis(*gate, results, shared_bdd);
+}
+
 void RiskAnalysis::RunAnalysis(const mef::Gate& target,
-                               Result* result) noexcept {
+                               const std::vector<int>& results,
+                               std::shared_ptr<SharedBdd> shared_bdd) noexcept {
+  if (shared_bdd)
+    return RunAnalysis<Bdd>(target, results, std::move(shared_bdd));
   switch (Analysis::settings().algorithm()) {
     case Algorithm::kBdd:
-      return RunAnalysis<Bdd>(target, result);
+      return RunAnalysis<Bdd>(target, results, nullptr);
     case Algorithm::kZbdd:
-      return RunAnalysis<Zbdd>(target, result);
+      return RunAnalysis<Zbdd>(target, results, nullptr);
     case Algorithm::kMocus:
-      return RunAnalysis<Mocus>(target, result);
+      return RunAnalysis<Mocus>(target, results, nullptr);
   }
 }
 
 template <class Algorithm>
 void RiskAnalysis::RunAnalysis(const mef::Gate& target,
-                               Result* result) noexcept {
-  auto fta = std::make_unique<FaultTreeAnalyzer<Algorithm>>(
-      target, Analysis::settings(), model_);
-  fta->Analyze();
-  if (Analysis::settings().probability_analysis()) {
-    switch (Analysis::settings().approximation()) {
-      case Approximation::kNone:
-        RunAnalysis<Algorithm, Bdd>(fta.get(), result);
-        break;
-      case Approximation::kRareEvent:
-        RunAnalysis<Algorithm, RareEventCalculator>(fta.get(), result);
-        break;
-      case Approximation::kMcub:
-        RunAnalysis<Algorithm, McubCalculator>(fta.get(), result);
+                               const std::vector<int>& results,
+                               std::shared_ptr<SharedBdd> shared_bdd) noexcept {
+  std::shared_ptr<FaultTreeAnalyzer<Algorithm>> fta;
+  {
+    const Result& result = results_[results.front()];
+    ContextOverlay overlay(result.id.context, model_);
+    LOG(INFO) << "Running analysis for " << GetName(result.id);
+    if (shared_bdd) {
+      fta = std::make_shared<FaultTreeAnalyzer<Algorithm>>(
+          target, Analysis::settings(), std::move(shared_bdd));
+    } else {
+      fta = std::make_shared<FaultTreeAnalyzer<Algorithm>>(
+          target, Analysis::settings(), model_);
     }
+    fta->Analyze();
+  }
+  // The quantitative analyses share the algorithm data structures,
+  // so the contexts of the results are analyzed one at a time.
+  for (int index : results) {
+    Result& result = results_[index];
+    ContextOverlay overlay(result.id.context, model_);
+    if (index != results.front())
+      LOG(INFO) << "Reusing the analysis for " << GetName(result.id);
+    // Every target gets its own random number stream from the base seed
+    // to keep the results independent of the job scheduling.
+    mef::RandomDeviate::seed(Analysis::settings().seed() + index);
+    if (Analysis::settings().probability_analysis()) {
+      switch (Analysis::settings().approximation()) {
+        case Approximation::kNone:
+          RunAnalysis<Algorithm, Bdd>(fta.get(), &result);
+          break;
+        case Approximation::kRareEvent:
+          RunAnalysis<Algorithm, RareEventCalculator>(fta.get(), &result);
+          break;
+        case Approximation::kMcub:
+          RunAnalysis<Algorithm, McubCalculator>(fta.get(), &result);
+      }
+    }
+    result.fault_tree_analysis = fta;
+    LOG(INFO) << "Finished analysis for " << GetName(result.id);
+    if (Progress* progress = Analysis::settings().progress().get())
+      progress->Advance();
   }
-  result->fault_tree_analysis = std::move(fta);
 }
 
 template <class Algorithm, class Calculator>
@@ -159,16 +359,27 @@ void RiskAnalysis::RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta,
   auto pa = std::make_unique<ProbabilityAnalyzer<Calculator>>(
       fta, &model_->mission_time());
   pa->Analyze();
+  std::unique_ptr<ImportanceAnalyzer<Calculator>> ia;
   if (Analysis::settings().importance_analysis()) {
-    auto ia = std::make_unique<ImportanceAnalyzer<Calculator>>(pa.get());
+    ia = std::make_unique<ImportanceAnalyzer<Calculator>>(pa.get());
     ia->Analyze();
-    result->importance_analysis = std::move(ia);
   }
   if (Analysis::settings().uncertainty_analysis()) {
-    auto ua = std::make_unique<UncertaintyAnalyzer<Calculator>>(pa.get());
+    auto ua = std::make_unique<UncertaintyAnalyzer<Calculator>>(
+        pa.get(),
+        Analysis::settings().importance_uncertainty() ? ia.get() : nullptr);
     ua->Analyze();
     result->uncertainty_analysis = std::move(ua);
   }
+  if (Analysis::settings().sensitivity_analysis()) {
+    auto it = ext::find(model_->parameters(),
+                        Analysis::settings().sensitivity_parameter());
+    assert(it && "The sensitivity parameter is not in the model.");
+    auto sa = std::make_unique<SensitivityAnalysis>(pa.get(), ia.get(), *it);
+    sa->Analyze();
+    result->sensitivity_analysis = std::move(sa);
+  }
+  result->importance_analysis = std::move(ia);
   result->probability_analysis = std::move(pa);
 }
 
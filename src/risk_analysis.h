@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -34,6 +35,7 @@
 #include "importance_analysis.h"
 #include "model.h"
 #include "probability_analysis.h"
+#include "sensitivity_analysis.h"
 #include "settings.h"
 #include "uncertainty_analysis.h"
 
@@ -62,13 +64,23 @@ class RiskAnalysis : public Analysis {
 
     /// Optional analyses, i.e., may be nullptr.
     /// @{
-    std::unique_ptr<const FaultTreeAnalysis> fault_tree_analysis;
+    /// The fault tree analysis may be shared
+    /// by the phases that do not change the target logic.
+    std::shared_ptr<const FaultTreeAnalysis> fault_tree_analysis;
     std::unique_ptr<const ProbabilityAnalysis> probability_analysis;
     std::unique_ptr<const ImportanceAnalysis> importance_analysis;
     std::unique_ptr<const UncertaintyAnalysis> uncertainty_analysis;
+    std::unique_ptr<const SensitivityAnalysis> sensitivity_analysis;
     /// @}
   };
 
+  /// The observer of the results finished during the analysis.
+  /// The observer is called concurrently from the analysis jobs
+  /// with the position of the final result in results().
+  /// The results of event tree sequences are final only after the analysis,
+  /// so they are not observed.
+  using Observer = std::function<void(int index)>;
+
   /// The analysis results grouped by an event-tree.
   ///
   /// @todo Replace with query (group_by).
@@ -83,7 +95,7 @@ class RiskAnalysis : public Analysis {
   /// @param[in] settings  Analysis settings for the given model.
   ///
   /// @note The model is not const
-  ///       because mission time and event-tree walk context are manipulated.
+  ///       because the event-tree walk context is manipulated.
   ///       However, at the end of analysis, everything is reset.
   ///
   /// @todo Make the analysis work with a constant model.
@@ -99,8 +111,19 @@ class RiskAnalysis : public Analysis {
   ///       only after full initialization of the model
   ///       with or without its probabilities.
   ///
+  /// @note The alignment phases are applied with thread-local overlays,
+  ///       so the targets of all the phases are analyzed concurrently.
+  ///       The phases that do not change the logic of a fault tree target
+  ///       share its qualitative analysis.
+  ///
+  /// @note If the analysis is canceled via the settings progress channel,
+  ///       only the results of the completed targets are kept,
+  ///       and the analysis warns about the cancellation.
+  ///
+  /// @param[in] observer  The optional observer of the finished results.
+  ///
   /// @pre The analysis is performed only once.
-  void Analyze() noexcept;
+  void Analyze(const Observer& observer = nullptr) noexcept;
 
   /// @returns The results of the analysis.
   const std::vector<Result>& results() const { return results_; }
@@ -111,31 +134,43 @@ class RiskAnalysis : public Analysis {
   }
 
  private:
-  /// Runs the whole analysis with the given alignment.
-  ///
-  /// @param[in] context  The optional context with the current alignment/phase.
+  /// The analysis of targets that run in one job.
+  struct Task;
+
+  /// Runs the analyses of the task targets.
   ///
-  /// @pre The model is in pristine.
+  /// @param[in] task  The targets with their result positions.
+  void RunTask(const Task& task) noexcept;
+
+  /// Discards the possibly incomplete results of the canceled task.
   ///
-  /// @post The model is restored to the original state.
-  void RunAnalysis(std::optional<Context> context = {}) noexcept;
+  /// @param[in] task  The targets with their result positions.
+  void Discard(const Task& task) noexcept;
 
   /// Runs all possible analysis on a given target.
   /// Analysis types are deduced from the settings.
   ///
   /// @param[in] target  Analysis target.
-  /// @param[in,out] result  The result container element.
-  void RunAnalysis(const mef::Gate& target, Result* result) noexcept;
-
-  /// Defines and runs Qualitative analysis on the target.
-  /// Calls the Quantitative analysis if requested in settings.
+  /// @param[in] results  The result positions of the target
+  ///                     in the contexts with the same target logic.
+  /// @param[in] shared_bdd  The optional BDD shared with other targets.
+  void RunAnalysis(const mef::Gate& target, const std::vector<int>& results,
+                   std::shared_ptr<SharedBdd> shared_bdd) noexcept;
+
+  /// Defines and runs Qualitative analysis on the target
+  /// once for all the results.
+  /// Calls the Quantitative analysis if requested in settings
+  /// in the context of every result.
   ///
   /// @tparam Algorithm  Qualitative analysis algorithm.
   ///
   /// @param[in] target  Analysis target.
-  /// @param[in,out] result  The result container element.
+  /// @param[in] results  The result positions of the target
+  ///                     in the contexts with the same target logic.
+  /// @param[in] shared_bdd  The optional BDD shared with other targets.
   template <class Algorithm>
-  void RunAnalysis(const mef::Gate& target, Result* result) noexcept;
+  void RunAnalysis(const mef::Gate& target, const std::vector<int>& results,
+                   std::shared_ptr<SharedBdd> shared_bdd) noexcept;
 
   /// Defines and runs Quantitative analysis on the target.
   ///
@@ -18,10 +18,13 @@
 /// @file
 /// Main entrance.
 
+#include <csignal>
 #include <cstdarg>
 #include <cstdio>  // vsnprintf
 #include <cstring>  // strerror
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -30,12 +33,14 @@
 #include <boost/core/typeinfo.hpp>
 #include <boost/exception/all.hpp>
 #include <boost/program_options.hpp>
+#include <boost/range/algorithm/find.hpp>
 #include <boost/version.hpp>
 
 #include <libxml/parser.h>  // xmlInitParser, xmlCleanupParser
 #include <libxml/xmlerror.h>  // initGenericErrorDefaultFunc
 #include <libxml/xmlversion.h>  // LIBXML_TEST_VERSION, LIBXML_DOTTED_VERSION
 
+#include "batch.h"
 #include "error.h"
 #include "ext/scope_guard.h"
 #include "initializer.h"
@@ -44,6 +49,7 @@
 #include "reporter.h"
 #include "risk_analysis.h"
 #include "serialization.h"
+#include "server.h"
 #include "settings.h"
 #include "version.h"
 
@@ -66,13 +72,24 @@ po::options_description ConstructOptions() {
       ("project", OPT_VALUE(path), "Project file with analysis configurations")
       ("allow-extern", "**UNSAFE** Allow external libraries")
       ("validate", "Validate input files without analysis")
+      ("compile-model", OPT_VALUE(path),
+       "Compile input files into a binary model for fast loading")
+      ("serve", "Serve line-delimited JSON requests on the standard streams")
+      ("batch", OPT_VALUE(path),
+       "Manifest of models to analyze into separate reports")
+      ("memory-limit", OPT_VALUE(int),
+       "Memory budget in megabytes for concurrent batch models")
       ("bdd", "Perform qualitative analysis with BDD")
       ("zbdd", "Perform qualitative analysis with ZBDD")
       ("mocus", "Perform qualitative analysis with MOCUS")
       ("prime-implicants", "Calculate prime implicants")
+      ("shared-bdd", "Analyze all targets with one shared BDD")
       ("probability", "Perform probability analysis")
       ("importance", "Perform importance analysis")
       ("uncertainty", "Perform uncertainty analysis")
+      ("control-variates", "Use control variates in uncertainty analysis")
+      ("importance-uncertainty",
+       "Perform uncertainty analysis of importance factors")
       ("ccf", "Perform common-cause failure analysis")
       ("sil", "Compute the Safety Integrity Level metrics")
       ("rare-event", "Use the rare event approximation")
@@ -88,7 +105,14 @@ po::options_description ConstructOptions() {
        "Number of quantiles for distributions")
       ("num-bins", OPT_VALUE(int), "Number of bins for histograms")
       ("seed", OPT_VALUE(int), "Seed for the pseudo-random number generator")
-      ("output,o", OPT_VALUE(path), "Output file for reports")
+      ("jobs,j", OPT_VALUE(int), "Number of concurrent analysis jobs")
+      ("cache-dir", OPT_VALUE(path),
+       "Directory to cache valid inputs and analysis results between runs")
+      ("cache-limit", OPT_VALUE(int), "Cache size limit in megabytes")
+      ("output,o", OPT_VALUE(path),
+       "Output file for reports (compressed if *.gz or *.zst)")
+      ("report-format", OPT_VALUE(std::string),
+       "Report format: xml (default), binary, csv, or jsonl")
       ("no-indent", "Omit indentation whitespace in output XML")
       ("verbosity", OPT_VALUE(int), "Set log verbosity");
 #ifndef NDEBUG
@@ -163,7 +187,16 @@ int ParseArguments(int argc, char* argv[], po::variables_map* vm) {
     }
   }
 
-  if (!vm->count("input-files") && !vm->count("project")) {
+  if (vm->count("batch")) {
+    if (vm->count("input-files") || vm->count("project") ||
+        vm->count("output") || vm->count("serve") || vm->count("validate") ||
+        vm->count("compile-model") || vm->count("report-format")) {
+      std::cerr << "The batch manifest provides the input files and reports."
+                << "\n\n";
+      print_help(std::cerr);
+      return 1;
+    }
+  } else if (!vm->count("input-files") && !vm->count("project")) {
     std::cerr << "No input or configuration file is given.\n\n";
     print_help(std::cerr);
     return 1;
@@ -174,6 +207,15 @@ int ParseArguments(int argc, char* argv[], po::variables_map* vm) {
     print_help(std::cerr);
     return 1;
   }
+  if (vm->count("report-format") &&
+      boost::find(scram::kReportFormatToString,
+                  (*vm)["report-format"].as<std::string>()) ==
+          std::end(scram::kReportFormatToString)) {
+    std::cerr << "Unknown report format: "
+              << (*vm)["report-format"].as<std::string>() << "\n\n";
+    print_help(std::cerr);
+    return 1;
+  }
   if (vm->count("rare-event") && vm->count("mcub")) {
     std::cerr << "The rare event and MCUB approximations cannot be "
               << "applied at the same time.\n\n";
@@ -209,6 +251,7 @@ void ConstructSettings(const po::variables_map& vm,
     settings->algorithm(scram::core::Algorithm::kMocus);
   }
   settings->prime_implicants(vm.count("prime-implicants"));
+  settings->shared_bdd(vm.count("shared-bdd"));
   // Determine if the probability approximation is requested.
   if (vm.count("rare-event")) {
     assert(!vm.count("mcub"));
@@ -222,6 +265,9 @@ void ConstructSettings(const po::variables_map& vm,
   settings->probability_analysis(vm.count("probability"));
   settings->importance_analysis(vm.count("importance"));
   settings->uncertainty_analysis(vm.count("uncertainty"));
+  if (vm.count("control-variates"))  // Keeps the project file request.
+    settings->control_variates(true);
+  settings->importance_uncertainty(vm.count("importance-uncertainty"));
   settings->ccf_analysis(vm.count("ccf"));
   SET("seed", int, seed);
   SET("limit-order", int, limit_order);
@@ -230,6 +276,9 @@ void ConstructSettings(const po::variables_map& vm,
   SET("num-trials", int, num_trials);
   SET("num-quantiles", int, num_quantiles);
   SET("num-bins", int, num_bins);
+  SET("jobs", int, num_jobs);
+  SET("cache-dir", std::string, cache_dir);
+  SET("cache-limit", int, cache_limit);
 #ifndef NDEBUG
   settings->preprocessor = vm.count("preprocessor");
   settings->print = vm.count("print");
@@ -237,14 +286,82 @@ void ConstructSettings(const po::variables_map& vm,
 }
 #undef SET
 
+/// The progress of the running analyses for the signal handler.
+std::atomic<scram::core::Progress*> analysis_progress = nullptr;
+
+/// Cancels the running analyses upon termination signals
+/// so that the completed results are still reported.
+/// A repeated signal terminates the program.
+///
+/// @param[in] signal_number  The received signal.
+extern "C" void CancelAnalysis(int signal_number) noexcept {
+  if (scram::core::Progress* progress = analysis_progress.load())
+    progress->Cancel();
+  std::signal(signal_number, SIG_DFL);
+}
+
+/// @returns The progress channel of the analyses
+///          canceled by the interrupt and termination signals.
+std::shared_ptr<scram::core::Progress> GetProgress() {
+  static auto progress = [] {
+    auto channel = std::make_shared<scram::core::Progress>();
+    analysis_progress = channel.get();
+    std::signal(SIGINT, CancelAnalysis);
+    std::signal(SIGTERM, CancelAnalysis);
+    return channel;
+  }();
+  return progress;
+}
+
+/// Analyzes the models of the batch manifest.
+/// The command-line settings overwrite the settings from the project files.
+///
+/// @param[in] vm  Variables map of program options.
+///
+/// @returns The number of failed models.
+///          Non-zero if the analyses are canceled.
+///
+/// @throws Error  The manifest file is invalid.
+/// @throws boost::exception  Boost errors with the variables map.
+/// @throws std::exception  All other problems.
+int RunBatch(const po::variables_map& vm) {
+  std::vector<scram::Batch::Job> jobs;
+  for (scram::Batch::Entry& entry :
+       scram::Batch::ReadManifest(vm["batch"].as<std::string>())) {
+    scram::Batch::Job job;
+    // The project files are loaded by the jobs
+    // so that invalid projects fail only their own models.
+    job.configure = [&vm](scram::core::Settings* settings) {
+      ConstructSettings(vm, settings);
+      settings->progress(GetProgress());
+    };
+    job.configure(&job.settings);
+    job.input_files = std::move(entry.input_files);
+    job.output = std::move(entry.output);
+    job.project = std::move(entry.project);
+    jobs.push_back(std::move(job));
+  }
+  int num_threads = vm.count("jobs") ? vm["jobs"].as<int>() : 1;
+  int memory_limit =
+      vm.count("memory-limit") ? vm["memory-limit"].as<int>() : 4096;
+  int num_failures =
+      scram::Batch(std::move(jobs), num_threads, memory_limit,
+                   vm.count("allow-extern"), !vm.count("no-indent"))
+          .Run();
+  return GetProgress()->canceled() ? std::max(num_failures, 1) : num_failures;
+}
+
 /// Main body of command-line entrance to run the program.
 ///
 /// @param[in] vm  Variables map of program options.
 ///
+/// @returns 0 for success.
+/// @returns 1 if the analysis is canceled with partial results.
+///
 /// @throws Error  Exceptions specific to SCRAM.
 /// @throws boost::exception  Boost errors with the variables map.
 /// @throws std::exception  All other problems.
-void RunScram(const po::variables_map& vm) {
+int RunScram(const po::variables_map& vm) {
   scram::core::Settings settings;  // Analysis settings.
   std::vector<std::string> input_files;
   // Get configurations if any.
@@ -261,6 +378,23 @@ void RunScram(const po::variables_map& vm) {
     auto cmd_input = vm["input-files"].as<std::vector<std::string>>();
     input_files.insert(input_files.end(), cmd_input.begin(), cmd_input.end());
   }
+  // The explicit validation does not trust the records of valid inputs.
+  if (vm.count("validate"))
+    settings.cache_dir("");
+  // The served requests need the probability expressions of all events.
+  if (vm.count("serve"))
+    settings.probability_analysis(true);
+  auto format = scram::ReportFormat::kXml;
+  if (vm.count("report-format")) {
+    format = static_cast<scram::ReportFormat>(
+        boost::find(scram::kReportFormatToString,
+                    vm["report-format"].as<std::string>()) -
+        std::begin(scram::kReportFormatToString));
+  }
+  scram::Reporter reporter(format);
+  // The results unfit for the report format fail before the analysis.
+  if (!vm.count("validate") && !vm.count("compile-model") && !vm.count("serve"))
+    reporter.CheckSettings(settings);
   // Process input files
   // into valid analysis containers and constructs.
   // Throws if anything is invalid.
@@ -268,26 +402,41 @@ void RunScram(const po::variables_map& vm) {
       scram::mef::Initializer(input_files, settings, vm.count("allow-extern"))
           .model();
 #ifndef NDEBUG
-  if (vm.count("serialize"))
-    return Serialize(*model, stdout);
+  if (vm.count("serialize")) {
+    Serialize(*model, stdout);
+    return 0;
+  }
 #endif
   if (vm.count("validate"))
-    return;  // Stop if only validation is requested.
+    return 0;  // Stop if only validation is requested.
+  if (vm.count("compile-model")) {  // The model is valid to compile.
+    scram::mef::Compile(input_files, vm["compile-model"].as<std::string>());
+    return 0;
+  }
+  if (vm.count("serve")) {
+    scram::Server(std::move(model), settings).Serve(std::cin, std::cout);
+    return 0;
+  }
 
   // Initiate risk analysis with the given information.
+  settings.progress(GetProgress());
   scram::core::RiskAnalysis analysis(model.get(), settings);
-  analysis.Analyze();
+  bool indent = vm.count("no-indent") ? false : true;
+  // The finished results are rendered while the other targets are analyzed.
+  analysis.Analyze(reporter.Prerender(analysis, indent));
+  int status = settings.canceled() ? 1 : 0;
+  if (status)
+    LOG(scram::ERROR) << "The analysis is canceled.";
 #ifndef NDEBUG
   if (vm.count("no-report") || vm.count("preprocessor") || vm.count("print"))
-    return;
+    return status;
 #endif
-  scram::Reporter reporter;
-  bool indent = vm.count("no-indent") ? false : true;
   if (vm.count("output")) {
     reporter.Report(analysis, vm["output"].as<std::string>(), indent);
   } else {
     reporter.Report(analysis, stdout, indent);
   }
+  return status;
 }
 
 /// Callback function to redirect XML library error/warning messages to logging.
@@ -344,6 +493,7 @@ int main(int argc, char* argv[]) {
 
   xmlGenericErrorFunc xml_error_printer = LogXmlError;
   initGenericErrorDefaultFunc(&xml_error_printer);
+  xmlThrDefSetGenericErrorFunc(nullptr, xml_error_printer);  // For new threads.
 
   try {
     // Parse command-line options.
@@ -357,8 +507,10 @@ int main(int argc, char* argv[]) {
           static_cast<scram::LogLevel>(vm["verbosity"].as<int>()));
     }
 
+    if (ret == 0 && vm.count("batch"))
+      return RunBatch(vm) ? 1 : 0;
     if (ret == 0)
-      RunScram(vm);
+      return RunScram(vm);
   } catch (const scram::LogicError& err) {
     LOG(scram::ERROR) << "Logic Error:\n" << boost::diagnostic_information(err);
     return 1;
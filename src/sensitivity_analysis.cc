@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the parameter sweep over the analysis results.
+
+#include "sensitivity_analysis.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "event.h"
+#include "expression/program.h"
+#include "logger.h"
+#include "parameter.h"
+
+namespace scram::core {
+
+namespace {
+
+/// The number of parameter values evaluated together.
+const int kSweepBatchSize = 256;
+
+}  // namespace
+
+SensitivityAnalysis::SensitivityAnalysis(
+    ProbabilityAnalyzerBase* prob_analyzer,
+    ImportanceAnalyzerBase* importance_analyzer,
+    const mef::Parameter& parameter)
+    : Analysis(std::as_const(*prob_analyzer).settings()),
+      prob_analyzer_(prob_analyzer),
+      importance_analyzer_(importance_analyzer),
+      parameter_(parameter) {}
+
+void SensitivityAnalysis::Analyze() noexcept {
+  CLOCK(sensitivity_time);
+  LOG(DEBUG3) << "Sweeping the parameter " << parameter_.id() << "...";
+  const std::vector<double>& values = Analysis::settings().sensitivity_values();
+  const std::vector<const mef::BasicEvent*>& basic_events =
+      prob_analyzer_->graph()->basic_events();
+
+  // Only the events depending on the parameter change over the sweep.
+  std::unordered_map<const mef::Expression*, bool> memo;
+  std::vector<int> dynamic_events;  // The positions of the basic events.
+  std::vector<mef::Expression*> dynamic_expressions;
+  for (int i = 0; i < basic_events.size(); ++i) {
+    mef::Expression* expression = &basic_events[i]->expression();
+    if (mef::DependsOn(expression, parameter_, &memo)) {
+      dynamic_events.push_back(i);
+      dynamic_expressions.push_back(expression);
+    }
+  }
+  LOG(DEBUG4) << "Parameter-dependent events: " << dynamic_events.size();
+  if (dynamic_events.empty())
+    Analysis::AddWarning("The parameter does not affect the analysis target.");
+
+  mef::ExpressionProgram program(dynamic_expressions,
+                                 mef::ExpressionProgram::Mode::kValue,
+                                 &parameter_);
+  // The parameter values are local to this analysis.
+  mef::Parameter::Overlay overlay(&parameter_, values.front());
+  const Pdag::IndexMap<double>& p_vars = prob_analyzer_->p_vars();
+
+  // The BDD calculators evaluate the batches of values in one graph pass.
+  int num_vars = p_vars.size();
+  std::vector<double> batch;
+  auto fill_batch = [&](int start, int num_points) {
+    batch.resize(num_vars * num_points);
+    for (int i = 0; i < num_vars; ++i) {
+      std::fill_n(batch.begin() + i * num_points, num_points,
+                  p_vars[i + Pdag::kVariableStartIndex]);
+    }
+    for (int j = 0; j < num_points; ++j) {
+      overlay.value(values[start + j]);
+      program.Run();
+      for (int k = 0; k < dynamic_events.size(); ++k)
+        batch[dynamic_events[k] * num_points + j] = program.result(k);
+    }
+  };
+  std::vector<double> p_total(values.size());
+
+  if (!importance_analyzer_) {
+    for (int start = 0; start < values.size(); start += kSweepBatchSize) {
+      int num_points = std::min<int>(kSweepBatchSize, values.size() - start);
+      fill_batch(start, num_points);
+      prob_analyzer_->CalculateTotalProbabilities(batch, num_points,
+                                                  &p_total[start]);
+    }
+    for (int i = 0; i < values.size(); ++i)
+      points_.push_back({values[i], p_total[i], {}, {}});
+
+  } else {
+    std::vector<int> positions;  // The positions of the important events.
+    std::vector<int> occurrences;
+    {
+      std::unordered_map<const mef::BasicEvent*, int> event_positions;
+      for (int i = 0; i < basic_events.size(); ++i)
+        event_positions.emplace(basic_events[i], i);
+      for (const ImportanceRecord& record :
+           importance_analyzer_->importance()) {
+        events_.push_back(&record.event);
+        positions.push_back(event_positions.at(&record.event));
+        occurrences.push_back(record.factors.occurrence);
+      }
+    }
+    std::vector<double> mifs;
+    for (int start = 0; start < values.size(); start += kSweepBatchSize) {
+      int num_points = std::min<int>(kSweepBatchSize, values.size() - start);
+      fill_batch(start, num_points);
+      importance_analyzer_->CalculateMarginalImportances(
+          batch, num_points, &p_total[start], &mifs);
+      for (int j = 0; j < num_points; ++j) {
+        SensitivityPoint point{values[start + j], p_total[start + j], {}, {}};
+        for (int i = 0; i < positions.size(); ++i) {
+          int cell = positions[i] * num_points + j;
+          ImportanceFactors factors = ImportanceAnalysis::CalculateFactors(
+              point.p_total, batch[cell], mifs[cell]);
+          factors.occurrence = occurrences[i];
+          point.p_events.push_back(batch[cell]);
+          point.importance.push_back(factors);
+        }
+        points_.push_back(std::move(point));
+      }
+    }
+  }
+  LOG(DEBUG3) << "Finished the parameter sweep in " << DUR(sensitivity_time);
+  Analysis::AddAnalysisTime(DUR(sensitivity_time));
+}
+
+}  // namespace scram::core
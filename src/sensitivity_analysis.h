@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Sensitivity analysis of the total probability
+/// over the values of a model parameter.
+
+#pragma once
+
+#include <vector>
+
+#include "analysis.h"
+#include "importance_analysis.h"
+#include "probability_analysis.h"
+
+namespace scram::mef {  // Decouple from the implementation dependence.
+class BasicEvent;
+class Parameter;
+}  // namespace scram::mef
+
+namespace scram::core {
+
+/// The analysis results for a single value of the swept parameter.
+struct SensitivityPoint {
+  double value;  ///< The value of the parameter.
+  double p_total;  ///< The total probability with the parameter value.
+  /// The probabilities of the important events
+  /// in the order of SensitivityAnalysis::events().
+  std::vector<double> p_events;
+  /// The importance factors of the important events
+  /// in the order of SensitivityAnalysis::events().
+  std::vector<ImportanceFactors> importance;
+};
+
+/// Sensitivity analysis of the total probability
+/// and, optionally, of the importance factors
+/// to the value of a single model parameter.
+///
+/// The products and the BDD of the probability analysis are reused
+/// for all the parameter values;
+/// only the probabilities of the dependent events are re-evaluated.
+class SensitivityAnalysis : public Analysis {
+ public:
+  /// @param[in] prob_analyzer  Completed probability analyzer.
+  /// @param[in] importance_analyzer  Completed importance analyzer or nullptr.
+  /// @param[in] parameter  The parameter to sweep
+  ///                       over the values given in the settings.
+  SensitivityAnalysis(ProbabilityAnalyzerBase* prob_analyzer,
+                      ImportanceAnalyzerBase* importance_analyzer,
+                      const mef::Parameter& parameter);
+
+  /// Calculates the results for all the parameter values.
+  ///
+  /// @pre Analysis is called only once.
+  void Analyze() noexcept;
+
+  /// @returns The swept parameter.
+  const mef::Parameter& parameter() const { return parameter_; }
+
+  /// @returns The important events with importance factors in the points.
+  ///          Empty if importance factors are not requested.
+  const std::vector<const mef::BasicEvent*>& events() const { return events_; }
+
+  /// @returns The results in the order of the parameter values.
+  const std::vector<SensitivityPoint>& points() const { return points_; }
+
+ private:
+  ProbabilityAnalyzerBase* prob_analyzer_;  ///< The probability calculator.
+  ImportanceAnalyzerBase* importance_analyzer_;  ///< The optional MIF source.
+  const mef::Parameter& parameter_;  ///< The swept parameter.
+  std::vector<const mef::BasicEvent*> events_;  ///< The important events.
+  std::vector<SensitivityPoint> points_;  ///< The results per value.
+};
+
+}  // namespace scram::core
@@ -32,6 +32,7 @@
 #include "expression/exponential.h"
 #include "ext/variant.h"
 #include "fault_tree.h"
+#include "xml.h"
 #include "xml_stream.h"
 
 namespace scram::mef {
@@ -51,6 +52,14 @@ void Serialize(const Model& model, const std::string& file) {
   }
 }
 
+void Compile(const std::vector<std::string>& xml_files,
+             const std::string& file) {
+  std::vector<xml::Document> documents;
+  for (const std::string& xml_file : xml_files)
+    documents.emplace_back(xml_file);
+  xml::Image::Write(documents, file);
+}
+
 namespace {  // The serialization helper functions for each model construct.
 
 void SerializeLabelAndAttributes(const Element& element,
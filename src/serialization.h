@@ -26,6 +26,7 @@
 #include <cstdio>
 
 #include <string>
+#include <vector>
 
 #include "model.h"
 
@@ -48,4 +49,21 @@ void Serialize(const Model& model, std::FILE* out);
 ///                  or the write operation has failed.
 void Serialize(const Model& model, const std::string& file);
 
+/// Compiles the model input files into a binary image
+/// that the initializer loads without XML parsing and validation.
+///
+/// The image holds the XInclude-resolved input documents
+/// rather than the model constructs,
+/// so it is loaded into the model with the same checks and extern libraries.
+/// The elements keep their original file names and lines for error messages.
+///
+/// @param[in] xml_files  The valid MEF input files.
+/// @param[out] file  The output destination for the image.
+///
+/// @throws IOError  The files are not accessible,
+///                  or the write operation has failed.
+/// @throws xml::Error  The input files are not valid XML.
+void Compile(const std::vector<std::string>& xml_files,
+             const std::string& file);
+
 }  // namespace scram::mef
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the quantification service.
+
+#include "server.h"
+
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string_view>
+
+#include <boost/core/typeinfo.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "error.h"
+#include "importance_analysis.h"
+#include "logger.h"
+#include "probability_analysis.h"
+
+namespace pt = boost::property_tree;
+
+namespace scram {
+
+namespace {
+
+/// Writes a JSON string literal.
+///
+/// @param[in] value  The string to be quoted and escaped.
+/// @param[in,out] out  The destination stream.
+void Quote(std::string_view value, std::ostream* out) {
+  *out << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        *out << "\\\"";
+        break;
+      case '\\':
+        *out << "\\\\";
+        break;
+      case '\n':
+        *out << "\\n";
+        break;
+      case '\t':
+        *out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          *out << ' ';
+        } else {
+          *out << c;
+        }
+    }
+  }
+  *out << '"';
+}
+
+/// @param[in] err  The error from the request processing.
+///
+/// @returns The description of the error for the response.
+std::string Describe(const Error& err) {
+  std::string message = boost::core::demangled_name(typeid(err));
+  if (*err.what())
+    message += std::string(": ") + err.what();
+  if (const auto* id = boost::get_error_info<mef::errinfo_element_id>(err)) {
+    message += " (";
+    if (const auto* type =
+            boost::get_error_info<mef::errinfo_element_type>(err))
+      message += std::string(*type) + " ";
+    message += *id + ")";
+  }
+  if (const auto* value = boost::get_error_info<errinfo_value>(err))
+    message += " [" + *value + "]";
+  return message;
+}
+
+}  // namespace
+
+Server::Server(std::unique_ptr<mef::Model> model,
+               const core::Settings& settings)
+    : model_(std::move(model)), settings_(settings) {
+  settings_.algorithm(core::Algorithm::kBdd)
+      .approximation(core::Approximation::kNone)
+      .safety_integrity_levels(false)
+      .time_step(0)
+      .probability_analysis(true);
+}
+
+void Server::Serve(std::istream& input, std::ostream& output) {
+  std::string request;
+  while (!done_ && std::getline(input, request)) {
+    if (request.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    output << Process(request) << std::endl;  // Flush for the waiting client.
+  }
+}
+
+std::string Server::Process(const std::string& request) noexcept {
+  CLOCK(request_time);
+  std::ostringstream response;
+  response.precision(std::numeric_limits<double>::max_digits10);
+  try {
+    pt::ptree tree;
+    std::istringstream request_stream(request);
+    pt::read_json(request_stream, tree);
+    std::string type = tree.get<std::string>("request");
+    LOG(DEBUG1) << "Processing the " << type << " request...";
+    response << R"({"status": "ok")";
+
+    if (type == "set-probability") {
+      auto* event = GetEvent<mef::BasicEvent>(tree.get<std::string>("event"));
+      auto expression =
+          std::make_unique<mef::ConstantExpression>(tree.get<double>("value"));
+      mef::Expression* previous =
+          event->HasExpression() ? &event->expression() : nullptr;
+      event->expression(expression.get());
+      try {
+        event->Validate();
+      } catch (const mef::DomainError&) {
+        event->expression(previous);
+        throw;
+      }
+      probabilities_[event] = std::move(expression);  // Frees the previous.
+
+    } else if (type == "set-house-event") {
+      auto* event = GetEvent<mef::HouseEvent>(tree.get<std::string>("event"));
+      bool state = tree.get<bool>("state", !event->state());
+      if (state != event->state()) {
+        event->state(state);
+        analyses_.clear();  // The constants are folded into the graphs.
+      }
+      response << R"(, "state": )" << (state ? "true" : "false");
+
+    } else if (type == "probability" || type == "importance") {
+      const auto* gate = GetEvent<mef::Gate>(tree.get<std::string>("gate"));
+      core::FaultTreeAnalyzer<core::Bdd>* fta = Analyze(*gate);
+      core::ProbabilityAnalyzer<core::Bdd> pa(fta, &model_->mission_time());
+      pa.Analyze();
+      response << R"(, "probability": )" << pa.p_total();
+      if (type == "importance") {
+        core::ImportanceAnalyzer<core::Bdd> ia(&pa);
+        ia.Analyze();
+        response << R"(, "importance": [)";
+        bool first = true;
+        for (const core::ImportanceRecord& record : ia.importance()) {
+          response << (first ? "" : ", ") << R"({"event": )";
+          Quote(record.event.id(), &response);
+          const core::ImportanceFactors& factors = record.factors;
+          response << R"(, "occurrence": )" << factors.occurrence
+                   << R"(, "MIF": )" << factors.mif << R"(, "CIF": )"
+                   << factors.cif << R"(, "DIF": )" << factors.dif
+                   << R"(, "RAW": )" << factors.raw << R"(, "RRW": )"
+                   << factors.rrw << "}";
+          first = false;
+        }
+        response << "]";
+      }
+
+    } else if (type == "quit") {
+      done_ = true;
+
+    } else {
+      SCRAM_THROW(IllegalOperation("Unknown request type: " + type));
+    }
+    response << "}";
+  } catch (const pt::ptree_error& err) {
+    response.str("");
+    response << R"({"status": "error", "message": )";
+    Quote(std::string("Invalid request: ") + err.what(), &response);
+    response << "}";
+  } catch (const Error& err) {
+    response.str("");
+    response << R"({"status": "error", "message": )";
+    Quote(Describe(err), &response);
+    response << "}";
+  }
+  LOG(DEBUG1) << "The request is processed in " << DUR(request_time);
+  return response.str();
+}
+
+core::FaultTreeAnalyzer<core::Bdd>* Server::Analyze(
+    const mef::Gate& gate) noexcept {
+  std::unique_ptr<core::FaultTreeAnalyzer<core::Bdd>>& fta = analyses_[&gate];
+  if (!fta) {
+    fta = std::make_unique<core::FaultTreeAnalyzer<core::Bdd>>(
+        gate, settings_, model_.get());
+    fta->Analyze();
+  }
+  return fta.get();
+}
+
+template <class T>
+T* Server::GetEvent(const std::string& id) {
+  mef::Formula::ArgEvent event = model_->GetEvent(id);
+  if (auto* result = std::get_if<T*>(&event))
+    return *result;
+  SCRAM_THROW(mef::UndefinedElement())
+      << mef::errinfo_element(id, T::kTypeString);
+}
+
+}  // namespace scram
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// The persistent quantification service for what-if requests.
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <boost/noncopyable.hpp>
+
+#include "bdd.h"
+#include "expression/constant.h"
+#include "fault_tree_analysis.h"
+#include "model.h"
+#include "settings.h"
+
+namespace scram {
+
+/// Re-quantifies a resident model upon requests
+/// to change basic event probabilities or house event states.
+///
+/// The requests and responses are JSON objects, one per line:
+///
+///     {"request": "set-probability", "event": "X", "value": 0.01}
+///     {"request": "set-house-event", "event": "H", "state": true}
+///     {"request": "probability", "gate": "G"}
+///     {"request": "importance", "gate": "G"}
+///     {"request": "quit"}
+///
+/// The successful responses have the "ok" status
+/// with the requested results if any.
+/// The failed requests get the "error" status with the message.
+///
+/// The fault tree analyses of gates are kept between requests.
+/// Probability changes re-run only the BDD evaluation,
+/// while house event changes invalidate the analyses
+/// because the constants are propagated into the graphs.
+class Server : private boost::noncopyable {
+ public:
+  /// @param[in] model  The fully initialized and validated model.
+  /// @param[in] settings  The analysis settings.
+  ///                      The BDD algorithm is always used
+  ///                      without probability approximations.
+  ///
+  /// @pre The basic events in the model have probability expressions.
+  Server(std::unique_ptr<mef::Model> model, const core::Settings& settings);
+
+  /// Processes the requests until the end of the input or the quit request.
+  ///
+  /// @param[in] input  The stream of line-delimited requests.
+  /// @param[out] output  The destination for line-delimited responses.
+  void Serve(std::istream& input, std::ostream& output);
+
+  /// Processes a single request.
+  ///
+  /// @param[in] request  The JSON request object.
+  ///
+  /// @returns The JSON response object without the trailing newline.
+  std::string Process(const std::string& request) noexcept;
+
+  /// @returns true if the quit request has been processed.
+  bool done() const { return done_; }
+
+ private:
+  /// @param[in] gate  The top event of the fault tree.
+  ///
+  /// @returns The cached or new fault tree analysis of the gate.
+  core::FaultTreeAnalyzer<core::Bdd>* Analyze(const mef::Gate& gate) noexcept;
+
+  /// Finds an event of the specific type in the model.
+  ///
+  /// @tparam T  The event type.
+  ///
+  /// @param[in] id  The unique ID of the event.
+  ///
+  /// @returns The event with the given ID.
+  ///
+  /// @throws UndefinedElement  The event of the type is not in the model.
+  template <class T>
+  T* GetEvent(const std::string& id);
+
+  std::unique_ptr<mef::Model> model_;  ///< The resident model.
+  core::Settings settings_;  ///< The settings for the analyses.
+  /// The fault tree analyses of the requested gates.
+  std::unordered_map<const mef::Gate*,
+                     std::unique_ptr<core::FaultTreeAnalyzer<core::Bdd>>>
+      analyses_;
+  /// The requested probabilities of basic events.
+  /// Only one expression is kept per event for the whole service.
+  std::unordered_map<const mef::BasicEvent*,
+                     std::unique_ptr<mef::ConstantExpression>>
+      probabilities_;
+  bool done_ = false;  ///< The indication of the quit request.
+};
+
+}  // namespace scram
@@ -39,6 +39,8 @@ Settings& Settings::algorithm(Algorithm value) noexcept {
         approximation(Approximation::kRareEvent);
       if (prime_implicants_)
         prime_implicants(false);
+      if (shared_bdd_)
+        shared_bdd(false);
   }
   return *this;
 }
@@ -84,6 +86,14 @@ Settings& Settings::prime_implicants(bool flag) {
   return *this;
 }
 
+Settings& Settings::shared_bdd(bool flag) {
+  if (flag && algorithm_ != Algorithm::kBdd)
+    SCRAM_THROW(SettingsError("Shared graphs are only available with BDD"));
+
+  shared_bdd_ = flag;
+  return *this;
+}
+
 Settings& Settings::limit_order(int order) {
   if (order < 0)
     SCRAM_THROW(SettingsError(
@@ -131,6 +141,24 @@ Settings& Settings::num_bins(int n) {
   return *this;
 }
 
+Settings& Settings::num_jobs(int n) {
+  if (n < 1)
+    SCRAM_THROW(SettingsError("The number of jobs cannot be less than 1."))
+        << errinfo_value(std::to_string(n));
+
+  num_jobs_ = n;
+  return *this;
+}
+
+Settings& Settings::cache_limit(int megabytes) {
+  if (megabytes < 1)
+    SCRAM_THROW(SettingsError("The cache size limit cannot be less than 1."))
+        << errinfo_value(std::to_string(megabytes));
+
+  cache_limit_ = megabytes;
+  return *this;
+}
+
 Settings& Settings::seed(int s) {
   if (s < 0)
     SCRAM_THROW(SettingsError("The seed for PRNG cannot be negative."))
@@ -172,4 +200,17 @@ Settings& Settings::safety_integrity_levels(bool flag) {
   return *this;
 }
 
+Settings& Settings::sensitivity_analysis(std::string parameter,
+                                         std::vector<double> values) {
+  if (!parameter.empty() && values.empty())
+    SCRAM_THROW(SettingsError("The sensitivity parameter has no values."))
+        << errinfo_value(parameter);
+
+  sensitivity_parameter_ = std::move(parameter);
+  sensitivity_values_ = std::move(values);
+  if (!sensitivity_parameter_.empty())
+    probability_analysis_ = true;
+  return *this;
+}
+
 }  // namespace scram::core
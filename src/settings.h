@@ -22,7 +22,13 @@
 
 #include <cstdint>
 
+#include <memory>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
+
+#include "progress.h"
 
 namespace scram::core {
 
@@ -106,6 +112,21 @@ class Settings {
   /// @throws SettingsError  The request is not relevant to the algorithm.
   Settings& prime_implicants(bool flag);
 
+  /// @returns true if all analysis targets share one PDAG and BDD.
+  bool shared_bdd() const { return shared_bdd_; }
+
+  /// Sets a flag to analyze all targets of a model
+  /// with a single multi-rooted BDD
+  /// instead of a separate graph for each target.
+  /// The shared BDD is only available for the BDD algorithm.
+  ///
+  /// @param[in] flag  True for the request.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The request is not relevant to the algorithm.
+  Settings& shared_bdd(bool flag);
+
   /// @returns The limit on the size of products.
   int limit_order() const { return limit_order_; }
 
@@ -167,6 +188,66 @@ class Settings {
   /// @throws SettingsError  The number is less than 1.
   Settings& num_bins(int n);
 
+  /// @returns The maximum number of analyses to run concurrently.
+  int num_jobs() const { return num_jobs_; }
+
+  /// Sets the number of concurrent jobs for independent analysis targets,
+  /// e.g., event tree sequences and fault tree top events.
+  ///
+  /// @param[in] n  A natural number for the number of jobs.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The number is less than 1.
+  Settings& num_jobs(int n);
+
+  /// @returns The directory of the analysis cache.
+  ///          Empty if the input validation
+  ///          and qualitative analysis results are not cached.
+  const std::string& cache_dir() const { return cache_dir_; }
+
+  /// Sets the directory to keep the qualitative analysis results
+  /// between runs with unchanged model logic
+  /// and the records of the input files known to be valid.
+  ///
+  /// @param[in] path  The cache directory path. Empty path disables caching.
+  ///
+  /// @returns Reference to this object.
+  Settings& cache_dir(std::string path) {
+    cache_dir_ = std::move(path);
+    return *this;
+  }
+
+  /// @returns The limit on the total size of the cache in megabytes.
+  int cache_limit() const { return cache_limit_; }
+
+  /// Sets the limit on the total size of the cache entries.
+  /// The least recently used entries are evicted beyond the limit.
+  ///
+  /// @param[in] megabytes  A natural number for the size limit.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The number is less than 1.
+  Settings& cache_limit(int megabytes);
+
+  /// @returns The channel for cancellation and progress of the analysis.
+  ///          nullptr if the analysis is not observed.
+  const std::shared_ptr<Progress>& progress() const { return progress_; }
+
+  /// Sets the channel for the observers of the analysis.
+  ///
+  /// @param[in] channel  The shared cancellation and progress state.
+  ///
+  /// @returns Reference to this object.
+  Settings& progress(std::shared_ptr<Progress> channel) {
+    progress_ = std::move(channel);
+    return *this;
+  }
+
+  /// @returns true if the cancellation of the analysis is requested.
+  bool canceled() const { return progress_ && progress_->canceled(); }
+
   /// @returns The seed of the pseudo-random number generator.
   int seed() const { return seed_; }
 
@@ -220,7 +301,7 @@ class Settings {
   /// @returns Reference to this object.
   Settings& probability_analysis(bool flag) {
     if (!importance_analysis_ && !uncertainty_analysis_ &&
-        !safety_integrity_levels_) {
+        !safety_integrity_levels_ && !sensitivity_analysis()) {
       probability_analysis_ = flag;
     }
     return *this;
@@ -274,6 +355,38 @@ class Settings {
     return *this;
   }
 
+  /// @returns true if uncertainty analysis must use control variates.
+  bool control_variates() const { return control_variates_; }
+
+  /// Sets the flag for the control-variate Monte Carlo estimator.
+  /// The Rare-Event approximation over the products
+  /// serves as the control variate for exact probability samples.
+  ///
+  /// @param[in] flag  True or false for turning on or off the estimator.
+  ///
+  /// @returns Reference to this object.
+  Settings& control_variates(bool flag) {
+    control_variates_ = flag;
+    return *this;
+  }
+
+  /// @returns true if importance factors are sampled in uncertainty analysis.
+  bool importance_uncertainty() const { return importance_uncertainty_; }
+
+  /// Sets the flag for uncertainty analysis of importance factors.
+  /// The importance factors are calculated in every Monte Carlo trial,
+  /// so importance and uncertainty analyses are turned on implicitly.
+  ///
+  /// @param[in] flag  True or false for turning on or off the analysis.
+  ///
+  /// @returns Reference to this object.
+  Settings& importance_uncertainty(bool flag) {
+    importance_uncertainty_ = flag;
+    if (importance_uncertainty_)
+      importance_analysis(true).uncertainty_analysis(true);
+    return *this;
+  }
+
   /// @returns true if CCF groups must be incorporated into analysis.
   bool ccf_analysis() const { return ccf_analysis_; }
 
@@ -287,6 +400,33 @@ class Settings {
     return *this;
   }
 
+  /// @returns true if sensitivity analysis is requested.
+  bool sensitivity_analysis() const { return !sensitivity_parameter_.empty(); }
+
+  /// @returns The ID of the parameter swept in sensitivity analysis.
+  const std::string& sensitivity_parameter() const {
+    return sensitivity_parameter_;
+  }
+
+  /// @returns The values of the parameter for sensitivity analysis.
+  const std::vector<double>& sensitivity_values() const {
+    return sensitivity_values_;
+  }
+
+  /// Sets the parameter sweep for sensitivity analysis.
+  /// Sensitivity analysis implies probability analysis,
+  /// so the probability analysis is turned on implicitly.
+  ///
+  /// @param[in] parameter  The ID of the model parameter to be swept.
+  ///                       Empty ID turns off the analysis.
+  /// @param[in] values  The values of the parameter in the analysis order.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The parameter has no values to sweep.
+  Settings& sensitivity_analysis(std::string parameter,
+                                 std::vector<double> values);
+
 #ifndef NDEBUG
   bool preprocessor = false;  ///< Stop analysis after preprocessor.
   bool print = false;  ///< Print analysis results in a terminal friendly way.
@@ -297,8 +437,11 @@ class Settings {
   bool safety_integrity_levels_ = false;  ///< Calculation of the SIL metrics.
   bool importance_analysis_ = false;  ///< A flag for importance analysis.
   bool uncertainty_analysis_ = false;  ///< A flag for uncertainty analysis.
+  bool control_variates_ = false;  ///< Control variates for Monte Carlo.
+  bool importance_uncertainty_ = false;  ///< Sampling of importance factors.
   bool ccf_analysis_ = false;  ///< A flag for common-cause analysis.
   bool prime_implicants_ = false;  ///< Calculation of prime implicants.
+  bool shared_bdd_ = false;  ///< Analysis of all targets with one BDD.
   /// Qualitative analysis algorithm.
   Algorithm algorithm_ = Algorithm::kBdd;
   /// The approximations for calculations.
@@ -308,9 +451,15 @@ class Settings {
   int num_trials_ = 1e3;  ///< The number of trials for Monte Carlo simulations.
   int num_quantiles_ = 20;  ///< The number of quantiles for distributions.
   int num_bins_ = 20;  ///< The number of bins for histograms.
+  int num_jobs_ = 1;  ///< The number of concurrent analysis jobs.
   double mission_time_ = 8760;  ///< System mission time.
   double time_step_ = 0;  ///< The time step for probability analyses.
   double cut_off_ = 1e-8;  ///< The cut-off probability for products.
+  std::string cache_dir_;  ///< The directory of the analysis cache.
+  int cache_limit_ = 1024;  ///< The limit on the cache size in megabytes.
+  std::shared_ptr<Progress> progress_;  ///< The optional analysis observers.
+  std::string sensitivity_parameter_;  ///< The swept parameter ID.
+  std::vector<double> sensitivity_values_;  ///< The swept parameter values.
 };
 
 }  // namespace scram::core
@@ -30,7 +30,7 @@ void Substitution::Add(BasicEvent* source_event) {
         return arg->id() == source_event->id();
       })) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(source_event->id(), "source event");
+        << errinfo_element(std::string(source_event->id()), "source event");
   }
   source_.push_back(source_event);
 }
@@ -42,13 +42,13 @@ void Substitution::Validate() const {
       })) {
     SCRAM_THROW(ValidityError(
         "Substitution hypothesis must be built over basic events only."))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
 
   if (ext::any_of(hypothesis_->args(),
                   [](const Formula::Arg& arg) { return arg.complement; })) {
     SCRAM_THROW(ValidityError("Substitution hypotheses must be coherent."))
-        << errinfo_element(Element::name(), kTypeString);
+        << errinfo_element(std::string(Element::name()), kTypeString);
   }
 
   if (declarative()) {
@@ -60,14 +60,14 @@ void Substitution::Validate() const {
         break;
       default:
         SCRAM_THROW(ValidityError("Substitution hypotheses must be coherent."))
-            << errinfo_element(Element::name(), kTypeString)
+            << errinfo_element(std::string(Element::name()), kTypeString)
             << errinfo_connective(
                    kConnectiveToString[hypothesis_->connective()]);
     }
     const bool* constant = std::get_if<bool>(&target_);
     if (constant && *constant)
       SCRAM_THROW(ValidityError("Substitution has no effect."))
-          << errinfo_element(Element::name(), kTypeString);
+          << errinfo_element(std::string(Element::name()), kTypeString);
   } else {  // Non-declarative.
     switch (hypothesis_->connective()) {
       case kNull:
@@ -78,14 +78,14 @@ void Substitution::Validate() const {
         SCRAM_THROW(
             ValidityError("Non-declarative substitution hypotheses only allow "
                           "AND/OR/NULL connectives."))
-            << errinfo_element(Element::name(), kTypeString)
+            << errinfo_element(std::string(Element::name()), kTypeString)
             << errinfo_connective(
                    kConnectiveToString[hypothesis_->connective()]);
     }
     const bool* constant = std::get_if<bool>(&target_);
     if (constant && !*constant)
       SCRAM_THROW(ValidityError("Substitution source set is irrelevant."))
-          << errinfo_element(Element::name(), kTypeString);
+          << errinfo_element(std::string(Element::name()), kTypeString);
   }
 }
 
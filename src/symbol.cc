@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the interned string pool.
+
+#include "symbol.h"
+
+#include <cassert>
+#include <cstring>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace scram::mef {
+
+/// The strings are allocated in large blocks,
+/// and the hash index is an open-addressing table
+/// with linear probing over the pointers to the strings.
+/// The strings are split into independent shards by their hash values.
+class Symbol::Pool {
+ public:
+  /// @returns The process-wide pool.
+  ///
+  /// @note The pool is never destroyed
+  ///       to outlive the symbols in static objects.
+  static Pool& instance() {
+    static Pool* pool = new Pool;
+    return *pool;
+  }
+
+  /// Finds or adds the string into the pool.
+  ///
+  /// @param[in] value  The non-empty string.
+  ///
+  /// @returns The pooled string counted for a new symbol.
+  const Entry* Intern(std::string_view value) {
+    std::size_t hash = std::hash<std::string_view>()(value);
+    Shard& shard = GetShard(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const Entry* entry = shard.Intern(value, hash);
+    shard.num_symbols.fetch_add(1, std::memory_order_relaxed);
+    return entry;
+  }
+
+  /// @param[in] value  The string to look up.
+  ///
+  /// @returns The pooled string if any without counting it.
+  const Entry* Find(std::string_view value) noexcept {
+    std::size_t hash = std::hash<std::string_view>()(value);
+    Shard& shard = GetShard(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.Find(value, hash);
+  }
+
+  /// Counts another symbol of the pooled string.
+  void Acquire(const Entry* entry) noexcept {
+    GetShard(entry->hash).num_symbols.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Uncounts a symbol of the pooled string.
+  void Release(const Entry* entry) noexcept {
+    GetShard(entry->hash).num_symbols.fetch_sub(1, std::memory_order_release);
+  }
+
+  /// Frees the shards without live symbols.
+  void ReleaseUnused() noexcept {
+    for (Shard& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      // The symbols are only created from the live symbols of the shard
+      // or under the lock.
+      if (!shard.num_symbols.load(std::memory_order_acquire))
+        shard.Clear();
+    }
+  }
+
+  /// Registers the pool user.
+  void AddUser() noexcept { num_users_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// Releases the unused shards after the last user.
+  void RemoveUser() noexcept {
+    if (num_users_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      ReleaseUnused();
+  }
+
+  /// @returns The number of the pooled strings.
+  std::size_t size() noexcept {
+    std::size_t num_entries = 0;
+    for (Shard& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      num_entries += shard.num_entries;
+    }
+    return num_entries;
+  }
+
+ private:
+  static const int kShardBits = 4;  ///< The hash bits to select the shards.
+  static const int kNumShards = 1 << kShardBits;  ///< The number of shards.
+  static const std::size_t kMinSlots = 1 << 10;  ///< The initial index size.
+  static const std::size_t kBlockSize = 1 << 16;  ///< The arena block size.
+
+  /// The part of the pool with its own lock, index, and arena.
+  struct alignas(64) Shard {
+    /// @returns The pooled string or nullptr.
+    const Entry* Find(std::string_view value, std::size_t hash) noexcept {
+      return slots.empty() ? nullptr : *Probe(value, hash);
+    }
+
+    /// @returns The pooled string added if new.
+    const Entry* Intern(std::string_view value, std::size_t hash) {
+      if (slots.empty())
+        Rehash(kMinSlots);
+      const Entry** slot = Probe(value, hash);
+      if (*slot)
+        return *slot;
+      if (value.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("The string is too long to intern.");
+      if (2 * (num_entries + 1) > slots.size()) {  // The load factor of 1/2.
+        Rehash(2 * slots.size());
+        slot = Probe(value, hash);
+      }
+      void* data = Allocate(sizeof(Entry) + value.size() + 1);
+      auto* entry =
+          new (data) Entry{hash, static_cast<std::uint32_t>(value.size())};
+      char* chars = const_cast<char*>(entry->data());
+      std::memcpy(chars, value.data(), value.size());
+      chars[value.size()] = '\0';
+      ++num_entries;
+      return *slot = entry;
+    }
+
+    /// Frees all the strings.
+    void Clear() noexcept {
+      slots = decltype(slots)();
+      num_entries = 0;
+      blocks = decltype(blocks)();
+      block = nullptr;
+      free = 0;
+    }
+
+    /// @returns The index slot of the string or the empty slot to insert it.
+    ///
+    /// @pre The index is not empty.
+    const Entry** Probe(std::string_view value, std::size_t hash) noexcept {
+      assert(!slots.empty());
+      std::size_t mask = slots.size() - 1;
+      for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Entry*& slot = slots[i];
+        if (!slot || (slot->hash == hash &&
+                      std::string_view(slot->data(), slot->size) == value))
+          return &slot;
+      }
+    }
+
+    /// Rebuilds the hash index with the new size.
+    ///
+    /// @param[in] num_slots  The power-of-two number of the slots.
+    void Rehash(std::size_t num_slots) {
+      std::vector<const Entry*> new_slots(num_slots);
+      std::size_t mask = num_slots - 1;
+      for (const Entry* entry : slots) {
+        if (!entry)
+          continue;
+        std::size_t i = entry->hash & mask;
+        while (new_slots[i])
+          i = (i + 1) & mask;
+        new_slots[i] = entry;
+      }
+      slots = std::move(new_slots);
+    }
+
+    /// @returns The memory in the arena aligned for the string headers.
+    void* Allocate(std::size_t size) {
+      size = (size + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+      if (size > kBlockSize / 4) {  // Large strings get dedicated blocks.
+        blocks.emplace_back(new char[size]);
+        return blocks.back().get();
+      }
+      if (free + size > kBlockSize || !block) {
+        blocks.emplace_back(new char[kBlockSize]);
+        block = blocks.back().get();
+        free = 0;
+      }
+      void* data = block + free;
+      free += size;
+      return data;
+    }
+
+    std::mutex mutex;  ///< The guard of the shard.
+    std::atomic<std::size_t> num_symbols = 0;  ///< The live symbols.
+    std::vector<const Entry*> slots;  ///< The hash index of the strings.
+    std::size_t num_entries = 0;  ///< The number of the strings.
+    std::vector<std::unique_ptr<char[]>> blocks;  ///< The arena memory.
+    char* block = nullptr;  ///< The current block for small strings.
+    std::size_t free = 0;  ///< The start of the free memory in the block.
+  };
+
+  /// @returns The shard of the strings with the hash value.
+  ///          The high bits of the hash select the shard,
+  ///          and the low bits select the index slot in the shard.
+  Shard& GetShard(std::size_t hash) noexcept {
+    return shards_[hash >>
+                   (std::numeric_limits<std::size_t>::digits - kShardBits)];
+  }
+
+  Shard shards_[kNumShards];  ///< The independent parts of the pool.
+  std::atomic<int> num_users_ = 0;  ///< The number of the pool users.
+};
+
+Symbol::Symbol(std::string_view value)
+    : entry_(value.empty() ? nullptr : Pool::instance().Intern(value)) {}
+
+Symbol::Key Symbol::Find(std::string_view value) noexcept {
+  return Key(value.empty() ? nullptr : Pool::instance().Find(value));
+}
+
+std::size_t Symbol::pool_size() noexcept { return Pool::instance().size(); }
+
+void Symbol::ReleaseUnused() noexcept { Pool::instance().ReleaseUnused(); }
+
+void Symbol::Acquire() const noexcept { Pool::instance().Acquire(entry_); }
+
+void Symbol::Release() const noexcept { Pool::instance().Release(entry_); }
+
+SymbolPoolUser::SymbolPoolUser() noexcept {
+  Symbol::Pool::instance().AddUser();
+}
+
+SymbolPoolUser::~SymbolPoolUser() noexcept {
+  Symbol::Pool::instance().RemoveUser();
+}
+
+}  // namespace scram::mef
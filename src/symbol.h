@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Interned strings for the identifiers of MEF constructs.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <string_view>
+#include <utility>
+
+namespace scram::mef {
+
+/// Immutable interned string.
+/// Equal strings share a single copy in the process-wide string pool,
+/// so the symbols are compared by their identity
+/// and hashed with the hash value computed upon the interning.
+///
+/// The pool is a thread-safe arena split into shards by the string hash.
+/// The shards are locked independently,
+/// so concurrent model loads rarely contend for the pool.
+/// Models with the same identifiers share the strings,
+/// e.g., the models of the batch analysis or the reloads of the model.
+/// The shards count their live symbols
+/// and are released as the last model is destroyed (see SymbolPoolUser)
+/// if no symbols refer to their strings anymore.
+/// The lookups of existing strings are not counted (see Symbol::Key),
+/// so the frequent probes of tables do not update the shared counts.
+class Symbol {
+ public:
+  class Key;  ///< The uncounted reference for lookups.
+
+  /// Constructs the empty string symbol.
+  Symbol() noexcept = default;
+
+  /// Interns the string into the pool.
+  ///
+  /// @param[in] value  The string value.
+  explicit Symbol(std::string_view value);
+
+  /// The symbols keep their strings in the pool.
+  /// @{
+  Symbol(const Symbol& other) noexcept : entry_(other.entry_) {
+    if (entry_)
+      Acquire();
+  }
+  Symbol(Symbol&& other) noexcept : entry_(std::exchange(other.entry_, {})) {}
+  Symbol& operator=(Symbol other) noexcept {
+    std::swap(entry_, other.entry_);
+    return *this;
+  }
+  ~Symbol() noexcept {
+    if (entry_)
+      Release();
+  }
+  /// @}
+
+  /// Looks up the string in the pool without interning.
+  ///
+  /// @param[in] value  The string value.
+  ///
+  /// @returns The key of the interned value.
+  ///          The empty key if the value has never been interned.
+  ///
+  /// @note The lookups for the references to non-existent strings
+  ///       do not grow the pool.
+  static Key Find(std::string_view value) noexcept;
+
+  /// @returns The number of the interned strings in the pool.
+  static std::size_t pool_size() noexcept;
+
+  /// Releases the memory of the pool shards without live symbols.
+  static void ReleaseUnused() noexcept;
+
+  /// @returns true for the empty string.
+  bool empty() const noexcept { return !entry_; }
+
+  /// @returns The interned string.
+  std::string_view view() const noexcept {
+    return entry_ ? std::string_view(entry_->data(), entry_->size)
+                  : std::string_view();
+  }
+
+  /// @returns The hash value of the string.
+  std::size_t hash() const noexcept {
+    return entry_ ? entry_->hash : std::hash<std::string_view>()({});
+  }
+
+  /// Comparison of the interned strings by identity.
+  /// @{
+  friend bool operator==(const Symbol& lhs, const Symbol& rhs) noexcept {
+    return lhs.entry_ == rhs.entry_;
+  }
+  friend bool operator!=(const Symbol& lhs, const Symbol& rhs) noexcept {
+    return lhs.entry_ != rhs.entry_;
+  }
+  /// @}
+
+ private:
+  /// The string header in the pool followed by the null-terminated string.
+  struct Entry {
+    /// @returns The characters of the string.
+    const char* data() const noexcept {
+      return reinterpret_cast<const char*>(this + 1);
+    }
+
+    std::size_t hash;  ///< The hash value of the string.
+    std::uint32_t size;  ///< The length of the string.
+  };
+
+  friend class SymbolPoolUser;  // Registers the users of the pool.
+
+  class Pool;  ///< The arena with the hash index of the interned strings.
+
+  /// Counts the symbol in the pool.
+  ///
+  /// @pre The symbol is not empty.
+  void Acquire() const noexcept;
+
+  /// Uncounts the symbol in the pool.
+  ///
+  /// @pre The symbol is not empty.
+  void Release() const noexcept;
+
+  const Entry* entry_ = nullptr;  ///< The pooled string; null if empty.
+};
+
+/// Uncounted reference to an interned string
+/// to probe the tables of symbols by identity.
+///
+/// @warning The key is valid only while the pool has users,
+///          i.e., the key must not outlive the lookup in the model.
+class Symbol::Key {
+ public:
+  /// Constructs the empty string key.
+  Key() noexcept = default;
+
+  /// @returns true for the empty string.
+  bool empty() const noexcept { return !entry_; }
+
+  /// @returns The hash value of the string.
+  std::size_t hash() const noexcept {
+    return entry_ ? entry_->hash : std::hash<std::string_view>()({});
+  }
+
+  /// Comparison with the symbols by identity.
+  /// @{
+  friend bool operator==(const Key& lhs, const Symbol& rhs) noexcept {
+    return lhs.refers(rhs);
+  }
+  friend bool operator==(const Symbol& lhs, const Key& rhs) noexcept {
+    return rhs.refers(lhs);
+  }
+  /// @}
+
+ private:
+  friend class Symbol;  // Finds the strings.
+
+  /// @param[in] entry  The existing string in the pool.
+  explicit Key(const Entry* entry) noexcept : entry_(entry) {}
+
+  /// @returns true if the symbol has the string of this key.
+  bool refers(const Symbol& symbol) const noexcept {
+    return entry_ == symbol.entry_;
+  }
+
+  const Entry* entry_ = nullptr;  ///< The pooled string; null if empty.
+};
+
+/// Base class of the owners of most symbols, i.e., the models.
+/// The unused memory of the pool is released
+/// as the last user is destroyed after all its symbols.
+class SymbolPoolUser {
+ protected:
+  SymbolPoolUser() noexcept;
+  SymbolPoolUser(const SymbolPoolUser&) noexcept : SymbolPoolUser() {}
+  SymbolPoolUser& operator=(const SymbolPoolUser&) noexcept { return *this; }
+  ~SymbolPoolUser() noexcept;
+};
+
+/// The hash of the symbols
+/// compatible with the lookups by the string values.
+struct SymbolHash {
+  /// @returns The hash value of the string.
+  /// @{
+  std::size_t operator()(const Symbol& symbol) const noexcept {
+    return symbol.hash();
+  }
+  std::size_t operator()(const Symbol::Key& key) const noexcept {
+    return key.hash();
+  }
+  std::size_t operator()(std::string_view value) const noexcept {
+    return std::hash<std::string_view>()(value);
+  }
+  /// @}
+};
+
+/// The equality of the symbols
+/// compatible with the lookups by the string values.
+struct SymbolEqual {
+  /// @returns true if the strings are equal.
+  /// @{
+  bool operator()(const Symbol& lhs, const Symbol& rhs) const noexcept {
+    return lhs == rhs;
+  }
+  bool operator()(std::string_view lhs, const Symbol& rhs) const noexcept {
+    return lhs == rhs.view();
+  }
+  bool operator()(const Symbol& lhs, std::string_view rhs) const noexcept {
+    return lhs.view() == rhs;
+  }
+  bool operator()(const Symbol::Key& lhs, const Symbol& rhs) const noexcept {
+    return lhs == rhs;
+  }
+  bool operator()(const Symbol& lhs, const Symbol::Key& rhs) const noexcept {
+    return lhs == rhs;
+  }
+  /// @}
+};
+
+}  // namespace scram::mef
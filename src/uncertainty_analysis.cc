@@ -22,6 +22,8 @@
 
 #include <cmath>
 
+#include <unordered_set>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/density.hpp>
 #include <boost/accumulators/statistics/extended_p_square_quantile.hpp>
@@ -32,9 +34,87 @@
 #include "event.h"
 #include "expression.h"
 #include "logger.h"
+#include "zbdd.h"
 
 namespace scram::core {
 
+/// Streaming statistics of importance factors of the tracked variables.
+class UncertaintyAnalysis::ImportanceAccumulator {
+ public:
+  /// Starts statistics with no tracked variables.
+  ImportanceAccumulator() : bands_({0.05, 0.5, 0.95}) {}
+
+  /// Adds a variable to track.
+  ///
+  /// @param[in] index  The index of the variable.
+  /// @param[in] event  The event of the variable.
+  void Track(int index, const mef::BasicEvent& event) {
+    using namespace boost::accumulators;  // NOLINT
+    std::vector<Accumulator> factors;
+    for (int i = 0; i < kNumFactors; ++i)
+      factors.emplace_back(extended_p_square_probabilities = bands_);
+    entries_.push_back({index, event, std::move(factors)});
+  }
+
+  /// Streams the importance factors of a single trial.
+  ///
+  /// @param[in] p_total  The total probability.
+  /// @param[in] mifs  The MIF values in the order of the graph basic events.
+  /// @param[in] p_vars  The probabilities of variables.
+  void operator()(double p_total, const std::vector<double>& mifs,
+                  const Pdag::IndexMap<double>& p_vars) noexcept {
+    for (Entry& entry : entries_) {
+      ImportanceFactors imp = ImportanceAnalysis::CalculateFactors(
+          p_total, p_vars[entry.index],
+          mifs[entry.index - Pdag::kVariableStartIndex]);
+      entry.factors[0](imp.mif);
+      entry.factors[1](imp.cif);
+      entry.factors[2](imp.dif);
+      entry.factors[3](imp.raw);
+      entry.factors[4](imp.rrw);
+    }
+  }
+
+  /// @returns The distributions of the factors of the tracked variables.
+  std::vector<ImportanceDistribution> Extract() noexcept {
+    using namespace boost::accumulators;  // NOLINT
+    auto extract = [this](const Accumulator& acc) {
+      return FactorStatistics{
+          boost::accumulators::mean(acc),
+          quantile(acc, quantile_probability = bands_[0]),
+          quantile(acc, quantile_probability = bands_[1]),
+          quantile(acc, quantile_probability = bands_[2])};
+    };
+    std::vector<ImportanceDistribution> result;
+    for (const Entry& entry : entries_) {
+      result.push_back({entry.event, extract(entry.factors[0]),
+                        extract(entry.factors[1]), extract(entry.factors[2]),
+                        extract(entry.factors[3]), extract(entry.factors[4])});
+    }
+    return result;
+  }
+
+ private:
+  static constexpr int kNumFactors = 5;  ///< MIF, CIF, DIF, RAW, RRW.
+
+  /// Streaming estimators of the mean and the quantile bands.
+  using Accumulator = boost::accumulators::accumulator_set<
+      double,
+      boost::accumulators::stats<
+          boost::accumulators::tag::mean,
+          boost::accumulators::tag::extended_p_square_quantile>>;
+
+  /// The statistics of a single tracked variable.
+  struct Entry {
+    int index;  ///< The index of the variable.
+    const mef::BasicEvent& event;  ///< The event of the variable.
+    std::vector<Accumulator> factors;  ///< In the order of kNumFactors.
+  };
+
+  std::vector<double> bands_;  ///< The probabilities of the reported quantiles.
+  std::vector<Entry> entries_;  ///< The tracked variables.
+};
+
 UncertaintyAnalysis::UncertaintyAnalysis(
     const ProbabilityAnalysis* prob_analysis)
     : Analysis(prob_analysis->settings()),
@@ -42,6 +122,8 @@ UncertaintyAnalysis::UncertaintyAnalysis(
       sigma_(0),
       error_factor_(1) {}
 
+UncertaintyAnalysis::~UncertaintyAnalysis() = default;
+
 void UncertaintyAnalysis::Analyze() noexcept {
   CLOCK(analysis_time);
   CLOCK(sample_time);
@@ -49,6 +131,10 @@ void UncertaintyAnalysis::Analyze() noexcept {
   // Sample probabilities and generate data.
   std::vector<double> samples = this->Sample();
   LOG(DEBUG3) << "Finished sampling probabilities in " << DUR(sample_time);
+  if (Analysis::settings().canceled()) {
+    Analysis::AddWarning("The analysis is canceled.");
+    return;
+  }
 
   {
     TIMER(DEBUG3, "Calculating statistics");
@@ -70,18 +156,41 @@ UncertaintyAnalysis::GatherDeviateExpressions(const Pdag* graph) noexcept {
   return deviate_expressions;
 }
 
+mef::ExpressionProgram UncertaintyAnalysis::CompileExpressions(
+    const std::vector<std::pair<int, mef::Expression&>>&
+        deviate_expressions) noexcept {
+  std::vector<mef::Expression*> expressions;
+  for (const auto& expression : deviate_expressions)
+    expressions.push_back(&expression.second);
+  mef::ExpressionProgram program(expressions,
+                                 mef::ExpressionProgram::Mode::kSample);
+  LOG(DEBUG4) << "Compiled deviate expressions into " << program.size()
+              << " instructions";
+  return program;
+}
+
 void UncertaintyAnalysis::SampleExpressions(
     const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
-    Pdag::IndexMap<double>* p_vars) noexcept {
-  // Reset distributions.
-  for (const auto& expression : deviate_expressions)
-    expression.second.Reset();
+    mef::ExpressionProgram* program, Pdag::IndexMap<double>* p_vars) noexcept {
+  program->Run();  // Resets and samples all expressions with distributions.
+  for (int i = 0; i < deviate_expressions.size(); ++i) {
+    double prob = program->result(i);
+    (*p_vars)[deviate_expressions[i].first] =
+        prob > 1 ? 1 : prob < 0 ? 0 : prob;
+  }
+}
 
-  // Sample all expressions with distributions.
-  for (const auto& expression : deviate_expressions) {
-    double prob = expression.second.Sample();
-    (*p_vars)[expression.first] = prob > 1 ? 1 : prob < 0 ? 0 : prob;
+double UncertaintyAnalysis::CalculateRareEventSum(
+    const Zbdd& products, const Pdag::IndexMap<double>& p_vars) noexcept {
+  double sum = 0;
+  for (const std::vector<int>& product : products) {
+    double prob = 1;
+    for (int literal : product) {
+      prob *= literal < 0 ? 1 - p_vars[std::abs(literal)] : p_vars[literal];
+    }
+    sum += prob;
   }
+  return sum;
 }
 
 void UncertaintyAnalysis::CalculateStatistics(
@@ -118,6 +227,79 @@ void UncertaintyAnalysis::CalculateStatistics(
   for (int i = 0; i < num_quantiles; ++i) {
     quantiles_[i] = quantile(acc, quantile_probability = quantiles_[i]);
   }
+
+  if (control_) {
+    ApplyControlVariate(samples);
+    control_.reset();
+  }
+  if (importance_accumulator_) {
+    importance_ = importance_accumulator_->Extract();
+    importance_accumulator_.reset();
+  }
+}
+
+void UncertaintyAnalysis::TrackImportance(
+    const ImportanceAnalysis& importance_analysis, const Pdag* graph) noexcept {
+  std::unordered_set<const mef::BasicEvent*> important_events;
+  for (const ImportanceRecord& record : importance_analysis.importance())
+    important_events.insert(&record.event);
+
+  importance_accumulator_ = std::make_unique<ImportanceAccumulator>();
+  int index = Pdag::kVariableStartIndex;
+  for (const mef::BasicEvent* event : graph->basic_events()) {
+    if (important_events.count(event))
+      importance_accumulator_->Track(index, *event);
+    ++index;
+  }
+}
+
+void UncertaintyAnalysis::AccumulateImportance(
+    double p_total, const std::vector<double>& mifs,
+    const Pdag::IndexMap<double>& p_vars) noexcept {
+  assert(importance_accumulator_ && "Importance factors are not tracked.");
+  (*importance_accumulator_)(p_total, mifs, p_vars);
+}
+
+void UncertaintyAnalysis::ApplyControlVariate(
+    const std::vector<double>& samples) noexcept {
+  assert(control_->samples.size() == samples.size());
+  int num_trials = samples.size();
+  if (num_trials < 3)
+    return;  // Not enough degrees of freedom for the regression.
+
+  double mean_x = 0;
+  double mean_c = 0;
+  for (int i = 0; i < num_trials; ++i) {
+    mean_x += samples[i];
+    mean_c += control_->samples[i];
+  }
+  mean_x /= num_trials;
+  mean_c /= num_trials;
+
+  double sum_xx = 0;
+  double sum_cc = 0;
+  double sum_xc = 0;
+  for (int i = 0; i < num_trials; ++i) {
+    double dx = samples[i] - mean_x;
+    double dc = control_->samples[i] - mean_c;
+    sum_xx += dx * dx;
+    sum_cc += dc * dc;
+    sum_xc += dx * dc;
+  }
+  if (sum_cc <= 0 || sum_xx <= 0)
+    return;  // The constant control carries no information.
+
+  double beta = sum_xc / sum_cc;  // The optimal control coefficient.
+  double var_x = sum_xx / (num_trials - 1);
+  double var_residual = (sum_xx - beta * sum_xc) / (num_trials - 2);
+  mean_ = std::clamp(mean_x - beta * (mean_c - control_->mean), 0.0, 1.0);
+  double var_mean = std::max(var_residual, 0.0) / num_trials +
+                    beta * beta * control_->mean_variance;
+  double half_width = 1.96 * std::sqrt(var_mean);
+  confidence_interval_.first = mean_ - half_width;
+  confidence_interval_.second = mean_ + half_width;
+  if (var_mean > 0)
+    variance_reduction_ = var_x / num_trials / var_mean;
 }
 
 }  // namespace scram::core
@@ -21,19 +21,44 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "analysis.h"
+#include "expression/program.h"
+#include "importance_analysis.h"
 #include "probability_analysis.h"
 #include "settings.h"
 
 namespace scram::mef {  // Decouple from the implementation dependence.
 class Expression;
+class BasicEvent;
 }  // namespace scram::mef
 
 namespace scram::core {
 
+/// Statistics of an importance factor with uncertain probabilities.
+struct FactorStatistics {
+  double mean;  ///< The mean value of the factor.
+  double lower;  ///< The 5th percentile of the factor.
+  double median;  ///< The 50th percentile of the factor.
+  double upper;  ///< The 95th percentile of the factor.
+};
+
+/// Mapping of an event and the distributions of its importance factors.
+struct ImportanceDistribution {
+  const mef::BasicEvent& event;  ///< The event occurring in products.
+  FactorStatistics mif;  ///< Birnbaum marginal importance factor.
+  FactorStatistics cif;  ///< Critical importance factor.
+  FactorStatistics dif;  ///< Fussel-Vesely diagnosis importance factor.
+  FactorStatistics raw;  ///< Risk achievement worth factor.
+  FactorStatistics rrw;  ///< Risk reduction worth factor.
+};
+
 /// Uncertainty analysis and statistics
 /// for top event or gate probabilities
 /// with probability distributions of basic events.
@@ -46,7 +71,7 @@ class UncertaintyAnalysis : public Analysis {
   /// @param[in] prob_analysis  Completed probability analysis.
   explicit UncertaintyAnalysis(const ProbabilityAnalysis* prob_analysis);
 
-  virtual ~UncertaintyAnalysis() = default;
+  virtual ~UncertaintyAnalysis();
 
   /// Performs quantitative analysis on the total probability.
   ///
@@ -75,7 +100,31 @@ class UncertaintyAnalysis : public Analysis {
   /// @returns Quantiles of the distribution.
   const std::vector<double>& quantiles() const { return quantiles_; }
 
+  /// @returns The variance reduction factor of the mean estimator
+  ///          achieved with control variates.
+  ///          None if no control variate has been applied.
+  const std::optional<double>& variance_reduction() const {
+    return variance_reduction_;
+  }
+
+  /// @returns Distributions of importance factors of important events.
+  ///          Empty if importance factors have not been sampled.
+  const std::vector<ImportanceDistribution>& importance() const {
+    return importance_;
+  }
+
  protected:
+  /// The number of control-only trials per estimator trial
+  /// to estimate the expected value of the control variate.
+  static constexpr int kControlTrialsFactor = 10;
+
+  /// Control variate samples paired with the trials of the estimator.
+  struct ControlVariate {
+    double mean;  ///< The estimated expected value of the control variate.
+    double mean_variance;  ///< The variance of the expected value estimate.
+    std::vector<double> samples;  ///< The control values in trial order.
+  };
+
   /// Gathers deviate expressions of variables.
   ///
   /// @param[in] graph  PDAG with the variables.
@@ -84,15 +133,64 @@ class UncertaintyAnalysis : public Analysis {
   std::vector<std::pair<int, mef::Expression&>>
   GatherDeviateExpressions(const Pdag* graph) noexcept;
 
+  /// Compiles deviate expressions for sampling.
+  ///
+  /// @param[in] deviate_expressions  A collection of deviate expressions.
+  ///
+  /// @returns The program to sample the expressions in the given order.
+  static mef::ExpressionProgram CompileExpressions(
+      const std::vector<std::pair<int, mef::Expression&>>&
+          deviate_expressions) noexcept;
+
   /// Samples uncertain probabilities.
   ///
   /// @param[in] deviate_expressions  A collection of deviate expressions.
+  /// @param[in,out] program  The program compiled from the expressions.
   /// @param[in,out] p_vars  Indices to probabilities mapping with values.
   void SampleExpressions(
       const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
+      mef::ExpressionProgram* program,
       Pdag::IndexMap<double>* p_vars) noexcept;
 
+  /// Calculates the Rare-Event approximation of products
+  /// without any adjustment into the probability domain.
+  /// The sum is cheap to compute and strongly correlated
+  /// with the exact probability for rare events.
+  ///
+  /// @param[in] products  The products of the qualitative analysis.
+  /// @param[in] p_vars  Probabilities of events mapped by the variable indices.
+  ///
+  /// @returns The plain sum of the product probabilities.
+  static double CalculateRareEventSum(
+      const Zbdd& products, const Pdag::IndexMap<double>& p_vars) noexcept;
+
+  /// Registers control variate samples
+  /// to correct the statistics of the next sample set.
+  ///
+  /// @param[in] control  The samples paired with the estimator trials.
+  void control_variate(ControlVariate control) {
+    control_ = std::move(control);
+  }
+
+  /// Starts streaming statistics of importance factors
+  /// for the important events found by the importance analysis.
+  ///
+  /// @param[in] importance_analysis  Completed importance analysis.
+  /// @param[in] graph  PDAG with the variables.
+  void TrackImportance(const ImportanceAnalysis& importance_analysis,
+                       const Pdag* graph) noexcept;
+
+  /// Streams importance factors of a single trial into the statistics.
+  ///
+  /// @param[in] p_total  The sampled total probability.
+  /// @param[in] mifs  The MIF values in the order of the graph basic events.
+  /// @param[in] p_vars  The sampled probabilities of variables.
+  void AccumulateImportance(double p_total, const std::vector<double>& mifs,
+                            const Pdag::IndexMap<double>& p_vars) noexcept;
+
  private:
+  class ImportanceAccumulator;  ///< Streaming statistics of the factors.
+
   /// Performs Monte Carlo Simulation
   /// by sampling the probability distributions
   /// and providing the final sampled values of the final probability.
@@ -105,6 +203,12 @@ class UncertaintyAnalysis : public Analysis {
   /// @param[in] samples  Gathered samples for statistical analysis.
   void CalculateStatistics(const std::vector<double>& samples) noexcept;
 
+  /// Corrects the mean estimate and its confidence interval
+  /// with the registered control variate.
+  ///
+  /// @param[in] samples  Gathered samples paired with the control samples.
+  void ApplyControlVariate(const std::vector<double>& samples) noexcept;
+
   double mean_;  ///< The mean of the final distribution.
   double sigma_;  ///< The standard deviation of the final distribution.
   double error_factor_;  ///< Error factor for 95% confidence level.
@@ -114,6 +218,12 @@ class UncertaintyAnalysis : public Analysis {
   std::vector<std::pair<double, double>> distribution_;
   /// The quantiles of the distribution.
   std::vector<double> quantiles_;
+  std::optional<ControlVariate> control_;  ///< The optional control variate.
+  std::optional<double> variance_reduction_;  ///< The control effectiveness.
+  /// The statistics of importance factors in progress.
+  std::unique_ptr<ImportanceAccumulator> importance_accumulator_;
+  /// The distributions of importance factors.
+  std::vector<ImportanceDistribution> importance_;
 };
 
 /// Uncertainty analysis facility.
@@ -126,9 +236,17 @@ class UncertaintyAnalyzer : public UncertaintyAnalysis {
   /// Probability analyzer facilities are used
   /// to calculate the total probability for sampling.
   ///
+  /// The optional importance analyzer
+  /// calculates the importance factors for every sample.
+  ///
   /// @param[in] prob_analyzer  Instantiated probability analyzer.
-  explicit UncertaintyAnalyzer(ProbabilityAnalyzer<Calculator>* prob_analyzer)
-      : UncertaintyAnalysis(prob_analyzer), prob_analyzer_(prob_analyzer) {}
+  /// @param[in] importance_analyzer  Completed importance analyzer or nullptr.
+  explicit UncertaintyAnalyzer(
+      ProbabilityAnalyzer<Calculator>* prob_analyzer,
+      ImportanceAnalyzer<Calculator>* importance_analyzer = nullptr)
+      : UncertaintyAnalysis(prob_analyzer),
+        prob_analyzer_(prob_analyzer),
+        importance_analyzer_(importance_analyzer) {}
 
  private:
   /// @returns Samples of the total probability.
@@ -136,23 +254,79 @@ class UncertaintyAnalyzer : public UncertaintyAnalysis {
 
   /// Calculator of the total probability.
   ProbabilityAnalyzer<Calculator>* prob_analyzer_;
+  /// Calculator of importance factors in the same trials.
+  ImportanceAnalyzer<Calculator>* importance_analyzer_;
 };
 
 template <class Calculator>
 std::vector<double> UncertaintyAnalyzer<Calculator>::Sample() noexcept {
   std::vector<std::pair<int, mef::Expression&>> deviate_expressions =
       UncertaintyAnalysis::GatherDeviateExpressions(prob_analyzer_->graph());
+  mef::ExpressionProgram program =
+      UncertaintyAnalysis::CompileExpressions(deviate_expressions);
+  // The samples of the shared expressions are private to this analysis.
+  mef::Expression::SampleContext sample_context;
   Pdag::IndexMap<double> p_vars = prob_analyzer_->p_vars();  // Private copy!
   std::vector<double> samples;
   samples.reserve(Analysis::settings().num_trials());
 
+  bool control = Analysis::settings().control_variates();
+  if (control && !std::is_same_v<Calculator, Bdd>) {
+    Analysis::AddWarning("Control variates require exact probability analysis.");
+    control = false;
+  }
+  std::vector<double> controls;
+  if (control)
+    controls.reserve(Analysis::settings().num_trials());
+
+  std::vector<double> mifs;
+  if (importance_analyzer_) {
+    UncertaintyAnalysis::TrackImportance(*importance_analyzer_,
+                                         prob_analyzer_->graph());
+  }
+
   for (int i = 0; i < Analysis::settings().num_trials(); ++i) {
-    UncertaintyAnalysis::SampleExpressions(deviate_expressions, &p_vars);
-    double result = prob_analyzer_->CalculateTotalProbability(p_vars);
+    if (Analysis::settings().canceled())
+      return samples;  // The incomplete samples are not analyzed.
+    UncertaintyAnalysis::SampleExpressions(deviate_expressions, &program,
+                                           &p_vars);
+    double result =
+        importance_analyzer_
+            ? importance_analyzer_->CalculateMarginalImportance(p_vars, &mifs)
+            : prob_analyzer_->CalculateTotalProbability(p_vars);
     assert(result >= 0 && result <= 1);
     samples.push_back(result);
+    if (importance_analyzer_)
+      UncertaintyAnalysis::AccumulateImportance(result, mifs, p_vars);
+    if (control) {
+      controls.push_back(UncertaintyAnalysis::CalculateRareEventSum(
+          prob_analyzer_->products(), p_vars));
+    }
   }
 
+  if (control) {
+    // The expected value of the control is estimated independently
+    // with the cheap trials that skip the exact calculations.
+    int num_control_trials =
+        kControlTrialsFactor * Analysis::settings().num_trials();
+    double sum = 0;
+    double sum_squares = 0;
+    for (int i = 0; i < num_control_trials; ++i) {
+      if (Analysis::settings().canceled())
+        return samples;
+      UncertaintyAnalysis::SampleExpressions(deviate_expressions, &program,
+                                             &p_vars);
+      double value = UncertaintyAnalysis::CalculateRareEventSum(
+          prob_analyzer_->products(), p_vars);
+      sum += value;
+      sum_squares += value * value;
+    }
+    double mean = sum / num_control_trials;
+    double variance =
+        std::max(sum_squares - sum * mean, 0.0) / (num_control_trials - 1);
+    UncertaintyAnalysis::control_variate(
+        {mean, variance / num_control_trials, std::move(controls)});
+  }
   return samples;
 }
 
@@ -20,15 +20,630 @@
 
 #include "xml.h"
 
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <libxml/SAX2.h>
+#include <libxml/parser.h>
+#include <libxml/uri.h>
 #include <libxml/xinclude.h>
+#include <libxml/xmlIO.h>
+#include <zlib.h>
+#ifdef SCRAM_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "logger.h"
+
+namespace fs = boost::filesystem;
 
 namespace scram::xml {
 
+namespace {
+
+/// Reader of gzip-compressed documents with the XML library I/O callbacks.
+/// The documents are decompressed on the fly
+/// regardless of the compression support in the XML library build.
+class GzipInput {
+ public:
+  /// Registers the callbacks for all the XML library input.
+  ///
+  /// @returns true on success.
+  static bool Register() noexcept {
+    return xmlRegisterInputCallbacks(&Match, &Open, &Read, &Close) >= 0;
+  }
+
+ private:
+  /// @returns true for the input files with the gzip extension.
+  static int Match(const char* file_path) {
+    return boost::ends_with(file_path, ".gz");
+  }
+
+  /// @returns The decompression context or null to fall back to defaults.
+  static void* Open(const char* file_path) { return gzopen(file_path, "rb"); }
+
+  /// @returns The number of the decompressed bytes or -1 on error.
+  static int Read(void* context, char* buffer, int len) {
+    return gzread(static_cast<gzFile>(context), buffer, len);
+  }
+
+  /// @returns 0 on success.
+  static int Close(void* context) {
+    return gzclose(static_cast<gzFile>(context)) == Z_OK ? 0 : -1;
+  }
+};
+
+#ifdef SCRAM_WITH_ZSTD
+/// Reader of zstd-compressed documents with the XML library I/O callbacks.
+class ZstdInput {
+ public:
+  /// Registers the callbacks for all the XML library input.
+  ///
+  /// @returns true on success.
+  static bool Register() noexcept {
+    return xmlRegisterInputCallbacks(&Match, &Open, &Read, &Close) >= 0;
+  }
+
+ private:
+  /// The decompression state of the document file.
+  struct Context {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file;  ///< The source.
+    /// The decompression state of the frames.
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> stream;
+    std::vector<char> buffer;  ///< The compressed data read from the file.
+    ZSTD_inBuffer input;  ///< The compressed data yet to be decompressed.
+    bool end_of_frame;  ///< The frame is fully decompressed.
+  };
+
+  /// @returns true for the input files with the zstd extension.
+  static int Match(const char* file_path) {
+    return boost::ends_with(file_path, ".zst");
+  }
+
+  /// @returns The decompression context or null to fall back to defaults.
+  static void* Open(const char* file_path) noexcept {
+    try {
+      auto context = std::make_unique<Context>(
+          Context{{std::fopen(file_path, "rb"), &std::fclose},
+                  {ZSTD_createDCtx(), &ZSTD_freeDCtx},
+                  std::vector<char>(ZSTD_DStreamInSize()),
+                  {},
+                  false});
+      if (!context->file || !context->stream)
+        return nullptr;
+      context->input = {context->buffer.data(), 0, 0};
+      return context.release();
+    } catch (const std::bad_alloc&) {
+      return nullptr;
+    }
+  }
+
+  /// @returns The number of the decompressed bytes or -1 on error.
+  static int Read(void* context, char* buffer, int len) noexcept {
+    Context& state = *static_cast<Context*>(context);
+    ZSTD_outBuffer output = {buffer, static_cast<std::size_t>(len), 0};
+    while (true) {
+      std::size_t consumed = state.input.pos;
+      std::size_t hint =
+          ZSTD_decompressStream(state.stream.get(), &output, &state.input);
+      if (ZSTD_isError(hint))
+        return -1;
+      // The calls past the end of the frame without input expect a new frame.
+      if (hint == 0 || state.input.pos != consumed)
+        state.end_of_frame = hint == 0;
+      if (output.pos || !len)
+        return output.pos;
+      if (state.input.pos < state.input.size)
+        continue;
+      state.input.size = std::fread(state.buffer.data(), 1,
+                                    state.buffer.size(), state.file.get());
+      state.input.pos = 0;
+      if (!state.input.size)  // Truncated frames are errors.
+        return std::ferror(state.file.get()) || !state.end_of_frame ? -1 : 0;
+    }
+  }
+
+  /// @returns 0 on success.
+  static int Close(void* context) noexcept {
+    delete static_cast<Context*>(context);
+    return 0;
+  }
+};
+#endif
+
+/// Tracker of the input files opened by the XML library on this thread
+/// (e.g., XInclude targets) while the tracker is alive.
+/// The tracking callbacks never claim the inputs
+/// and must take precedence over all other callbacks.
+class InputTracker {
+ public:
+  /// @param[out] inputs  The destination for the absolute input file paths.
+  explicit InputTracker(std::vector<std::string>* inputs) noexcept {
+    inputs_ = inputs;
+  }
+
+  ~InputTracker() noexcept { inputs_ = nullptr; }
+
+  InputTracker(const InputTracker&) = delete;
+  InputTracker& operator=(const InputTracker&) = delete;
+
+  /// Registers the callbacks for all the XML library input.
+  ///
+  /// @returns true on success.
+  static bool Register() noexcept {
+    return xmlRegisterInputCallbacks(&Match, &Open, &Read, &Close) >= 0;
+  }
+
+ private:
+  /// Records the input file if this thread has a live tracker.
+  ///
+  /// @returns 0 to fall back to other callbacks.
+  static int Match(const char* uri) {
+    if (!inputs_)
+      return 0;
+    try {
+      std::string path = uri;
+      if (boost::starts_with(path, "file://")) {
+        std::unique_ptr<char, void (*)(void*)> unescaped(
+            xmlURIUnescapeString(uri + std::strlen("file://"), 0, nullptr),
+            xmlFree);
+        if (!unescaped)
+          throw std::bad_alloc();
+        path = unescaped.get();
+      }
+      inputs_->push_back(fs::absolute(path).string());
+    } catch (...) {
+      inputs_->push_back({});  // Unknown inputs are never recorded.
+    }
+    return 0;
+  }
+
+  /// @{
+  /// The dummy callbacks for never claimed inputs.
+  static void* Open(const char*) { return nullptr; }
+  static int Read(void*, char*, int) { return -1; }
+  static int Close(void*) { return -1; }
+  /// @}
+
+  static thread_local std::vector<std::string>* inputs_;  ///< The record.
+};
+
+thread_local std::vector<std::string>* InputTracker::inputs_ = nullptr;
+
+/// Registers the callbacks of the compressed documents
+/// with precedence over the default callbacks
+/// and the input tracking callbacks with precedence over all.
+///
+/// The XML library callback table is not thread-safe,
+/// so the callbacks are registered once as the library is loaded
+/// before any threads open inputs.
+void RegisterCompressedInput() noexcept {
+  static const bool registered = [] {
+    xmlInitParser();  // The default callbacks are registered first.
+    bool success = GzipInput::Register();
+#ifdef SCRAM_WITH_ZSTD
+    success &= ZstdInput::Register();
+#endif
+    success &= InputTracker::Register();
+    return success;
+  }();
+  (void)registered;
+}
+
+/// The registration of the input callbacks at the library load.
+[[maybe_unused]] const bool kInputRegistered =
+    (RegisterCompressedInput(), true);
+
+/// Captures the XML library diagnostics on the current thread
+/// instead of reporting them right away.
+class ErrorCapture {
+ public:
+  /// @param[out] diagnostics  The destination for the formatted messages.
+  explicit ErrorCapture(std::vector<std::string>* diagnostics) noexcept
+      : handler_(xmlStructuredError),
+        context_(xmlStructuredErrorContext),
+        diagnostics_(diagnostics) {
+    xmlSetStructuredErrorFunc(this, &Capture);
+  }
+
+  ~ErrorCapture() noexcept { xmlSetStructuredErrorFunc(context_, handler_); }
+
+  ErrorCapture(const ErrorCapture&) = delete;
+  ErrorCapture& operator=(const ErrorCapture&) = delete;
+
+ private:
+  /// Formats the diagnostic as "file:line: message".
+  static void Capture(void* capture, xmlErrorPtr xml_error) noexcept {
+    try {
+      std::string text;
+      if (xml_error->file)
+        text += std::string(xml_error->file) + ":" +
+                std::to_string(xml_error->line) + ": ";
+      if (xml_error->level == XML_ERR_WARNING)
+        text += "warning : ";
+      if (xml_error->message)
+        text += xml_error->message;
+      static_cast<ErrorCapture*>(capture)->diagnostics_->push_back(
+          std::move(text));
+    } catch (...) {  // The diagnostics are optional.
+    }
+  }
+
+  xmlStructuredErrorFunc handler_;  ///< The replaced handler.
+  void* context_;  ///< The context of the replaced handler.
+  std::vector<std::string>* diagnostics_;  ///< The captured messages.
+};
+
+/// @param[in] node  The node in the document being read.
+///
+/// @returns true if the node is an XInclude directive left unresolved.
+bool IsXInclude(const xmlNode* node) {
+  return node && node->type == XML_ELEMENT_NODE && node->ns &&
+         (xmlStrEqual(node->ns->href, XINCLUDE_NS) ||
+          xmlStrEqual(node->ns->href, XINCLUDE_OLD_NS));
+}
+
+/// @param[in] element  The completely read element.
+///
+/// @returns true if the element or its descendants are XInclude directives.
+bool HasXInclude(const xmlNode* element) {
+  if (IsXInclude(element))
+    return true;
+  for (const xmlNode* child = element->children; child; child = child->next) {
+    if (child->type == XML_ELEMENT_NODE && HasXInclude(child))
+      return true;
+  }
+  return false;
+}
+
+/// @param[in] element  The completely read element.
+///
+/// @returns The number of the element and its descendant elements.
+int CountElements(const xmlNode* element) {
+  int num_elements = 1;
+  for (const xmlNode* child = element->children; child; child = child->next) {
+    if (child->type == XML_ELEMENT_NODE)
+      num_elements += CountElements(child);
+  }
+  return num_elements;
+}
+
+/// Produces the XInclude failure error for the unresolved directive.
+///
+/// @param[in] node  The XInclude directive element.
+///
+/// @returns The exception object to be thrown.
+XIncludeError GetXIncludeError(const xmlNode* node) {
+  xmlErrorPtr xml_error = xmlGetLastError();
+  if (xml_error && xml_error->domain == XML_FROM_XINCLUDE)
+    return detail::GetError<XIncludeError>(xml_error);
+  XIncludeError error("XInclude resolution has failed.");
+  if (node->doc && node->doc->URL)
+    error << boost::errinfo_file_name(detail::from_utf8(node->doc->URL));
+  error << boost::errinfo_at_line(detail::GetLine(node));
+  return error;
+}
+
+/// @returns The last error of the XML library if it is not a warning.
+xmlErrorPtr GetLastError() {
+  xmlErrorPtr xml_error = xmlGetLastError();
+  return xml_error && xml_error->level >= XML_ERR_ERROR ? xml_error : nullptr;
+}
+
+/// Checks the results of the XML library reader functions.
+///
+/// @param[in] ret  The return code of the reader function.
+/// @param[in] file_path  The document file for error messages.
+///
+/// @returns true if the reader has not reached the end of the document.
+///
+/// @throws Error  The reader has failed.
+bool CheckReader(int ret, const std::string& file_path) {
+  // The warnings are reported only if the reader has failed.
+  xmlErrorPtr xml_error = ret == -1 ? xmlGetLastError() : GetLastError();
+  if (ret != -1 && !xml_error)
+    return ret == 1;
+  if (!xml_error) {
+    SCRAM_THROW(ParseError("Failed to read the XML document."))
+        << boost::errinfo_file_name(file_path);
+  }
+  if (xml_error->domain == xmlErrorDomain::XML_FROM_IO) {
+    SCRAM_THROW(IOError(xml_error->message))
+        << boost::errinfo_file_name(file_path) << boost::errinfo_errno(errno)
+        << boost::errinfo_file_open_mode("r");
+  }
+  if (xml_error->domain == xmlErrorDomain::XML_FROM_XINCLUDE)
+    SCRAM_THROW(detail::GetError<XIncludeError>(xml_error));
+  SCRAM_THROW(detail::GetError<ParseError>(xml_error));
+}
+
+/// @param[in] file_path  The path to the file.
+///
+/// @returns The hexadecimal digest of the file content
+///          from the FNV-1a and CRC-32 hashes and the size.
+///          Empty if the file cannot be read.
+std::string Digest(const std::string& file_path) noexcept {
+  const std::size_t kBufferSize = 1 << 16;
+  std::ifstream file(file_path, std::ios::binary);
+  if (!file)
+    return {};
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  std::uint64_t fnv = 0xcbf29ce484222325;
+  uLong crc = crc32(0, nullptr, 0);
+  std::uint64_t size = 0;
+  while (file) {
+    file.read(buffer.get(), kBufferSize);
+    std::streamsize num_read = file.gcount();
+    for (std::streamsize i = 0; i < num_read; ++i) {
+      fnv ^= static_cast<unsigned char>(buffer[i]);
+      fnv *= 0x100000001b3;
+    }
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(buffer.get()), num_read);
+    size += num_read;
+  }
+  if (file.bad())
+    return {};
+  std::ostringstream out;
+  out << std::hex << std::setfill('0') << std::setw(16) << fnv << std::setw(8)
+      << crc << std::setw(16) << size;
+  return out.str();
+}
+
+const std::uint32_t kImageMagic = 0x53434d49;  ///< "SCMI" in the native order.
+const std::int32_t kImageVersion = 2;  ///< Changes with the image format.
+const std::size_t kImageChecksumOffset = 8;  ///< The checksum in the header.
+const std::size_t kImageHeaderSize = 28;  ///< The fixed part of the header.
+
+/// @returns The CRC-32 checksum of the data.
+std::uint32_t Checksum(const char* data, const char* end) noexcept {
+  uLong crc = crc32(0, nullptr, 0);
+  while (data != end) {
+    auto size = static_cast<uInt>(
+        std::min<std::size_t>(end - data, std::numeric_limits<uInt>::max()));
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data), size);
+    data += size;
+  }
+  return crc;
+}
+
+/// Records the full line numbers of the elements
+/// past the limit of the XML library.
+void SetLine(xmlNode* element, int line) noexcept {
+  element->line = std::min(line, detail::kMaxNodeLine);
+  element->_private = line < detail::kMaxNodeLine
+                          ? nullptr
+                          : reinterpret_cast<void*>(
+                                static_cast<std::intptr_t>(line));
+}
+
+/// Starts the elements of the documents parsed with the XML library
+/// keeping the full line numbers.
+void StartElement(void* ctx, const xmlChar* localname, const xmlChar* prefix,
+                  const xmlChar* uri, int nb_namespaces,
+                  const xmlChar** namespaces, int nb_attributes,
+                  int nb_defaulted, const xmlChar** attributes) {
+  xmlSAX2StartElementNs(ctx, localname, prefix, uri, nb_namespaces,
+                        namespaces, nb_attributes, nb_defaulted, attributes);
+  auto* ctxt = static_cast<xmlParserCtxt*>(ctx);
+  if (ctxt->node && ctxt->input && ctxt->input->line >= detail::kMaxNodeLine)
+    SetLine(ctxt->node, ctxt->input->line);
+}
+
+}  // namespace
+
+/// Serializer of documents into the binary image format.
+///
+/// The image starts with the magic number, the format version,
+/// the CRC-32 checksum of the rest of the image, the number of the strings, the size of the string table in bytes,
+/// the number of the documents, and the offsets of the documents.
+/// The string table of null-terminated strings follows,
+/// and then the documents, each with the file name and the root element.
+/// The elements are stored in the depth-first order
+/// with the name, the line number, the attributes,
+/// the text, and the number of the child elements.
+/// The strings are referenced by their indices in the table, -1 for none.
+class ImageWriter {
+ public:
+  /// @param[in] intern_values  Intern the attribute values and texts
+  ///                           besides the names.
+  ///                           The values are mostly unique,
+  ///                           so the lookups may cost more than the copies.
+  explicit ImageWriter(bool intern_values = true)
+      : intern_values_(intern_values) {}
+
+  /// Appends the binary representation of a number.
+  template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+  void Write(T value) {
+    body_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  /// Appends the index of the string in the table.
+  ///
+  /// @param[in] text  The string or nullptr for none.
+  /// @param[in] intern  Reuse the equal string in the table.
+  void Write(const xmlChar* text, bool intern = true) {
+    if (!text) {
+      Write<std::int32_t>(-1);
+      return;
+    }
+    std::string_view value = detail::from_utf8(text);
+    if (intern) {
+      auto it = ids_.find(value);
+      if (it != ids_.end()) {
+        Write<std::int32_t>(it->second);
+        return;
+      }
+      ids_.emplace(interned_.emplace_back(value), num_strings_);
+    }
+    strings_.append(value.data(), value.size());
+    strings_.push_back('\0');
+    Write<std::int32_t>(num_strings_++);
+  }
+
+  /// Appends the element with all its descendants.
+  void Write(const xmlNode* element) {
+    WriteAttributes(element);
+    int num_children = 0;
+    int num_texts = 0;
+    const xmlChar* text = nullptr;
+    for (const xmlNode* child = element->children; child; child = child->next) {
+      if (child->type == XML_ELEMENT_NODE) {
+        ++num_children;
+      } else if (child->type == XML_TEXT_NODE ||
+                 child->type == XML_CDATA_SECTION_NODE) {
+        if (!num_texts++)
+          text = child->content;
+      }
+    }
+    // Only the leaf elements have text.
+    if (num_children || num_texts < 2) {
+      Write(num_children ? nullptr : text, intern_values_);
+    } else {  // The text is split by comments or processing instructions.
+      std::unique_ptr<xmlChar, void (*)(void*)> content(
+          xmlNodeGetContent(element), xmlFree);
+      if (!content)
+        throw std::bad_alloc();
+      Write(content.get(), intern_values_);
+    }
+    Write<std::int32_t>(num_children);
+    for (const xmlNode* child = element->children; child; child = child->next) {
+      if (child->type == XML_ELEMENT_NODE)
+        Write(child);
+    }
+  }
+
+  /// Starts the next document.
+  void Start(const xmlDoc* doc) {
+    Close();
+    offsets_.push_back(body_.size());
+    Write(doc->URL);
+  }
+
+  /// Starts the next document with the root element
+  /// whose children are appended later.
+  void Open(const xmlNode* root) {
+    Start(root->doc);
+    WriteAttributes(root);
+    Write(static_cast<const xmlChar*>(nullptr));
+    open_root_ = body_.size();
+    Write<std::int32_t>(0);
+  }
+
+  /// Appends the element with all its descendants
+  /// as the next child of the open root element.
+  void Append(const xmlNode* element) {
+    assert(open_root_ && "The document root is not open.");
+    Write(element);
+    ++num_appended_;
+  }
+
+  /// @returns The complete image.
+  std::string Finish() {
+    Close();
+    ImageWriter image;
+    image.Write(kImageMagic);
+    image.Write(kImageVersion);
+    image.Write<std::uint32_t>(0);  // The checksum of the complete image.
+    image.Write<std::int32_t>(num_strings_);
+    image.Write<std::uint64_t>(strings_.size());
+    image.Write<std::int32_t>(offsets_.size());
+    for (std::uint64_t offset : offsets_)
+      image.Write(offset);
+    std::string data = image.body_ + strings_ + body_;
+    std::uint32_t checksum = Checksum(data.data() + kImageChecksumOffset + 4,
+                                      data.data() + data.size());
+    data.replace(kImageChecksumOffset, sizeof(checksum),
+                 reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    return data;
+  }
+
+ private:
+  /// Appends the name, the line number, and the XML attributes of the element.
+  void WriteAttributes(const xmlNode* element) {
+    Write(element->name);
+    Write<std::int32_t>(detail::GetLine(element));
+    int num_attributes = 0;
+    for (const xmlAttr* attr = element->properties; attr; attr = attr->next)
+      ++num_attributes;
+    Write<std::int32_t>(num_attributes);
+    for (const xmlAttr* attr = element->properties; attr; attr = attr->next) {
+      Write(attr->name);
+      const xmlNode* text = attr->children;
+      if (text && !text->next && text->type == XML_TEXT_NODE) {
+        // The common case without entities.
+        Write(text->content, intern_values_);
+        continue;
+      }
+      std::unique_ptr<xmlChar, void (*)(void*)> value(
+          xmlNodeListGetString(element->doc, attr->children, 1), xmlFree);
+      Write(value ? value.get() : reinterpret_cast<const xmlChar*>(""),
+            intern_values_);
+    }
+  }
+
+  /// Records the number of the children appended to the open root element.
+  void Close() {
+    if (!open_root_)
+      return;
+    std::int32_t num_children = num_appended_;
+    body_.replace(open_root_, sizeof(num_children),
+                  reinterpret_cast<const char*>(&num_children),
+                  sizeof(num_children));
+    open_root_ = 0;
+    num_appended_ = 0;
+  }
+
+  bool intern_values_;  ///< Intern the attribute values and texts.
+  std::string body_;  ///< The serialized documents.
+  std::string strings_;  ///< The table of null-terminated strings.
+  int num_strings_ = 0;  ///< The number of the strings in the table.
+  std::deque<std::string> interned_;  ///< The stable copies of the keys.
+  std::unordered_map<std::string_view, int> ids_;  ///< The interned indices.
+  std::vector<std::uint64_t> offsets_;  ///< The starts of the documents.
+  std::size_t open_root_ = 0;  ///< The child count position of the open root.
+  int num_appended_ = 0;  ///< The children appended to the open root.
+};
+
+namespace {
+
+/// @returns The number in the native order from the binary data.
+template <typename T>
+T Load(const char* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
 Document::Document(const std::string& file_path, Validator* validator)
     : doc_(nullptr, &xmlFreeDoc) {
+  RegisterCompressedInput();
   xmlResetLastError();
-  doc_.reset(xmlReadFile(file_path.c_str(), nullptr, kParserOptions));
-  xmlErrorPtr xml_error = xmlGetLastError();
+  std::unique_ptr<xmlParserCtxt, decltype(&xmlFreeParserCtxt)> ctxt(
+      xmlNewParserCtxt(), &xmlFreeParserCtxt);
+  if (!ctxt)
+    throw std::bad_alloc();
+  ctxt->sax->startElementNs = &StartElement;
+  doc_.reset(
+      xmlCtxtReadFile(ctxt.get(), file_path.c_str(), nullptr, kParserOptions));
+  xmlErrorPtr xml_error = doc_ ? GetLastError() : xmlGetLastError();
   if (xml_error) {
     if (xml_error->domain == xmlErrorDomain::XML_FROM_IO) {
       SCRAM_THROW(IOError(xml_error->message))
@@ -38,15 +653,39 @@ Document::Document(const std::string& file_path, Validator* validator)
     SCRAM_THROW(detail::GetError<ParseError>(xml_error));
   }
   assert(doc_ && "Internal XML library failure.");
-  if (xmlXIncludeProcessFlags(get(), kParserOptions) < 0 || xmlGetLastError())
+  if (xmlXIncludeProcessFlags(get(), kParserOptions) < 0 || GetLastError())
     SCRAM_THROW(detail::GetError<XIncludeError>());
   if (validator)
     validator->validate(*this);
 }
 
+Document::Document(const Element& root)
+    : doc_(xmlNewDoc(root.to_node()->doc->version), &xmlFreeDoc) {
+  if (!doc_)
+    throw std::bad_alloc();
+  const xmlDoc* source = root.to_node()->doc;
+  if (source->URL)
+    doc_->URL = xmlStrdup(source->URL);
+  if (source->dict) {  // The copies share the interned names.
+    doc_->dict = source->dict;
+    xmlDictReference(doc_->dict);
+  }
+  xmlNode* root_copy = xmlDocCopyNode(root.to_node(), get(), /*extended=*/2);
+  if (!root_copy)
+    throw std::bad_alloc();
+  xmlDocSetRootElement(get(), root_copy);
+}
+
+Element Document::append(const Element& element) {
+  xmlNode* copy = xmlDocCopyNode(element.to_node(), get(), /*recursive=*/1);
+  if (!copy)
+    throw std::bad_alloc();
+  xmlAddChild(xmlDocGetRootElement(get()), copy);
+  return Element(reinterpret_cast<const xmlElement*>(copy));
+}
+
 Validator::Validator(const std::string& rng_file)
-    : schema_(nullptr, &xmlRelaxNGFree),
-      valid_ctxt_(nullptr, &xmlRelaxNGFreeValidCtxt) {
+    : schema_(nullptr, &xmlRelaxNGFree) {
   xmlResetLastError();
   std::unique_ptr<xmlRelaxNGParserCtxt, decltype(&xmlRelaxNGFreeParserCtxt)>
       parser_ctxt(xmlRelaxNGNewParserCtxt(rng_file.c_str()),
@@ -57,10 +696,511 @@ Validator::Validator(const std::string& rng_file)
   schema_.reset(xmlRelaxNGParse(parser_ctxt.get()));
   if (!schema_)
     SCRAM_THROW(detail::GetError<ParseError>());
+  digest_ = Digest(rng_file);
+}
 
-  valid_ctxt_.reset(xmlRelaxNGNewValidCtxt(schema_.get()));
-  if (!valid_ctxt_)
-    SCRAM_THROW(detail::GetError<LogicError>());
+ValidationCache::ValidationCache(std::string directory) noexcept
+    : directory_(std::move(directory)) {
+  boost::system::error_code error;
+  fs::create_directories(directory_, error);
+  if (error)
+    LOG(WARNING) << "Cannot create the cache directory " << directory_ << ": "
+                 << error.message();
+}
+
+std::string ValidationCache::Key(const std::string& file_path,
+                                 const Validator& validator) noexcept {
+  std::string digest = Digest(file_path);
+  if (digest.empty())
+    return {};
+  return digest + "-" + validator.digest();
+}
+
+bool ValidationCache::Contains(const std::string& key) const noexcept {
+  std::string path = GetPath(key);
+  std::ifstream record(path);
+  if (!record)
+    return false;
+  std::string line;
+  std::getline(record, line);  // The header with the key.
+  while (std::getline(record, line)) {
+    std::string::size_type separator = line.find(' ');
+    if (separator == std::string::npos ||
+        Digest(line.substr(separator + 1)) != line.substr(0, separator)) {
+      return false;
+    }
+  }
+  if (record.bad())
+    return false;
+  boost::system::error_code error;
+  fs::last_write_time(path, std::time(nullptr), error);  // Recently used.
+  return true;
+}
+
+void ValidationCache::Insert(const std::string& key,
+                             const std::vector<std::string>& inputs) noexcept {
+  std::string record;
+  for (const std::string& input : inputs) {
+    std::string digest = Digest(input);
+    if (digest.empty())
+      return;  // The changes in the input would go unnoticed.
+    record += digest + " " + input + "\n";
+  }
+  std::string path = GetPath(key);
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream out(temp_path);
+    out << "# " << key << "\n" << record;
+    if (!out.flush()) {
+      LOG(WARNING) << "Cannot record the valid document in " << directory_;
+      return;
+    }
+  }
+  boost::system::error_code error;
+  fs::rename(temp_path, path, error);  // The records are complete or absent.
+  if (error)
+    fs::remove(temp_path, error);
+}
+
+std::string ValidationCache::GetPath(const std::string& key) const {
+  return (fs::path(directory_) / (key + kExtension)).string();
+}
+
+void Validation::run() noexcept {
+  const int kBatchSize = 256;  // Elements between the progress publications.
+  int num_elements = 0;
+  std::exception_ptr error;
+  // The diagnostics are reported with the errors in the order of the files.
+  std::vector<std::string> diagnostics;
+  std::optional<ErrorCapture> capture(&diagnostics);
+  try {
+    std::string key;
+    if (cache_) {
+      key = ValidationCache::Key(file_path_, *validator_);
+      if (!key.empty() && cache_->Contains(key)) {
+        LOG(DEBUG3) << "Skipping the validation of unchanged " << file_path_;
+        publish(std::numeric_limits<int>::max());
+        return;
+      }
+    }
+    std::vector<std::string> inputs;
+    std::optional<InputTracker> tracker;
+    if (!key.empty())
+      tracker.emplace(&inputs);
+    xmlResetLastError();
+    std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> reader(
+        xmlReaderForFile(file_path_.c_str(), nullptr,
+                         kParserOptions | XML_PARSE_NOBLANKS),
+        &xmlFreeTextReader);
+    if (!reader)
+      CheckReader(-1, file_path_);
+    if (xmlTextReaderRelaxNGSetSchema(reader.get(), validator_->schema_.get()))
+      SCRAM_THROW(LogicError("The schema validation has failed to start."));
+    int ret = 0;
+    while (!canceled_ && (ret = xmlTextReaderRead(reader.get())) == 1 &&
+           !GetLastError()) {
+      if (xmlTextReaderNodeType(reader.get()) == XML_READER_TYPE_ELEMENT &&
+          ++num_elements % kBatchSize == 0) {
+        publish(num_elements);
+      }
+    }
+    if (!canceled_ && (ret || xmlTextReaderIsValid(reader.get()) != 1)) {
+      // Unresolved XInclude directives violate the schema.
+      if (xmlErrorPtr xml_error = xmlGetLastError()) {
+        const auto* node = static_cast<const xmlNode*>(xml_error->node);
+        if (xml_error->domain == XML_FROM_RELAXNGV && IsXInclude(node))
+          SCRAM_THROW(GetXIncludeError(node));
+      }
+      // The streaming validation errors are less informative.
+      // The complete document is re-read for the errors to be reported
+      // exactly as if the whole document were parsed before validation.
+      reader.reset();
+      diagnostics.clear();
+      Document(file_path_, validator_);
+      SCRAM_THROW(ValidityError("The document failed schema validation."))
+          << boost::errinfo_file_name(file_path_);
+    }
+    if (!canceled_ && !key.empty()) {
+      tracker.reset();
+      // The document file is the first input.
+      std::string document = fs::absolute(file_path_).string();
+      inputs.erase(std::remove(inputs.begin(), inputs.end(), document),
+                   inputs.end());
+      if (std::find(inputs.begin(), inputs.end(), "") == inputs.end())
+        cache_->Insert(key, inputs);
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  capture.reset();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    diagnostics_ = std::move(diagnostics);
+  }
+  publish(error || canceled_ ? num_elements : std::numeric_limits<int>::max(),
+          error);
+}
+
+int Validation::confirm(int num_elements) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  progress_.wait(lock, [this, num_elements] {
+    return error_ || num_validated_ >= num_elements;
+  });
+  std::vector<std::string> diagnostics = std::move(diagnostics_);
+  diagnostics_.clear();
+  std::exception_ptr error = error_;
+  int num_validated = num_validated_;
+  lock.unlock();
+  // The diagnostics go to the handler of the reading thread
+  // as if the document were validated by the reader itself.
+  for (const std::string& diagnostic : diagnostics)
+    xmlGenericError(xmlGenericErrorContext, "%s", diagnostic.c_str());
+  if (error)
+    std::rethrow_exception(error);
+  return num_validated;
+}
+
+void Validation::publish(int num_elements, std::exception_ptr error) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_validated_ = num_elements;
+    error_ = std::move(error);
+  }
+  progress_.notify_one();
+}
+
+void Image::Write(const std::vector<Document>& documents,
+                  const std::string& file_path) {
+  ImageWriter out;
+  for (const Document& document : documents) {
+    out.Start(document.get());
+    out.Write(xmlDocGetRootElement(document.get()));
+  }
+  std::string data = out.Finish();
+  std::ofstream file(file_path, std::ios::binary);
+  if (!file.write(data.data(), data.size()) || !file.flush()) {
+    SCRAM_THROW(IOError("Cannot write the binary image file."))
+        << boost::errinfo_file_name(file_path) << boost::errinfo_errno(errno)
+        << boost::errinfo_file_open_mode("wb");
+  }
+}
+
+bool Image::Detect(const std::string& file_path) noexcept {
+  std::ifstream file(file_path, std::ios::binary);
+  char magic[sizeof(kImageMagic)];
+  return file.read(magic, sizeof(magic)) &&
+         Load<std::uint32_t>(magic) == kImageMagic;
+}
+
+Image::Builder::Builder()
+    : writer_(std::make_unique<ImageWriter>(/*intern_values=*/false)) {}
+
+Image::Builder::~Builder() noexcept = default;
+
+void Image::Builder::Start(const Element& root) {
+  writer_->Open(root.to_node());
+}
+
+void Image::Builder::Append(const Element& element) {
+  writer_->Append(element.to_node());
+}
+
+Image Image::Builder::Finish() {
+  auto data = std::make_shared<std::string>(writer_->Finish());
+  writer_ = std::make_unique<ImageWriter>(/*intern_values=*/false);
+  Image image;
+  image.data_ = std::shared_ptr<const char>(data, data->data());
+  image.end_ = image.data_.get() + data->size();
+  image.Index();
+  return image;
+}
+
+Image::Image(const std::string& file_path) : file_path_(file_path) {
+  namespace ipc = boost::interprocess;
+  try {
+    ipc::file_mapping file(file_path.c_str(), ipc::read_only);
+    auto region = std::make_shared<ipc::mapped_region>(file, ipc::read_only);
+    data_ = std::shared_ptr<const char>(
+        region, static_cast<const char*>(region->get_address()));
+    end_ = data_.get() + region->get_size();
+  } catch (const ipc::interprocess_exception& err) {
+    SCRAM_THROW(IOError(err.what()))
+        << boost::errinfo_file_name(file_path)
+        << boost::errinfo_file_open_mode("rb");
+  }
+  Index();
+  intact_ = Checksum(data_.get() + kImageChecksumOffset + 4, end_) ==
+            Load<std::uint32_t>(data_.get() + kImageChecksumOffset);
+}
+
+Document Image::document(int index) const {
+  Reader reader(*this, index);
+  Document document(reader.root());
+  while (std::optional<Element> element = reader.next())
+    document.append(*element);
+  return document;
+}
+
+void Image::Index() {
+  auto invalid = [this] {
+    SCRAM_THROW(ParseError("The file is not a binary image "
+                           "of the supported version."))
+        << boost::errinfo_file_name(file_path_);
+  };
+  const char* data = data_.get();
+  if (end_ - data < kImageHeaderSize ||
+      Load<std::uint32_t>(data) != kImageMagic ||
+      Load<std::int32_t>(data + 4) != kImageVersion)
+    invalid();
+  int num_strings = Load<std::int32_t>(data + 12);
+  std::uint64_t strings_size = Load<std::uint64_t>(data + 16);
+  int num_documents = Load<std::int32_t>(data + 24);
+  const char* strings =
+      data + kImageHeaderSize + sizeof(std::uint64_t) * num_documents;
+  if (num_strings < 0 || num_documents < 0 ||
+      strings_size > static_cast<std::uint64_t>(end_ - data) ||
+      strings > end_ - strings_size)
+    invalid();
+  const char* body = strings + strings_size;
+  for (int i = 0; i < num_documents; ++i) {
+    auto offset = Load<std::uint64_t>(data + kImageHeaderSize + 8 * i);
+    if (offset >= static_cast<std::uint64_t>(end_ - body))
+      invalid();
+    documents_.push_back(body + offset);
+  }
+  strings_.reserve(num_strings);
+  for (const char* it = strings; it != body;) {
+    const char* next = static_cast<const char*>(std::memchr(it, 0, body - it));
+    if (!next)
+      invalid();
+    strings_.push_back(it);
+    it = next + 1;
+  }
+  if (strings_.size() != static_cast<std::size_t>(num_strings))
+    invalid();
+}
+
+Reader::Reader(const std::string& file_path,
+               std::vector<std::string> containers, Validation* validation)
+    : reader_(nullptr, &xmlFreeTextReader),
+      file_path_(file_path),
+      container_names_(std::move(containers)),
+      validation_(validation),
+      doc_(nullptr, &xmlFreeDoc) {
+  RegisterCompressedInput();
+  xmlResetLastError();
+  // Blanks between elements carry no data in the MEF.
+  reader_.reset(xmlReaderForFile(file_path.c_str(), nullptr,
+                                 kParserOptions | XML_PARSE_NOBLANKS));
+  if (!reader_)
+    check(-1);
+  do {
+    if (!check(xmlTextReaderRead(reader_.get()))) {
+      SCRAM_THROW(ParseError("The document has no root element."))
+          << boost::errinfo_file_name(file_path_);
+    }
+  } while (xmlTextReaderNodeType(reader_.get()) != XML_READER_TYPE_ELEMENT);
+  root_ = xmlTextReaderCurrentNode(reader_.get());
+  open();
+  confirm(num_elements_);
+}
+
+Reader::Reader(const Image& image, int index,
+               std::vector<std::string> containers)
+    : reader_(nullptr, &xmlFreeTextReader),
+      file_path_(image.file_path_),
+      container_names_(std::move(containers)),
+      validation_(nullptr),
+      image_(&image),
+      cursor_(image.documents_.at(index)),
+      doc_(xmlNewDoc(reinterpret_cast<const xmlChar*>("1.0")), &xmlFreeDoc) {
+  if (!doc_)
+    throw std::bad_alloc();
+  doc_->dict = xmlDictCreate();  // The element names are interned.
+  if (!doc_->dict)
+    throw std::bad_alloc();
+  // The elements appear to come from the original file.
+  const char* url = read_string();
+  doc_->URL = xmlStrdup(reinterpret_cast<const xmlChar*>(url ? url : ""));
+  int num_children = 0;
+  root_ = build(&num_children);
+  xmlDocSetRootElement(doc_.get(), root_);
+  containers_.push_back(root_);
+  num_children_.push_back(num_children);
+}
+
+std::optional<Element> Reader::next() {
+  if (containers_.empty())
+    return {};
+  if (image_)
+    return next_in_image();
+  if (empty_) {
+    empty_ = false;
+    containers_.pop_back();
+    if (containers_.empty())  // The document ends with the root element.
+      confirm(std::numeric_limits<int>::max());
+    return {};
+  }
+  xmlTextReader* reader = reader_.get();
+  // The reader frees the previous element while skipping past it.
+  // Skipping elements without children is left to the reader,
+  // which fails to skip such elements if they are already in memory.
+  int ret = expanded_ && expanded_->children ? xmlTextReaderNext(reader)
+                                             : xmlTextReaderRead(reader);
+  expanded_ = nullptr;
+  int depth = containers_.size();  // The depth of the children.
+  for (; check(ret); ret = xmlTextReaderNext(reader)) {
+    if (xmlTextReaderDepth(reader) < depth) {
+      assert(xmlTextReaderNodeType(reader) == XML_READER_TYPE_END_ELEMENT);
+      containers_.pop_back();
+      if (containers_.empty())  // The document ends with the root element.
+        confirm(std::numeric_limits<int>::max());
+      return {};
+    }
+    if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+      continue;
+    xmlNode* node = xmlTextReaderCurrentNode(reader);
+    if (std::find(container_names_.begin(), container_names_.end(),
+                  detail::from_utf8(node->name)) != container_names_.end()) {
+      open();
+      confirm(num_elements_);
+      return Element(reinterpret_cast<const xmlElement*>(node));
+    }
+    node = xmlTextReaderExpand(reader);
+    if (!node)
+      check(-1);
+    // The reader resolves only the XInclude directives it steps on.
+    if (IsXInclude(node) ||
+        (HasXInclude(node) &&
+         xmlXIncludeProcessTreeFlags(node, kParserOptions) < 0))
+      SCRAM_THROW(GetXIncludeError(node));
+    check(1);
+    num_elements_ += CountElements(node);
+    // The validation of the element is complete past its end.
+    confirm(num_elements_ + 1);
+    expanded_ = node;
+    return Element(reinterpret_cast<const xmlElement*>(node));
+  }
+  // The document ends with the root element.
+  containers_.clear();
+  confirm(std::numeric_limits<int>::max());
+  return {};
+}
+
+std::optional<Element> Reader::next_in_image() {
+  // The elements are freed as soon as the reader moves past them.
+  if (expanded_) {
+    xmlUnlinkNode(expanded_);
+    xmlFreeNode(expanded_);
+    expanded_ = nullptr;
+  }
+  if (!num_children_.back()) {
+    xmlNode* container = containers_.back();
+    containers_.pop_back();
+    num_children_.pop_back();
+    if (!containers_.empty()) {  // The root element outlives the stream.
+      xmlUnlinkNode(container);
+      xmlFreeNode(container);
+    }
+    return {};
+  }
+  --num_children_.back();
+  int num_children = 0;
+  xmlNode* node = build(&num_children);
+  xmlAddChild(containers_.back(), node);
+  if (std::find(container_names_.begin(), container_names_.end(),
+                detail::from_utf8(node->name)) != container_names_.end()) {
+    containers_.push_back(node);
+    num_children_.push_back(num_children);
+  } else {
+    build(node, num_children);
+    expanded_ = node;
+  }
+  return Element(reinterpret_cast<const xmlElement*>(node));
+}
+
+xmlNode* Reader::build(int* num_children) {
+  const char* position = cursor_;
+  const char* name = read_string();
+  if (!name)
+    corrupted(position);  // Every element must have a name.
+  xmlNode* element = xmlNewDocNode(
+      doc_.get(), nullptr, reinterpret_cast<const xmlChar*>(name), nullptr);
+  if (!element)
+    throw std::bad_alloc();
+  std::unique_ptr<xmlNode, decltype(&xmlFreeNode)> guard(element, &xmlFreeNode);
+  SetLine(element, read(0, std::numeric_limits<int>::max()));
+  for (int i = read(0, std::numeric_limits<int>::max()); i > 0; --i) {
+    position = cursor_;
+    const char* attr_name = read_string();
+    const char* value = read_string();
+    if (!attr_name || !value)
+      corrupted(position);
+    if (!xmlNewProp(element, reinterpret_cast<const xmlChar*>(attr_name),
+                    reinterpret_cast<const xmlChar*>(value)))
+      throw std::bad_alloc();
+  }
+  if (const char* text = read_string()) {
+    if (!xmlAddChild(element, xmlNewDocText(doc_.get(), reinterpret_cast<
+                                                            const xmlChar*>(
+                                                            text))))
+      throw std::bad_alloc();
+  }
+  *num_children = read(0, std::numeric_limits<int>::max());
+  return guard.release();
+}
+
+void Reader::build(xmlNode* element, int num_children) {
+  // The open elements with the numbers of their children left to build.
+  std::vector<std::pair<xmlNode*, int>> path = {{element, num_children}};
+  while (!path.empty()) {
+    auto& [parent, num_left] = path.back();
+    if (!num_left) {
+      path.pop_back();
+      continue;
+    }
+    --num_left;
+    int num_grandchildren = 0;
+    xmlNode* child = build(&num_grandchildren);
+    xmlAddChild(parent, child);
+    if (num_grandchildren)
+      path.emplace_back(child, num_grandchildren);
+  }
+}
+
+int Reader::read(int min_value, int max_value) {
+  if (image_->end_ - cursor_ < static_cast<long>(sizeof(std::int32_t)))
+    corrupted(cursor_);
+  int value = Load<std::int32_t>(cursor_);
+  if (value < min_value || value > max_value)
+    corrupted(cursor_);
+  cursor_ += sizeof(std::int32_t);
+  return value;
+}
+
+void Reader::corrupted(const char* position) const {
+  SCRAM_THROW(ParseError("The binary image is corrupted at offset " +
+                         std::to_string(position - image_->data_.get()) +
+                         "."))
+      << boost::errinfo_file_name(file_path_);
+}
+
+const char* Reader::read_string() {
+  int index = read(-1, static_cast<int>(image_->strings_.size()) - 1);
+  return index < 0 ? nullptr : image_->strings_[index];
+}
+
+bool Reader::check(int ret) { return CheckReader(ret, file_path_); }
+
+void Reader::open() {
+  containers_.push_back(xmlTextReaderCurrentNode(reader_.get()));
+  empty_ = xmlTextReaderIsEmptyElement(reader_.get()) == 1;
+  ++num_elements_;
+}
+
+void Reader::confirm(int num_elements) {
+  if (validation_ && num_elements > num_valid_)
+    num_valid_ = validation_->confirm(num_elements);
 }
 
 }  // namespace scram::xml
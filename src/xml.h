@@ -35,13 +35,18 @@
 #include <cstdint>
 #include <cstdlib>
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include <boost/exception/errinfo_at_line.hpp>
 #include <boost/exception/errinfo_errno.hpp>
@@ -53,6 +58,7 @@
 #include <libxml/parser.h>
 #include <libxml/relaxng.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 #include "error.h"
 
@@ -165,6 +171,20 @@ T GetError(xmlErrorPtr xml_error = nullptr) {
   return throw_error;
 }
 
+/// The line number saturated in the nodes of the XML library.
+const int kMaxNodeLine = std::numeric_limits<unsigned short>::max();
+
+/// @param[in] node  The element node.
+///
+/// @returns The line number of the element.
+///          The full line numbers past the limit of the XML library
+///          are kept as the private data of the nodes.
+inline int GetLine(const xmlNode* node) noexcept {
+  if (node->line == kMaxNodeLine && node->_private)
+    return static_cast<int>(reinterpret_cast<std::intptr_t>(node->_private));
+  return XML_GET_LINE(node);
+}
+
 }  // namespace detail
 
 /// XML Element adaptor.
@@ -257,7 +277,7 @@ class Element {
   const char* filename() const { return detail::from_utf8(element_->doc->URL); }
 
   /// @returns The line number of the element.
-  int line() const { return XML_GET_LINE(to_node()); }
+  int line() const { return detail::GetLine(to_node()); }
 
   /// @returns The name of the XML element.
   ///
@@ -382,6 +402,9 @@ class Element {
   }
 
  private:
+  friend class Document;  // Copies elements between documents.
+  friend class Image;  // Copies elements into images.
+
   /// Converts the data to its base.
   xmlNode* to_node() const {
     return reinterpret_cast<xmlNode*>(const_cast<xmlElement*>(element_));
@@ -391,9 +414,11 @@ class Element {
 };
 
 /// The parser options passed to the library parser.
+/// The CDATA sections are merged into the text nodes.
 const int kParserOptions = XML_PARSE_XINCLUDE | XML_PARSE_NOBASEFIX |
                            XML_PARSE_NONET | XML_PARSE_NOXINCNODE |
-                           XML_PARSE_COMPACT | XML_PARSE_HUGE;
+                           XML_PARSE_COMPACT | XML_PARSE_HUGE |
+                           XML_PARSE_NOCDATA;
 
 class Validator;  // Forward declaration for validation upon DOM constructions.
 
@@ -415,6 +440,22 @@ class Document {
   explicit Document(const std::string& file_path,
                     Validator* validator = nullptr);
 
+  /// Starts a new document
+  /// to keep copies of elements from another document.
+  /// The new document shares the file name and strings of the original.
+  ///
+  /// @param[in] root  The root element of the original document.
+  ///                  Only the XML attributes of the root are copied.
+  explicit Document(const Element& root);
+
+  /// Copies an element with all its descendants
+  /// and appends the copy to the root element of this document.
+  ///
+  /// @param[in] element  The element from another document.
+  ///
+  /// @returns The copy owned by this document.
+  Element append(const Element& element);
+
   /// @returns The root element of the document.
   ///
   /// @pre The document has a root node.
@@ -443,24 +484,392 @@ class Validator {
   explicit Validator(const std::string& rng_file);
 
   /// Validates XML DOM documents against the schema.
+  /// The compiled schema is shared by concurrent validations,
+  /// but each validation gets its own context.
   ///
   /// @param[in] doc  The initialized XML DOM document.
   ///
   /// @throws ValidityError  The document failed schema validation.
+  /// @throws LogicError  The XML library functions have failed internally.
   void validate(const Document& doc) {
     xmlResetLastError();
-    int ret = xmlRelaxNGValidateDoc(valid_ctxt_.get(),
+    std::unique_ptr<xmlRelaxNGValidCtxt, decltype(&xmlRelaxNGFreeValidCtxt)>
+        valid_ctxt(xmlRelaxNGNewValidCtxt(schema_.get()),
+                   &xmlRelaxNGFreeValidCtxt);
+    if (!valid_ctxt)
+      SCRAM_THROW(detail::GetError<LogicError>());
+    int ret = xmlRelaxNGValidateDoc(valid_ctxt.get(),
                                     const_cast<xmlDoc*>(doc.get()));
     if (ret != 0)
       SCRAM_THROW(detail::GetError<ValidityError>());
   }
 
+  /// @returns The hexadecimal digest of the schema file.
+  const std::string& digest() const { return digest_; }
+
  private:
-  /// The schema used by the validation context.
+  friend class Validation;  // Validates the document stream.
+
+  /// The compiled schema for validation contexts.
   std::unique_ptr<xmlRelaxNG, decltype(&xmlRelaxNGFree)> schema_;
-  /// The validation context.
-  std::unique_ptr<xmlRelaxNGValidCtxt, decltype(&xmlRelaxNGFreeValidCtxt)>
-      valid_ctxt_;
+  std::string digest_;  ///< The identity of the schema version.
+};
+
+/// Record of the documents known to be valid
+/// in a directory shared by runs.
+/// The documents are identified by the digest of their file content
+/// and the digest of the schema,
+/// so any change in the document or the schema requires new validation.
+/// The record keeps the digests of the files included into the document,
+/// and any change in these files invalidates the record.
+///
+/// The cache is only an optimization;
+/// failures to read or write the records are ignored.
+class ValidationCache {
+ public:
+  /// The extension of the record files.
+  static constexpr const char* kExtension = ".valid";
+
+  /// @param[in] directory  The cache directory.
+  explicit ValidationCache(std::string directory) noexcept;
+
+  /// @param[in] file_path  The path to the document file.
+  /// @param[in] validator  The validator with the RNG schema.
+  ///
+  /// @returns The key of the document validity against the schema.
+  ///          Empty if the file cannot be read.
+  static std::string Key(const std::string& file_path,
+                         const Validator& validator) noexcept;
+
+  /// Checks the record of the document
+  /// and marks it as the most recently used.
+  ///
+  /// @param[in] key  The key of the document validity.
+  ///
+  /// @returns true if the document and its included files
+  ///          are known to be valid.
+  bool Contains(const std::string& key) const noexcept;
+
+  /// Records the document valid.
+  ///
+  /// @param[in] key  The key of the document validity.
+  /// @param[in] inputs  The files read for the document
+  ///                    besides the document file itself.
+  void Insert(const std::string& key,
+              const std::vector<std::string>& inputs) noexcept;
+
+ private:
+  /// @returns The path to the record file.
+  std::string GetPath(const std::string& key) const;
+
+  std::string directory_;  ///< The cache directory.
+};
+
+/// Streaming schema validation of an XML document.
+/// The validation pass runs concurrently with the reading of the document
+/// and keeps only a few elements of the document in memory.
+///
+/// The compiled schema is shared by concurrent validations,
+/// but each validation pass gets its own reader and validation context.
+class Validation {
+ public:
+  /// @param[in] file_path  The path to the document file.
+  /// @param[in] validator  The validator with the RNG schema.
+  /// @param[in] cache  The optional record of the valid documents.
+  Validation(std::string file_path, Validator* validator,
+             ValidationCache* cache = nullptr)
+      : file_path_(std::move(file_path)),
+        validator_(validator),
+        cache_(cache) {}
+
+  /// Runs the validation pass over the whole document.
+  /// The errors are reported to the readers of the document.
+  /// The documents recorded in the cache skip the pass,
+  /// and the valid documents are recorded upon the pass.
+  ///
+  /// @note This function is expected to run on a separate thread.
+  void run() noexcept;
+
+  /// Requests the validation pass to stop as soon as possible.
+  void cancel() noexcept { canceled_ = true; }
+
+  /// Waits for the validation pass to get past the elements.
+  /// The XML library diagnostics of the finished validation pass
+  /// are reported to the error handler of the calling thread.
+  ///
+  /// @param[in] num_elements  The number of elements in document order
+  ///                          that must be valid.
+  ///
+  /// @returns The number of elements known to be valid, at least the given.
+  ///
+  /// @throws IOError  The file is not available.
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  /// @throws LogicError  The XML library functions have failed internally.
+  int confirm(int num_elements);
+
+ private:
+  /// Publishes the progress of the validation pass.
+  ///
+  /// @param[in] num_elements  The number of valid elements in document order.
+  /// @param[in] error  The failure of the validation pass.
+  void publish(int num_elements, std::exception_ptr error = nullptr) noexcept;
+
+  std::string file_path_;  ///< The document file.
+  Validator* validator_;  ///< The schema to validate against.
+  ValidationCache* cache_;  ///< The record of the valid documents.
+  std::mutex mutex_;  ///< The guard of the validation progress.
+  std::condition_variable progress_;  ///< The validation progress notification.
+  int num_validated_ = 0;  ///< The number of elements passed by the validation.
+  std::exception_ptr error_;  ///< The validation failure.
+  std::vector<std::string> diagnostics_;  ///< The unreported XML diagnostics.
+  std::atomic<bool> canceled_ = false;  ///< The request to stop the validation.
+};
+
+class ImageWriter;  // The serializer of the binary image format.
+
+/// Compact binary image of XML documents
+/// to be read without parsing and validation of the XML text.
+/// The element and attribute names and values are interned
+/// into a table of strings shared by all the documents.
+/// The elements keep their line numbers
+/// and the names of their original files for error messages.
+///
+/// The image is in the native byte order;
+/// images with a foreign byte order fail the format check.
+/// The checksum of the image guards against the corruption of the data
+/// that is trusted to be valid.
+class Image {
+ public:
+  /// Incremental construction of an image in memory
+  /// from the elements of streamed documents.
+  /// The copies of the elements are much smaller than their DOM trees.
+  class Builder {
+   public:
+    Builder();
+    ~Builder() noexcept;
+
+    /// Starts the next document of the image.
+    ///
+    /// @param[in] root  The root element of the document.
+    ///                  Only its name and XML attributes are copied.
+    void Start(const Element& root);
+
+    /// Appends a copy of the element with all its descendants
+    /// as the next child of the root element of the current document.
+    ///
+    /// @param[in] element  The element of the current document.
+    ///
+    /// @pre The document has been started.
+    void Append(const Element& element);
+
+    /// @returns The image with all the documents.
+    ///          The builder is left without documents.
+    Image Finish();
+
+   private:
+    std::unique_ptr<ImageWriter> writer_;  ///< The serializer of the image.
+  };
+
+  /// Writes documents into an image file.
+  ///
+  /// @param[in] documents  The documents with XInclude directives processed.
+  /// @param[in] file_path  The destination file.
+  ///
+  /// @throws IOError  The file cannot be written.
+  static void Write(const std::vector<Document>& documents,
+                    const std::string& file_path);
+
+  /// @param[in] file_path  The path to a file.
+  ///
+  /// @returns true if the file starts as an image.
+  static bool Detect(const std::string& file_path) noexcept;
+
+  /// Maps the image file into memory.
+  ///
+  /// @param[in] file_path  The path to the image file.
+  ///
+  /// @throws IOError  The file is not accessible.
+  /// @throws ParseError  The file is not an image of the supported version.
+  explicit Image(const std::string& file_path);
+
+  /// @returns The number of documents in the image.
+  int num_documents() const { return documents_.size(); }
+
+  /// @returns false if the image data does not match its checksum,
+  ///          and the documents must be validated before use.
+  bool intact() const { return intact_; }
+
+  /// Rebuilds a document of the image as a DOM tree for validation.
+  ///
+  /// @param[in] index  The index of the document in the image.
+  ///
+  /// @returns The document as if it were parsed from the original file.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  Document document(int index) const;
+
+ private:
+  friend class Reader;  // Reads the documents.
+
+  Image() = default;
+
+  /// Locates the string table and the documents in the image data.
+  ///
+  /// @throws ParseError  The data is not an image of the supported version.
+  void Index();
+
+  std::string file_path_;  ///< The image file for error messages.
+  std::shared_ptr<const char> data_;  ///< The start of the image data.
+  const char* end_ = nullptr;  ///< The end of the image data.
+  std::vector<const char*> strings_;  ///< The interned strings.
+  std::vector<const char*> documents_;  ///< The starts of the documents.
+  bool intact_ = true;  ///< The data matches the checksum.
+};
+
+/// Streaming reader of XML documents.
+/// Only one element of the document is kept in memory at a time,
+/// and the element is freed as soon as the reader moves past it.
+/// Containers of many elements are streamed instead
+/// to avoid reading their whole contents into memory.
+/// All XInclude directives are processed as they are encountered.
+class Reader {
+ public:
+  /// Opens the document and reads its root element.
+  /// The root element is always streamed as a container.
+  ///
+  /// @param[in] file_path  The path to the document file.
+  /// @param[in] containers  The names of elements to be streamed.
+  /// @param[in] validation  Optional validation pass of the document.
+  ///                        The reader hands out only the elements
+  ///                        the validation pass has already got past.
+  ///
+  /// @throws IOError  The file is not available.
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws ValidityError  The XML file is not valid.
+  /// @throws LogicError  The XML library functions have failed internally.
+  explicit Reader(const std::string& file_path,
+                  std::vector<std::string> containers = {},
+                  Validation* validation = nullptr);
+
+  /// Opens a document of a binary image
+  /// as if it were the original document file.
+  ///
+  /// @param[in] image  The image with the document.
+  /// @param[in] index  The index of the document in the image.
+  /// @param[in] containers  The names of elements to be streamed.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  Reader(const Image& image, int index,
+         std::vector<std::string> containers = {});
+
+  /// @returns The root element of the document.
+  ///
+  /// @note Only the XML attributes of the root element are available.
+  Element root() const {
+    return Element(reinterpret_cast<const xmlElement*>(root_));
+  }
+
+  /// Reads the next child element of the current container.
+  /// The element previously returned by this function is invalidated.
+  ///
+  /// If the child element is a container,
+  /// only its XML attributes are available,
+  /// and the child becomes the current container;
+  /// that is, the next calls read the children of the child.
+  ///
+  /// @returns The completely read and validated element
+  ///          with all its descendants or the start of the child container.
+  ///          None at the end of the current container,
+  ///          whose parent becomes the current container.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  std::optional<Element> next();
+
+ private:
+  /// Checks the results of the XML library reader functions.
+  ///
+  /// @param[in] ret  The return code of the reader function.
+  ///
+  /// @returns true if the reader has not reached the end of the document.
+  ///
+  /// @throws Error  The reader has failed.
+  bool check(int ret);
+
+  /// Starts streaming the children of the container at the reader position.
+  void open();
+
+  /// @returns The next element of the document in the image.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  std::optional<Element> next_in_image();
+
+  /// Builds the next element of the image without its children.
+  ///
+  /// @param[out] num_children  The number of the child elements to follow.
+  ///
+  /// @returns The element with its attributes and text.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  xmlNode* build(int* num_children);
+
+  /// Builds the descendants of the element
+  /// without recursion to accommodate deeply nested documents.
+  ///
+  /// @param[in,out] element  The element built from the image.
+  /// @param[in] num_children  The number of the child elements to build.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  void build(xmlNode* element, int num_children);
+
+  /// @returns The next number in the image.
+  ///
+  /// @param[in] min_value  The least valid value.
+  /// @param[in] max_value  The greatest valid value.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  int read(int min_value, int max_value);
+
+  /// @returns The next string in the image or nullptr for none.
+  ///
+  /// @throws ParseError  The image is corrupted.
+  const char* read_string();
+
+  /// Reports the corrupted data of the image.
+  ///
+  /// @param[in] position  The start of the corrupted data.
+  ///
+  /// @throws ParseError  Always.
+  [[noreturn]] void corrupted(const char* position) const;
+
+  /// Waits for the validation pass to get past the elements read so far.
+  ///
+  /// @param[in] num_elements  The number of elements in document order
+  ///                          that must be valid.
+  ///
+  /// @throws Error  The validation pass has failed.
+  void confirm(int num_elements);
+
+  /// The stream processor.
+  std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> reader_;
+  std::string file_path_;  ///< The document file for error messages.
+  std::vector<std::string> container_names_;  ///< The streamed elements.
+  Validation* validation_;  ///< The optional validation pass to wait for.
+  xmlNode* root_ = nullptr;  ///< The root element of the document.
+  std::vector<xmlNode*> containers_;  ///< The stack of open containers.
+  xmlNode* expanded_ = nullptr;  ///< The last returned complete element.
+  bool empty_ = false;  ///< The last opened container has no children.
+  int num_elements_ = 0;  ///< The number of elements read in document order.
+  int num_valid_ = 0;  ///< The number of elements known to be valid.
+
+  const Image* image_ = nullptr;  ///< The image with the document.
+  const char* cursor_ = nullptr;  ///< The position in the image.
+  std::vector<int> num_children_;  ///< The children left in the containers.
+  /// The document of the elements built from the image.
+  std::unique_ptr<xmlDoc, decltype(&xmlFreeDoc)> doc_;
 };
 
 }  // namespace scram::xml
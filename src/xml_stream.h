@@ -21,13 +21,24 @@
 #pragma once
 
 #include <cassert>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 
 #include <algorithm>
+#include <charconv>
 #include <exception>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include <boost/exception/errinfo_errno.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <zlib.h>
+#ifdef SCRAM_WITH_ZSTD
+#include <zstd.h>
+#endif
 
 #include "error.h"
 
@@ -38,6 +49,98 @@ struct StreamError : public Error {
   using Error::Error;
 };
 
+/// Text with the XML special characters escaped in advance
+/// to be streamed as is,
+/// e.g., the names repeated many times in a document.
+struct EscapedText {
+  /// Escapes &, <, " chars in the text.
+  ///
+  /// @param[in] text  The raw text.
+  explicit EscapedText(std::string_view text) {
+    value.reserve(text.size());
+    for (char symbol : text) {
+      switch (symbol) {
+        case '&':
+          value += "&amp;";
+          break;
+        case '<':
+          value += "&lt;";
+          break;
+        case '"':
+          value += "&quot;";
+          break;
+        default:
+          value += symbol;
+      }
+    }
+  }
+
+  std::string value;  ///< The escaped text.
+};
+
+#ifdef SCRAM_WITH_ZSTD
+/// Output file with on-the-fly zstd compression.
+///
+/// @note Write operations do not return any error code or throw exceptions.
+///       If any IO errors happen,
+///       the stream contains the error information.
+class ZstdFile : private boost::noncopyable {
+ public:
+  /// @param[in] file  The destination file of the compressed data.
+  explicit ZstdFile(std::FILE* file)
+      : file_(file),
+        context_(ZSTD_createCCtx(), &ZSTD_freeCCtx),
+        buffer_(new char[kBufferSize]) {
+    if (!context_)
+      error_ = ENOMEM;
+  }
+
+  /// Compresses the data into the file.
+  void write(const char* data, std::size_t size) noexcept {
+    ZSTD_inBuffer input = {data, size, 0};
+    while (!error_ && input.pos < input.size)
+      compress(&input, ZSTD_e_continue);
+  }
+
+  /// Writes the remaining data and the end of the frame into the file.
+  ///
+  /// @returns The non-zero error code if any operation has failed.
+  int close() noexcept {
+    ZSTD_inBuffer input = {nullptr, 0, 0};
+    while (!error_ && compress(&input, ZSTD_e_end))
+      continue;
+    return error();
+  }
+
+  /// @returns The non-zero error code if any operation has failed.
+  int error() const noexcept { return error_ ? error_ : std::ferror(file_); }
+
+ private:
+  static const std::size_t kBufferSize = 1 << 17;  ///< The output capacity.
+
+  /// Compresses the data and writes the compressed output into the file.
+  ///
+  /// @returns The size of the data left in the compression context.
+  std::size_t compress(ZSTD_inBuffer* input, ZSTD_EndDirective mode) noexcept {
+    ZSTD_outBuffer output = {buffer_.get(), kBufferSize, 0};
+    std::size_t remaining =
+        ZSTD_compressStream2(context_.get(), &output, input, mode);
+    if (ZSTD_isError(remaining)) {
+      error_ = EIO;
+      return 0;
+    }
+    std::fwrite(buffer_.get(), 1, output.pos, file_);
+    return remaining;
+  }
+
+  std::FILE* file_;  ///< The destination file.
+  /// The compression state of the frame.
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context_;
+  std::unique_ptr<char[]> buffer_;  ///< The compressed output.
+  int error_ = 0;  ///< The error code of the compression.
+};
+#endif
+
 namespace detail {  // XML streaming helpers.
 
 const char kIndentChar = ' ';  ///< The whitespace character.
@@ -94,53 +197,136 @@ class Indenter {
     return indent_ ? Indentation(num_chars, this) : Indentation(0, this);
   }
 
+  /// @returns true if the indentation is enabled.
+  bool indent() const { return indent_; }
+
  private:
   bool indent_;  ///< Option to enable/disable indentation.
   char spaces[kMaxIndent + 1];  ///< The indentation and terminator.
 };
 
-/// Adaptor for stdio FILE stream with write generic interface.
+/// Buffered adaptor for stdio FILE, gzip or zstd-compressed, or memory stream
+/// with write generic interface.
+/// The data is accumulated in a large buffer
+/// and handed to the destination in big chunks,
+/// so the per-call locking and formatting of stdio are avoided.
+/// The numbers are formatted with std::to_chars;
+/// the floating-point numbers are printed in the shortest round-trip form.
 ///
 /// @note Write operations do not return any error code or throw exceptions.
 ///       If any IO errors happen,
-///       the FILE handler contains the error information.
-class FileStream {
+///       the stream contains the error information.
+class FileStream : private boost::noncopyable {
  public:
   /// @param[in] file  The output file stream.
   explicit FileStream(std::FILE* file) : file_(file) {}
 
-  /// @returns The destination file stream.
-  std::FILE* file() { return file_; }
+  /// @param[in] file  The output file with on-the-fly compression.
+  explicit FileStream(gzFile file) : file_(nullptr), gz_file_(file) {}
+
+#ifdef SCRAM_WITH_ZSTD
+  /// @param[in] file  The output file with on-the-fly compression.
+  explicit FileStream(ZstdFile* file) : file_(nullptr), zstd_file_(file) {}
+#endif
+
+  /// @param[out] text  The memory destination to append the output.
+  explicit FileStream(std::string* text) : file_(nullptr), text_(text) {}
+
+  /// Flushes the remaining data into the destination.
+  ~FileStream() noexcept { flush(); }
+
+  /// Writes the buffered data into the destination.
+  void flush() noexcept {
+    if (!size_)
+      return;
+    drain(buffer_.get(), size_);
+    size_ = 0;
+  }
+
+  /// Flushes the buffered data to report all the write errors.
+  ///
+  /// @returns The non-zero error code if any write operation has failed.
+  int error() noexcept {
+    flush();
+    if (text_)
+      return 0;
+#ifdef SCRAM_WITH_ZSTD
+    if (zstd_file_)
+      return zstd_file_->error();
+#endif
+    if (!gz_file_)
+      return std::ferror(file_);
+    int err = Z_OK;
+    gzerror(gz_file_, &err);
+    return err == Z_ERRNO ? errno : err;
+  }
 
   /// Writes a value into file.
   /// @{
-  void write(const std::string& value) { write(value.c_str()); }
-  void write(const char* value) { std::fputs(value, file_); }
-  void write(const char value) { std::fputc(value, file_); }
-  void write(int value) {
-    if (value < 0) {
-      std::fputc('-', file_);
-      value = -value;
-    }
-    write(static_cast<std::size_t>(value));
-  }
-  void write(std::size_t value) {
-    char temp[20];
-    char* p = temp;
-    do {
-      *p++ = value % 10 + '0';
-      value /= 10;
-    } while (value > 0);
-
-    do {
-      std::fputc(*--p, file_);
-    } while (p != temp);
+  void write(const std::string& value) { put(value.data(), value.size()); }
+  void write(const char* value) { put(value, std::strlen(value)); }
+  void write(std::string_view value) { put(value.data(), value.size()); }
+  void write(const char value) {
+    if (size_ == kBufferSize)
+      flush();
+    buffer_[size_++] = value;
   }
-  void write(double value) { std::fprintf(file_, "%g", value); }
+  void write(int value) { put_number(value); }
+  void write(std::size_t value) { put_number(value); }
+  void write(double value) { put_number(value); }
   /// @}
 
  private:
+  static const std::size_t kBufferSize = 1 << 16;  ///< The buffer capacity.
+  static const std::size_t kMaxNumberSize = 32;  ///< The number text limit.
+
+  /// Writes the characters into the buffer.
+  void put(const char* data, std::size_t size) {
+    if (kBufferSize - size_ < size) {
+      flush();
+      if (size >= kBufferSize) {  // Large strings bypass the buffer.
+        drain(data, size);
+        return;
+      }
+    }
+    std::memcpy(buffer_.get() + size_, data, size);
+    size_ += size;
+  }
+
+  /// Writes the characters into the destination.
+  void drain(const char* data, std::size_t size) noexcept {
+    if (gz_file_) {
+      gzwrite(gz_file_, data, size);
+    } else if (text_) {
+      text_->append(data, size);
+#ifdef SCRAM_WITH_ZSTD
+    } else if (zstd_file_) {
+      zstd_file_->write(data, size);
+#endif
+    } else {
+      std::fwrite(data, 1, size, file_);
+    }
+  }
+
+  /// Formats the number right in the buffer.
+  template <typename T>
+  void put_number(T value) {
+    if (kBufferSize - size_ < kMaxNumberSize)
+      flush();
+    char* first = buffer_.get() + size_;
+    auto [last, ec] = std::to_chars(first, first + kMaxNumberSize, value);
+    assert(ec == std::errc() && "Unexpected long number text.");
+    size_ += last - first;
+  }
+
   std::FILE* file_;  ///< The destination file.
+  gzFile gz_file_ = nullptr;  ///< The compressed destination file.
+#ifdef SCRAM_WITH_ZSTD
+  ZstdFile* zstd_file_ = nullptr;  ///< The zstd-compressed destination file.
+#endif
+  std::string* text_ = nullptr;  ///< The memory destination.
+  std::unique_ptr<char[]> buffer_{new char[kBufferSize]};  ///< The data.
+  std::size_t size_ = 0;  ///< The number of the buffered characters.
 };
 
 /// Convenience wrapper to provide C++ stream-like interface.
@@ -152,6 +338,8 @@ FileStream& operator<<(FileStream& file, T&& value) {
 
 }  // namespace detail
 
+class Fragment;
+
 /// Writer of data formed as an XML element to a stream.
 /// This class relies on the RAII to put the closing tags.
 /// It is designed for stack-based use
@@ -206,6 +394,8 @@ class StreamElement {
   ~StreamElement() noexcept {
     assert(active_ && "The child element may still be alive.");
     assert(!(parent_ && parent_->active_) && "The parent must be inactive.");
+    if (!kName_)  // The fragment placeholder has no tags.
+      return;
     if (parent_)
       parent_->active_ = true;
     if (accept_attributes_) {
@@ -307,7 +497,17 @@ class StreamElement {
                          &out_);
   }
 
+  /// Puts the child elements rendered separately into a fragment.
+  ///
+  /// @param[in] fragment  The complete fragment of this element.
+  ///
+  /// @throws StreamError  Invalid state for element addition.
+  void AddFragment(const Fragment& fragment);
+
  private:
+  friend class Fragment;
+
+
   static const int kIndentIncrement = 2;  ///< The number of chars per indent.
 
   /// Private constructor for a streamer
@@ -344,6 +544,24 @@ class StreamElement {
     out_ << indenter_(kIndent_) << "<" << kName_;
   }
 
+  /// Constructs a placeholder for the element
+  /// that only accepts child elements without putting any tags.
+  ///
+  /// @param[in] indent  The number of spaces to indent the element tags.
+  /// @param[in] indenter  The indentation provider.
+  /// @param[in,out] out  The destination stream.
+  StreamElement(int indent, detail::Indenter* indenter,
+                detail::FileStream* out) noexcept
+      : kName_(nullptr),
+        kIndent_(indent),
+        accept_attributes_(false),
+        accept_elements_(true),
+        accept_text_(false),
+        active_(true),
+        parent_(nullptr),
+        indenter_(*indenter),
+        out_(*out) {}
+
   /// Puts the value as text escaping the required XML special characters.
   /// @{
   void PutValue(int value) { out_ << value; }
@@ -351,6 +569,28 @@ class StreamElement {
   void PutValue(std::size_t value) { out_ << value; }
   void PutValue(bool value) { out_ << (value ? "true" : "false"); }
   void PutValue(const std::string& value) { PutValue(value.c_str()); }
+  void PutValue(const EscapedText& text) { out_ << text.value; }
+  void PutValue(std::string_view value) {
+    if (value.find_first_of("&<\"") == std::string_view::npos) {
+      out_ << value;
+      return;
+    }
+    for (char symbol : value) {
+      switch (symbol) {
+        case '&':
+          out_ << "&amp;";
+          break;
+        case '<':
+          out_ << "&lt;";
+          break;
+        case '"':
+          out_ << "&quot;";
+          break;
+        default:
+          out_ << symbol;
+      }
+    }
+  }
   void PutValue(const char* value) {
     bool has_special_chars = [value]() mutable {  // 2x faster than strpbrk.
       for (;; ++value) {
@@ -400,6 +640,63 @@ class StreamElement {
   detail::FileStream& out_;  ///< The output destination.
 };
 
+/// Child elements of a stream element rendered into memory
+/// independently of the parent stream,
+/// e.g., on another thread.
+/// The complete fragment is put into the parent with StreamElement::AddFragment
+/// as if the children were added to the parent directly.
+class Fragment : private boost::noncopyable {
+ public:
+  /// @param[in] parent  The element to receive the fragment.
+  ///                    The parent is only inspected for its indentation.
+  explicit Fragment(const StreamElement& parent)
+      : indenter_(parent.indenter_.indent()),
+        out_(&text_),
+        root_(parent.kIndent_, &indenter_, &out_) {}
+
+  /// Prepares the fragment ahead of the parent element.
+  ///
+  /// @param[in] depth  The depth of the element to receive the fragment
+  ///                   with the root element at depth 0.
+  /// @param[in] indent  The indentation of the document.
+  Fragment(int depth, bool indent)
+      : indenter_(indent),
+        out_(&text_),
+        root_(depth * StreamElement::kIndentIncrement, &indenter_, &out_) {}
+
+  /// @returns The placeholder of the parent element to add the children.
+  ///
+  /// @pre The children are destroyed before passing the fragment to the parent.
+  StreamElement& root() { return root_; }
+
+  /// @returns The rendered text of the fragment.
+  const std::string& text() const {
+    out_.flush();
+    return text_;
+  }
+
+ private:
+  std::string text_;  ///< The rendered fragment.
+  detail::Indenter indenter_;  ///< The indentation manager for the fragment.
+  mutable detail::FileStream out_;  ///< The memory stream into the text.
+  StreamElement root_;  ///< The placeholder for the parent element.
+};
+
+inline void StreamElement::AddFragment(const Fragment& fragment) {
+  if (!active_)
+    throw StreamError("The element is inactive.");
+  if (!accept_elements_)
+    throw StreamError("Too late to add elements.");
+
+  if (accept_text_)
+    accept_text_ = false;
+  if (accept_attributes_) {
+    accept_attributes_ = false;
+    out_ << ">\n";
+  }
+  out_ << fragment.text();
+}
+
 /// XML Stream document.
 ///
 /// @pre Only this stream and its elements write to the output destination.
@@ -416,19 +713,39 @@ class Stream {
   ///
   /// @note This output file has clean error state.
   explicit Stream(std::FILE* out, bool indent = true)
-      : indenter_(indent),
-        has_root_(false),
-        uncaught_exceptions_(std::uncaught_exceptions()),
-        out_(out) {
-    assert(!std::ferror(out) && "Unclean error state in output destination.");
-    out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+      : indenter_(indent), out_(out) {
+    Start();
+  }
+
+  /// Constructs a gzip-compressed document with XML header.
+  ///
+  /// @param[in] out  The compressed stream destination.
+  /// @param[in] indent  Option to indent output for readability.
+  ///
+  /// @note The compressed data is flushed only upon closing the file.
+  explicit Stream(gzFile out, bool indent = true)
+      : indenter_(indent), out_(out) {
+    Start();
+  }
+
+#ifdef SCRAM_WITH_ZSTD
+  /// Constructs a zstd-compressed document with XML header.
+  ///
+  /// @param[in] out  The compressed stream destination.
+  /// @param[in] indent  Option to indent output for readability.
+  ///
+  /// @note The compressed frame is complete only upon closing the file.
+  explicit Stream(ZstdFile* out, bool indent = true)
+      : indenter_(indent), out_(out) {
+    Start();
   }
+#endif
 
   /// @throws IOError  The file write operation has failed.
   ///
   /// @post The exception is thrown only if no other exception is on flight.
   ~Stream() noexcept(false) {
-    int err = std::ferror(out_.file());
+    int err = out_.error();
     if (err && (std::uncaught_exceptions() == uncaught_exceptions_))
       SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
   }
@@ -452,9 +769,15 @@ class Stream {
   }
 
  private:
+  /// Puts the XML header into the destination with clean error state.
+  void Start() {
+    assert(!out_.error() && "Unclean error state in output destination.");
+    out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  }
+
   detail::Indenter indenter_;  ///< The indentation manager for the document.
-  bool has_root_;  ///< The document has constructed its root.
-  int uncaught_exceptions_;  ///< The balance of exceptions.
+  bool has_root_ = false;  ///< The document has constructed its root.
+  int uncaught_exceptions_ = std::uncaught_exceptions();  ///< The balance.
   detail::FileStream out_;  ///< The output stream.
 };
 
@@ -101,6 +101,48 @@ void Zbdd::Analyze(const Pdag* graph) noexcept {
   LOG(DEBUG3) << "G" << module_index_ << " analysis time: " << DUR(zbdd_time);
 }
 
+Zbdd::Zbdd(const Image& image, const Settings& settings) noexcept
+    : Zbdd(settings, image.coherent, image.index) {
+  std::vector<VertexPtr> vertices = {kEmpty_, kBase_};
+  vertices.reserve(image.nodes.size() + 2);
+  for (const Image::Node& node : image.nodes) {
+    assert(node.high < vertices.size() && node.low < vertices.size());
+    vertices.push_back(FindOrAddVertex(node.index, vertices[node.high],
+                                       vertices[node.low], node.order,
+                                       node.module, node.coherent));
+  }
+  root_ = vertices[image.root];
+  for (const Image& module : image.modules) {
+    modules_.emplace(module.index,
+                     std::unique_ptr<Zbdd>(new Zbdd(module, settings)));
+  }
+  Freeze();
+}
+
+Zbdd::Image Zbdd::Export() const noexcept {
+  Image image{module_index_, coherent_, 0, {}, {}};
+  std::unordered_map<int, int> references;  // Vertex ids to image references.
+  auto reference = [&image, &references](auto& self,
+                                         const VertexPtr& vertex) -> int {
+    if (vertex->terminal())
+      return Terminal<SetNode>::Ref(vertex).value();
+    if (auto it = references.find(vertex->id()); it != references.end())
+      return it->second;
+    const SetNode& node = SetNode::Ref(vertex);
+    int high = self(self, node.high());
+    int low = self(self, node.low());
+    image.nodes.push_back({node.index(), node.order(), high, low, node.module(),
+                           node.coherent()});
+    int position = image.nodes.size() + 1;
+    references.emplace(vertex->id(), position);
+    return position;
+  };
+  image.root = reference(reference, root_);
+  for (const auto& entry : modules_)
+    image.modules.push_back(entry.second->Export());
+  return image;
+}
+
 Zbdd::Zbdd(const Settings& settings, bool coherent, int module_index) noexcept
     : kBase_(new Terminal<SetNode>(true)),
       kEmpty_(new Terminal<SetNode>(false)),
@@ -358,6 +400,8 @@ Zbdd::VertexPtr Zbdd::ConvertGraph(
   });
   auto it = args.cbegin();
   for (result = *it++; it != args.cend(); ++it) {
+    if (kSettings_.canceled())
+      break;  // The incomplete result is discarded by the risk analysis.
     result = Apply(gate.type(), result, *it, kSettings_.limit_order());
   }
   ClearTables();
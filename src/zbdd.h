@@ -308,6 +308,26 @@ class Zbdd : private boost::noncopyable {
     module_iterator it_;  ///< The root module iterator for the whole ZBDD.
   };
 
+  /// Flat representation of the ZBDD graph and its modules
+  /// for storage outside of the analysis.
+  struct Image {
+    /// The set node with references to the terminal vertices (0 or 1)
+    /// or to preceding nodes (the position in the node list + 2).
+    struct Node {
+      int index;  ///< The index of the set node.
+      int order;  ///< The positive order of the set node.
+      int high;  ///< The reference to the high vertex.
+      int low;  ///< The reference to the low vertex.
+      bool module;  ///< The indication of a module proxy.
+      bool coherent;  ///< The coherence of the module.
+    };
+    int index;  ///< The module index or 0 for the root graph.
+    bool coherent;  ///< The coherence of the graph.
+    int root;  ///< The reference to the root vertex.
+    std::vector<Node> nodes;  ///< The nodes with the children first.
+    std::vector<Image> modules;  ///< The graphs of the module proxies.
+  };
+
   /// Converts Reduced Ordered BDD
   /// into Zero-Suppressed BDD.
   ///
@@ -333,6 +353,14 @@ class Zbdd : private boost::noncopyable {
   /// @note The construction may take considerable time.
   Zbdd(const Pdag* graph, const Settings& settings) noexcept;
 
+  /// Restores the analysis results exported by another ZBDD.
+  ///
+  /// @param[in] image  The valid image of an analyzed ZBDD.
+  /// @param[in] settings  The analysis settings of the exported ZBDD.
+  ///
+  /// @post The ZBDD is frozen and ready for product iteration.
+  Zbdd(const Image& image, const Settings& settings) noexcept;
+
   virtual ~Zbdd() noexcept = default;
 
   /// Runs the analysis
@@ -364,6 +392,9 @@ class Zbdd : private boost::noncopyable {
   /// @returns true if the ZBDD represents a base/unity set.
   bool base() const { return root_ == kBase_; }
 
+  /// @returns The flat image of the analyzed ZBDD with its modules.
+  Image Export() const noexcept;
+
  protected:
   /// The common constructor to initialize member variables.
   ///
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batch.h"
+
+#include <fstream>
+
+#include <catch2/catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include "error.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram::test {
+
+namespace {
+
+/// Temporary directory for the batch manifest and reports.
+struct TempDir {
+  TempDir()
+      : path(fs::temp_directory_path() /
+             ("scram_batch_test-" + fs::unique_path().string())) {
+    fs::create_directories(path);
+  }
+  ~TempDir() { fs::remove_all(path); }
+
+  /// Writes the manifest file into the directory.
+  std::string Manifest(const std::string& text) const {
+    std::string manifest = (path / "manifest.txt").string();
+    std::ofstream(manifest) << text;
+    return manifest;
+  }
+
+  fs::path path;  ///< The directory path.
+};
+
+}  // namespace
+
+TEST_CASE("BatchTest.ReadManifest", "[batch]") {
+  TempDir dir;
+  std::string manifest = dir.Manifest(
+      "# Comment line\n"
+      "\n"
+      "first.xml model.xml /abs/extra.xml\n"
+      "  second.xml --project config.xml\n");
+  std::vector<Batch::Entry> entries = Batch::ReadManifest(manifest);
+  REQUIRE(entries.size() == 2);
+  fs::path base = fs::absolute(dir.path);
+  CHECK(entries[0].output == (base / "first.xml").generic_string());
+  CHECK(entries[0].project.empty());
+  CHECK(entries[0].input_files ==
+        std::vector<std::string>{(base / "model.xml").generic_string(),
+                                 "/abs/extra.xml"});
+  CHECK(entries[1].output == (base / "second.xml").generic_string());
+  CHECK(entries[1].project == (base / "config.xml").generic_string());
+  CHECK(entries[1].input_files.empty());
+}
+
+TEST_CASE("BatchTest.InvalidManifest", "[batch]") {
+  TempDir dir;
+  CHECK_THROWS_AS(Batch::ReadManifest((dir.path / "missing.txt").string()),
+                  IOError);
+  CHECK_THROWS_AS(Batch::ReadManifest(dir.Manifest("report.xml\n")),
+                  SettingsError);
+  CHECK_THROWS_AS(Batch::ReadManifest(dir.Manifest("report.xml --project\n")),
+                  SettingsError);
+  CHECK_THROWS_AS(
+      Batch::ReadManifest(dir.Manifest("out --project a.xml --project b\n")),
+      SettingsError);
+  CHECK_THROWS_AS(Batch({}, 0, 1), SettingsError);
+  CHECK_THROWS_AS(Batch({}, 1, 0), SettingsError);
+}
+
+TEST_CASE("BatchTest.Run", "[batch]") {
+  TempDir dir;
+  core::Settings settings;
+  settings.probability_analysis(true);
+  std::vector<Batch::Job> jobs;
+  for (const char* input : {"tests/input/fta/correct_tree_input_with_probs.xml",
+                            "tests/input/fta/cyclic_tree.xml",
+                            "input/SmallTree/SmallTree.xml",
+                            "input/ThreeMotor/three_motor.xml"}) {
+    std::string output =
+        (dir.path / (fs::path(input).stem().string() + ".xml")).string();
+    jobs.push_back({{input}, settings, output});
+  }
+  CHECK(Batch(jobs, 3, 1).Run() == 1);
+  for (const Batch::Job& job : jobs) {
+    INFO(job.output);
+    bool invalid = job.output.find("cyclic") != std::string::npos;
+    CHECK(fs::exists(job.output) != invalid);
+  }
+}
+
+TEST_CASE("BatchTest.BrokenProject", "[batch]") {
+  TempDir dir;
+  std::vector<Batch::Job> jobs;
+  for (const char* project : {"tests/input/fta/pi_configuration.xml",
+                              "tests/input/fta/invalid_configuration.xml",
+                              "tests/input/fta/nonexistent_configuration.xml",
+                              "tests/input/fta/full_configuration.xml"}) {
+    std::string output =
+        (dir.path / (fs::path(project).stem().string() + ".xml")).string();
+    Batch::Job job{{}, {}, output};
+    job.project = project;
+    job.configure = [](core::Settings* settings) {
+      settings->num_trials(10);
+    };
+    jobs.push_back(std::move(job));
+  }
+  CHECK(Batch(jobs, 2, 1).Run() == 2);
+  for (const Batch::Job& job : jobs) {
+    INFO(job.output);
+    bool invalid = job.output.find("invalid") != std::string::npos ||
+                   job.output.find("nonexistent") != std::string::npos;
+    CHECK(fs::exists(job.output) != invalid);
+  }
+}
+
+}  // namespace scram::test
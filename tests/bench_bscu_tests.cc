@@ -53,4 +53,27 @@ TEST_P(RiskAnalysisTest, BSCU) {
   }
 }
 
+// The control-variate estimator must agree with the plain Monte Carlo.
+TEST_P(RiskAnalysisTest, BSCUControlVariates) {
+  std::string tree_input = "input/BSCU/BSCU.xml";
+  settings.uncertainty_analysis(true).control_variates(true);
+  settings.num_trials(10000);
+  ASSERT_NO_THROW(ProcessInputFiles({tree_input}));
+  ASSERT_NO_THROW(analysis->Analyze());
+  const UncertaintyAnalysis& result =
+      *analysis->results().front().uncertainty_analysis;
+
+  if (settings.approximation() == Approximation::kNone) {
+    EXPECT_NEAR(0.117, mean(), 5e-3);
+    EXPECT_NEAR(0.183, sigma(), 5e-3);
+    ASSERT_TRUE(result.variance_reduction());
+    EXPECT_TRUE(*result.variance_reduction() > 1);
+    EXPECT_TRUE(result.warnings().empty());
+  } else {
+    EXPECT_NEAR(0.137, mean(), 5e-3);
+    EXPECT_TRUE(!result.variance_reduction());
+    EXPECT_TRUE(!result.warnings().empty());
+  }
+}
+
 }  // namespace scram::core::test
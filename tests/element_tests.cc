@@ -17,9 +17,13 @@
 
 #include "element.h"
 
+#include <string>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include "error.h"
+#include "model.h"
 
 namespace scram::mef::test {
 
@@ -42,6 +46,44 @@ class DummyContainer : public Element,
 
 }  // namespace
 
+TEST_CASE("SymbolTest.Interning", "[mef::element]") {
+  CHECK(Symbol().empty());
+  CHECK(Symbol("").empty());
+  CHECK(Symbol() == Symbol(""));
+  CHECK(Symbol().view().empty());
+
+  Symbol symbol("symbol-test-value");
+  CHECK_FALSE(symbol.empty());
+  CHECK(symbol.view() == "symbol-test-value");
+  CHECK(symbol == Symbol(std::string("symbol-test-value")));
+  CHECK(symbol.view().data() == Symbol("symbol-test-value").view().data());
+  CHECK(symbol.hash() == SymbolHash()("symbol-test-value"));
+  CHECK(symbol != Symbol("symbol-test-other"));
+
+  std::size_t pool_size = Symbol::pool_size();
+  CHECK(Symbol::Find("symbol-test-value") == symbol);
+  CHECK(Symbol::Find("symbol-test-missing").empty());
+  CHECK(Symbol::pool_size() == pool_size);
+}
+
+// The strings without symbols are released after the last model.
+TEST_CASE("SymbolTest.Release", "[mef::element]") {
+  std::size_t pool_size = 0;
+  Symbol kept;
+  {
+    Model model;
+    std::vector<Symbol> symbols;
+    for (int i = 0; i < 1000; ++i)
+      symbols.emplace_back("symbol-release-test-" + std::to_string(i));
+    kept = symbols.front();
+    pool_size = Symbol::pool_size();
+  }
+  CHECK(Symbol::pool_size() < pool_size);
+  CHECK(Symbol::pool_size() > 0);  // The kept symbol.
+  CHECK(kept.view() == "symbol-release-test-0");
+  CHECK(Symbol::Find("symbol-release-test-0") == kept);
+}
+
 TEST_CASE("ElementTest.Name", "[mef::element]") {
   CHECK_THROWS_AS(NamedElement(""), LogicError);
 
@@ -17,6 +17,12 @@
 
 #include "event.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/exception/get_error_info.hpp>
+#include <boost/range/adaptor/indirected.hpp>
 #include <catch2/catch.hpp>
 
 #include "cycle.h"
@@ -244,6 +250,44 @@ TEST_CASE("MEFGateTest.Cycle", "[mef::event]") {
   CHECK(cycle::PrintCycle(cycle) == "Top->Middle->Bottom->Top");
 }
 
+// The detection must not depend on the call stack depth.
+TEST_CASE("MEFGateTest.DeepCycle", "[mef::event]") {
+  const int kDepth = 1e5;
+  std::vector<std::unique_ptr<Gate>> gates;
+  for (int i = 0; i < kDepth; ++i)
+    gates.push_back(std::make_unique<Gate>("G" + std::to_string(i)));
+  for (int i = 0; i < kDepth; ++i) {
+    gates[i]->formula(std::make_unique<Formula>(
+        kNot, Formula::ArgSet{gates[(i + 1) % kDepth].get()}));
+  }
+  std::vector<Gate*> cycle;
+  CHECK(cycle::DetectCycle(gates.front().get(), &cycle));
+  CHECK(cycle.size() == kDepth + 1);
+  CHECK(cycle.front() == gates.front().get());
+  CHECK(cycle.back() == gates.front().get());
+}
+
+TEST_CASE("MEFGateTest.AllCycles", "[mef::event]") {
+  Gate one("One");
+  Gate two("Two");
+  Gate three("Three");
+  Gate four("Four");
+  one.formula(std::make_unique<Formula>(kAnd, Formula::ArgSet{&two, &three}));
+  two.formula(std::make_unique<Formula>(kNot, Formula::ArgSet{&one}));
+  three.formula(std::make_unique<Formula>(kNot, Formula::ArgSet{&four}));
+  four.formula(std::make_unique<Formula>(kNot, Formula::ArgSet{&four}));
+
+  std::vector<Gate*> gates = {&one, &two, &three, &four};
+  try {
+    cycle::CheckCycle<Gate>(gates | boost::adaptors::indirected, "gate");
+    FAIL("Cycles are not detected.");
+  } catch (const CycleError& err) {
+    const std::string* cycles = boost::get_error_info<errinfo_cycle>(err);
+    REQUIRE(cycles);
+    CHECK(*cycles == "One->Two->One, Four->Four");
+  }
+}
+
 // Test gate connective validation.
 TEST_CASE("FormulaTest.Validate", "[mef::event]") {
   BasicEvent arg_one("a");
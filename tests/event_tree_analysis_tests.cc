@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "event_tree_analysis.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+#include <catch2/catch.hpp>
+
+#include "initializer.h"
+#include "model.h"
+#include "settings.h"
+
+namespace scram::core::test {
+
+namespace {
+
+/// The states of the events by their IDs.
+using EventStates = std::unordered_map<std::string, bool>;
+
+bool Evaluate(const mef::Formula& formula, const EventStates& basic_events,
+              const EventStates& set_instructions);
+
+/// @returns The state of the argument event.
+///          The set-instructions override the original house event states.
+bool Evaluate(const mef::Formula::Arg& arg, const EventStates& basic_events,
+              const EventStates& set_instructions) {
+  bool state = std::visit(
+      [&](auto* event) {
+        using T = std::decay_t<decltype(*event)>;
+        if constexpr (std::is_same_v<T, mef::Gate>) {
+          return Evaluate(event->formula(), basic_events, set_instructions);
+        } else if constexpr (std::is_same_v<T, mef::BasicEvent>) {
+          return basic_events.at(std::string(event->id()));
+        } else {
+          auto it = set_instructions.find(std::string(event->id()));
+          return it == set_instructions.end() ? event->state() : it->second;
+        }
+      },
+      arg.event);
+  return arg.complement ? !state : state;
+}
+
+/// @returns The state of the formula with the AND, OR, NOT, NULL connectives.
+bool Evaluate(const mef::Formula& formula, const EventStates& basic_events,
+              const EventStates& set_instructions) {
+  switch (formula.connective()) {
+    case mef::kAnd:
+      for (const mef::Formula::Arg& arg : formula.args()) {
+        if (!Evaluate(arg, basic_events, set_instructions))
+          return false;
+      }
+      return true;
+    case mef::kOr:
+      for (const mef::Formula::Arg& arg : formula.args()) {
+        if (Evaluate(arg, basic_events, set_instructions))
+          return true;
+      }
+      return false;
+    case mef::kNot:
+      return !Evaluate(formula.args().front(), basic_events, set_instructions);
+    case mef::kNull:
+      return Evaluate(formula.args().front(), basic_events, set_instructions);
+    default:
+      FAIL("Unexpected connective in the test model.");
+  }
+  return false;
+}
+
+/// @returns The gate argument at the position in the formula.
+const mef::Gate* GetGate(const mef::Formula& formula, int index) {
+  const mef::Gate* const* gate =
+      std::get_if<mef::Gate*>(&formula.args().at(index).event);
+  REQUIRE(gate);
+  return *gate;
+}
+
+/// @returns The argument gate of the formula with the original gate name.
+const mef::Gate* FindGate(const mef::Formula& formula, std::string_view name) {
+  for (const mef::Formula::Arg& arg : formula.args()) {
+    if (auto* gate = std::get_if<mef::Gate*>(&arg.event)) {
+      if ((*gate)->name() == name)
+        return *gate;
+    }
+  }
+  FAIL("No argument gate " << name);
+  return nullptr;
+}
+
+}  // namespace
+
+// The formulas collected under set-house-event instructions
+// are equivalent to the original formulas with the instructions applied,
+// and only the gates with affected house events are cloned.
+TEST_CASE("EventTreeAnalysisTest.SetHouseEventClones",
+          "[core::event_tree_analysis]") {
+  std::unique_ptr<mef::Model> model =
+      mef::Initializer({"tests/input/eta/set_house_event_clones.xml"},
+                       Settings())
+          .model();
+  REQUIRE(model->initiating_events().size() == 1);
+  EventTreeAnalysis eta(*model->initiating_events().begin(), Settings(),
+                        model->context());
+  eta.Analyze();
+  REQUIRE(eta.sequences().size() == 4);
+
+  std::map<std::string, const mef::Formula*> sequences;
+  for (const EventTreeAnalysis::Result& result : eta.sequences())
+    sequences.emplace(result.sequence.name(), &result.gate->formula());
+
+  const mef::Gate& top = *model->gates().find("Top");
+  // The expected set-instructions and the complement of the top gate.
+  std::map<std::string, std::pair<EventStates, bool>> expected = {
+      {"S1", {{{"H1", true}, {"H2", false}}, false}},
+      {"S2", {{{"H1", true}}, false}},
+      {"S3", {{{"H1", true}}, true}},
+      {"S4", {{{"H2", true}}, false}}};
+  for (const auto& [name, instructions] : expected) {
+    CAPTURE(name);
+    REQUIRE(sequences.count(name));
+    const mef::Formula& formula = *sequences[name];
+    for (int i = 0; i < (1 << 4); ++i) {
+      EventStates basic_events;
+      for (int j = 0; j < 4; ++j)
+        basic_events["B" + std::to_string(j + 1)] = i & (1 << j);
+      CAPTURE(i);
+      CHECK(Evaluate(formula, basic_events, {}) ==
+            (Evaluate(top.formula(), basic_events, instructions.first) !=
+             instructions.second));
+    }
+  }
+
+  const mef::Gate* top_s1 = GetGate(*sequences["S1"], 0);
+  const mef::Gate* top_s2 = GetGate(*sequences["S2"], 0);
+  const mef::Gate* top_s3 = GetGate(*sequences["S3"], 0);
+  const mef::Gate* top_s4 = GetGate(*sequences["S4"], 0);
+  CHECK(top_s4 == &top);  // The instruction keeps the house event state.
+  CHECK(top_s1 != &top);
+  CHECK(top_s2 != &top);
+  CHECK(top_s2 == top_s3);  // The same effective house event states.
+  CHECK(top_s1 != top_s2);
+
+  const mef::Gate* plain = FindGate(top.formula(), "Plain");
+  for (const mef::Gate* clone : {top_s1, top_s2}) {
+    // The unaffected gates are not cloned.
+    CHECK(FindGate(clone->formula(), "Plain") == plain);
+    // The shared gate is cloned once for all its parents.
+    const mef::Gate* ga = FindGate(clone->formula(), "GA");
+    const mef::Gate* gb = FindGate(clone->formula(), "GB");
+    CHECK(FindGate(ga->formula(), "Shared") ==
+          FindGate(gb->formula(), "Shared"));
+    CHECK(FindGate(gb->formula(), "Nested") !=
+          FindGate(FindGate(top.formula(), "GB")->formula(), "Nested"));
+  }
+  // The clones depend only on the house events in their sub-graphs.
+  CHECK(FindGate(top_s1->formula(), "GA") == FindGate(top_s2->formula(), "GA"));
+  CHECK(FindGate(top_s1->formula(), "GB") != FindGate(top_s2->formula(), "GB"));
+}
+
+}  // namespace scram::core::test
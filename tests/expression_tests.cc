@@ -21,9 +21,13 @@
 #include "expression/constant.h"
 #include "expression/exponential.h"
 #include "expression/numerical.h"
+#include "expression/program.h"
 #include "expression/random_deviate.h"
 #include "parameter.h"
 
+#include <thread>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include "error.h"
@@ -320,6 +324,146 @@ TEST_CASE("ExpressionTest.PeriodicTest11", "[mef::expression]") {
   EXPECT_NEAR(0.645377, dev->value(), 1e-5);
 }
 
+// The grid evaluation must agree with the point-wise evaluation.
+TEST_CASE("ExpressionTest.ValuesOverTime", "[mef::expression]") {
+  MissionTime time(8760);
+  OpenExpression lambda(7e-4, 7e-4);
+  OpenExpression lambda_test(6e-4, 6e-4);
+  OpenExpression mu(4e-4, 4e-4);
+  OpenExpression gamma(0.01, 0.01);
+  OpenExpression alpha(1000, 1000);
+  OpenExpression beta(2, 2);
+  OpenExpression t0(10, 10);
+  OpenExpression tau(120, 120);
+  OpenExpression theta(4740, 4740);
+  OpenExpression test_duration(20, 20);
+  OpenExpression available_at_test(true, true);
+  OpenExpression sigma(0.9, 0.9);
+  OpenExpression omega(0.01, 0.01);
+  std::vector<std::unique_ptr<Expression>> expressions;
+  expressions.push_back(std::make_unique<Exponential>(&lambda, &time));
+  expressions.push_back(std::make_unique<Glm>(&gamma, &lambda, &mu, &time));
+  expressions.push_back(std::make_unique<Weibull>(&alpha, &beta, &t0, &time));
+  expressions.push_back(
+      std::make_unique<PeriodicTest>(&lambda, &tau, &theta, &time));
+  expressions.push_back(
+      std::make_unique<PeriodicTest>(&lambda, &mu, &tau, &theta, &time));
+  expressions.push_back(std::make_unique<PeriodicTest>(
+      &lambda, &lambda_test, &mu, &tau, &theta, &gamma, &test_duration,
+      &available_at_test, &sigma, &omega, &time));
+  std::vector<double> grid = {0, 5, 100, 4740, 4750, 4870, 8710, 8760};
+
+  for (const auto& expression : expressions) {
+    std::unordered_map<const Expression*, bool> memo;
+    CHECK(DependsOn(expression.get(), time, &memo));
+    CHECK_FALSE(DependsOn(&lambda, time, &memo));
+    std::vector<double> values;
+    REQUIRE(expression->ValuesOverTime(time, grid, &values));
+    REQUIRE(values.size() == grid.size());
+    for (int i = 0; i < grid.size(); ++i) {
+      time.value(grid[i]);
+      CHECK(values[i] == Approx(expression->value()));
+    }
+    time.value(8760);
+    CHECK_FALSE(expression->ValuesOverTime(lambda, grid, &values));
+  }
+  CHECK_FALSE(MissionTime().ValuesOverTime(time, grid, nullptr));
+}
+
+// The compiled program must agree with the expression evaluation.
+TEST_CASE("ExpressionTest.Program", "[mef::expression]") {
+  MissionTime time(100);
+  OpenExpression lambda(1e-3, 1e-3);
+  OpenExpression two(2, 2);
+  Exponential exponential(&lambda, &time);
+  Exponential same_exponential(&lambda, &time);
+  Add sum({&exponential, &same_exponential});
+  Mul product({&two, &two});
+  std::vector<Expression*> roots = {&exponential, &same_exponential, &sum,
+                                    &product};
+
+  SECTION("Value over time") {
+    ExpressionProgram program(roots, ExpressionProgram::Mode::kValue, &time);
+    CHECK(program.size() == 3);  // The time, the shared exponential, the sum.
+    for (double t : {100.0, 200.0, 0.0}) {
+      time.value(t);
+      program.Run();
+      for (int i = 0; i < roots.size(); ++i)
+        CHECK(program.result(i) == Approx(roots[i]->value()));
+    }
+  }
+
+  SECTION("Constant folding") {
+    ExpressionProgram program(roots, ExpressionProgram::Mode::kValue);
+    CHECK(program.size() == 0);
+    program.Run();
+    for (int i = 0; i < roots.size(); ++i)
+      CHECK(program.result(i) == Approx(roots[i]->value()));
+  }
+
+  SECTION("Sample") {
+    OpenExpression min(1, 1);
+    OpenExpression max(2, 2);
+    UniformDeviate deviate(&min, &max);
+    Add shifted({&deviate, &sum});
+    Parameter parameter("param");
+    parameter.expression(&deviate);
+    ExpressionProgram program({&shifted, &parameter},
+                              ExpressionProgram::Mode::kSample);
+    CHECK(program.size() == 2);  // The deviate and the sum.
+    double last_sample = 0;
+    for (int i = 0; i < 5; ++i) {
+      program.Run();
+      double sample = deviate.Sample();
+      CHECK(program.result(0) == Approx(sample + sum.value()));
+      CHECK(program.result(1) == sample);
+      CHECK(sample != last_sample);
+      last_sample = sample;
+    }
+  }
+}
+
+// The arms of conditionals not taken must not trap in the program.
+TEST_CASE("ExpressionTest.ProgramConditionalArms", "[mef::expression]") {
+  MissionTime time(100);
+  ConstantExpression zero(0);
+  Lt condition(&time, &zero);  // Always false.
+  Mod mod(&time, &zero);
+  Ite ite(&condition, &mod, &ConstantExpression::kOne);
+  Ite constant_ite(&ConstantExpression::kZero, &mod,
+                   &ConstantExpression::kOne);
+  ExpressionProgram program({&ite, &constant_ite},
+                            ExpressionProgram::Mode::kValue, &time);
+  CHECK(program.size() > 1);  // The ite arms are not folded.
+  program.Run();
+  CHECK(program.result(0) == 1);
+  CHECK(program.result(1) == 1);
+}
+
+// The samples in the contexts are private to the sampling threads.
+TEST_CASE("ExpressionTest.SampleContext", "[mef::expression]") {
+  OpenExpression min(1, 1);
+  OpenExpression max(2, 2);
+  UniformDeviate deviate(&min, &max);
+  Add sum({&deviate, &ConstantExpression::kOne});
+  double shared_sample = sum.Sample();
+  std::vector<double> samples;
+  bool consistent = true;  // The samples are kept until the reset.
+  std::thread([&] {
+    Expression::SampleContext context;
+    for (int i = 0; i < 3; ++i) {
+      double sample = sum.Sample();
+      consistent &= sum.Sample() == sample && deviate.Sample() + 1 == sample;
+      samples.push_back(sample);
+      sum.Reset();
+    }
+  }).join();
+  CHECK(consistent);
+  CHECK(samples[0] != samples[1]);
+  CHECK(samples[1] != samples[2]);
+  CHECK(sum.Sample() == shared_sample);  // Untouched by the context.
+}
+
 // Uniform deviate test for invalid minimum and maximum values.
 TEST_CASE("ExpressionTest.UniformDeviate", "[mef::expression]") {
   OpenExpression min(1, 2);
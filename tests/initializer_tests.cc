@@ -17,11 +17,23 @@
 
 #include "initializer.h"
 
+#include <cstdarg>
+#include <cstdio>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include <boost/exception/get_error_info.hpp>
+#include <boost/filesystem.hpp>
 #include <catch2/catch.hpp>
 
 #include "error.h"
 #include "settings.h"
 
+namespace fs = boost::filesystem;
+
 namespace scram::mef::test {
 
 // Test if the XML is well formed.
@@ -49,6 +61,106 @@ TEST_CASE("InitializerTest.NonExistentFile", "[mef::initializer]") {
       IOError);
 }
 
+// The gzip and zstd-compressed inputs are decompressed on the fly.
+TEST_CASE("InitializerTest.CompressedInput", "[mef::initializer]") {
+  std::unique_ptr<Model> model;
+  REQUIRE_NOTHROW(model = Initializer({"input/Autogenerated/telecom.xml.gz"},
+                                      core::Settings())
+                              .model());
+  CHECK_FALSE(model->gates().empty());
+#ifdef SCRAM_WITH_ZSTD
+  std::unique_ptr<Model> zstd_model;
+  REQUIRE_NOTHROW(zstd_model =
+                      Initializer({"input/Autogenerated/telecom.xml.zst"},
+                                  core::Settings())
+                          .model());
+  CHECK(zstd_model->gates().size() == model->gates().size());
+  CHECK(zstd_model->basic_events().size() == model->basic_events().size());
+#endif
+}
+
+#ifdef SCRAM_WITH_ZSTD
+// The truncated compressed input is not mistaken for a complete document.
+TEST_CASE("InitializerTest.TruncatedCompressedInput", "[mef::initializer]") {
+  std::ifstream input("input/Autogenerated/telecom.xml.zst", std::ios::binary);
+  std::string data(std::istreambuf_iterator<char>(input), {});
+  REQUIRE_FALSE(data.empty());
+  fs::path temp_file = fs::temp_directory_path() /
+                       ("scram_truncated_test-" + fs::unique_path().string() +
+                        ".xml.zst");
+  std::ofstream(temp_file.string(), std::ios::binary)
+      .write(data.data(), data.size() / 2);
+  CHECK_THROWS_AS(Initializer({temp_file.string()}, core::Settings()),
+                  xml::ParseError);
+  fs::remove(temp_file);
+}
+#endif
+
+// The forward references of the streamed elements are defined
+// from the compact copies of their XML definitions.
+TEST_CASE("InitializerTest.StreamedDefinitions", "[mef::initializer]") {
+  std::unique_ptr<Model> model;
+  REQUIRE_NOTHROW(model = Initializer({"tests/input/fta/correct_tree_input.xml"},
+                                      core::Settings())
+                              .model());
+  REQUIRE(model->gates().count("TopEvent"));
+  const Gate& top = *model->gates().find("TopEvent");
+  CHECK(top.formula().connective() == kAnd);
+  REQUIRE(top.formula().args().size() == 2);
+  CHECK(std::get<Gate*>(top.formula().args().front().event)->id() ==
+        "TrainOne");
+  CHECK(std::get<Gate*>(top.formula().args().back().event)->id() ==
+        "TrainTwo");
+  REQUIRE(model->gates().count("TrainOne"));
+  CHECK(model->gates().find("TrainOne")->formula().args().size() == 2);
+}
+
+// The unchanged files known to be valid are recorded once.
+TEST_CASE("InitializerTest.ValidationCache", "[mef::initializer]") {
+  fs::path cache_dir = fs::temp_directory_path() /
+                       ("scram_cache_test-" + fs::unique_path().string());
+  core::Settings settings;
+  settings.cache_dir(cache_dir.string());
+  auto count_records = [&cache_dir] {
+    return std::distance(fs::directory_iterator(cache_dir),
+                         fs::directory_iterator());
+  };
+  std::string input = "tests/input/fta/correct_tree_input.xml";
+  for (int run = 0; run < 2; ++run) {
+    INFO("run: " << run);
+    CHECK_NOTHROW(Initializer({input}, settings));
+    CHECK(count_records() == 1);
+  }
+  CHECK_THROWS_AS(Initializer({"tests/input/schema_fail.xml"}, settings),
+                  xml::ValidityError);
+  CHECK(count_records() == 1);  // Invalid files are never recorded.
+  fs::remove_all(cache_dir);
+}
+
+// The changes in the included files invalidate the records.
+TEST_CASE("InitializerTest.ValidationCacheXInclude", "[mef::initializer]") {
+  fs::path dir = fs::temp_directory_path() /
+                 ("scram_cache_test-" + fs::unique_path().string());
+  fs::create_directories(dir);
+  core::Settings settings;
+  settings.cache_dir((dir / "cache").string());
+  std::string input = (dir / "main.xml").string();
+  std::ofstream(input) << R"xml(<?xml version="1.0"?>
+<opsa-mef xmlns:xi="http://www.w3.org/2001/XInclude">
+  <xi:include href="part.xml" xpointer="xpointer(/opsa-mef/*)"/>
+</opsa-mef>)xml";
+  fs::path part = dir / "part.xml";
+  fs::copy_file("tests/input/fta/correct_tree_input.xml", part);
+  for (int run = 0; run < 2; ++run) {
+    INFO("run: " << run);
+    CHECK_NOTHROW(Initializer({input}, settings));
+  }
+  fs::copy_file("tests/input/schema_fail.xml", part,
+                fs::copy_option::overwrite_if_exists);
+  CHECK_THROWS_AS(Initializer({input}, settings), xml::ValidityError);
+  fs::remove_all(dir);
+}
+
 // Test if passing the same file twice causing an error.
 TEST_CASE("InitializerTest.PassTheSameFileTwice", "[mef::initializer]") {
   std::string input_correct = "tests/input/fta/correct_tree_input.xml";
@@ -75,6 +187,66 @@ TEST_CASE("InitializerTest.FailSchemaValidation", "[mef::initializer]") {
                   xml::ValidityError);
 }
 
+// The files are validated concurrently,
+// but the errors are reported in the order of the files.
+TEST_CASE("InitializerTest.ConcurrentFileValidation", "[mef::initializer]") {
+  std::string dir = "tests/input/";
+  core::Settings settings;
+  settings.num_jobs(4);
+  CHECK_THROWS_AS(Initializer({dir + "fta/correct_tree_input.xml",
+                               dir + "schema_fail.xml",
+                               dir + "xml_formatting_error.xml"},
+                              settings),
+                  xml::ValidityError);
+  CHECK_THROWS_AS(Initializer({dir + "xml_formatting_error.xml",
+                               dir + "schema_fail.xml"},
+                              settings),
+                  xml::ParseError);
+}
+
+namespace {
+
+/// Collects the XML library diagnostics reported on the test thread.
+void CollectXmlError(void* diagnostics, const char* format, ...) {
+  char buffer[1024];
+  std::va_list args;
+  va_start(args, format);
+  std::vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  static_cast<std::string*>(diagnostics)->append(buffer);
+}
+
+}  // namespace
+
+// Only the first invalid file is reported with its diagnostics
+// regardless of the order of the concurrent validation passes.
+TEST_CASE("InitializerTest.ConcurrentValidationErrors", "[mef::initializer]") {
+  std::string first = "tests/input/fta/nested_formula.xml";
+  std::string second = "tests/input/schema_fail.xml";
+  core::Settings settings;
+  settings.num_jobs(4);
+  for (const auto& [invalid, ignored] :
+       {std::pair(first, second), std::pair(second, first)}) {
+    CAPTURE(invalid);
+    std::string diagnostics;
+    xmlSetGenericErrorFunc(&diagnostics, &CollectXmlError);
+    try {
+      Initializer({"tests/input/fta/correct_tree_input.xml", invalid, ignored},
+                  settings);
+      FAIL("The invalid files are not reported.");
+    } catch (const xml::ValidityError& err) {
+      const std::string* file =
+          boost::get_error_info<boost::errinfo_file_name>(err);
+      REQUIRE(file);
+      CHECK(*file == invalid);
+    }
+    xmlSetGenericErrorFunc(nullptr, nullptr);
+    INFO(diagnostics);
+    CHECK(diagnostics.find(invalid) != std::string::npos);
+    CHECK(diagnostics.find(ignored) == std::string::npos);
+  }
+}
+
 // Unsupported operations.
 TEST_CASE("InitializerTest.UnsupportedFeature", "[mef::initializer]") {
   std::string dir = "tests/input/";
@@ -171,6 +343,15 @@ TEST_CASE("InitializerTest.IncorrectEtaInputs", "[mef::initializer]") {
   CHECK_THROWS_AS(Initializer({dir + input}, core::Settings()), ValidityError);
 }
 
+// The links nested in rules and blocks of sequences are part of the cycles.
+TEST_CASE("InitializerTest.CyclicNestedLinks", "[mef::initializer]") {
+  std::string dir = "tests/input/eta/";
+  auto input = GENERATE(as<const char*>(), "cyclic_link_rule.xml",
+                        "cyclic_link_block.xml");
+  CAPTURE(input);
+  CHECK_THROWS_AS(Initializer({dir + input}, core::Settings()), CycleError);
+}
+
 TEST_CASE("InitializerTest.CorrectLabelsAndAttributes", "[mef::initializer]") {
   const char* input = "tests/input/fta/labels_and_attributes.xml";
   CAPTURE(input);
@@ -212,8 +393,9 @@ TEST_CASE("InitializerTest.CorrectFtaInputs", "[mef::initializer]") {
 
 TEST_CASE("InitializerTest.CorrectInclude", "[mef::initializer]") {
   std::string dir = "tests/input/";
-  auto input =
-      GENERATE(as<const char*>(), "xinclude.xml", "xinclude_transitive.xml");
+  // The warnings of the missing files with fallbacks do not stop the loading.
+  auto input = GENERATE(as<const char*>(), "xinclude.xml",
+                        "xinclude_transitive.xml", "xinclude_fallback.xml");
   CAPTURE(input);
   CHECK_NOTHROW(Initializer({dir + input}, core::Settings()));
 }
@@ -319,6 +501,26 @@ TEST_CASE("InitializerTest.IncorrectProbabilityInputs", "[mef::initializer]") {
   CHECK_THROWS_AS(Initializer({dir + input}, settings), ValidityError);
 }
 
+// The swept parameter must exist
+// and keep the probabilities valid over the sweep.
+TEST_CASE("InitializerTest.SensitivityInputs", "[mef::initializer]") {
+  std::string input = "tests/input/fta/sensitivity.xml";
+  core::Settings settings;
+  settings.sensitivity_analysis("PumpFailure", {0, 0.5, 1});
+  CHECK_NOTHROW(Initializer({input}, settings));
+  settings.sensitivity_analysis("Missing", {0.5});
+  CHECK_THROWS_AS(Initializer({input}, settings), UndefinedElement);
+  settings.sensitivity_analysis("PumpFailure", {0.5, 2});
+  CHECK_THROWS_AS(Initializer({input}, settings), DomainError);
+
+  // The mean value is valid, but the sample domain is not.
+  input = "tests/input/fta/sensitivity_deviate.xml";
+  settings.sensitivity_analysis("PumpFailure", {0.5, 1});
+  CHECK_NOTHROW(Initializer({input}, settings));
+  settings.sensitivity_analysis("PumpFailure", {0.5, 1.5});
+  CHECK_THROWS_AS(Initializer({input}, settings), DomainError);
+}
+
 // Test the case when a top event is not orphan.
 // The top event of one fault tree
 // can be a child of a gate of another fault tree.
@@ -43,7 +43,11 @@
 
 #include "performance_tests.h"
 
+#include <boost/range/adaptor/indirected.hpp>
+
 #include "bdd.h"
+#include "cycle.h"
+#include "logger.h"
 #include "zbdd.h"
 
 namespace scram::core::test {
@@ -72,6 +76,17 @@ TEST_CASE_METHOD(PerformanceTest, "probability", "[.perf]") {
   REQUIRE(ProbabilityCalculationTime() < p_time_std);
 }
 
+// Tests the performance of probability calculations over the mission time.
+TEST_CASE_METHOD(PerformanceTest, "probability over time", "[.perf]") {
+  double p_time_std = 0.05;
+  std::string input = GENERATE(as<std::string>(),
+                               "input/ThreeMotor/three_motor.xml",
+                               "input/TwoTrain/two_train.xml");
+  settings.algorithm("bdd").time_step(1).safety_integrity_levels(true);
+  REQUIRE_NOTHROW(Analyze({input}));
+  REQUIRE(ProbabilityCalculationTime() < p_time_std);
+}
+
 TEST_CASE_METHOD(PerformanceTest, "perf chinese", "[.perf]") {
   double mcs_time = 0.1;
   std::vector<std::string> input_files{
@@ -171,4 +186,28 @@ TEST_CASE_METHOD(PerformanceTest, "perf Baobab1_ZBDD", "[.perf]") {
   CHECK(ProductGenerationTime() == Approx(mcs_time).epsilon(delta));
 }
 
+// Tests the performance of cycle detection in large generated fault trees.
+TEST_CASE("perf cycle detection", "[.perf]") {
+  double check_time = 0.5;
+  const int kNumGates = 1e6;
+  mef::BasicEvent leaf("Leaf");
+  std::vector<std::unique_ptr<mef::Gate>> gates;
+  for (int i = 0; i < kNumGates; ++i)
+    gates.push_back(std::make_unique<mef::Gate>("G" + std::to_string(i)));
+  // Every gate shares descendants with its neighbors in the deep tree.
+  for (int i = 0; i < kNumGates; ++i) {
+    mef::Formula::ArgSet args{&leaf};
+    for (int j : {i + 1, i + 2 + i % 101}) {
+      if (j < kNumGates)
+        args.Add(gates[j].get());
+    }
+    gates[i]->formula(std::make_unique<mef::Formula>(
+        args.size() > 1 ? mef::kOr : mef::kNull, std::move(args)));
+  }
+  CLOCK(check_start);
+  REQUIRE_NOTHROW(mef::cycle::CheckCycle<mef::Gate>(
+      gates | boost::adaptors::indirected, "gate"));
+  CHECK(DUR(check_start) < check_time);
+}
+
 }  // namespace scram::core::test
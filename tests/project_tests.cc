@@ -68,6 +68,7 @@ TEST_CASE("ProjectTest.FullSettings", "[config]") {
   CHECK(settings.probability_analysis());
   CHECK(settings.importance_analysis());
   CHECK(settings.uncertainty_analysis());
+  CHECK(settings.control_variates());
   CHECK(settings.ccf_analysis());
   CHECK(settings.safety_integrity_levels());
   CHECK(settings.approximation() == core::Approximation::kRareEvent);
@@ -97,6 +98,15 @@ TEST_CASE("ProjectTest.PrimeImplicantsSettings", "[config]") {
   CHECK(settings.prime_implicants());
 }
 
+TEST_CASE("ProjectTest.SensitivitySettings", "[config]") {
+  Project config("tests/input/fta/sensitivity_configuration.xml");
+  const core::Settings& settings = config.settings();
+  CHECK(settings.probability_analysis());
+  CHECK(settings.sensitivity_parameter() == "PumpFailure");
+  CHECK(settings.sensitivity_values() ==
+        std::vector<double>{0, 0.25, 0.5, 0.75, 1});
+}
+
 TEST_CASE("ProjectTest.CanonicalPath", "[config]") {
   std::string config_file = "tests/input/win_path_in_config.xml";
   std::string cwd = boost::filesystem::current_path().generic_string();
@@ -17,6 +17,15 @@
 
 #include "risk_analysis_tests.h"
 
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
 #include <utility>
 
 #include <boost/filesystem.hpp>
@@ -121,7 +130,8 @@ std::map<std::string, double> RiskAnalysisTest::sequences() {
 std::set<std::string> RiskAnalysisTest::Convert(const Product& product) {
   std::set<std::string> string_set;
   for (const Literal& literal : product) {
-    string_set.insert((literal.complement ? "not " : "") + literal.event.id());
+    string_set.insert((literal.complement ? "not " : "") +
+                      std::string(literal.event.id()));
   }
   return string_set;
 }
@@ -308,6 +318,57 @@ TEST_P(RiskAnalysisTest, ImportanceOneProbability) {
   TestImportance({{"A", {1, 1, 1, 1, 1, 0}}});
 }
 
+// Sampling of importance factors with constant probabilities
+// must reproduce the point estimates.
+TEST_P(RiskAnalysisTest, ImportanceUncertaintyConstant) {
+  std::string with_prob = "tests/input/fta/correct_tree_input_with_probs.xml";
+  settings.importance_uncertainty(true).num_trials(100);
+  REQUIRE_NOTHROW(ProcessInputFiles({with_prob}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  const auto& result = analysis->results().front();
+  const auto& distributions = result.uncertainty_analysis->importance();
+  REQUIRE(distributions.size() == result.importance_analysis->importance().size());
+  for (const ImportanceDistribution& entry : distributions) {
+    const ImportanceFactors& point =
+        importance(std::string(entry.event.id()));
+    CHECK(entry.mif.mean == Approx(point.mif));
+    CHECK(entry.dif.mean == Approx(point.dif));
+    CHECK(entry.raw.mean == Approx(point.raw));
+    CHECK(entry.raw.lower == Approx(point.raw));
+    CHECK(entry.raw.upper == Approx(point.raw));
+  }
+}
+
+// The importance factors vary with the uncertain probabilities,
+// and the same seed reproduces the distributions.
+TEST_P(RiskAnalysisTest, ImportanceUncertaintyLognormal) {
+  std::string tree_input = "tests/input/fta/importance_uncertainty.xml";
+  settings.importance_uncertainty(true).num_trials(1000).seed(42);
+  // The statistics of the factors in the order of the events.
+  auto run = [this, &tree_input] {
+    REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+    REQUIRE_NOTHROW(analysis->Analyze());
+    std::vector<std::pair<std::string, std::vector<double>>> statistics;
+    for (const ImportanceDistribution& entry :
+         analysis->results().front().uncertainty_analysis->importance()) {
+      std::vector<double> values;
+      for (const FactorStatistics& factor :
+           {entry.mif, entry.cif, entry.dif, entry.raw, entry.rrw}) {
+        INFO("event: " << entry.event.id());
+        CHECK(factor.lower < factor.mean);
+        CHECK(factor.mean < factor.upper);
+        values.insert(values.end(), {factor.mean, factor.lower, factor.median,
+                                     factor.upper});
+      }
+      statistics.emplace_back(entry.event.id(), std::move(values));
+    }
+    return statistics;
+  };
+  auto statistics = run();
+  CHECK(statistics.size() == 4);
+  CHECK(run() == statistics);
+}
+
 // Apply the rare event approximation.
 TEST_F(RiskAnalysisTest, ImportanceRareEvent) {
   std::string with_prob = "tests/input/fta/importance_test.xml";
@@ -378,6 +439,364 @@ TEST_P(RiskAnalysisTest, AnalyzeProbabilityOverTime) {
   REQUIRE(time);
 }
 
+// The long curves are evaluated in several batches of time points.
+TEST_P(RiskAnalysisTest, AnalyzeProbabilityOverLongTime) {
+  std::string tree_input = "tests/input/core/single_exponential.xml";
+  settings.probability_analysis(true).time_step(1).mission_time(1000);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE_FALSE(analysis->results().empty());
+  REQUIRE(analysis->results().front().probability_analysis);
+  const auto& p_time =
+      analysis->results().front().probability_analysis->p_time();
+  REQUIRE(p_time.size() == 1001);
+  double time = 0;
+  for (const std::pair<double, double>& p_vs_time : p_time) {
+    CHECK(p_vs_time.second == time);
+    CHECK(p_vs_time.first == Approx(1 - std::exp(-1e-5 * time)));
+    time += settings.time_step();
+  }
+}
+
+// The results restored from the cache must be identical to the analysis.
+TEST_P(RiskAnalysisTest, AnalyzeWithCache) {
+  std::vector<std::string> input_files = {"input/EventTrees/bcd.xml",
+                                          "input/SmallTree/SmallTree.xml"};
+  fs::path cache_dir = fs::temp_directory_path() /
+                       ("scram_cache_test-" + fs::unique_path().string());
+  settings.probability_analysis(true).importance_analysis(true).cache_dir(
+      cache_dir.string());
+  auto count_entries = [&cache_dir] {
+    return std::distance(fs::directory_iterator(cache_dir),
+                         fs::directory_iterator());
+  };
+  std::vector<std::tuple<std::vector<int>, double, int>> expected;
+  int num_entries = 0;
+  for (int run = 0; run < 2; ++run) {
+    INFO("run: " << run);
+    REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+    REQUIRE_NOTHROW(analysis->Analyze());
+    std::vector<std::tuple<std::vector<int>, double, int>> results;
+    for (const RiskAnalysis::Result& result : analysis->results()) {
+      if (!result.fault_tree_analysis)
+        continue;  // Constant event tree sequences.
+      results.emplace_back(result.fault_tree_analysis->products().distribution(),
+                           result.probability_analysis->p_total(),
+                           result.importance_analysis->importance().size());
+    }
+    if (run) {
+      CHECK(results == expected);
+      CHECK(count_entries() == num_entries);  // No new entries for hits.
+    } else {
+      expected = std::move(results);
+      num_entries = count_entries();
+      CHECK(num_entries > 0);
+    }
+  }
+  fs::remove_all(cache_dir);
+}
+
+// The least recently used records of valid inputs are evicted with entries.
+TEST_P(RiskAnalysisTest, AnalyzeWithCacheEviction) {
+  fs::path cache_dir = fs::temp_directory_path() /
+                       ("scram_cache_test-" + fs::unique_path().string());
+  fs::create_directories(cache_dir);
+  fs::path stale_record = cache_dir / "stale.valid";
+  std::ofstream(stale_record.string()) << std::string(2 << 20, '#');
+  fs::last_write_time(stale_record, 0);
+  settings.cache_dir(cache_dir.string()).cache_limit(1);
+  REQUIRE_NOTHROW(ProcessInputFiles({"input/SmallTree/SmallTree.xml"}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_FALSE(fs::exists(stale_record));
+  fs::remove_all(cache_dir);
+}
+
+// The phases are analyzed with their own mission time and house events,
+// and the phases without changes in the target logic share its analysis.
+TEST_P(RiskAnalysisTest, AnalyzeAlignmentPhases) {
+  std::string tree_input = "tests/input/fta/alignment_phases.xml";
+  settings.probability_analysis(true).mission_time(1000).num_jobs(2);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  const auto& results = analysis->results();
+  REQUIRE(results.size() == 4);  // Top and FixedTop in two phases.
+  double p_normal = 1 - std::exp(-0.25);
+  double p_maintenance = 1 - std::exp(-0.75);
+
+  CHECK(results[0].id.context->phase.name() == "normal");
+  CHECK(results[0].fault_tree_analysis->products().size() == 1);
+  EXPECT_DOUBLE_EQ(p_normal, results[0].probability_analysis->p_total());
+  EXPECT_DOUBLE_EQ(250, results[0].probability_analysis->settings()
+                            .mission_time());
+  EXPECT_DOUBLE_EQ(0.1 * p_normal, results[1].probability_analysis->p_total());
+
+  CHECK(results[2].id.context->phase.name() == "maintenance");
+  CHECK(results[2].fault_tree_analysis->products().size() == 2);
+  CHECK(results[2].probability_analysis->p_total() > p_maintenance);
+  EXPECT_DOUBLE_EQ(0.1 * p_maintenance,
+                   results[3].probability_analysis->p_total());
+
+  CHECK(results[0].fault_tree_analysis != results[2].fault_tree_analysis);
+  CHECK(results[1].fault_tree_analysis == results[3].fault_tree_analysis);
+}
+
+// The canceled analysis keeps only the completed results.
+TEST_P(RiskAnalysisTest, AnalyzeWithProgress) {
+  std::vector<std::string> input_files = {"input/EventTrees/bcd.xml",
+                                          "input/SmallTree/SmallTree.xml"};
+  auto progress = std::make_shared<Progress>();
+  settings.probability_analysis(true).uncertainty_analysis(true).progress(
+      progress);
+  REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK(progress->fraction() == 1);
+  CHECK(analysis->warnings().empty());
+  for (const RiskAnalysis::Result& result : analysis->results())
+    CHECK(result.probability_analysis);
+
+  progress->Cancel();
+  REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_FALSE(analysis->warnings().empty());
+  for (const RiskAnalysis::Result& result : analysis->results()) {
+    CHECK_FALSE(result.fault_tree_analysis);
+    CHECK_FALSE(result.probability_analysis);
+    CHECK_FALSE(result.uncertainty_analysis);
+  }
+}
+
+// Concurrent analyses must reproduce the serial results in the same order.
+TEST_P(RiskAnalysisTest, AnalyzeConcurrentJobs) {
+  std::vector<std::string> input_files = {"input/EventTrees/bcd.xml",
+                                          "input/SmallTree/SmallTree.xml"};
+  settings.uncertainty_analysis(true).num_trials(1000).time_step(1000);
+  REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::vector<std::pair<double, double>> serial;
+  for (const RiskAnalysis::Result& result : analysis->results())
+    serial.emplace_back(result.probability_analysis->p_total(),
+                        result.uncertainty_analysis->mean());
+  REQUIRE(serial.size() > 2);
+
+  settings.num_jobs(4);
+  REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE(analysis->results().size() == serial.size());
+  for (int i = 0; i < serial.size(); ++i) {
+    const RiskAnalysis::Result& result = analysis->results()[i];
+    CHECK(result.probability_analysis->p_total() == serial[i].first);
+    CHECK(result.uncertainty_analysis->mean() == serial[i].second);
+  }
+}
+
+// Incremental updates of probabilities must agree with full recalculations.
+TEST_F(RiskAnalysisTest, UpdateProbability) {
+  std::string tree_input = GENERATE(
+      std::string("input/ThreeMotor/three_motor.xml"),
+      std::string("tests/input/fta/correct_non_coherent.xml"));
+  INFO("input: " + tree_input);
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  const mef::Gate& top = *model->fault_trees().begin()->top_events().front();
+  FaultTreeAnalyzer<Bdd> fta(top, settings, model.get());
+  fta.Analyze();
+  ProbabilityAnalyzer<Bdd> exact(&fta, &model->mission_time());
+  ProbabilityAnalyzer<RareEventCalculator> rare_event(&fta,
+                                                      &model->mission_time());
+  auto check_updates = [](auto* pa) {
+    pa->Analyze();
+    int num_vars = pa->p_vars().size();
+    for (int i = 0; i < 2 * num_vars; ++i) {
+      std::vector<std::pair<int, double>> changes = {
+          {Pdag::kVariableStartIndex + (i * 7) % num_vars, 1.0 / (i + 2)},
+          {Pdag::kVariableStartIndex + i % num_vars, i % 3 ? 0.01 : 0.9}};
+      double p_total = pa->Update(changes);
+      CHECK(pa->p_vars()[changes.back().first] == changes.back().second);
+      CHECK(pa->p_total() == p_total);
+      CHECK(p_total == Approx(pa->CalculateTotalProbability(pa->p_vars())));
+    }
+  };
+  check_updates(&exact);
+  check_updates(&rare_event);
+}
+
+// Incremental updates must follow the variables in complemented literals.
+TEST_F(RiskAnalysisTest, UpdateProbabilityNonCoherent) {
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(
+      ProcessInputFiles({"tests/input/fta/correct_non_coherent.xml"}));
+  const mef::Gate& top = *model->fault_trees().begin()->top_events().front();
+  auto check_updates = [](auto* pa) {
+    pa->Analyze();
+    int num_vars = pa->p_vars().size();
+    for (int i = 0; i < num_vars; ++i) {
+      for (double p : {0.9, 0.5, 0.01}) {
+        double p_total = pa->Update({{Pdag::kVariableStartIndex + i, p}});
+        CHECK(p_total == Approx(pa->CalculateTotalProbability(pa->p_vars())));
+      }
+    }
+  };
+  FaultTreeAnalyzer<Bdd> bdd_fta(top, settings, model.get());
+  bdd_fta.Analyze();
+  ProbabilityAnalyzer<Bdd> exact(&bdd_fta, &model->mission_time());
+  check_updates(&exact);
+  FaultTreeAnalyzer<Zbdd> zbdd_fta(top, settings, model.get());
+  zbdd_fta.Analyze();
+  ProbabilityAnalyzer<RareEventCalculator> rare_event(&zbdd_fta,
+                                                      &model->mission_time());
+  check_updates(&rare_event);
+}
+
+// The batched MIFs must match the MIFs of the separate probability sets.
+TEST_F(RiskAnalysisTest, BatchMarginalImportanceNonCoherent) {
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(
+      ProcessInputFiles({"tests/input/fta/correct_non_coherent.xml"}));
+  const mef::Gate& top = *model->fault_trees().begin()->top_events().front();
+  auto check_batch = [](auto* pa, ImportanceAnalyzerBase* ia) {
+    pa->Analyze();
+    int num_vars = pa->p_vars().size();
+    std::vector<double> points = {0.9, 0.5, 0.01};
+    int num_points = points.size();
+    std::vector<double> batch(num_vars * num_points);
+    for (int i = 0; i < num_vars; ++i) {
+      for (int j = 0; j < num_points; ++j)  // Every variable differs.
+        batch[i * num_points + j] = points[(i + j) % num_points];
+    }
+    std::vector<double> p_total(num_points);
+    std::vector<double> mifs;
+    ia->CalculateMarginalImportances(batch, num_points, p_total.data(), &mifs);
+    REQUIRE(mifs.size() == batch.size());
+    Pdag::IndexMap<double> p_vars(num_vars);
+    std::vector<double> point_mifs;
+    for (int j = 0; j < num_points; ++j) {
+      for (int i = 0; i < num_vars; ++i)
+        p_vars[i + Pdag::kVariableStartIndex] = batch[i * num_points + j];
+      CHECK(p_total[j] ==
+            Approx(ia->CalculateMarginalImportance(p_vars, &point_mifs)));
+      for (int i = 0; i < num_vars; ++i)
+        CHECK(mifs[i * num_points + j] == Approx(point_mifs[i]));
+    }
+  };
+  FaultTreeAnalyzer<Bdd> bdd_fta(top, settings, model.get());
+  bdd_fta.Analyze();
+  ProbabilityAnalyzer<Bdd> exact(&bdd_fta, &model->mission_time());
+  ImportanceAnalyzer<Bdd> exact_importance(&exact);
+  check_batch(&exact, &exact_importance);
+  FaultTreeAnalyzer<Zbdd> zbdd_fta(top, settings, model.get());
+  zbdd_fta.Analyze();
+  ProbabilityAnalyzer<RareEventCalculator> rare_event(&zbdd_fta,
+                                                      &model->mission_time());
+  ImportanceAnalyzer<RareEventCalculator> rare_importance(&rare_event);
+  check_batch(&rare_event, &rare_importance);
+}
+
+// The total probability and importance over the values of a parameter.
+TEST_F(RiskAnalysisTest, AnalyzeSensitivity) {
+  std::string tree_input = "tests/input/fta/sensitivity.xml";
+  bool importance = GENERATE(false, true);
+  INFO("importance: " << importance);
+  settings.sensitivity_analysis("PumpFailure", {0, 0.5, 1})
+      .importance_analysis(importance);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  EXPECT_DOUBLE_EQ(0.608, p_total());  // The model value is intact.
+  const RiskAnalysis::Result& result = analysis->results().front();
+  REQUIRE(result.sensitivity_analysis);
+  const SensitivityAnalysis& sensitivity = *result.sensitivity_analysis;
+  CHECK(sensitivity.parameter().id() == "PumpFailure");
+  CHECK(sensitivity.warnings().empty());
+  REQUIRE(sensitivity.points().size() == 3);
+  std::vector<double> expected = {0.2, 0.525, 1};
+  for (int i = 0; i < expected.size(); ++i) {
+    const SensitivityPoint& point = sensitivity.points()[i];
+    EXPECT_EQ(0.5 * i, point.value);
+    EXPECT_DOUBLE_EQ(expected[i], point.p_total);
+  }
+  if (!importance) {
+    CHECK(sensitivity.events().empty());
+    return;
+  }
+  REQUIRE(sensitivity.events().size() == 4);
+  const SensitivityPoint& point = sensitivity.points()[1];
+  REQUIRE(point.importance.size() == 4);
+  for (int i = 0; i < sensitivity.events().size(); ++i) {
+    std::string id(sensitivity.events()[i]->id());
+    INFO("event: " + id);
+    if (id == "PumpOne") {
+      EXPECT_DOUBLE_EQ(0.5, point.p_events[i]);
+      EXPECT_DOUBLE_EQ(0.45, point.importance[i].mif);
+    } else if (id == "ValveTwo") {
+      EXPECT_DOUBLE_EQ(0.5, point.p_events[i]);
+      EXPECT_DOUBLE_EQ(0.35, point.importance[i].mif);
+    }
+    EXPECT_EQ(2, point.importance[i].occurrence);
+  }
+}
+
+// Analysis with the BDD shared by all targets must reproduce
+// the results of separate analyses.
+TEST_F(RiskAnalysisTest, AnalyzeSharedBdd) {
+  std::vector<std::string> input_files = GENERATE(
+      std::vector<std::string>{"input/ThreeMotor/three_motor.xml",
+                               "input/ThreeMotor/event_tree.xml"},
+      std::vector<std::string>{"input/EventTrees/bcd.xml",
+                               "input/SmallTree/SmallTree.xml"},
+      std::vector<std::string>{"tests/input/fta/correct_non_coherent.xml"},
+      std::vector<std::string>{"tests/input/fta/children_nand_nor.xml"},
+      std::vector<std::string>{"tests/input/core/atleast.xml"});
+  bool prime_implicants = GENERATE(false, true);
+  INFO("input: " + input_files.front());
+  INFO("prime implicants: " << prime_implicants);
+  settings.prime_implicants(prime_implicants).importance_analysis(true);
+  // The results of analyses by the target names.
+  using Summary = std::tuple<int, double, std::multiset<double>>;
+  auto summarize = [this] {
+    std::map<std::string, Summary> summaries;
+    for (const RiskAnalysis::Result& result : analysis->results()) {
+      std::string name;
+      if (auto* gate = std::get_if<const mef::Gate*>(&result.id.target)) {
+        name = (*gate)->id();
+      } else {
+        name = std::get<1>(result.id.target).second.name();
+      }
+      Summary& summary = summaries[name];
+      if (result.fault_tree_analysis) {
+        std::get<0>(summary) =
+            result.fault_tree_analysis->products().size();
+      }
+      std::get<1>(summary) = result.probability_analysis->p_total();
+      if (result.importance_analysis) {
+        for (const ImportanceRecord& record :
+             result.importance_analysis->importance())
+          std::get<2>(summary).insert(record.factors.mif);
+      }
+    }
+    return summaries;
+  };
+
+  REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::map<std::string, Summary> separate = summarize();
+
+  settings.shared_bdd(true);
+  REQUIRE_NOTHROW(ProcessInputFiles(input_files));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::map<std::string, Summary> shared = summarize();
+  REQUIRE(shared.size() == separate.size());
+  for (const auto& [name, summary] : separate) {
+    INFO("target: " + name);
+    REQUIRE(shared.count(name));
+    const auto& [num_products, p_total, mifs] = shared.at(name);
+    CHECK(num_products == std::get<0>(summary));
+    CHECK(p_total == Approx(std::get<1>(summary)));
+    REQUIRE(mifs.size() == std::get<2>(summary).size());
+    auto it = std::get<2>(summary).begin();
+    for (double mif : mifs)
+      CHECK(mif == Approx(*it++));
+  }
+}
+
 TEST_P(RiskAnalysisTest, AnalyzeSil) {
   std::string tree_input = "tests/input/core/single_exponential.xml";
   settings.time_step(24).safety_integrity_levels(true);
@@ -493,6 +912,202 @@ TEST_F(RiskAnalysisTest, ReportIOError) {
   CHECK_THROWS_AS(Reporter().Report(*analysis, output), IOError);
 }
 
+// The compressed report is read back with on-the-fly decompression.
+TEST_F(RiskAnalysisTest, ReportCompressed) {
+  static xml::Validator validator(env::report_schema());
+  std::string tree_input = "tests/input/fta/correct_tree_input.xml";
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  fs::path temp_file = fs::temp_directory_path() /
+                       ("scram_report_test-" + fs::unique_path().string() +
+                        ".xml.gz");
+  REQUIRE_NOTHROW(Reporter().Report(*analysis, temp_file.string()));
+  std::ifstream file(temp_file.string(), std::ios::binary);
+  char magic[2] = {};
+  CHECK(file.read(magic, sizeof(magic)));
+  CHECK(magic[0] == '\x1f');  // The gzip header.
+  CHECK(magic[1] == '\x8b');
+  CHECK_NOTHROW(xml::Document(temp_file.string(), &validator));
+  fs::remove(temp_file);
+}
+
+#ifdef SCRAM_WITH_ZSTD
+// The zstd-compressed report is read back with on-the-fly decompression.
+TEST_F(RiskAnalysisTest, ReportCompressedZstd) {
+  static xml::Validator validator(env::report_schema());
+  std::string tree_input = "tests/input/fta/correct_tree_input.xml";
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  fs::path temp_file = fs::temp_directory_path() /
+                       ("scram_report_test-" + fs::unique_path().string() +
+                        ".xml.zst");
+  REQUIRE_NOTHROW(Reporter().Report(*analysis, temp_file.string()));
+  std::ifstream file(temp_file.string(), std::ios::binary);
+  char magic[4] = {};
+  CHECK(file.read(magic, sizeof(magic)));
+  CHECK(magic[0] == '\x28');  // The zstd frame header.
+  CHECK(magic[1] == '\xb5');
+  CHECK(magic[2] == '\x2f');
+  CHECK(magic[3] == '\xfd');
+  CHECK_NOTHROW(xml::Document(temp_file.string(), &validator));
+  fs::remove(temp_file);
+}
+#endif
+
+// The compact reports of products in the non-XML formats.
+TEST_F(RiskAnalysisTest, ReportCompactFormats) {
+  std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  auto report = [this](ReportFormat format) {
+    fs::path temp_file = fs::temp_directory_path() /
+                         ("scram_report_test-" + fs::unique_path().string());
+    REQUIRE_NOTHROW(Reporter(format).Report(*analysis, temp_file.string()));
+    std::ifstream file(temp_file.string(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    fs::remove(temp_file);
+    return content;
+  };
+  auto count_lines = [](const std::string& content, const char* prefix) {
+    std::istringstream stream(content);
+    int num_lines = 0;
+    for (std::string line; std::getline(stream, line);)
+      num_lines += line.compare(0, std::strlen(prefix), prefix) == 0;
+    return num_lines;
+  };
+
+  std::string csv = report(ReportFormat::kCsv);
+  CHECK(count_lines(csv, "# software: SCRAM") == 1);
+  CHECK(count_lines(csv, "name,") == 1);
+  CHECK(count_lines(csv, "\"TopEvent\",,,,2,") == 4);
+  CHECK(csv.find(",0.42,\"PumpOne;PumpTwo\"\n") != std::string::npos);
+
+  std::string jsonl = report(ReportFormat::kJsonLines);
+  CHECK(count_lines(jsonl, "{\"information\":{\"software\":\"SCRAM\"") == 1);
+  CHECK(count_lines(jsonl, "{\"sum-of-products\":{\"name\":\"TopEvent\"") ==
+        1);
+  CHECK(count_lines(jsonl, "{\"product\":{\"name\":\"TopEvent\"") == 4);
+  CHECK(jsonl.find("\"literals\":[\"PumpOne\",\"PumpTwo\"]") !=
+        std::string::npos);
+
+  std::string binary = report(ReportFormat::kBinary);
+  CHECK(binary.compare(0, 4, "SCMP") == 0);
+  // The literal stream of the last target products and the probabilities.
+  const int kNumProducts = 4;
+  REQUIRE(binary.size() > (kNumProducts * 3 + 1) + kNumProducts * 8);
+  CHECK(binary[binary.size() - kNumProducts * 8 - 1] == 1);
+}
+
+// The compact reports have the target warnings
+// and reject the results they cannot hold.
+TEST_F(RiskAnalysisTest, ReportCompactLimits) {
+  std::string tree_input = "tests/input/core/a_or_not_a.xml";
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  fs::path temp_file = fs::temp_directory_path() /
+                       ("scram_report_test-" + fs::unique_path().string());
+  auto report = [this, &temp_file](ReportFormat format) {
+    Reporter(format).Report(*analysis, temp_file.string());
+    std::ifstream file(temp_file.string(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    fs::remove(temp_file);
+    return content;
+  };
+  std::string warning = "The set is UNITY/Base.";
+  CHECK(report(ReportFormat::kCsv).find("\n# warning:TopEvent: " + warning +
+                                        "\n") != std::string::npos);
+  CHECK(report(ReportFormat::kJsonLines)
+            .find("\"warning:TopEvent\":\"" + warning + "\"") !=
+        std::string::npos);
+
+  core::Settings importance;
+  importance.importance_analysis(true);
+  CHECK_NOTHROW(Reporter().CheckSettings(importance));
+  for (auto format :
+       {ReportFormat::kBinary, ReportFormat::kCsv, ReportFormat::kJsonLines}) {
+    CHECK_THROWS_AS(Reporter(format).CheckSettings(importance), SettingsError);
+  }
+  settings.importance_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_THROWS_AS(report(ReportFormat::kCsv), SettingsError);
+  CHECK_FALSE(fs::exists(temp_file));
+}
+
+// The results rendered concurrently are reported in the analysis order.
+TEST_F(RiskAnalysisTest, ReportConcurrently) {
+  // The same results are reported with the different number of jobs.
+  struct ConcurrentAnalysis : public RiskAnalysis {
+    using RiskAnalysis::RiskAnalysis;
+    void num_jobs(int n) { settings().num_jobs(n); }
+  };
+  std::string input = "input/EventTrees/gas_leak/gas_leak_reactive.xml";
+  settings.probability_analysis(true).importance_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({input}));
+  ConcurrentAnalysis concurrent_analysis(model.get(), settings);
+  REQUIRE_NOTHROW(concurrent_analysis.Analyze());
+  auto report = [&concurrent_analysis](int num_jobs) {
+    concurrent_analysis.num_jobs(num_jobs);
+    fs::path temp_file = fs::temp_directory_path() /
+                         ("scram_report_test-" + fs::unique_path().string());
+    REQUIRE_NOTHROW(Reporter().Report(concurrent_analysis, temp_file.string()));
+    std::ifstream file(temp_file.string());
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    fs::remove(temp_file);
+    std::string::size_type pos = content.find("<results>");
+    REQUIRE(pos != std::string::npos);
+    return content.substr(pos);  // The information has run-time data.
+  };
+  std::string serial = report(1);
+  CHECK(serial.find("<importance ") != std::string::npos);
+  CHECK(report(4) == serial);
+  CHECK(report(64) == serial);
+}
+
+// The results rendered during the analysis are reported as if rendered after.
+TEST_F(RiskAnalysisTest, ReportPrerendered) {
+  std::string input = GENERATE(
+      std::string("input/ThreeMotor/three_motor.xml"),
+      std::string("input/TwoTrain/two_train_alignment.xml"));
+  INFO("input: " + input);
+  settings.probability_analysis(true).importance_analysis(true);
+  auto report = [this](Reporter* reporter) {
+    fs::path temp_file = fs::temp_directory_path() /
+                         ("scram_report_test-" + fs::unique_path().string());
+    REQUIRE_NOTHROW(reporter->Report(*analysis, temp_file.string()));
+    std::ifstream file(temp_file.string());
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    fs::remove(temp_file);
+    std::string::size_type pos = content.find("<results>");
+    REQUIRE(pos != std::string::npos);
+    return content.substr(pos);  // The information has run-time data.
+  };
+  REQUIRE_NOTHROW(ProcessInputFiles({input}));
+  Reporter serial_reporter;
+  CHECK_FALSE(serial_reporter.Prerender(*analysis, true));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::string serial = report(&serial_reporter);
+
+  settings.num_jobs(4);
+  REQUIRE_NOTHROW(ProcessInputFiles({input}));
+  Reporter reporter;
+  RiskAnalysis::Observer observer = reporter.Prerender(*analysis, true);
+  REQUIRE(observer);
+  std::atomic<int> num_observed = 0;
+  REQUIRE_NOTHROW(analysis->Analyze([&observer, &num_observed](int index) {
+    ++num_observed;
+    observer(index);
+  }));
+  CHECK(num_observed > 0);
+  CHECK(report(&reporter) == serial);
+}
+
 TEST_F(RiskAnalysisTest, ReportEmpty) {
   std::string tree_input = "tests/input/empty_model.xml";
   CheckReport({tree_input});
@@ -536,6 +1151,21 @@ TEST_F(RiskAnalysisTest, ReportUncertaintyResults) {
   CheckReport({tree_input});
 }
 
+// Reporting of importance factor distributions.
+TEST_F(RiskAnalysisTest, ReportImportanceUncertainty) {
+  std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
+  settings.importance_uncertainty(true);
+  CheckReport({tree_input});
+}
+
+// Reporting of the parameter sweep with importance factors.
+TEST_F(RiskAnalysisTest, ReportSensitivity) {
+  std::string tree_input = "tests/input/fta/sensitivity.xml";
+  settings.sensitivity_analysis("PumpFailure", {0, 0.3, 0.6})
+      .importance_analysis(true);
+  CheckReport({tree_input});
+}
+
 // Reporting event tree analysis with an initiating event.
 TEST_F(RiskAnalysisTest, ReportInitiatingEventAnalysis) {
   const char* tree_input = "input/EventTrees/bcd.xml";
@@ -17,11 +17,18 @@
 
 #include "serialization.h"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <boost/exception/get_error_info.hpp>
 #include <boost/filesystem.hpp>
 
 #include <catch2/catch.hpp>
 
 #include "env.h"
+#include "error.h"
 #include "initializer.h"
 #include "settings.h"
 #include "xml.h"
@@ -57,4 +64,113 @@ TEST_CASE("SerializationTest.InputOutput", "[mef::serialization]") {
   fs::remove(temp_file);
 }
 
+namespace {
+
+/// @returns The XML serialization of the model.
+std::string SerializeToString(const Model& model, const fs::path& temp_file) {
+  Serialize(model, temp_file.string());
+  std::stringstream text;
+  text << std::ifstream(temp_file.string()).rdbuf();
+  return text.str();
+}
+
+}  // namespace
+
+TEST_CASE("SerializationTest.CompileModel", "[mef::serialization]") {
+  auto input = GENERATE(values<std::vector<std::string>>(
+      {{"tests/input/xml_special_chars.xml"},
+       {"tests/input/xml_cdata.xml"},
+       {"tests/input/fta/correct_tree_input_with_probs.xml"},
+       {"tests/input/fta/correct_formulas.xml"},
+       {"input/Theatre/theatre.xml"},
+       {"input/Baobab/baobab2.xml", "input/Baobab/baobab2-basic-events.xml"}}));
+  INFO("inputs: " +
+       Catch::StringMaker<std::vector<std::string>>::convert(input))
+  fs::path temp_file =
+      fs::temp_directory_path() / ("scram_test-" + fs::unique_path().string());
+  fs::path image_file = temp_file.string() + ".smb";
+  REQUIRE_NOTHROW(Compile(input, image_file.string()));
+  CHECK(xml::Image::Detect(image_file.string()));
+  CHECK_FALSE(xml::Image::Detect(input.front()));
+
+  std::unique_ptr<Model> model = Initializer(input, core::Settings{}).model();
+  std::unique_ptr<Model> loaded;
+  REQUIRE_NOTHROW(
+      loaded = Initializer({image_file.string()}, core::Settings{}).model());
+  CHECK(SerializeToString(*loaded, temp_file) ==
+        SerializeToString(*model, temp_file));
+
+  fs::resize_file(image_file, fs::file_size(image_file) / 2);
+  CHECK_THROWS_AS(Initializer({image_file.string()}, core::Settings{}),
+                  xml::ParseError);
+  fs::remove(image_file);
+  fs::remove(temp_file);
+}
+
+// The texts of the elements keep the CDATA sections.
+TEST_CASE("SerializationTest.CompileCdata", "[mef::serialization]") {
+  fs::path image_file =
+      fs::temp_directory_path() /
+      ("scram_test-" + fs::unique_path().string() + ".smb");
+  Compile({"tests/input/xml_cdata.xml"}, image_file.string());
+  std::unique_ptr<Model> model;
+  REQUIRE_NOTHROW(
+      model = Initializer({image_file.string()}, core::Settings{}).model());
+  REQUIRE(model->basic_events().size() == 1);
+  CHECK(model->basic_events().begin()->label() ==
+        "Label with <CDATA> & \"quotes\" in the middle");
+  fs::remove(image_file);
+}
+
+// The elements keep the line numbers past the limit of the XML library.
+TEST_CASE("SerializationTest.CompileBigLines", "[mef::serialization]") {
+  fs::path temp_file =
+      fs::temp_directory_path() / ("scram_test-" + fs::unique_path().string());
+  fs::path input_file = temp_file.string() + ".xml";
+  fs::path image_file = temp_file.string() + ".smb";
+  const char* kEvent =
+      "<define-basic-event name=\"e1\"><float value=\"0.1\"/>"
+      "</define-basic-event>\n";
+  std::string input = "<?xml version=\"1.0\"?>\n<opsa-mef>\n<model-data>\n";
+  input += kEvent + std::string(70000, '\n');
+  int line = std::count(input.begin(), input.end(), '\n') + 1;
+  input += kEvent + std::string("</model-data>\n</opsa-mef>\n");
+  std::ofstream(input_file.string()) << input;
+
+  Compile({input_file.string()}, image_file.string());
+  try {
+    Initializer({image_file.string()}, core::Settings{});
+    FAIL("The redefinition must be an error.");
+  } catch (const ValidityError& err) {
+    const int* error_line = boost::get_error_info<boost::errinfo_at_line>(err);
+    REQUIRE(error_line);
+    CHECK(*error_line == line);
+  }
+  fs::remove(input_file);
+  fs::remove(image_file);
+}
+
+// The corrupted images are validated as the original documents.
+TEST_CASE("SerializationTest.CompileCorrupted", "[mef::serialization]") {
+  fs::path image_file =
+      fs::temp_directory_path() /
+      ("scram_test-" + fs::unique_path().string() + ".smb");
+  Compile({"tests/input/fta/ccf_unordered_factors.xml"}, image_file.string());
+  std::string data;
+  {
+    std::stringstream image;
+    image << std::ifstream(image_file.string(), std::ios::binary).rdbuf();
+    data = image.str();
+  }
+  const std::string kName("members", sizeof("members"));  // The table entry.
+  std::string::size_type pos = data.find(kName);
+  REQUIRE(pos != std::string::npos);
+  data[pos + kName.size() - 2] = 'z';
+  std::ofstream(image_file.string(), std::ios::binary) << data;
+  CHECK(xml::Image::Detect(image_file.string()));
+  CHECK_THROWS_AS(Initializer({image_file.string()}, core::Settings{}),
+                  xml::ValidityError);
+  fs::remove(image_file);
+}
+
 }  // namespace scram::mef::test
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server.h"
+
+#include <sstream>
+
+#include <catch2/catch.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "initializer.h"
+
+namespace pt = boost::property_tree;
+
+namespace scram::test {
+
+namespace {
+
+/// Loads the model from the input file into a new server.
+std::unique_ptr<Server> MakeServer(const std::string& input_file) {
+  core::Settings settings;
+  settings.probability_analysis(true);
+  return std::make_unique<Server>(
+      mef::Initializer({input_file}, settings).model(), settings);
+}
+
+/// Processes the request and parses the response.
+pt::ptree Request(Server* server, const std::string& request) {
+  std::istringstream response(server->Process(request));
+  pt::ptree tree;
+  pt::read_json(response, tree);
+  return tree;
+}
+
+}  // namespace
+
+TEST_CASE("ServerTest.SetProbability", "[server]") {
+  auto server = MakeServer("tests/input/fta/correct_tree_input_with_probs.xml");
+  const char* request = R"({"request": "probability", "gate": "TopEvent"})";
+  pt::ptree response = Request(server.get(), request);
+  REQUIRE(response.get<std::string>("status") == "ok");
+  CHECK(response.get<double>("probability") == Approx(0.646));
+
+  response = Request(
+      server.get(),
+      R"({"request": "set-probability", "event": "PumpOne", "value": 0})");
+  REQUIRE(response.get<std::string>("status") == "ok");
+  response = Request(server.get(), request);
+  CHECK(response.get<double>("probability") == Approx(0.34));
+
+  response = Request(
+      server.get(),
+      R"({"request": "set-probability", "event": "PumpOne", "value": 2})");
+  CHECK(response.get<std::string>("status") == "error");
+  response = Request(server.get(), request);
+  CHECK(response.get<double>("probability") == Approx(0.34));
+}
+
+// The probabilities are reported without the loss of precision.
+TEST_CASE("ServerTest.ResponsePrecision", "[server]") {
+  auto server = MakeServer("tests/input/fta/constant_propagation.xml");
+  const char* request = R"({"request": "probability", "gate": "Root"})";
+  REQUIRE(Request(server.get(),
+                  R"({"request": "set-probability", "event": "B", "value": 1})")
+              .get<std::string>("status") == "ok");
+  const char* set_request =
+      R"({"request": "set-probability", "event": "A", )"
+      R"("value": 0.1234567890123456789})";
+  for (int i = 0; i < 3; ++i) {  // The expressions are replaced.
+    REQUIRE(Request(server.get(), set_request).get<std::string>("status") ==
+            "ok");
+  }
+  CHECK(Request(server.get(), request).get<double>("probability") ==
+        0.1234567890123456789);
+}
+
+TEST_CASE("ServerTest.SetHouseEvent", "[server]") {
+  auto server = MakeServer("tests/input/fta/constant_propagation.xml");
+  const char* request = R"({"request": "probability", "gate": "Root"})";
+  CHECK(Request(server.get(), request).get<double>("probability") ==
+        Approx(0.02));
+
+  pt::ptree response =
+      Request(server.get(), R"({"request": "set-house-event", "event": "h2"})");
+  REQUIRE(response.get<std::string>("status") == "ok");
+  CHECK(response.get<bool>("state"));
+  CHECK(Request(server.get(), request).get<double>("probability") == 1);
+
+  response = Request(
+      server.get(),
+      R"({"request": "set-house-event", "event": "h2", "state": false})");
+  CHECK_FALSE(response.get<bool>("state"));
+  CHECK(Request(server.get(), request).get<double>("probability") ==
+        Approx(0.02));
+}
+
+TEST_CASE("ServerTest.Importance", "[server]") {
+  auto server = MakeServer("tests/input/fta/correct_tree_input_with_probs.xml");
+  pt::ptree response = Request(
+      server.get(), R"({"request": "importance", "gate": "TrainOne"})");
+  REQUIRE(response.get<std::string>("status") == "ok");
+  CHECK(response.get<double>("probability") == Approx(0.76));
+  const pt::ptree& importance = response.get_child("importance");
+  REQUIRE(importance.size() == 2);
+  for (const auto& record : importance) {
+    double mif = record.second.get<double>("MIF");
+    if (record.second.get<std::string>("event") == "PumpOne") {
+      CHECK(mif == Approx(0.6));
+    } else {
+      CHECK(mif == Approx(0.4));
+    }
+  }
+}
+
+TEST_CASE("ServerTest.InvalidRequests", "[server]") {
+  auto server = MakeServer("tests/input/fta/correct_tree_input_with_probs.xml");
+  for (const char* request :
+       {"not json", R"({"gate": "TopEvent"})", R"({"request": "unknown"})",
+        R"({"request": "probability", "gate": "Missing"})",
+        R"({"request": "probability", "gate": "PumpOne"})",
+        R"({"request": "set-house-event", "event": "TopEvent"})",
+        R"({"request": "set-probability", "event": "PumpOne"})"}) {
+    INFO(request);
+    CHECK(Request(server.get(), request).get<std::string>("status") ==
+          "error");
+  }
+  CHECK_FALSE(server->done());
+  std::istringstream input(
+      "\n"
+      R"({"request": "probability", "gate": "TopEvent"})"
+      "\n"
+      R"({"request": "quit"})"
+      "\n"
+      R"({"request": "probability", "gate": "TopEvent"})"
+      "\n");
+  std::ostringstream output;
+  server->Serve(input, output);
+  CHECK(server->done());
+  std::istringstream responses(output.str());
+  std::string line;
+  int num_responses = 0;
+  while (std::getline(responses, line))
+    ++num_responses;
+  CHECK(num_responses == 2);
+}
+
+}  // namespace scram::test
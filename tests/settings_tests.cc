@@ -43,6 +43,11 @@ TEST_CASE("SettingsTest IncorrectSetup", "[settings]") {
   // Incorrect number of bins.
   CHECK_THROWS_AS(s.num_bins(-10), SettingsError);
   CHECK_THROWS_AS(s.num_bins(0), SettingsError);
+  // Incorrect number of jobs.
+  CHECK_THROWS_AS(s.num_jobs(-1), SettingsError);
+  CHECK_THROWS_AS(s.num_jobs(0), SettingsError);
+  // Incorrect cache size limit.
+  CHECK_THROWS_AS(s.cache_limit(0), SettingsError);
   // Incorrect seed.
   CHECK_THROWS_AS(s.seed(-1), SettingsError);
   // Incorrect mission time.
@@ -90,6 +95,11 @@ TEST_CASE("SettingsTest CorrectSetup", "[settings]") {
   CHECK_NOTHROW(s.num_bins(1));
   CHECK_NOTHROW(s.num_bins(10));
 
+  // Correct number of jobs.
+  CHECK_NOTHROW(s.num_jobs(1));
+  CHECK_NOTHROW(s.num_jobs(8));
+  // Correct cache size limit.
+  CHECK_NOTHROW(s.cache_limit(1));
   // Correct seed.
   CHECK_NOTHROW(s.seed(1));
 
@@ -122,4 +132,34 @@ TEST_CASE("SettingsTest SetupForPrimeImplicants", "[settings]") {
   CHECK_THROWS_AS(s.approximation("mcub"), SettingsError);
 }
 
+TEST_CASE("SettingsTest SetupForSharedBdd", "[settings]") {
+  Settings s;
+  // Incorrect request for the shared BDD.
+  CHECK_NOTHROW(s.algorithm("zbdd"));
+  CHECK_THROWS_AS(s.shared_bdd(true), SettingsError);
+  // Correct request for the shared BDD.
+  REQUIRE_NOTHROW(s.algorithm("bdd"));
+  REQUIRE_NOTHROW(s.shared_bdd(true));
+  CHECK(s.shared_bdd());
+  // Other algorithms cancel the request.
+  CHECK_NOTHROW(s.algorithm("mocus"));
+  CHECK_FALSE(s.shared_bdd());
+}
+
+TEST_CASE("SettingsTest SetupForSensitivityAnalysis", "[settings]") {
+  Settings s;
+  CHECK_THROWS_AS(s.sensitivity_analysis("lambda", {}), SettingsError);
+  CHECK_FALSE(s.sensitivity_analysis());
+  REQUIRE_NOTHROW(s.sensitivity_analysis("lambda", {1e-3, 1e-2}));
+  CHECK(s.sensitivity_analysis());
+  CHECK(s.sensitivity_parameter() == "lambda");
+  CHECK(s.sensitivity_values() == std::vector<double>{1e-3, 1e-2});
+  // The sensitivity analysis requires probability analysis.
+  CHECK(s.probability_analysis());
+  s.probability_analysis(false);
+  CHECK(s.probability_analysis());
+  REQUIRE_NOTHROW(s.sensitivity_analysis("", {}));
+  CHECK_FALSE(s.sensitivity_analysis());
+}
+
 }  // namespace scram::core::test
@@ -156,4 +156,68 @@ TEST_CASE("XmlStreamTest.Full", "[xml_stream]") {
   fs::remove(temp_file);
 }
 
+// The numbers are printed in the shortest form to read back exactly.
+TEST_CASE("XmlStreamTest.Numbers", "[xml_stream]") {
+  fs::path unique_name = "scram_xml_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  INFO("XML temp file: " + temp_file.string());
+  const char content[] =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<root int=\"-42\" size=\"18446744073709551615\" double=\"0.1\""
+      " exact=\"0.12345678901234566\" tiny=\"1e-300\" name=\"a&amp;&lt;b\"/>\n";
+  {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(temp_file.string().c_str(), "w"), &std::fclose);
+    Stream xml_stream(fp.get());
+    xml_stream.root("root")
+        .SetAttribute("int", -42)
+        .SetAttribute("size", static_cast<std::size_t>(-1))
+        .SetAttribute("double", 0.1)
+        .SetAttribute("exact", 0.12345678901234566)
+        .SetAttribute("tiny", 1e-300)
+        .SetAttribute("name", EscapedText("a&<b"));
+  }
+  std::stringstream str_stream;
+  str_stream << std::fstream(temp_file.string()).rdbuf();
+  CHECK(str_stream.str() == content);
+  fs::remove(temp_file);
+}
+
+// The children rendered separately are put as if added directly.
+TEST_CASE("XmlStreamTest.Fragment", "[xml_stream]") {
+  fs::path unique_name = "scram_xml_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  INFO("XML temp file: " + temp_file.string());
+  const char content[] =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<root attr=\"1\">\n"
+      "  <first>\n"
+      "    <leaf/>\n"
+      "  </first>\n"
+      "  <second>text</second>\n"
+      "  <third/>\n"
+      "</root>\n";
+  {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(temp_file.string().c_str(), "w"), &std::fclose);
+    Stream xml_stream(fp.get());
+    StreamElement root = xml_stream.root("root");
+    root.SetAttribute("attr", 1);
+    Fragment first(root);
+    first.root().AddChild("first").AddChild("leaf");
+    Fragment rest(root);
+    rest.root().AddChild("second").AddText("text");
+    rest.root().AddChild("third");
+    CHECK_THROWS_AS(rest.root().SetAttribute("late", 1), StreamError);
+    CHECK_THROWS_AS(rest.root().AddText("late"), StreamError);
+    root.AddFragment(first);
+    root.AddFragment(rest);
+    CHECK_THROWS_AS(root.SetAttribute("late", 1), StreamError);
+  }
+  std::stringstream str_stream;
+  str_stream << std::fstream(temp_file.string()).rdbuf();
+  CHECK(str_stream.str() == content);
+  fs::remove(temp_file);
+}
+
 }  // namespace scram::xml::test
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xml.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/exception/get_error_info.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "env.h"
+
+namespace scram::xml::test {
+
+namespace {
+
+/// The containers streamed by the model initializer.
+const std::vector<std::string> kContainers = {
+    "define-fault-tree", "define-component", "model-data"};
+
+/// @returns true if the element is streamed as a container.
+bool IsContainer(const Element& element) {
+  return std::find(kContainers.begin(), kContainers.end(), element.name()) !=
+         kContainers.end();
+}
+
+/// @returns The name, the line, and the identifying attributes
+///          of the element with its descendants.
+std::string Dump(const Element& element, bool recursive = true) {
+  std::string dump = std::string(element.name()) + "@" +
+                     std::to_string(element.line()) + "(" +
+                     std::string(element.attribute("name")) + "," +
+                     std::string(element.attribute("value")) + ")";
+  if (recursive) {
+    for (const Element& child : element.children())
+      dump += "[" + Dump(child) + "]";
+  }
+  return dump;
+}
+
+/// @returns The dumps of the elements in the streaming order.
+std::vector<std::string> Stream(Reader* reader) {
+  std::vector<std::string> elements;
+  for (int depth = 1; depth;) {
+    std::optional<Element> element = reader->next();
+    if (!element) {
+      --depth;
+      elements.push_back("end");
+    } else if (IsContainer(*element)) {
+      ++depth;
+      elements.push_back(Dump(*element, /*recursive=*/false));
+    } else {
+      elements.push_back(Dump(*element));
+    }
+  }
+  return elements;
+}
+
+/// Lists the dumps of the DOM elements in the streaming order.
+void Traverse(const Element& parent, std::vector<std::string>* elements) {
+  for (const Element& element : parent.children()) {
+    if (IsContainer(element)) {
+      elements->push_back(Dump(element, /*recursive=*/false));
+      Traverse(element, elements);
+    } else {
+      elements->push_back(Dump(element));
+    }
+  }
+  elements->push_back("end");
+}
+
+}  // namespace
+
+// The streamed elements are the same as the elements of the DOM document.
+TEST_CASE("XmlTest.ReaderStream", "[xml]") {
+  // clang-format off
+  auto input = GENERATE(as<std::string>(),
+                        "tests/input/fta/correct_tree_input.xml",
+                        "tests/input/fta/component_definition.xml",
+                        "tests/input/fta/correct_expressions.xml",
+                        "tests/input/xinclude.xml",
+                        "tests/input/xinclude_transitive.xml",
+                        "tests/input/xinclude_fallback.xml");
+  // clang-format on
+  CAPTURE(input);
+  Document document(input);
+  std::vector<std::string> expected;
+  Traverse(document.root(), &expected);
+
+  Reader reader(input, kContainers);
+  CHECK(reader.root().name() == "opsa-mef");
+  CHECK(Stream(&reader) == expected);
+  CHECK_FALSE(reader.next());
+}
+
+// The image copies of the streamed elements outlive the stream.
+TEST_CASE("XmlTest.ImageBuilder", "[xml]") {
+  std::vector<std::string> inputs = {"tests/input/fta/correct_tree_input.xml",
+                                     "tests/input/fta/component_definition.xml"};
+  Image::Builder builder;
+  std::vector<std::vector<std::string>> expected;
+  for (const std::string& input : inputs) {
+    Reader reader(input, kContainers);
+    builder.Start(reader.root());
+    expected.emplace_back();
+    for (int depth = 1; depth;) {
+      std::optional<Element> element = reader.next();
+      if (!element) {
+        --depth;
+      } else if (IsContainer(*element)) {
+        ++depth;
+      } else {
+        builder.Append(*element);
+        expected.back().push_back(Dump(*element));
+      }
+    }
+  }
+  Image image = builder.Finish();
+  REQUIRE(image.num_documents() == inputs.size());
+  for (int i = 0; i < image.num_documents(); ++i) {
+    Reader reader(image, i);
+    CHECK(reader.root().filename() == inputs[i]);
+    std::vector<std::string> elements;
+    while (std::optional<Element> element = reader.next())
+      elements.push_back(Dump(*element));
+    CHECK(elements == expected[i]);
+  }
+}
+
+// The warnings of the XML library do not fail the validation.
+TEST_CASE("XmlTest.ValidationWarnings", "[xml]") {
+  Validator validator(env::input_schema());
+  Validation validation("tests/input/xinclude_fallback.xml", &validator);
+  validation.run();
+  CHECK(validation.confirm(std::numeric_limits<int>::max()) ==
+        std::numeric_limits<int>::max());
+}
+
+// The streaming validation falls back to the DOM validation
+// to report the errors.
+TEST_CASE("XmlTest.ValidationFallback", "[xml]") {
+  std::string input = "tests/input/schema_fail.xml";
+  Validator validator(env::input_schema());
+  int line = 0;
+  std::string message;
+  try {
+    Document(input, &validator);
+    FAIL("The document must be invalid.");
+  } catch (const ValidityError& err) {
+    const int* error_line = boost::get_error_info<boost::errinfo_at_line>(err);
+    REQUIRE(error_line);
+    line = *error_line;
+    message = err.what();
+  }
+
+  Validation validation(input, &validator);
+  validation.run();
+  try {
+    Reader reader(input, kContainers, &validation);
+    Stream(&reader);
+    FAIL("The streamed document must be invalid.");
+  } catch (const ValidityError& err) {
+    const int* error_line = boost::get_error_info<boost::errinfo_at_line>(err);
+    REQUIRE(error_line);
+    CHECK(*error_line == line);
+    CHECK(std::string(err.what()) == message);
+  }
+}
+
+}  // namespace scram::xml::test